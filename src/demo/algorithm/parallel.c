@@ -0,0 +1,156 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the large item type for testing the reference items
+typedef struct __tb_demo_item_t
+{
+    tb_long_t           key;
+    tb_byte_t           data[32];
+
+}tb_demo_item_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * test
+ */
+static tb_bool_t tb_demo_parallel_walk_func(tb_iterator_ref_t iterator, tb_pointer_t item, tb_cpointer_t priv)
+{
+    return (tb_long_t)item != (tb_long_t)priv;
+}
+static tb_void_t tb_demo_parallel_sum_reduce(tb_iterator_ref_t iterator, tb_pointer_t result, tb_cpointer_t item, tb_cpointer_t priv)
+{
+    *((tb_hong_t*)result) += (tb_long_t)item;
+}
+static tb_void_t tb_demo_parallel_sum_merge(tb_pointer_t result, tb_cpointer_t partial, tb_cpointer_t priv)
+{
+    *((tb_hong_t*)result) += *((tb_hong_t const*)partial);
+}
+static tb_bool_t tb_demo_parallel_pred_positive(tb_iterator_ref_t iterator, tb_cpointer_t item, tb_cpointer_t value)
+{
+    return (tb_long_t)item > 0;
+}
+static tb_long_t tb_demo_parallel_item_comp(tb_iterator_ref_t iterator, tb_cpointer_t litem, tb_cpointer_t ritem)
+{
+    tb_long_t lkey = ((tb_demo_item_t const*)litem)->key;
+    tb_long_t rkey = ((tb_demo_item_t const*)ritem)->key;
+    return lkey < rkey? -1 : (lkey > rkey);
+}
+static tb_void_t tb_demo_parallel_test_long(tb_size_t n)
+{
+    // init data
+    tb_size_t  i = 0;
+    tb_long_t* data = (tb_long_t*)tb_nalloc0(n, sizeof(tb_long_t));
+    tb_long_t* copy = (tb_long_t*)tb_nalloc0(n, sizeof(tb_long_t));
+    if (data && copy)
+    {
+        // init iterators
+        tb_array_iterator_t array_iterator;
+        tb_array_iterator_t copy_iterator;
+        tb_iterator_ref_t   iterator = tb_array_iterator_init_long(&array_iterator, data, n);
+        tb_iterator_ref_t   iterator_copy = tb_array_iterator_init_long(&copy_iterator, copy, n);
+
+        // make data
+        for (i = 0; i < n; i++) data[i] = tb_random_range(TB_MINS16, TB_MAXS16);
+        tb_memcpy(copy, data, n * sizeof(tb_long_t));
+
+        // reduce
+        tb_hong_t sum = 0;
+        tb_hong_t sum_check = 0;
+        tb_hong_t time = tb_mclock();
+        tb_parallel_reduce_all(tb_null, iterator, &sum, sizeof(sum), tb_demo_parallel_sum_reduce, tb_demo_parallel_sum_merge, tb_null);
+        time = tb_mclock() - time;
+        for (i = 0; i < n; i++) sum_check += data[i];
+        tb_trace_i("reduce: sum: %lld, %s, %lld ms", sum, sum == sum_check? "ok" : "failed", time);
+
+        // count
+        time = tb_mclock();
+        tb_size_t count = tb_parallel_count_all_if(tb_null, iterator, tb_demo_parallel_pred_positive, tb_null);
+        time = tb_mclock() - time;
+        tb_trace_i("count: %lu, %s, %lld ms", count, count == tb_count_all_if(iterator, tb_demo_parallel_pred_positive, tb_null)? "ok" : "failed", time);
+
+        // find the first item
+        tb_long_t value = data[n * 3 / 4];
+        time = tb_mclock();
+        tb_size_t itor = tb_parallel_find_all_if(tb_null, iterator, tb_predicate_eq, (tb_cpointer_t)value);
+        time = tb_mclock() - time;
+        tb_trace_i("find: %ld at %lu, %s, %lld ms", value, itor, itor == tb_find_all_if(iterator, tb_predicate_eq, (tb_cpointer_t)value)? "ok" : "failed", time);
+
+        // walk until the found item
+        time = tb_mclock();
+        tb_size_t walked = tb_parallel_walk_all(tb_null, iterator, tb_demo_parallel_walk_func, (tb_cpointer_t)value);
+        time = tb_mclock() - time;
+        tb_trace_i("walk: %lu items, %s, %lld ms", walked, walked >= itor? "ok" : "failed", time);
+
+        // sort
+        time = tb_mclock();
+        tb_parallel_sort_all(tb_null, iterator, tb_null);
+        time = tb_mclock() - time;
+
+        // sort the copy
+        tb_hong_t time_copy = tb_mclock();
+        tb_sort_all(iterator_copy, tb_null);
+        time_copy = tb_mclock() - time_copy;
+
+        // check
+        tb_trace_i("sort: %lu items, %s, %lld ms, tb_sort: %lld ms", n, !tb_memcmp(data, copy, n * sizeof(tb_long_t))? "ok" : "failed", time, time_copy);
+    }
+
+    // exit data
+    if (data) tb_free(data);
+    if (copy) tb_free(copy);
+}
+static tb_void_t tb_demo_parallel_test_mem(tb_size_t n)
+{
+    // init data
+    tb_size_t       i = 0;
+    tb_demo_item_t* data = (tb_demo_item_t*)tb_nalloc0(n, sizeof(tb_demo_item_t));
+    if (data)
+    {
+        // init iterator
+        tb_array_iterator_t array_iterator;
+        tb_iterator_ref_t   iterator = tb_array_iterator_init_mem(&array_iterator, data, n, sizeof(tb_demo_item_t));
+
+        // make data
+        for (i = 0; i < n; i++)
+        {
+            data[i].key = tb_random_range(TB_MINS16, TB_MAXS16);
+            tb_memset(data[i].data, (tb_byte_t)data[i].key, sizeof(data[i].data));
+        }
+
+        // sort
+        tb_hong_t time = tb_mclock();
+        tb_parallel_sort_all(tb_null, iterator, tb_demo_parallel_item_comp);
+        time = tb_mclock() - time;
+
+        // check
+        tb_bool_t ok = tb_true;
+        for (i = 0; i < n && ok; i++)
+        {
+            if (i && data[i - 1].key > data[i].key) ok = tb_false;
+            if (data[i].data[31] != (tb_byte_t)data[i].key) ok = tb_false;
+        }
+        tb_trace_i("sort: %lu large items, %s, %lld ms", n, ok? "ok" : "failed", time);
+
+        // exit data
+        tb_free(data);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_algorithm_parallel_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the items count
+    tb_size_t n = argv[1]? tb_atoi(argv[1]) : 1000000;
+
+    // test it
+    tb_demo_parallel_test_long(n);
+    tb_demo_parallel_test_mem(n >> 2);
+    return 0;
+}
@@ -0,0 +1,128 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the ping-pong count
+#define COUNT       (10000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the busy-polling timeout (us)
+static tb_size_t    g_busypoll = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_busypoll_trace(tb_char_t const* name, tb_co_scheduler_ref_t scheduler)
+{
+    tb_co_scheduler_stats_t stats;
+    if (tb_co_scheduler_stats(scheduler, &stats))
+    {
+        tb_hize_t per = stats.waits? stats.events * 100 / stats.waits : 0;
+        tb_trace_i("[%s]: waits: %llu, wakeups: %llu, events: %llu, events/wait: %llu.%02llu, spins: %llu, spin hits: %llu"
+            , name, stats.waits, stats.wakeups, stats.events, per / 100, per % 100, stats.spins, stats.spin_hits);
+    }
+}
+static tb_void_t tb_demo_coroutine_busypoll_pong(tb_cpointer_t priv)
+{
+    // reply all ping data
+    tb_byte_t       data = 0;
+    tb_socket_ref_t sock = (tb_socket_ref_t)priv;
+    while (tb_socket_brecv(sock, &data, 1))
+    {
+        if (!tb_socket_bsend(sock, &data, 1)) break;
+    }
+    tb_socket_exit(sock);
+}
+static tb_void_t tb_demo_coroutine_busypoll_ping(tb_cpointer_t priv)
+{
+    // ping and wait the reply data
+    tb_size_t       i = 0;
+    tb_byte_t       data = 0;
+    tb_socket_ref_t sock = (tb_socket_ref_t)priv;
+    tb_hong_t       time = tb_uclock();
+    for (i = 0; i < COUNT; i++)
+    {
+        data = (tb_byte_t)i;
+        if (!tb_socket_bsend(sock, &data, 1)) break;
+        if (!tb_socket_brecv(sock, &data, 1)) break;
+    }
+    time = tb_uclock() - time;
+
+    // trace
+    tb_trace_i("[ping]: count: %lu, average rtt: %lld us", i, i? time / (tb_hong_t)i : 0);
+    tb_socket_exit(sock);
+}
+static tb_int_t tb_demo_coroutine_busypoll_thread(tb_cpointer_t priv)
+{
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // enable busy-polling
+        tb_co_scheduler_busypoll_set(scheduler, g_busypoll);
+
+        // start the pong coroutine
+        tb_coroutine_start(scheduler, tb_demo_coroutine_busypoll_pong, priv, 0);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_false);
+
+        // trace
+        tb_demo_coroutine_busypoll_trace("pong", scheduler);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_busypoll_main(tb_int_t argc, tb_char_t** argv)
+{
+    // get the busy-polling timeout (us), e.g. 50
+    if (argv[1]) g_busypoll = tb_atoi(argv[1]);
+
+    // init socket pair
+    tb_socket_ref_t pair[2];
+    if (!tb_socket_pair(TB_SOCKET_TYPE_TCP, pair)) return -1;
+
+    // start the pong thread
+    tb_thread_ref_t thread = tb_thread_init(tb_null, tb_demo_coroutine_busypoll_thread, pair[1], 0);
+    if (thread)
+    {
+        // init scheduler
+        tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+        if (scheduler)
+        {
+            // enable busy-polling
+            tb_co_scheduler_busypoll_set(scheduler, g_busypoll);
+
+            // start the ping coroutine
+            tb_coroutine_start(scheduler, tb_demo_coroutine_busypoll_ping, pair[0], 0);
+
+            // run scheduler
+            tb_co_scheduler_loop(scheduler, tb_false);
+
+            // trace
+            tb_demo_coroutine_busypoll_trace("ping", scheduler);
+
+            // exit scheduler
+            tb_co_scheduler_exit(scheduler);
+        }
+
+        // wait the pong thread
+        tb_thread_wait(thread, -1, tb_null);
+        tb_thread_exit(thread);
+    }
+    return 0;
+}
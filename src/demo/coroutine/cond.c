@@ -0,0 +1,117 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the consumers count
+#define CONSUMERN   (4)
+
+// the produced items count
+#define COUNT       (20)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the lock
+static tb_co_lock_ref_t     g_lock = tb_null;
+
+// the cond
+static tb_co_cond_ref_t     g_cond = tb_null;
+
+// the pending items count
+static tb_size_t            g_items = 0;
+
+// the produced items count
+static tb_size_t            g_produced = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_cond_consumer(tb_cpointer_t priv)
+{
+    tb_size_t count = 0;
+    while (1)
+    {
+        // wait items
+        tb_co_lock_enter(g_lock);
+        while (!g_items && g_produced < COUNT)
+        {
+            // we need also check the timeout
+            if (!tb_co_cond_wait(g_cond, g_lock, 1000))
+                tb_trace_i("[consumer: %lu]: wait timeout", (tb_size_t)priv);
+        }
+
+        // no more items?
+        if (!g_items)
+        {
+            tb_co_lock_leave(g_lock);
+            break;
+        }
+
+        // take it
+        g_items--;
+        count++;
+        tb_co_lock_leave(g_lock);
+    }
+
+    // trace
+    tb_trace_i("[consumer: %lu]: consumed %lu items", (tb_size_t)priv, count);
+}
+static tb_void_t tb_demo_coroutine_cond_producer(tb_cpointer_t priv)
+{
+    tb_size_t i = 0;
+    for (i = 0; i < COUNT; i++)
+    {
+        // produce an item and wake up a consumer
+        tb_co_lock_enter(g_lock);
+        g_items++;
+        g_produced++;
+        tb_co_cond_signal(g_cond);
+        tb_co_lock_leave(g_lock);
+
+        // wait some time
+        tb_msleep(10);
+    }
+
+    // finished, wake up all consumers
+    tb_co_cond_broadcast(g_cond);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_cond_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init lock and cond
+    g_lock = tb_co_lock_init();
+    g_cond = tb_co_cond_init();
+    if (g_lock && g_cond)
+    {
+        // init scheduler
+        tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+        if (scheduler)
+        {
+            // start consumers and producer
+            tb_size_t i = 0;
+            for (i = 0; i < CONSUMERN; i++)
+                tb_coroutine_start(scheduler, tb_demo_coroutine_cond_consumer, (tb_cpointer_t)i, 0);
+            tb_coroutine_start(scheduler, tb_demo_coroutine_cond_producer, tb_null, 0);
+
+            // run scheduler
+            tb_co_scheduler_loop(scheduler, tb_true);
+
+            // exit scheduler
+            tb_co_scheduler_exit(scheduler);
+        }
+    }
+
+    // exit lock and cond
+    if (g_cond) tb_co_cond_exit(g_cond);
+    if (g_lock) tb_co_lock_exit(g_lock);
+    return 0;
+}
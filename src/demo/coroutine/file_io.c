@@ -0,0 +1,128 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the block size
+#define BLOCK       (65536)
+
+// the block count
+#define COUNT       (256)
+
+// the tick interval (ms)
+#define INTERVAL    (5)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the file path
+static tb_char_t    g_filepath[TB_PATH_MAXN];
+
+// the file io has been finished?
+static tb_bool_t    g_finished = tb_false;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_file_io_func(tb_cpointer_t priv)
+{
+    // init data
+    tb_byte_t* data = tb_malloc_bytes(BLOCK);
+    tb_assert_and_check_return(data);
+
+    // init file
+    tb_file_ref_t file = tb_file_init(g_filepath, TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+    if (file)
+    {
+        // write blocks and sync them, the other coroutines will not be blocked
+        tb_size_t i = 0;
+        tb_hong_t time = tb_mclock();
+        tb_memset(data, 'x', BLOCK);
+        for (i = 0; i < COUNT; i++)
+        {
+            if (tb_file_writ(file, data, BLOCK) != BLOCK) break;
+        }
+        tb_bool_t ok = i == COUNT && tb_file_sync(file);
+        tb_trace_i("[io]: writ: %lu blocks, sync: %s, in %lld ms", i, ok? "ok" : "no", tb_mclock() - time);
+
+        // read blocks
+        tb_hize_t read = 0;
+        time = tb_mclock();
+        for (i = 0; i < COUNT; i++)
+        {
+            tb_long_t real = tb_file_pread(file, data, BLOCK, (tb_hize_t)i * BLOCK);
+            if (real <= 0) break;
+            read += real;
+        }
+        tb_trace_i("[io]: read: %llu bytes, in %lld ms", read, tb_mclock() - time);
+
+        // exit file
+        tb_file_exit(file);
+    }
+
+    // remove file
+    tb_file_remove(g_filepath);
+
+    // exit data
+    tb_free(data);
+
+    // finished
+    g_finished = tb_true;
+}
+static tb_void_t tb_demo_coroutine_file_tick_func(tb_cpointer_t priv)
+{
+    // tick until the file io is finished
+    tb_size_t count = 0;
+    tb_hong_t delay = 0;
+    while (!g_finished)
+    {
+        // sleep it
+        tb_hong_t time = tb_mclock();
+        tb_msleep(INTERVAL);
+
+        // update the maximum delay
+        time = tb_mclock() - time;
+        if (time > delay) delay = time;
+        count++;
+    }
+
+    // trace, the ticks will be stalled if the file io blocks the scheduler
+    tb_trace_i("[tick]: count: %lu, max interval: %lld ms", count, delay);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_file_io_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init the file path
+    if (argv[1]) tb_strlcpy(g_filepath, argv[1], sizeof(g_filepath));
+    else
+    {
+        tb_char_t temp[TB_PATH_MAXN];
+        tb_size_t size = tb_directory_temporary(temp, sizeof(temp));
+        tb_assert_and_check_return_val(size, -1);
+        tb_snprintf(g_filepath, sizeof(g_filepath), "%s/tbox_coroutine_file_io.bin", temp);
+    }
+
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // start coroutines
+        tb_coroutine_start(scheduler, tb_demo_coroutine_file_io_func, tb_null, 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_file_tick_func, tb_null, 0);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_true);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
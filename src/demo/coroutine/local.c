@@ -0,0 +1,153 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the requests count
+#define COUNT       (10)
+
+// the access count for benchmark
+#define ACCESS      (1000000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the request context type
+typedef struct __tb_demo_context_t
+{
+    // the trace id
+    tb_size_t           trace_id;
+
+}tb_demo_context_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the request context local
+static tb_co_local_t    g_context = TB_CO_LOCAL_INIT;
+
+// the freed contexts count
+static tb_size_t        g_freed = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_local_free(tb_cpointer_t priv)
+{
+    // trace
+    tb_demo_context_t* context = (tb_demo_context_t*)priv;
+    tb_trace_i("[free]: trace_id: %lu", context->trace_id);
+
+    // free it
+    tb_free(context);
+    g_freed++;
+}
+static tb_void_t tb_demo_coroutine_local_trace(tb_char_t const* info)
+{
+    // trace it with the trace id of the current request
+    tb_demo_context_t* context = (tb_demo_context_t*)tb_co_local_get(&g_context);
+    tb_trace_i("[%lu]: %s", context? context->trace_id : 0, info);
+}
+static tb_void_t tb_demo_coroutine_local_request(tb_cpointer_t priv)
+{
+    // the recycled coroutine must not see the context of the previous request
+    tb_assert(!tb_co_local_has(&g_context));
+
+    // init the request context
+    tb_demo_context_t* context = tb_malloc0_type(tb_demo_context_t);
+    if (!context) return ;
+    context->trace_id = (tb_size_t)priv;
+    tb_co_local_set(&g_context, context);
+
+    // handle this request
+    tb_demo_coroutine_local_trace("begin");
+    tb_coroutine_sleep((tb_long_t)(COUNT - ((tb_size_t)priv - 1) % COUNT) * 10);
+    tb_demo_coroutine_local_trace("end");
+
+    // check it
+    tb_assert(tb_co_local_get(&g_context) == context);
+}
+static tb_void_t tb_demo_coroutine_local_bench(tb_cpointer_t priv)
+{
+    // init the request context
+    tb_demo_context_t* context = tb_malloc0_type(tb_demo_context_t);
+    if (!context) return ;
+    tb_co_local_set(&g_context, context);
+
+    // access it
+    tb_size_t i = 0;
+    tb_size_t sum = 0;
+    tb_hong_t time = tb_mclock();
+    for (i = 0; i < ACCESS; i++)
+    {
+        context = (tb_demo_context_t*)tb_co_local_get(&g_context);
+        sum += context->trace_id + i;
+    }
+    time = tb_mclock() - time;
+
+    // trace
+    tb_trace_i("[bench]: get %lu times in %lld ms, sum: %lu", i, time, sum);
+}
+static tb_void_t tb_demo_coroutine_local_handle(tb_co_scheduler_ref_t scheduler, tb_size_t from)
+{
+    // spawn the requests
+    tb_size_t           i = 0;
+    tb_co_handle_ref_t  handles[COUNT];
+    for (i = 0; i < COUNT; i++)
+        handles[i] = tb_coroutine_spawn(scheduler, tb_demo_coroutine_local_request, (tb_cpointer_t)(from + i), 0);
+
+    // wait them
+    for (i = 0; i < COUNT; i++)
+    {
+        if (handles[i])
+        {
+            tb_coroutine_join(handles[i], -1);
+            tb_coroutine_handle_exit(handles[i]);
+        }
+    }
+}
+static tb_void_t tb_demo_coroutine_local_server(tb_cpointer_t priv)
+{
+    // handle the first requests
+    tb_co_scheduler_ref_t scheduler = (tb_co_scheduler_ref_t)priv;
+    tb_demo_coroutine_local_handle(scheduler, 1);
+
+    // handle the next requests, they will reuse the dead coroutines
+    tb_demo_coroutine_local_handle(scheduler, COUNT + 1);
+
+    // start the benchmark
+    tb_coroutine_start(scheduler, tb_demo_coroutine_local_bench, tb_null, 0);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_local_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init the request context local
+    if (!tb_co_local_init(&g_context, tb_demo_coroutine_local_free)) return -1;
+
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // start the server
+        tb_coroutine_start(scheduler, tb_demo_coroutine_local_server, scheduler, 0);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_true);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+
+    // trace
+    tb_trace_i("freed: %lu", g_freed);
+    return 0;
+}
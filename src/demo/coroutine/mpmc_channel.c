@@ -0,0 +1,137 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the sent data count of each producer
+#define COUNT       (100000)
+
+// the producers count
+#define PRODUCERN   (2)
+
+// the consumer threads count
+#define THREADN     (4)
+
+// the consumer coroutines count of each thread
+#define CONSUMERN   (8)
+
+// the channel size
+#define SIZE        (64)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the received count
+static tb_atomic_t      g_recv = 0;
+
+// the received sum
+static tb_atomic_t      g_sum = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_mpmc_channel_send(tb_cpointer_t priv)
+{
+    // check
+    tb_co_mpmc_channel_ref_t channel = (tb_co_mpmc_channel_ref_t)priv;
+
+    // send data, it will be suspended if the channel is full and be waked up by the consumer threads
+    tb_size_t i = 0;
+    for (i = 1; i <= COUNT; i++)
+        tb_co_mpmc_channel_send(channel, (tb_cpointer_t)i);
+}
+static tb_void_t tb_demo_coroutine_mpmc_channel_recv(tb_cpointer_t priv)
+{
+    // check
+    tb_co_mpmc_channel_ref_t channel = (tb_co_mpmc_channel_ref_t)priv;
+
+    // recv data until the stop data (0)
+    tb_size_t data = 0;
+    while ((data = (tb_size_t)tb_co_mpmc_channel_recv(channel)))
+    {
+        tb_atomic_fetch_and_add(&g_recv, 1);
+        tb_atomic_fetch_and_add(&g_sum, (tb_long_t)data);
+    }
+}
+static tb_int_t tb_demo_coroutine_mpmc_channel_consumer(tb_cpointer_t priv)
+{
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // start consumers
+        tb_size_t i = 0;
+        for (i = 0; i < CONSUMERN; i++)
+            tb_coroutine_start(scheduler, tb_demo_coroutine_mpmc_channel_recv, priv, 0);
+
+        // run scheduler, we cannot use the exclusive mode for multiple threads
+        tb_co_scheduler_loop(scheduler, tb_false);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_mpmc_channel_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init channel
+    tb_co_mpmc_channel_ref_t channel = tb_co_mpmc_channel_init(SIZE, tb_null, tb_null);
+    tb_assert_and_check_return_val(channel, -1);
+
+    // start the consumer threads, each thread has its own scheduler
+    tb_size_t       i = 0;
+    tb_thread_ref_t threads[THREADN];
+    for (i = 0; i < THREADN; i++)
+        threads[i] = tb_thread_init("consumer", tb_demo_coroutine_mpmc_channel_consumer, channel, 0);
+
+    // init the producer scheduler, e.g. the accept thread
+    tb_hong_t time = tb_mclock();
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // start producers
+        for (i = 0; i < PRODUCERN; i++)
+            tb_coroutine_start(scheduler, tb_demo_coroutine_mpmc_channel_send, channel, 0);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_false);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+
+    // stop all consumers from the non-coroutine thread
+    for (i = 0; i < THREADN * CONSUMERN; i++)
+    {
+        while (!tb_co_mpmc_channel_send_try(channel, tb_null))
+            tb_usleep(100);
+    }
+
+    // wait the consumer threads
+    for (i = 0; i < THREADN; i++)
+    {
+        if (threads[i])
+        {
+            tb_thread_wait(threads[i], -1, tb_null);
+            tb_thread_exit(threads[i]);
+        }
+    }
+    time = tb_mclock() - time;
+
+    // trace
+    tb_trace_i("recv: %ld/%d, sum: %ld/%ld, in %lld ms", tb_atomic_get(&g_recv), PRODUCERN * COUNT
+            , tb_atomic_get(&g_sum), (tb_long_t)PRODUCERN * ((tb_long_t)COUNT * (COUNT + 1) / 2), time);
+
+    // exit channel
+    tb_co_mpmc_channel_exit(channel);
+    return 0;
+}
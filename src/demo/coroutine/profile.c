@@ -0,0 +1,113 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the loop count
+#define COUNT       (10)
+
+// the slow threshold (us)
+#define SLOW        (20000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_profile_slow(tb_co_scheduler_ref_t scheduler, tb_co_profile_ref_t profile, tb_cpointer_t priv)
+{
+    // trace
+    tb_trace_i("[slow]: coroutine(%p) has been run %lld us without yielding, max stack depth: %lu/%lu"
+        , profile->coroutine, profile->runtime_last, profile->stackdepth, profile->stacksize);
+}
+static tb_size_t tb_demo_coroutine_profile_deep(tb_size_t depth)
+{
+    // use some stack space
+    tb_byte_t data[1024];
+    tb_memset(data, (tb_byte_t)depth, sizeof(data));
+    return depth? data[depth % sizeof(data)] + tb_demo_coroutine_profile_deep(depth - 1) : 0;
+}
+static tb_void_t tb_demo_coroutine_profile_hog(tb_cpointer_t priv)
+{
+    tb_size_t i = 0;
+    for (i = 0; i < COUNT; i++)
+    {
+        // run it for a long time without yielding
+        tb_hong_t stop = tb_mclock() + (i == COUNT / 2? 50 : 1);
+        while (tb_mclock() < stop) ;
+
+        // use the deep stack
+        if (i == COUNT / 2) tb_trace_i("[hog]: deep: %lu", tb_demo_coroutine_profile_deep(32));
+
+        // yield it
+        tb_coroutine_yield();
+    }
+}
+static tb_void_t tb_demo_coroutine_profile_sleeper(tb_cpointer_t priv)
+{
+    tb_size_t i = 0;
+    for (i = 0; i < COUNT; i++)
+        tb_coroutine_sleep(10);
+}
+static tb_void_t tb_demo_coroutine_profile_pong(tb_cpointer_t priv)
+{
+    // reply all ping data
+    tb_byte_t       data = 0;
+    tb_socket_ref_t sock = (tb_socket_ref_t)priv;
+    while (tb_socket_brecv(sock, &data, 1))
+    {
+        if (!tb_socket_bsend(sock, &data, 1)) break;
+    }
+    tb_socket_exit(sock);
+}
+static tb_void_t tb_demo_coroutine_profile_ping(tb_cpointer_t priv)
+{
+    // ping and wait the reply data slowly
+    tb_size_t       i = 0;
+    tb_byte_t       data = 0;
+    tb_socket_ref_t sock = (tb_socket_ref_t)priv;
+    for (i = 0; i < COUNT; i++)
+    {
+        if (!tb_socket_bsend(sock, &data, 1)) break;
+        if (!tb_socket_brecv(sock, &data, 1)) break;
+        tb_coroutine_sleep(5);
+    }
+
+    // dump all coroutines before exiting
+    tb_co_scheduler_dump(tb_co_scheduler_self());
+    tb_socket_exit(sock);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_profile_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init socket pair
+    tb_socket_ref_t pair[2];
+    if (!tb_socket_pair(TB_SOCKET_TYPE_TCP, pair)) return -1;
+
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // enable the profiling and report the slow coroutines
+        tb_co_scheduler_profile_set(scheduler, tb_true);
+        tb_co_scheduler_slow_set(scheduler, SLOW, tb_demo_coroutine_profile_slow, tb_null);
+
+        // start coroutines
+        tb_coroutine_start(scheduler, tb_demo_coroutine_profile_hog, tb_null, 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_profile_sleeper, tb_null, 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_profile_pong, pair[1], 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_profile_ping, pair[0], 0);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_true);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
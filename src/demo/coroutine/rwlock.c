@@ -0,0 +1,111 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the readers count
+#define READERN     (4)
+
+// the writers count
+#define WRITERN     (2)
+
+// the loop count
+#define COUNT       (5)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the rwlock
+static tb_co_rwlock_ref_t   g_rwlock = tb_null;
+
+// the shared value
+static tb_size_t            g_value = 0;
+
+// the readers count in the lock
+static tb_size_t            g_readers = 0;
+
+// the maximum readers count in the lock
+static tb_size_t            g_readers_maxn = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_rwlock_reader(tb_cpointer_t priv)
+{
+    tb_size_t i = 0;
+    for (i = 0; i < COUNT; i++)
+    {
+        // enter reader lock, the other readers can enter it at the same time
+        tb_co_rwlock_enter_read(g_rwlock);
+        g_readers++;
+        if (g_readers > g_readers_maxn) g_readers_maxn = g_readers;
+
+        // read it
+        tb_trace_i("[reader: %lu]: value: %lu, readers: %lu", (tb_size_t)priv, g_value, g_readers);
+        tb_msleep(10);
+
+        // leave reader lock
+        g_readers--;
+        tb_co_rwlock_leave(g_rwlock);
+        tb_msleep(5);
+    }
+}
+static tb_void_t tb_demo_coroutine_rwlock_writer(tb_cpointer_t priv)
+{
+    tb_size_t i = 0;
+    for (i = 0; i < COUNT; i++)
+    {
+        // enter writer lock, it's exclusive
+        tb_co_rwlock_enter_write(g_rwlock);
+        tb_assert(!g_readers);
+
+        // write it
+        g_value++;
+        tb_trace_i("[writer: %lu]: value: %lu", (tb_size_t)priv, g_value);
+        tb_msleep(10);
+
+        // leave writer lock
+        tb_co_rwlock_leave(g_rwlock);
+        tb_msleep(20);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_rwlock_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init rwlock
+    g_rwlock = tb_co_rwlock_init();
+    tb_assert_and_check_return_val(g_rwlock, -1);
+
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // start readers and writers
+        tb_size_t i = 0;
+        for (i = 0; i < READERN; i++)
+            tb_coroutine_start(scheduler, tb_demo_coroutine_rwlock_reader, (tb_cpointer_t)i, 0);
+        for (i = 0; i < WRITERN; i++)
+            tb_coroutine_start(scheduler, tb_demo_coroutine_rwlock_writer, (tb_cpointer_t)i, 0);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_true);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+
+    // trace
+    tb_trace_i("value: %lu/%d, maximum concurrent readers: %lu", g_value, WRITERN * COUNT, g_readers_maxn);
+
+    // exit rwlock
+    tb_co_rwlock_exit(g_rwlock);
+    return 0;
+}
@@ -0,0 +1,145 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the backend workers count
+#define WORKERS         (5)
+
+// the client will be disconnected after this time (ms)
+#define DISCONNECT      (350)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the results channel
+static tb_co_channel_ref_t  g_results = tb_null;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_select_worker(tb_cpointer_t priv)
+{
+    // get the worker index
+    tb_size_t index = (tb_size_t)priv;
+
+    // simulate the backend request, it will be interrupted if this worker is cancelled
+    tb_coroutine_sleep(100 * (index + 1));
+
+    // send the result, we use select because the handler may have been gone
+    tb_co_select_case_t scase;
+    tb_co_select_case_send(&scase, g_results, (tb_cpointer_t)(index + 1));
+    if (tb_co_select(&scase, 1, -1) > 0)
+        tb_trace_i("[worker: %lu]: send result ok", index);
+    else tb_trace_i("[worker: %lu]: cancelled", index);
+}
+static tb_void_t tb_demo_coroutine_select_client(tb_cpointer_t priv)
+{
+    // disconnect it after a while
+    tb_coroutine_sleep(DISCONNECT);
+
+    // trace
+    tb_trace_i("[client]: disconnect");
+    tb_socket_exit((tb_socket_ref_t)priv);
+}
+static tb_void_t tb_demo_coroutine_select_handler(tb_cpointer_t priv)
+{
+    // scatter the requests to the backend workers
+    tb_size_t           i;
+    tb_co_handle_ref_t  workers[WORKERS];
+    for (i = 0; i < WORKERS; i++)
+        workers[i] = tb_coroutine_spawn(tb_null, tb_demo_coroutine_select_worker, (tb_cpointer_t)i, 0);
+
+    // gather the results until the client is disconnected
+    tb_size_t           count = 0;
+    tb_socket_ref_t     sock = (tb_socket_ref_t)priv;
+    tb_poller_object_t  object;
+    object.type     = TB_POLLER_OBJECT_SOCK;
+    object.ref.sock = sock;
+    while (count < WORKERS)
+    {
+        // wait the next result or the client events
+        tb_co_select_case_t cases[2];
+        tb_co_select_case_recv(&cases[0], g_results);
+        tb_co_select_case_waitio(&cases[1], &object, TB_POLLER_EVENT_RECV);
+        tb_long_t ok = tb_co_select(cases, 2, 1000);
+        if (ok <= 0)
+        {
+            tb_trace_i("[handler]: %s", ok? "failed" : "timeout");
+            break;
+        }
+
+        // get a result
+        if (cases[0].ready)
+        {
+            tb_trace_i("[handler]: result: %lu", (tb_size_t)cases[0].data);
+            count++;
+        }
+        // the client is disconnected? it's readable but no data
+        else if (cases[1].ready)
+        {
+            tb_byte_t data;
+            if (tb_socket_recv(sock, &data, 1) <= 0)
+            {
+                tb_trace_i("[handler]: client disconnected");
+                break;
+            }
+        }
+    }
+
+    // cancel the pending workers and join them, so their stacks will not be leaked
+    tb_hong_t time = tb_mclock();
+    for (i = 0; i < WORKERS; i++)
+    {
+        if (workers[i])
+        {
+            tb_coroutine_cancel(workers[i]);
+            tb_coroutine_join(workers[i], -1);
+            tb_coroutine_handle_exit(workers[i]);
+        }
+    }
+    time = tb_mclock() - time;
+
+    // trace
+    tb_trace_i("[handler]: gathered %lu/%lu results, all workers joined in %lld ms", count, (tb_size_t)WORKERS, time);
+    tb_socket_exit(sock);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_select_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init socket pair
+    tb_socket_ref_t pair[2];
+    if (!tb_socket_pair(TB_SOCKET_TYPE_TCP, pair)) return -1;
+
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // init the results channel
+        g_results = tb_co_channel_init(0, tb_null, tb_null);
+        tb_assert(g_results);
+
+        // start the handler and client
+        tb_coroutine_start(scheduler, tb_demo_coroutine_select_handler, pair[0], 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_select_client, pair[1], 0);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_true);
+
+        // exit the results channel
+        tb_co_channel_exit(g_results);
+        g_results = tb_null;
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
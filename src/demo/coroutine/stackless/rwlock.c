@@ -0,0 +1,106 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the rwlock local type
+typedef struct __tb_demo_lo_rwlock_t
+{
+    // is writer?
+    tb_bool_t       writer;
+
+    // the count
+    tb_size_t       count;
+
+}tb_demo_lo_rwlock_t, *tb_demo_lo_rwlock_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the rwlock
+static tb_lo_rwlock_t   g_rwlock;
+
+// the shared value
+static tb_size_t        g_value = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_lo_coroutine_rwlock_func(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // the local
+    tb_demo_lo_rwlock_ref_t local = (tb_demo_lo_rwlock_ref_t)priv;
+
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        while (local->count--)
+        {
+            // write it
+            if (local->writer)
+            {
+                tb_lo_rwlock_enter_write(&g_rwlock);
+                g_value++;
+                tb_trace_i("[writer: %p]: value: %lu", tb_lo_coroutine_self(), g_value);
+                tb_lo_coroutine_sleep(20);
+                tb_lo_rwlock_leave(&g_rwlock);
+            }
+            // read it
+            else
+            {
+                tb_lo_rwlock_enter_read(&g_rwlock);
+                tb_trace_i("[reader: %p]: value: %lu, readers: %lu", tb_lo_coroutine_self(), g_value, g_rwlock.readers);
+                tb_lo_coroutine_sleep(10);
+                tb_lo_rwlock_leave(&g_rwlock);
+            }
+
+            // wait some time
+            tb_lo_coroutine_sleep(10);
+        }
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_lo_coroutine_rwlock_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init scheduler
+    tb_lo_scheduler_ref_t scheduler = tb_lo_scheduler_init();
+    if (scheduler)
+    {
+        // init rwlock
+        tb_lo_rwlock_init(&g_rwlock);
+
+        // start readers and writers
+        tb_demo_lo_rwlock_t locals[] =
+        {
+            {tb_false,  5}
+        ,   {tb_false,  5}
+        ,   {tb_false,  5}
+        ,   {tb_true,   5}
+        ,   {tb_true,   5}
+        };
+        tb_size_t i = 0;
+        for (i = 0; i < tb_arrayn(locals); i++)
+            tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_rwlock_func, &locals[i], tb_null);
+
+        // run scheduler
+        tb_lo_scheduler_loop(scheduler, tb_true);
+
+        // exit scheduler
+        tb_lo_scheduler_exit(scheduler);
+
+        // exit rwlock
+        tb_lo_rwlock_exit(&g_rwlock);
+    }
+
+    // trace
+    tb_trace_i("value: %lu", g_value);
+    return 0;
+}
@@ -0,0 +1,124 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the workers count
+#define WORKERN     (8)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the worker local type
+typedef struct __tb_demo_lo_worker_t
+{
+    // the index
+    tb_size_t       index;
+
+    // the result
+    tb_size_t       result;
+
+}tb_demo_lo_worker_t, *tb_demo_lo_worker_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the wait group
+static tb_lo_waitgroup_t    g_group;
+
+// the start cond
+static tb_lo_cond_t         g_cond;
+
+// is started?
+static tb_bool_t            g_started = tb_false;
+
+// the workers
+static tb_demo_lo_worker_t  g_workers[WORKERN];
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_lo_coroutine_waitgroup_worker(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // the local
+    tb_demo_lo_worker_ref_t local = (tb_demo_lo_worker_ref_t)priv;
+
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        // wait to be started
+        while (!g_started)
+            tb_lo_cond_wait(&g_cond);
+
+        // do some work
+        tb_lo_coroutine_sleep(10 + local->index * 5);
+        local->result = local->index * local->index;
+
+        // finished
+        tb_lo_waitgroup_done(&g_group);
+    }
+}
+static tb_void_t tb_demo_lo_coroutine_waitgroup_main_func(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        // start all workers
+        tb_lo_coroutine_sleep(10);
+        tb_trace_i("start %d workers", WORKERN);
+        g_started = tb_true;
+        tb_lo_cond_broadcast(&g_cond);
+
+        // wait all workers
+        tb_lo_waitgroup_wait(&g_group);
+        tb_trace_i("all workers have been finished");
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_lo_coroutine_waitgroup_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init scheduler
+    tb_lo_scheduler_ref_t scheduler = tb_lo_scheduler_init();
+    if (scheduler)
+    {
+        // init wait group and cond
+        tb_lo_waitgroup_init(&g_group);
+        tb_lo_cond_init(&g_cond);
+
+        // start workers
+        tb_size_t i = 0;
+        tb_lo_waitgroup_add(&g_group, WORKERN);
+        for (i = 0; i < WORKERN; i++)
+        {
+            g_workers[i].index = i;
+            tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_waitgroup_worker, &g_workers[i], tb_null);
+        }
+        tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_waitgroup_main_func, tb_null, tb_null);
+
+        // run scheduler
+        tb_lo_scheduler_loop(scheduler, tb_true);
+
+        // exit scheduler
+        tb_lo_scheduler_exit(scheduler);
+
+        // exit wait group and cond
+        tb_lo_cond_exit(&g_cond);
+        tb_lo_waitgroup_exit(&g_group);
+    }
+
+    // trace
+    tb_size_t i = 0;
+    tb_size_t sum = 0;
+    for (i = 0; i < WORKERN; i++) sum += g_workers[i].result;
+    tb_trace_i("sum: %lu", sum);
+    return 0;
+}
@@ -0,0 +1,159 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the switch count of each worker
+#define COUNT       (10000000)
+
+// the coroutines count of each worker
+#define COROUTINEN  (2)
+
+// the spawned coroutines count
+#define SPAWNN      (10000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the finished switches
+static tb_atomic_t      g_switches = 0;
+
+// the finished coroutines
+static tb_atomic_t      g_finished = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_lo_coroutine_worker_switch_func(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // check
+    tb_size_t* count = (tb_size_t*)priv;
+    tb_assert(count);
+
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        // loop
+        while (*count)
+        {
+            // yield
+            (*count)--;
+            tb_lo_coroutine_yield();
+        }
+
+        // save the switches count
+        tb_atomic_fetch_and_add(&g_switches, COUNT / COROUTINEN);
+    }
+}
+static tb_void_t tb_demo_lo_coroutine_worker_switch(tb_size_t workern)
+{
+    // init scheduler
+    tb_lo_scheduler_ref_t scheduler = tb_lo_scheduler_init_with_workers(workern);
+    if (scheduler)
+    {
+        // start coroutines, they will be distributed to all workers by round-robin
+        tb_size_t  i = 0;
+        tb_size_t  n = workern * COROUTINEN;
+        tb_size_t* counts = tb_nalloc_type(n, tb_size_t);
+        if (counts)
+        {
+            for (i = 0; i < n; i++)
+            {
+                counts[i] = COUNT / COROUTINEN;
+                tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_worker_switch_func, &counts[i], tb_null);
+            }
+        }
+
+        // run scheduler
+        tb_atomic_set(&g_switches, 0);
+        tb_hong_t time = tb_mclock();
+        tb_lo_scheduler_loop(scheduler, tb_false);
+        time = tb_mclock() - time;
+        if (time <= 0) time = 1;
+
+        // trace
+        tb_hong_t switches = (tb_hong_t)tb_atomic_get(&g_switches);
+        tb_trace_i("switch: workers: %lu, %lld switches in %lld ms, %lld switches per second, %lld switches per second per core"
+            , workern, switches, time, (1000 * switches) / time, (1000 * switches) / time / workern);
+
+        // exit scheduler
+        tb_lo_scheduler_exit(scheduler);
+        if (counts) tb_free(counts);
+    }
+}
+static tb_void_t tb_demo_lo_coroutine_worker_spawn_func(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        // yield it once
+        tb_lo_coroutine_yield();
+
+        // finished
+        tb_atomic_fetch_and_add(&g_finished, 1);
+    }
+}
+static tb_void_t tb_demo_lo_coroutine_worker_spawner_func(tb_lo_coroutine_ref_t coroutine, tb_cpointer_t priv)
+{
+    // the spawned count
+    tb_size_t* count = (tb_size_t*)priv;
+    tb_assert(count);
+
+    // enter coroutine
+    tb_lo_coroutine_enter(coroutine)
+    {
+        // spawn coroutines, they will be handed off to the other workers
+        while (*count)
+        {
+            (*count)--;
+            tb_lo_coroutine_start(tb_lo_scheduler_self(), tb_demo_lo_coroutine_worker_spawn_func, tb_null, tb_null);
+            tb_lo_coroutine_yield();
+        }
+    }
+}
+static tb_void_t tb_demo_lo_coroutine_worker_spawn(tb_size_t workern)
+{
+    // init scheduler
+    tb_lo_scheduler_ref_t scheduler = tb_lo_scheduler_init_with_workers(workern);
+    if (scheduler)
+    {
+        // start the spawner coroutine
+        tb_size_t count = SPAWNN;
+        tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_worker_spawner_func, &count, tb_null);
+
+        // run scheduler
+        tb_atomic_set(&g_finished, 0);
+        tb_hong_t time = tb_mclock();
+        tb_lo_scheduler_loop(scheduler, tb_false);
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("spawn: workers: %lu, finished: %ld, in %lld ms", workern, tb_atomic_get(&g_finished), time);
+
+        // exit scheduler
+        tb_lo_scheduler_exit(scheduler);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_lo_coroutine_worker_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the worker count
+    tb_size_t workern = argv[1]? tb_atoi(argv[1]) : tb_cpu_count();
+
+    // only one worker
+    tb_demo_lo_coroutine_worker_switch(1);
+    tb_demo_lo_coroutine_worker_spawn(1);
+
+    // multiple workers
+    tb_demo_lo_coroutine_worker_switch(workern);
+    tb_demo_lo_coroutine_worker_spawn(workern);
+    return 0;
+}
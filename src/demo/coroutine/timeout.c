@@ -0,0 +1,144 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the ping-pong pairs count
+#define TB_DEMO_PAIR_MAXN       (100)
+
+// the ping-pong rounds count of each pair
+#define TB_DEMO_ROUND_MAXN      (1000)
+
+// the idle pairs count, all of them will be timeout
+#define TB_DEMO_IDLE_MAXN       (100)
+
+// the timeout of the ping-pong waitings (ms), they are always cancelled before timeout
+#define TB_DEMO_TIMEOUT         (5000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the timeouts count
+static tb_size_t    g_timeouts = 0;
+
+// the maximum late time (ms) of the timeouts
+static tb_hong_t    g_late = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_bool_t tb_demo_coroutine_timeout_recv(tb_socket_ref_t sock, tb_byte_t* data)
+{
+    while (1)
+    {
+        // recv data
+        tb_long_t real = tb_socket_recv(sock, data, 1);
+        if (real) return real > 0;
+
+        // wait it with timeout
+        if (tb_socket_wait(sock, TB_SOCKET_EVENT_RECV, TB_DEMO_TIMEOUT) <= 0) return tb_false;
+    }
+    return tb_false;
+}
+static tb_void_t tb_demo_coroutine_timeout_pong(tb_cpointer_t priv)
+{
+    // reply all ping data
+    tb_byte_t       data = 0;
+    tb_socket_ref_t sock = (tb_socket_ref_t)priv;
+    while (tb_demo_coroutine_timeout_recv(sock, &data))
+    {
+        if (!tb_socket_bsend(sock, &data, 1)) break;
+    }
+    tb_socket_exit(sock);
+}
+static tb_void_t tb_demo_coroutine_timeout_ping(tb_cpointer_t priv)
+{
+    // ping and wait the reply data
+    tb_size_t       i = 0;
+    tb_byte_t       data = 0;
+    tb_socket_ref_t sock = (tb_socket_ref_t)priv;
+    for (i = 0; i < TB_DEMO_ROUND_MAXN; i++)
+    {
+        data = (tb_byte_t)i;
+        if (!tb_socket_bsend(sock, &data, 1)) break;
+        if (!tb_demo_coroutine_timeout_recv(sock, &data)) break;
+    }
+    tb_socket_exit(sock);
+}
+static tb_void_t tb_demo_coroutine_timeout_idle(tb_cpointer_t priv)
+{
+    // wait the idle socket until timeout
+    tb_socket_ref_t sock = (tb_socket_ref_t)priv;
+    tb_size_t       timeout = tb_random_range(10, 200);
+    tb_hong_t       time = tb_mclock();
+    if (!tb_socket_wait(sock, TB_SOCKET_EVENT_RECV, timeout))
+    {
+        g_timeouts++;
+        g_late = tb_max(g_late, tb_mclock() - time - (tb_hong_t)timeout);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_timeout_main(tb_int_t argc, tb_char_t** argv)
+{
+    // get the timeout slack (ms), e.g. 10
+    tb_size_t slack = argv[1]? tb_atoi(argv[1]) : 0;
+
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // enable the deadline timeout mode
+        tb_co_scheduler_timeout_slack_set(scheduler, slack);
+
+        // start the ping-pong coroutines, each waiting arms a timeout and cancels it
+        tb_size_t       i = 0;
+        tb_socket_ref_t pair[2];
+        for (i = 0; i < TB_DEMO_PAIR_MAXN; i++)
+        {
+            if (!tb_socket_pair(TB_SOCKET_TYPE_TCP, pair)) break;
+            tb_coroutine_start(scheduler, tb_demo_coroutine_timeout_pong, pair[1], 0);
+            tb_coroutine_start(scheduler, tb_demo_coroutine_timeout_ping, pair[0], 0);
+        }
+
+        // start the idle coroutines, all of them will be timeout
+        tb_socket_ref_t idles[TB_DEMO_IDLE_MAXN][2];
+        tb_size_t       idlen = 0;
+        for (idlen = 0; idlen < TB_DEMO_IDLE_MAXN; idlen++)
+        {
+            if (!tb_socket_pair(TB_SOCKET_TYPE_TCP, idles[idlen])) break;
+            tb_coroutine_start(scheduler, tb_demo_coroutine_timeout_idle, idles[idlen][0], 0);
+        }
+
+        // run scheduler
+        tb_hong_t time = tb_mclock();
+        tb_co_scheduler_loop(scheduler, tb_true);
+        time = tb_mclock() - time;
+
+        // trace
+        tb_co_scheduler_stats_t stats;
+        if (tb_co_scheduler_stats(scheduler, &stats))
+        {
+            tb_trace_i("slack: %lu ms, %lu x %d waitings: %lld ms, timeouts: %lu/%lu, max late: %lld ms, wakeups: %llu"
+                , slack, i, TB_DEMO_ROUND_MAXN * 2, time, g_timeouts, idlen, g_late, stats.wakeups);
+        }
+
+        // exit the idle sockets
+        for (i = 0; i < idlen; i++)
+        {
+            tb_socket_exit(idles[i][0]);
+            tb_socket_exit(idles[i][1]);
+        }
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
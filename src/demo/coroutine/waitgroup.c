@@ -0,0 +1,104 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the rpc calls count of each request
+#define CALLN       (8)
+
+// the requests count
+#define COUNT       (3)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the rpc call type
+typedef struct __tb_demo_call_t
+{
+    // the wait group
+    tb_co_waitgroup_ref_t   group;
+
+    // the call index
+    tb_size_t               index;
+
+    // the result
+    tb_size_t               result;
+
+}tb_demo_call_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_waitgroup_call(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_call_t* call = (tb_demo_call_t*)priv;
+    tb_assert(call);
+
+    // do the rpc call
+    tb_msleep(10 + call->index * 5);
+    call->result = call->index * call->index;
+
+    // finished
+    tb_co_waitgroup_done(call->group);
+}
+static tb_void_t tb_demo_coroutine_waitgroup_request(tb_cpointer_t priv)
+{
+    // init wait group
+    tb_co_waitgroup_ref_t group = tb_co_waitgroup_init();
+    tb_assert_and_check_return(group);
+
+    tb_size_t i = 0;
+    tb_size_t j = 0;
+    for (i = 0; i < COUNT; i++)
+    {
+        // fan-out the rpc calls
+        tb_demo_call_t calls[CALLN];
+        tb_hong_t time = tb_mclock();
+        tb_co_waitgroup_add(group, CALLN);
+        for (j = 0; j < CALLN; j++)
+        {
+            calls[j].group  = group;
+            calls[j].index  = j;
+            calls[j].result = 0;
+            tb_coroutine_start(tb_null, tb_demo_coroutine_waitgroup_call, &calls[j], 0);
+        }
+
+        // fan-in the results
+        tb_long_t ok = tb_co_waitgroup_wait(group, -1);
+        tb_size_t sum = 0;
+        for (j = 0; j < CALLN; j++) sum += calls[j].result;
+
+        // trace
+        tb_trace_i("[request: %lu]: wait: %ld, sum: %lu, in %lld ms", i, ok, sum, tb_mclock() - time);
+    }
+
+    // exit wait group
+    tb_co_waitgroup_exit(group);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_waitgroup_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // start request
+        tb_coroutine_start(scheduler, tb_demo_coroutine_waitgroup_request, tb_null, 0);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_true);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
@@ -0,0 +1,168 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the coroutines count
+#define COUNT       (256)
+
+// the loop count of each coroutine
+#define LOOP        (100)
+
+// the socket pairs count
+#define PAIRN       (64)
+
+// the sent data size of each socket pair
+#define SIZE        (1024 * 1024)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the finished loops
+static tb_atomic_t      g_loops = 0;
+
+// the migrated count
+static tb_atomic_t      g_migrated = 0;
+
+// the received bytes
+static tb_atomic_t      g_recv = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_worker_compute_func(tb_cpointer_t priv)
+{
+    // loop
+    tb_size_t count = LOOP;
+    while (count--)
+    {
+        // do some computing
+        __tb_volatile__ tb_size_t i = 0;
+        __tb_volatile__ tb_size_t sum = 0;
+        for (i = 0; i < 100000; i++) sum += i;
+
+        // sleep it, it may be resumed on the other worker
+        tb_size_t thread = tb_thread_self();
+        tb_coroutine_sleep(1);
+        if (thread != tb_thread_self()) tb_atomic_fetch_and_add(&g_migrated, 1);
+
+        // yield
+        tb_coroutine_yield();
+        tb_atomic_fetch_and_add(&g_loops, 1);
+    }
+}
+static tb_void_t tb_demo_coroutine_worker_compute(tb_size_t workern)
+{
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init_with_workers(workern);
+    if (scheduler)
+    {
+        // start coroutines
+        tb_size_t i = 0;
+        for (i = 0; i < COUNT; i++)
+            tb_coroutine_start(scheduler, tb_demo_coroutine_worker_compute_func, tb_null, 0);
+
+        // run scheduler
+        tb_atomic_set(&g_loops, 0);
+        tb_atomic_set(&g_migrated, 0);
+        tb_hong_t time = tb_mclock();
+        tb_co_scheduler_loop(scheduler, tb_false);
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("compute: workers: %lu, loops: %ld, migrated: %ld, in %lld ms", workern, tb_atomic_get(&g_loops), tb_atomic_get(&g_migrated), time);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+}
+static tb_void_t tb_demo_coroutine_worker_send_func(tb_cpointer_t priv)
+{
+    // check
+    tb_socket_ref_t sock = (tb_socket_ref_t)priv;
+    tb_assert_and_check_return(sock);
+
+    // send data, it will wait io in the coroutine and be pinned to the current worker
+    tb_byte_t data[8192];
+    tb_size_t size = SIZE;
+    tb_memset(data, 'x', sizeof(data));
+    while (size && tb_socket_bsend(sock, data, tb_min(size, sizeof(data))))
+        size -= tb_min(size, sizeof(data));
+
+    // exit socket
+    tb_socket_exit(sock);
+}
+static tb_void_t tb_demo_coroutine_worker_recv_func(tb_cpointer_t priv)
+{
+    // check
+    tb_socket_ref_t sock = (tb_socket_ref_t)priv;
+    tb_assert_and_check_return(sock);
+
+    // recv data
+    tb_byte_t data[8192];
+    tb_size_t size = SIZE;
+    while (size)
+    {
+        tb_size_t need = tb_min(size, sizeof(data));
+        if (!tb_socket_brecv(sock, data, need)) break;
+        tb_atomic_fetch_and_add(&g_recv, need);
+        size -= need;
+    }
+
+    // exit socket
+    tb_socket_exit(sock);
+}
+static tb_void_t tb_demo_coroutine_worker_io(tb_size_t workern)
+{
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init_with_workers(workern);
+    if (scheduler)
+    {
+        // start coroutines
+        tb_size_t i = 0;
+        for (i = 0; i < PAIRN; i++)
+        {
+            tb_socket_ref_t pair[2];
+            if (tb_socket_pair(TB_SOCKET_TYPE_TCP, pair))
+            {
+                tb_coroutine_start(scheduler, tb_demo_coroutine_worker_send_func, pair[0], 0);
+                tb_coroutine_start(scheduler, tb_demo_coroutine_worker_recv_func, pair[1], 0);
+            }
+        }
+
+        // run scheduler
+        tb_atomic_set(&g_recv, 0);
+        tb_hong_t time = tb_mclock();
+        tb_co_scheduler_loop(scheduler, tb_false);
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("io: workers: %lu, recv: %ld bytes, in %lld ms", workern, tb_atomic_get(&g_recv), time);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_worker_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the worker count
+    tb_size_t workern = argv[1]? tb_atoi(argv[1]) : tb_cpu_count();
+
+    // only one worker
+    tb_demo_coroutine_worker_compute(1);
+    tb_demo_coroutine_worker_io(1);
+
+    // multiple workers
+    tb_demo_coroutine_worker_compute(workern);
+    tb_demo_coroutine_worker_io(workern);
+    return 0;
+}
@@ -132,10 +132,12 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(memory_string_pool)
 ,   TB_DEMO_MAIN_ITEM(memory_large_allocator)
 ,   TB_DEMO_MAIN_ITEM(memory_small_allocator)
+,   TB_DEMO_MAIN_ITEM(memory_region_allocator)
 ,   TB_DEMO_MAIN_ITEM(memory_default_allocator)
 ,   TB_DEMO_MAIN_ITEM(memory_memops)
 ,   TB_DEMO_MAIN_ITEM(memory_buffer)
 ,   TB_DEMO_MAIN_ITEM(memory_queue_buffer)
+,   TB_DEMO_MAIN_ITEM(memory_chain_buffer)
 ,   TB_DEMO_MAIN_ITEM(memory_static_buffer)
 ,   TB_DEMO_MAIN_ITEM(memory_impl_static_fixed_pool)
 
@@ -179,10 +181,12 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(platform_lock)
 ,   TB_DEMO_MAIN_ITEM(platform_timer)
 ,   TB_DEMO_MAIN_ITEM(platform_ltimer)
+,   TB_DEMO_MAIN_ITEM(platform_wtimer)
 ,   TB_DEMO_MAIN_ITEM(platform_event)
 ,   TB_DEMO_MAIN_ITEM(platform_semaphore)
 ,   TB_DEMO_MAIN_ITEM(platform_thread)
 ,   TB_DEMO_MAIN_ITEM(platform_thread_pool)
+,   TB_DEMO_MAIN_ITEM(platform_thread_pool_graph)
 ,   TB_DEMO_MAIN_ITEM(platform_thread_local)
 ,   TB_DEMO_MAIN_ITEM(platform_poller_pipe)
 ,   TB_DEMO_MAIN_ITEM(platform_poller_client)
@@ -213,6 +217,7 @@ static tb_demo_t g_demo[] =
     // algorithm
 ,   TB_DEMO_MAIN_ITEM(algorithm_find)
 ,   TB_DEMO_MAIN_ITEM(algorithm_sort)
+,   TB_DEMO_MAIN_ITEM(algorithm_parallel)
 
     // coroutine
 #ifdef TB_CONFIG_MODULE_HAVE_COROUTINE
@@ -226,10 +231,20 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(coroutine_switch)
 ,   TB_DEMO_MAIN_ITEM(coroutine_thread)
 ,   TB_DEMO_MAIN_ITEM(coroutine_channel)
+,   TB_DEMO_MAIN_ITEM(coroutine_mpmc_channel)
 ,   TB_DEMO_MAIN_ITEM(coroutine_semaphore)
 ,   TB_DEMO_MAIN_ITEM(coroutine_process)
 ,   TB_DEMO_MAIN_ITEM(coroutine_process_pipe)
 ,   TB_DEMO_MAIN_ITEM(coroutine_fwatcher)
+,   TB_DEMO_MAIN_ITEM(coroutine_file_io)
+,   TB_DEMO_MAIN_ITEM(coroutine_busypoll)
+,   TB_DEMO_MAIN_ITEM(coroutine_timeout)
+,   TB_DEMO_MAIN_ITEM(coroutine_rwlock)
+,   TB_DEMO_MAIN_ITEM(coroutine_cond)
+,   TB_DEMO_MAIN_ITEM(coroutine_waitgroup)
+,   TB_DEMO_MAIN_ITEM(coroutine_select)
+,   TB_DEMO_MAIN_ITEM(coroutine_local)
+,   TB_DEMO_MAIN_ITEM(coroutine_profile)
 ,   TB_DEMO_MAIN_ITEM(coroutine_echo_server)
 ,   TB_DEMO_MAIN_ITEM(coroutine_echo_client)
 ,   TB_DEMO_MAIN_ITEM(coroutine_unix_echo_server)
@@ -237,13 +252,17 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(coroutine_file_server)
 ,   TB_DEMO_MAIN_ITEM(coroutine_file_client)
 ,   TB_DEMO_MAIN_ITEM(coroutine_http_server)
+,   TB_DEMO_MAIN_ITEM(coroutine_worker)
 ,   TB_DEMO_MAIN_ITEM(coroutine_spider)
 
     // stackless coroutine
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_nest)
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_lock)
+,   TB_DEMO_MAIN_ITEM(lo_coroutine_rwlock)
+,   TB_DEMO_MAIN_ITEM(lo_coroutine_waitgroup)
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_sleep)
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_switch)
+,   TB_DEMO_MAIN_ITEM(lo_coroutine_worker)
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_process)
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_process_pipe)
 ,   TB_DEMO_MAIN_ITEM(lo_coroutine_echo_server)
@@ -128,10 +128,12 @@ TB_DEMO_MAIN_DECL(memory_fixed_pool);
 TB_DEMO_MAIN_DECL(memory_string_pool);
 TB_DEMO_MAIN_DECL(memory_large_allocator);
 TB_DEMO_MAIN_DECL(memory_small_allocator);
+TB_DEMO_MAIN_DECL(memory_region_allocator);
 TB_DEMO_MAIN_DECL(memory_default_allocator);
 TB_DEMO_MAIN_DECL(memory_memops);
 TB_DEMO_MAIN_DECL(memory_buffer);
 TB_DEMO_MAIN_DECL(memory_queue_buffer);
+TB_DEMO_MAIN_DECL(memory_chain_buffer);
 TB_DEMO_MAIN_DECL(memory_static_buffer);
 TB_DEMO_MAIN_DECL(memory_impl_static_fixed_pool);
 
@@ -160,6 +162,7 @@ TB_DEMO_MAIN_DECL(platform_event);
 TB_DEMO_MAIN_DECL(platform_utils);
 TB_DEMO_MAIN_DECL(platform_timer);
 TB_DEMO_MAIN_DECL(platform_ltimer);
+TB_DEMO_MAIN_DECL(platform_wtimer);
 TB_DEMO_MAIN_DECL(platform_atomic);
 TB_DEMO_MAIN_DECL(platform_atomic32);
 TB_DEMO_MAIN_DECL(platform_atomic64);
@@ -179,6 +182,7 @@ TB_DEMO_MAIN_DECL(platform_cache_time);
 TB_DEMO_MAIN_DECL(platform_environment);
 TB_DEMO_MAIN_DECL(platform_thread);
 TB_DEMO_MAIN_DECL(platform_thread_pool);
+TB_DEMO_MAIN_DECL(platform_thread_pool_graph);
 TB_DEMO_MAIN_DECL(platform_thread_local);
 TB_DEMO_MAIN_DECL(platform_poller_pipe);
 TB_DEMO_MAIN_DECL(platform_poller_client);
@@ -205,6 +209,7 @@ TB_DEMO_MAIN_DECL(container_bloom_filter);
 // algorithm
 TB_DEMO_MAIN_DECL(algorithm_find);
 TB_DEMO_MAIN_DECL(algorithm_sort);
+TB_DEMO_MAIN_DECL(algorithm_parallel);
 
 // coroutine
 TB_DEMO_MAIN_DECL(coroutine_dns);
@@ -216,12 +221,22 @@ TB_DEMO_MAIN_DECL(coroutine_spider);
 TB_DEMO_MAIN_DECL(coroutine_stream);
 TB_DEMO_MAIN_DECL(coroutine_switch);
 TB_DEMO_MAIN_DECL(coroutine_channel);
+TB_DEMO_MAIN_DECL(coroutine_mpmc_channel);
 TB_DEMO_MAIN_DECL(coroutine_semaphore);
 TB_DEMO_MAIN_DECL(coroutine_thread);
 TB_DEMO_MAIN_DECL(coroutine_pipe);
 TB_DEMO_MAIN_DECL(coroutine_process);
 TB_DEMO_MAIN_DECL(coroutine_process_pipe);
 TB_DEMO_MAIN_DECL(coroutine_fwatcher);
+TB_DEMO_MAIN_DECL(coroutine_file_io);
+TB_DEMO_MAIN_DECL(coroutine_busypoll);
+TB_DEMO_MAIN_DECL(coroutine_timeout);
+TB_DEMO_MAIN_DECL(coroutine_rwlock);
+TB_DEMO_MAIN_DECL(coroutine_cond);
+TB_DEMO_MAIN_DECL(coroutine_waitgroup);
+TB_DEMO_MAIN_DECL(coroutine_select);
+TB_DEMO_MAIN_DECL(coroutine_local);
+TB_DEMO_MAIN_DECL(coroutine_profile);
 TB_DEMO_MAIN_DECL(coroutine_echo_client);
 TB_DEMO_MAIN_DECL(coroutine_echo_server);
 TB_DEMO_MAIN_DECL(coroutine_unix_echo_client);
@@ -229,12 +244,16 @@ TB_DEMO_MAIN_DECL(coroutine_unix_echo_server);
 TB_DEMO_MAIN_DECL(coroutine_file_client);
 TB_DEMO_MAIN_DECL(coroutine_file_server);
 TB_DEMO_MAIN_DECL(coroutine_http_server);
+TB_DEMO_MAIN_DECL(coroutine_worker);
 
 // stackless coroutine
 TB_DEMO_MAIN_DECL(lo_coroutine_nest);
 TB_DEMO_MAIN_DECL(lo_coroutine_lock);
+TB_DEMO_MAIN_DECL(lo_coroutine_rwlock);
+TB_DEMO_MAIN_DECL(lo_coroutine_waitgroup);
 TB_DEMO_MAIN_DECL(lo_coroutine_sleep);
 TB_DEMO_MAIN_DECL(lo_coroutine_switch);
+TB_DEMO_MAIN_DECL(lo_coroutine_worker);
 TB_DEMO_MAIN_DECL(lo_coroutine_process);
 TB_DEMO_MAIN_DECL(lo_coroutine_process_pipe);
 TB_DEMO_MAIN_DECL(lo_coroutine_echo_server);
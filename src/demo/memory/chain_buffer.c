@@ -0,0 +1,80 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_chain_buffer_trace(tb_char_t const* name, tb_chain_buffer_ref_t buffer)
+{
+    // export the data segments
+    tb_iovec_t  list[16];
+    tb_size_t   count = tb_chain_buffer_pull_iovec(buffer, list, 16);
+
+    // trace
+    tb_size_t i = 0;
+    tb_trace_i("%s: size: %lu, segments: %lu", name, tb_chain_buffer_size(buffer), tb_chain_buffer_count(buffer));
+    for (i = 0; i < count; i++)
+        tb_trace_i("    [%lu]: %.*s", i, (tb_int_t)list[i].size, list[i].data);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_memory_chain_buffer_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init pool with the small blocks
+    tb_chain_buffer_pool_ref_t pool = tb_chain_buffer_pool_init(16);
+    if (pool)
+    {
+        // init buffers
+        tb_chain_buffer_t request;
+        tb_chain_buffer_t head;
+        tb_chain_buffer_init(&request, pool);
+        tb_chain_buffer_init(&head, pool);
+
+        // append and prepend data
+        tb_chain_buffer_append(&request, (tb_byte_t const*)"Host: tboox.org\r\n\r\nhello world!", 31);
+        tb_chain_buffer_prepend(&request, (tb_byte_t const*)"GET / HTTP/1.1\r\n", 16);
+        tb_demo_chain_buffer_trace("request", &request);
+
+        // split the header without copying
+        tb_chain_buffer_split(&request, 35, &head);
+        tb_demo_chain_buffer_trace("head", &head);
+        tb_demo_chain_buffer_trace("body", &request);
+
+        // splice the body back to the head
+        tb_chain_buffer_splice(&head, &request);
+        tb_demo_chain_buffer_trace("spliced", &head);
+
+        // reserve the free space for receiving data
+        tb_iovec_t  list[4];
+        tb_size_t   count = tb_chain_buffer_push_iovec(&head, list, 4, 20);
+        tb_size_t   i = 0;
+        tb_size_t   size = 0;
+        tb_char_t const* data = " more data from the socket";
+        for (i = 0; i < count && data[size]; i++)
+        {
+            tb_size_t n = tb_min((tb_size_t)list[i].size, tb_strlen(data + size));
+            tb_memcpy(list[i].data, data + size, n);
+            size += n;
+        }
+        tb_chain_buffer_push_commit(&head, size);
+        tb_demo_chain_buffer_trace("received", &head);
+
+        // read all data
+        tb_char_t   line[256];
+        tb_size_t   real = tb_chain_buffer_read(&head, (tb_byte_t*)line, sizeof(line) - 1);
+        line[real] = '\0';
+        tb_trace_i("read: %lu: %s", real, line);
+
+        // exit buffers
+        tb_chain_buffer_exit(&head);
+        tb_chain_buffer_exit(&request);
+
+        // exit pool
+        tb_chain_buffer_pool_exit(pool);
+    }
+    return 0;
+}
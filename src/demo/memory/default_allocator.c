@@ -214,6 +214,177 @@ tb_void_t tb_demo_default_allocator_perf()
     large_allocator = tb_null;
 }
 
+static tb_int_t tb_demo_default_allocator_cache_thread(tb_cpointer_t priv)
+{
+    // check
+    tb_allocator_ref_t allocator = (tb_allocator_ref_t)priv;
+    tb_assert_and_check_return_val(allocator, -1);
+
+    // make data list
+    tb_pointer_t list[64] = {0};
+    tb_size_t    loop = 10000;
+    tb_size_t    rand = 0xbeaf;
+    while (loop--)
+    {
+        // make data
+        tb_size_t i = 0;
+        for (i = 0; i < tb_arrayn(list); i++)
+        {
+            list[i] = tb_allocator_malloc(allocator, (rand & 511) + 1);
+            tb_assert_and_check_break(list[i]);
+            rand = (rand * 10807 + 1) & 0xffffffff;
+        }
+
+        // free data
+        for (i = 0; i < tb_arrayn(list); i++)
+        {
+            if (list[i]) tb_allocator_free(allocator, list[i]);
+            list[i] = tb_null;
+        }
+    }
+    return 0;
+}
+static tb_hong_t tb_demo_default_allocator_cache_test(tb_allocator_ref_t allocator, tb_size_t count)
+{
+    // init threads
+    tb_size_t       i = 0;
+    tb_thread_ref_t threads[64] = {0};
+    tb_hong_t       time = tb_mclock();
+    for (i = 0; i < count; i++)
+        threads[i] = tb_thread_init(tb_null, tb_demo_default_allocator_cache_thread, allocator, 0);
+
+    // wait threads
+    for (i = 0; i < count; i++)
+    {
+        if (threads[i])
+        {
+            tb_thread_wait(threads[i], -1, tb_null);
+            tb_thread_exit(threads[i]);
+        }
+    }
+    return tb_mclock() - time;
+}
+tb_void_t tb_demo_default_allocator_cache_perf(tb_noarg_t);
+tb_void_t tb_demo_default_allocator_cache_perf()
+{
+    // done
+    tb_allocator_ref_t allocator = tb_null;
+    tb_allocator_ref_t large_allocator = tb_null;
+    do
+    {
+        // init large allocator
+        large_allocator = tb_large_allocator_init(tb_null, 0);
+        tb_assert_and_check_break(large_allocator);
+
+        // init allocator
+        allocator = tb_default_allocator_init(large_allocator);
+        tb_assert_and_check_break(allocator);
+
+        // the thread count
+        tb_size_t count = tb_min(tb_cpu_count(), 64);
+        if (count < 2) count = 2;
+
+        // test it without the thread cache
+        tb_hong_t time = tb_demo_default_allocator_cache_test(allocator, count);
+        tb_trace_i("threads: %lu, nocache: %lld ms", count, time);
+
+        // test it with the thread cache
+        if (tb_default_allocator_cache_enable(allocator, tb_true))
+        {
+            time = tb_demo_default_allocator_cache_test(allocator, count);
+            tb_trace_i("threads: %lu, cached: %lld ms", count, time);
+            tb_default_allocator_cache_enable(allocator, tb_false);
+        }
+
+#ifdef __tb_debug__
+        // dump allocator
+        tb_allocator_dump(allocator);
+#endif
+
+    } while (0);
+
+    // exit allocator
+    if (allocator) tb_allocator_exit(allocator);
+    allocator = tb_null;
+
+    // exit large allocator
+    if (large_allocator) tb_allocator_exit(large_allocator);
+    large_allocator = tb_null;
+}
+tb_void_t tb_demo_default_allocator_profile(tb_size_t rate);
+tb_void_t tb_demo_default_allocator_profile(tb_size_t rate)
+{
+    // done
+    tb_allocator_ref_t allocator = tb_null;
+    tb_allocator_ref_t large_allocator = tb_null;
+    do
+    {
+        // init large allocator
+        large_allocator = tb_large_allocator_init(tb_null, 0);
+        tb_assert_and_check_break(large_allocator);
+
+        // init allocator
+        allocator = tb_default_allocator_init(large_allocator);
+        tb_assert_and_check_break(allocator);
+
+        // enable profiler, sample one of every rate allocations
+        if (rate) tb_allocator_profiler_enable(allocator, rate);
+
+        // make data list
+        tb_size_t       maxn = 10000;
+        tb_pointer_t*   list = (tb_pointer_t*)tb_allocator_nalloc0(allocator, maxn, sizeof(tb_pointer_t));
+        tb_assert_and_check_break(list);
+
+        // done
+        tb_size_t                   count = 50;
+        __tb_volatile__ tb_size_t   indx = 0;
+        __tb_volatile__ tb_hong_t   time = tb_mclock();
+        __tb_volatile__ tb_size_t   rand = 0xbeaf;
+        while (count--)
+        {
+            for (indx = 0; indx < maxn; indx++)
+            {
+                // make rand
+                rand = (rand * 10807 + 1) & 0xffffffff;
+
+                // free the old data
+                if (list[indx]) tb_allocator_free(allocator, list[indx]);
+
+                // make the small or large data from the different sites
+                if (indx & 63) list[indx] = tb_allocator_malloc(allocator, ((rand >> 8) & 255) + 1);
+                else list[indx] = tb_allocator_malloc(allocator, ((rand >> 8) & 8191) + 1);
+                tb_assert_and_check_break(list[indx]);
+            }
+        }
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("profile: rate: %lu, time: %lld ms", rate, time);
+
+        // exit list
+        for (indx = 0; indx < maxn; indx++)
+        {
+            if (list[indx]) tb_allocator_free(allocator, list[indx]);
+        }
+        tb_allocator_free(allocator, list);
+
+        // dump the profile results, all live bytes should have been freed
+        if (rate) tb_allocator_dump(allocator);
+
+        // disable profiler
+        if (rate) tb_allocator_profiler_enable(tb_null, 0);
+
+    } while (0);
+
+    // exit allocator
+    if (allocator) tb_allocator_exit(allocator);
+    allocator = tb_null;
+
+    // exit large allocator
+    if (large_allocator) tb_allocator_exit(large_allocator);
+    large_allocator = tb_null;
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
  */
@@ -223,6 +394,15 @@ tb_int_t tb_demo_memory_default_allocator_main(tb_int_t argc, tb_char_t** argv)
     tb_demo_default_allocator_perf();
 #endif
 
+#if 1
+    tb_demo_default_allocator_cache_perf();
+#endif
+
+#if 1
+    tb_demo_default_allocator_profile(0);
+    tb_demo_default_allocator_profile(1024);
+#endif
+
 #if 0
     tb_demo_default_allocator_leak();
 #endif
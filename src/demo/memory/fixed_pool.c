@@ -124,15 +124,15 @@ tb_void_t tb_demo_fixed_pool_underflow2()
     // exit pool
     if (pool) tb_fixed_pool_exit(pool);
 }
-tb_void_t tb_demo_fixed_pool_perf(tb_size_t item_size);
-tb_void_t tb_demo_fixed_pool_perf(tb_size_t item_size)
+tb_void_t tb_demo_fixed_pool_perf(tb_size_t item_size, tb_bool_t aligned);
+tb_void_t tb_demo_fixed_pool_perf(tb_size_t item_size, tb_bool_t aligned)
 {
     // done
     tb_fixed_pool_ref_t pool = tb_null;
     do
     {
         // init pool
-        pool = tb_fixed_pool_init(tb_null, 0, item_size, tb_null, tb_null, tb_null);
+        pool = aligned? tb_fixed_pool_init_aligned(tb_null, 0, item_size, tb_null, tb_null, tb_null) : tb_fixed_pool_init(tb_null, 0, item_size, tb_null, tb_null, tb_null);
         tb_assert_and_check_break(pool);
 
         // make data list
@@ -177,7 +177,7 @@ tb_void_t tb_demo_fixed_pool_perf(tb_size_t item_size)
 #endif
 
         // trace
-        tb_trace_i("time: %lld ms", time);
+        tb_trace_i("item: %lu, aligned: %d, time: %lld ms", item_size, aligned, time);
 
         // clear pool
         tb_fixed_pool_clear(pool);
@@ -188,24 +188,111 @@ tb_void_t tb_demo_fixed_pool_perf(tb_size_t item_size)
     if (pool) tb_fixed_pool_exit(pool);
 }
 
+static tb_int_t tb_demo_fixed_pool_remote_func(tb_cpointer_t priv)
+{
+    // free all data from the remote thread
+    tb_value_ref_t      tuple = (tb_value_ref_t)priv;
+    tb_fixed_pool_ref_t pool = (tb_fixed_pool_ref_t)tuple[0].ptr;
+    tb_pointer_t*       list = (tb_pointer_t*)tuple[1].ptr;
+    tb_size_t           maxn = tuple[2].ul;
+    tb_size_t           indx = 0;
+    for (indx = 0; indx < maxn; indx++)
+        tb_fixed_pool_free_remote(pool, list[indx]);
+    return 0;
+}
+tb_void_t tb_demo_fixed_pool_remote(tb_noarg_t);
+tb_void_t tb_demo_fixed_pool_remote()
+{
+    // done
+    tb_fixed_pool_ref_t pool = tb_null;
+    tb_pointer_t*       list = tb_null;
+    do
+    {
+        // init pool
+        pool = tb_fixed_pool_init(tb_null, 0, sizeof(tb_size_t), tb_null, tb_null, tb_null);
+        tb_assert_and_check_break(pool);
+
+        // make data list
+        tb_size_t indx = 0;
+        tb_size_t maxn = 10000;
+        list = (tb_pointer_t*)tb_nalloc0(maxn, sizeof(tb_pointer_t));
+        tb_assert_and_check_break(list);
+        for (indx = 0; indx < maxn; indx++)
+        {
+            list[indx] = tb_fixed_pool_malloc(pool);
+            tb_assert_and_check_break(list[indx]);
+        }
+
+        // free them on the remote thread
+        tb_value_t tuple[3];
+        tuple[0].ptr = (tb_pointer_t)pool;
+        tuple[1].ptr = list;
+        tuple[2].ul  = maxn;
+        tb_thread_ref_t thread = tb_thread_init(tb_null, tb_demo_fixed_pool_remote_func, tuple, 0);
+        tb_assert_and_check_break(thread);
+
+        // make and free data on the owner thread at the same time
+        tb_hong_t time = tb_mclock();
+        for (indx = 0; indx < maxn; indx++)
+        {
+            tb_pointer_t data = tb_fixed_pool_malloc(pool);
+            if (data) tb_fixed_pool_free(pool, data);
+        }
+
+        // wait thread
+        tb_thread_wait(thread, -1, tb_null);
+        tb_thread_exit(thread);
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("remote: size: %lu, time: %lld ms", tb_fixed_pool_size(pool), time);
+
+    } while (0);
+
+    // exit list
+    if (list) tb_free(list);
+
+    // exit pool
+    if (pool) tb_fixed_pool_exit(pool);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
  */
 tb_int_t tb_demo_memory_fixed_pool_main(tb_int_t argc, tb_char_t** argv)
 {
 #if 1
-    tb_demo_fixed_pool_perf(16);
-    tb_demo_fixed_pool_perf(32);
-    tb_demo_fixed_pool_perf(64);
-    tb_demo_fixed_pool_perf(96);
-    tb_demo_fixed_pool_perf(128);
-    tb_demo_fixed_pool_perf(192);
-    tb_demo_fixed_pool_perf(256);
-    tb_demo_fixed_pool_perf(384);
-    tb_demo_fixed_pool_perf(512);
-    tb_demo_fixed_pool_perf(1024);
-    tb_demo_fixed_pool_perf(2048);
-    tb_demo_fixed_pool_perf(3072);
+    tb_demo_fixed_pool_perf(16, tb_false);
+    tb_demo_fixed_pool_perf(32, tb_false);
+    tb_demo_fixed_pool_perf(64, tb_false);
+    tb_demo_fixed_pool_perf(96, tb_false);
+    tb_demo_fixed_pool_perf(128, tb_false);
+    tb_demo_fixed_pool_perf(192, tb_false);
+    tb_demo_fixed_pool_perf(256, tb_false);
+    tb_demo_fixed_pool_perf(384, tb_false);
+    tb_demo_fixed_pool_perf(512, tb_false);
+    tb_demo_fixed_pool_perf(1024, tb_false);
+    tb_demo_fixed_pool_perf(2048, tb_false);
+    tb_demo_fixed_pool_perf(3072, tb_false);
+#endif
+
+#if 1
+    tb_demo_fixed_pool_perf(16, tb_true);
+    tb_demo_fixed_pool_perf(32, tb_true);
+    tb_demo_fixed_pool_perf(64, tb_true);
+    tb_demo_fixed_pool_perf(96, tb_true);
+    tb_demo_fixed_pool_perf(128, tb_true);
+    tb_demo_fixed_pool_perf(192, tb_true);
+    tb_demo_fixed_pool_perf(256, tb_true);
+    tb_demo_fixed_pool_perf(384, tb_true);
+    tb_demo_fixed_pool_perf(512, tb_true);
+    tb_demo_fixed_pool_perf(1024, tb_true);
+    tb_demo_fixed_pool_perf(2048, tb_true);
+    tb_demo_fixed_pool_perf(3072, tb_true);
+#endif
+
+#if 1
+    tb_demo_fixed_pool_remote();
 #endif
 
 #if 0
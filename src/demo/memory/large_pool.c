@@ -226,6 +226,41 @@ tb_void_t tb_demo_large_allocator_perf()
     // exit pool
     if (pool) tb_allocator_exit(pool);
 }
+tb_void_t tb_demo_large_allocator_flags(tb_size_t flags);
+tb_void_t tb_demo_large_allocator_flags(tb_size_t flags)
+{
+    // done
+    tb_allocator_ref_t pool = tb_null;
+    do
+    {
+        // init pool with the virtual memory flags
+        pool = tb_large_allocator_init_with_flags(flags);
+        tb_assert_and_check_break(pool);
+
+        // make the large data and touch all pages
+        tb_size_t       size = 64 * 1024 * 1024;
+        tb_hong_t       time = tb_mclock();
+        tb_pointer_t    data = tb_allocator_large_malloc(pool, size, tb_null);
+        tb_assert_and_check_break(data);
+        tb_memset(data, 0, size);
+
+        // grow it, the new data will keep these flags
+        data = tb_allocator_large_ralloc(pool, data, size << 1, tb_null);
+        tb_assert_and_check_break(data);
+        tb_memset(data, 0, size << 1);
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("flags: %lx, time: %lld ms", flags, time);
+
+        // exit data
+        tb_allocator_large_free(pool, data);
+
+    } while (0);
+
+    // exit pool
+    if (pool) tb_allocator_exit(pool);
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
@@ -267,5 +302,12 @@ tb_int_t tb_demo_memory_large_allocator_main(tb_int_t argc, tb_char_t** argv)
     tb_demo_large_allocator_real(3072 * 256);
 #endif
 
+#if 1
+    tb_demo_large_allocator_flags(TB_VIRTUAL_MEMORY_FLAG_NONE);
+    tb_demo_large_allocator_flags(TB_VIRTUAL_MEMORY_FLAG_THP);
+    tb_demo_large_allocator_flags(TB_VIRTUAL_MEMORY_FLAG_HUGETLB | TB_VIRTUAL_MEMORY_FLAG_THP);
+    tb_demo_large_allocator_flags(TB_VIRTUAL_MEMORY_FLAG_THP | TB_VIRTUAL_MEMORY_FLAG_NUMA_NODE(0));
+#endif
+
     return 0;
 }
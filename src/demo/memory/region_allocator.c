@@ -0,0 +1,128 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * demo
+ */
+tb_void_t tb_demo_region_allocator_check(tb_noarg_t);
+tb_void_t tb_demo_region_allocator_check()
+{
+    // done
+    tb_allocator_ref_t region_allocator = tb_null;
+    do
+    {
+        // init region allocator
+        region_allocator = tb_region_allocator_init(tb_null, 4096);
+        tb_assert_and_check_break(region_allocator);
+
+        // make small data
+        tb_char_t* data0 = (tb_char_t*)tb_allocator_malloc0(region_allocator, 10);
+        tb_assert_and_check_break(data0);
+        tb_strlcpy(data0, "hello", 10);
+
+        // grow the last data in place
+        tb_char_t* data1 = (tb_char_t*)tb_allocator_ralloc(region_allocator, data0, 100);
+        tb_assert_and_check_break(data1 && !tb_strcmp(data1, "hello"));
+        tb_trace_i("ralloc: in place: %s", data0 == data1? "ok" : "no");
+
+        // make large data
+        tb_char_t* data2 = (tb_char_t*)tb_allocator_malloc(region_allocator, 8192);
+        tb_assert_and_check_break(data2);
+        tb_memset(data2, 0, 8192);
+
+        // free large data
+        tb_allocator_free(region_allocator, data2);
+
+#ifdef __tb_debug__
+        // dump region allocator
+        tb_allocator_dump(region_allocator);
+#endif
+
+        // free all data
+        tb_allocator_clear(region_allocator);
+
+    } while (0);
+
+    // exit region allocator
+    if (region_allocator) tb_allocator_exit(region_allocator);
+    region_allocator = tb_null;
+}
+tb_void_t tb_demo_region_allocator_perf(tb_allocator_ref_t allocator, tb_bool_t region);
+tb_void_t tb_demo_region_allocator_perf(tb_allocator_ref_t allocator, tb_bool_t region)
+{
+    // make data list
+    tb_size_t       maxn = 1000;
+    tb_pointer_t*   list = (tb_pointer_t*)tb_nalloc0(maxn, sizeof(tb_pointer_t));
+    tb_assert_and_check_return(list);
+
+    // done requests
+    tb_size_t                   count = 1000;
+    tb_size_t                   indx = 0;
+    __tb_volatile__ tb_hong_t   time = tb_mclock();
+    __tb_volatile__ tb_size_t   rand = 0xbeaf;
+    while (count--)
+    {
+        // make many short-lived data for this request
+        for (indx = 0; indx < maxn; indx++)
+        {
+            // make rand
+            rand = (rand * 10807 + 1) & 0xffffffff;
+
+            // make data
+            list[indx] = tb_allocator_malloc(allocator, (rand & 255) + 1);
+            tb_assert_and_check_break(list[indx]);
+
+            // re-make data
+            if (!(indx & 15))
+            {
+                list[indx] = tb_allocator_ralloc(allocator, list[indx], (rand & 511) + 1);
+                tb_assert_and_check_break(list[indx]);
+            }
+        }
+
+        // free all data of this request
+        if (region) tb_allocator_clear(allocator);
+        else
+        {
+            for (indx = 0; indx < maxn; indx++)
+            {
+                if (list[indx]) tb_allocator_free(allocator, list[indx]);
+                list[indx] = tb_null;
+            }
+        }
+    }
+    time = tb_mclock() - time;
+
+    // trace
+    tb_trace_i("%s: time: %lld ms", region? "region" : "default", time);
+
+    // exit list
+    tb_free(list);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_memory_region_allocator_main(tb_int_t argc, tb_char_t** argv)
+{
+#if 1
+    tb_demo_region_allocator_check();
+#endif
+
+#if 1
+    // perf the global allocator
+    tb_demo_region_allocator_perf(tb_allocator(), tb_false);
+
+    // perf the region allocator
+    tb_allocator_ref_t region_allocator = tb_region_allocator_init(tb_null, 0);
+    if (region_allocator)
+    {
+        tb_demo_region_allocator_perf(region_allocator, tb_true);
+        tb_allocator_exit(region_allocator);
+    }
+#endif
+
+    return 0;
+}
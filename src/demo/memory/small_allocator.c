@@ -3,6 +3,61 @@
  */
 #include "../demo.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the counting allocator type for the memory-waste benchmark
+typedef struct __tb_demo_counting_allocator_t
+{
+    // the base
+    tb_allocator_t          base;
+
+    // the allocated bytes
+    tb_size_t               size;
+
+}tb_demo_counting_allocator_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * counting allocator
+ */
+
+// the data head size of the counting allocator, it saves the data size
+#define TB_DEMO_COUNTING_HEAD_SIZE          (16)
+
+static tb_pointer_t tb_demo_counting_allocator_large_ralloc(tb_allocator_ref_t self, tb_pointer_t data, tb_size_t size, tb_size_t* real __tb_debug_decl__)
+{
+    // the counting allocator
+    tb_demo_counting_allocator_t* allocator = (tb_demo_counting_allocator_t*)self;
+
+    // the data head
+    tb_byte_t* head = data? (tb_byte_t*)data - TB_DEMO_COUNTING_HEAD_SIZE : tb_null;
+    if (head) allocator->size -= *((tb_size_t*)head);
+
+    // ralloc it from the native allocator
+    head = (tb_byte_t*)tb_allocator_ralloc_(tb_native_allocator(), head, size + TB_DEMO_COUNTING_HEAD_SIZE __tb_debug_args__);
+    tb_assert_and_check_return_val(head, tb_null);
+
+    // save size
+    *((tb_size_t*)head) = size;
+    allocator->size += size;
+    if (real) *real = size;
+    return head + TB_DEMO_COUNTING_HEAD_SIZE;
+}
+static tb_pointer_t tb_demo_counting_allocator_large_malloc(tb_allocator_ref_t self, tb_size_t size, tb_size_t* real __tb_debug_decl__)
+{
+    return tb_demo_counting_allocator_large_ralloc(self, tb_null, size, real __tb_debug_args__);
+}
+static tb_bool_t tb_demo_counting_allocator_large_free(tb_allocator_ref_t self, tb_pointer_t data __tb_debug_decl__)
+{
+    // the data head
+    tb_byte_t* head = (tb_byte_t*)data - TB_DEMO_COUNTING_HEAD_SIZE;
+    ((tb_demo_counting_allocator_t*)self)->size -= *((tb_size_t*)head);
+
+    // free it
+    return tb_allocator_free_(tb_native_allocator(), head __tb_debug_args__);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * demo
  */
@@ -211,6 +266,68 @@ tb_void_t tb_demo_small_allocator_perf()
     if (large_allocator) tb_allocator_exit(large_allocator);
     large_allocator = tb_null;
 }
+tb_void_t tb_demo_small_allocator_waste(tb_size_t minn, tb_size_t maxn);
+tb_void_t tb_demo_small_allocator_waste(tb_size_t minn, tb_size_t maxn)
+{
+    // init the counting allocator
+    tb_demo_counting_allocator_t counting;
+    tb_memset(&counting, 0, sizeof(counting));
+    counting.base.type          = TB_ALLOCATOR_TYPE_NONE;
+    counting.base.flag          = TB_ALLOCATOR_FLAG_NOLOCK;
+    counting.base.large_malloc  = tb_demo_counting_allocator_large_malloc;
+    counting.base.large_ralloc  = tb_demo_counting_allocator_large_ralloc;
+    counting.base.large_free    = tb_demo_counting_allocator_large_free;
+
+    // done
+    tb_allocator_ref_t  small_allocator = tb_null;
+    tb_pointer_t*       list = tb_null;
+    do
+    {
+        // init small allocator
+        small_allocator = tb_small_allocator_init((tb_allocator_ref_t)&counting);
+        tb_assert_and_check_break(small_allocator);
+
+        // make data list
+        tb_size_t count = 100000;
+        list = (tb_pointer_t*)tb_nalloc0(count, sizeof(tb_pointer_t));
+        tb_assert_and_check_break(list);
+
+        // make data with the random size in [minn, maxn]
+        tb_size_t indx = 0;
+        tb_size_t need = 0;
+        tb_size_t base = counting.size;
+        tb_size_t rand = 0xbeaf;
+        for (indx = 0; indx < count; indx++)
+        {
+            // make rand
+            rand = (rand * 10807 + 1) & 0xffffffff;
+
+            // make data
+            tb_size_t size = minn + (rand >> 8) % (maxn - minn + 1);
+            list[indx] = tb_allocator_malloc(small_allocator, size);
+            tb_assert_and_check_break(list[indx]);
+            need += size;
+        }
+
+        // trace
+        tb_size_t used = counting.size - base;
+        tb_trace_i("waste: size: %lu-%lu, need: %lu, used: %lu, waste: %lu%%", minn, maxn, need, used, used > need? (used - need) * 100 / used : 0);
+
+        // free data
+        for (indx = 0; indx < count; indx++)
+        {
+            if (list[indx]) tb_allocator_free(small_allocator, list[indx]);
+        }
+
+    } while (0);
+
+    // exit list
+    if (list) tb_free(list);
+
+    // exit small allocator
+    if (small_allocator) tb_allocator_exit(small_allocator);
+    small_allocator = tb_null;
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
@@ -221,6 +338,16 @@ tb_int_t tb_demo_memory_small_allocator_main(tb_int_t argc, tb_char_t** argv)
     tb_demo_small_allocator_perf();
 #endif
 
+#if 1
+    tb_demo_small_allocator_waste(1, 64);
+    tb_demo_small_allocator_waste(65, 65);
+    tb_demo_small_allocator_waste(129, 129);
+    tb_demo_small_allocator_waste(65, 256);
+    tb_demo_small_allocator_waste(257, 1024);
+    tb_demo_small_allocator_waste(1025, 3072);
+    tb_demo_small_allocator_waste(1, 3072);
+#endif
+
 #if 0
     tb_demo_small_allocator_leak();
 #endif
@@ -3,6 +3,103 @@
  */
 #include "../demo.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the concurrent demo type
+typedef struct __tb_demo_string_pool_t
+{
+    // the string pool
+    tb_string_pool_ref_t    pool;
+
+    // the global lock for the non-concurrent pool
+    tb_mutex_ref_t          lock;
+
+    // the done count
+    tb_atomic_t             done;
+
+}tb_demo_string_pool_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_int_t tb_demo_string_pool_worker(tb_cpointer_t priv)
+{
+    // check
+    tb_demo_string_pool_t* demo = (tb_demo_string_pool_t*)priv;
+    tb_assert_and_check_return_val(demo, -1);
+
+    // intern the header names and keys
+    tb_char_t   s[64];
+    tb_size_t   n = 200000;
+    tb_size_t   rand = (tb_size_t)tb_thread_self();
+    while (n--)
+    {
+        // make key
+        rand = (rand * 10807 + 1) & 0xffffffff;
+        tb_snprintf(s, sizeof(s), "x-header-%lu", (rand >> 8) % 1000);
+
+        // insert it and get the stable handle
+        if (demo->lock) tb_mutex_enter(demo->lock);
+        tb_char_t const* cstr = tb_string_pool_insert(demo->pool, s);
+        if (demo->lock) tb_mutex_leave(demo->lock);
+        tb_assert_and_check_break(cstr && !tb_strcmp(cstr, s));
+
+        // lookup it
+        if (demo->lock) tb_mutex_enter(demo->lock);
+        tb_bool_t ok = tb_string_pool_has(demo->pool, cstr);
+        if (demo->lock) tb_mutex_leave(demo->lock);
+        tb_assert_and_check_break(ok);
+
+        // remove it
+        if (demo->lock) tb_mutex_enter(demo->lock);
+        tb_string_pool_remove(demo->pool, cstr);
+        if (demo->lock) tb_mutex_leave(demo->lock);
+    }
+
+    // done
+    tb_atomic_fetch_and_add(&demo->done, 1);
+    return 0;
+}
+static tb_void_t tb_demo_string_pool_concurrent(tb_bool_t concurrent)
+{
+    // init demo
+    tb_demo_string_pool_t demo;
+    tb_memset(&demo, 0, sizeof(demo));
+    tb_atomic_init(&demo.done, 0);
+    demo.pool = concurrent? tb_string_pool_init_concurrent(tb_true, 0) : tb_string_pool_init(tb_true);
+    demo.lock = concurrent? tb_null : tb_mutex_init();
+    if (demo.pool && (concurrent || demo.lock))
+    {
+        // init threads
+        tb_size_t           i = 0;
+        tb_size_t           threadn = tb_max(tb_min(tb_cpu_count(), 16), 4);
+        tb_thread_ref_t     threads[16] = {0};
+        tb_hong_t           time = tb_mclock();
+        for (i = 0; i < threadn; i++)
+            threads[i] = tb_thread_init(tb_null, tb_demo_string_pool_worker, &demo, 0);
+
+        // wait threads
+        for (i = 0; i < threadn; i++)
+        {
+            if (threads[i])
+            {
+                tb_thread_wait(threads[i], -1, tb_null);
+                tb_thread_exit(threads[i]);
+            }
+        }
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("%s: threads: %lu, done: %ld, time: %lld ms", concurrent? "sharded" : "mutex", threadn, tb_atomic_get(&demo.done), time);
+    }
+
+    // exit demo
+    if (demo.pool) tb_string_pool_exit(demo.pool);
+    if (demo.lock) tb_mutex_exit(demo.lock);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
  */
@@ -34,5 +131,10 @@ tb_int_t tb_demo_memory_string_pool_main(tb_int_t argc, tb_char_t** argv)
     // del hello
     tb_string_pool_remove(tb_string_pool(), hello);
 #endif
+
+#if 1
+    tb_demo_string_pool_concurrent(tb_false);
+    tb_demo_string_pool_concurrent(tb_true);
+#endif
     return 0;
 }
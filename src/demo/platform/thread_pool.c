@@ -3,6 +3,26 @@
  */
 #include "../demo.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the spawned tasks count of each task for the perf test
+#define TB_DEMO_TASK_SPAWN      (4)
+
+// the task tree depth for the perf test
+#define TB_DEMO_TASK_DEPTH      (6)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the thread pool for the perf test
+static tb_thread_pool_ref_t g_pool = tb_null;
+
+// the finished tasks count for the perf test
+static tb_atomic_t          g_finished = 0;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * test
  */
@@ -20,11 +40,69 @@ static tb_void_t tb_demo_task_time_exit(tb_thread_pool_worker_ref_t worker, tb_c
     tb_trace_i("exit: %u ms", tb_p2u32(priv));
 }
 
+static tb_void_t tb_demo_task_spawn_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // do some short computing
+    __tb_volatile__ tb_size_t i = 0;
+    __tb_volatile__ tb_size_t sum = 0;
+    for (i = 0; i < 1000; i++) sum += i;
+
+    // spawn the child tasks from the worker thread
+    tb_size_t depth = tb_p2u32(priv);
+    if (depth)
+    {
+        for (i = 0; i < TB_DEMO_TASK_SPAWN; i++)
+            tb_thread_pool_task_post(g_pool, tb_null, tb_demo_task_spawn_done, tb_null, tb_u2p(depth - 1), tb_false);
+    }
+
+    // finished
+    tb_atomic_fetch_and_add(&g_finished, 1);
+}
+static tb_void_t tb_demo_thread_pool_perf(tb_size_t mode)
+{
+    // init pool
+    g_pool = tb_thread_pool_init_with_mode(0, 0, mode);
+    if (g_pool)
+    {
+        // the total tasks count of the task tree
+        tb_size_t i = 0;
+        tb_size_t n = 1;
+        tb_size_t total = 0;
+        for (i = 0; i <= TB_DEMO_TASK_DEPTH; i++, n *= TB_DEMO_TASK_SPAWN) total += n;
+
+        // post the root task
+        tb_atomic_set(&g_finished, 0);
+        tb_hong_t time = tb_mclock();
+        tb_thread_pool_task_post(g_pool, tb_null, tb_demo_task_spawn_done, tb_null, tb_u2p(TB_DEMO_TASK_DEPTH), tb_false);
+
+        // wait all tasks finished
+        while ((tb_size_t)tb_atomic_get(&g_finished) < total) tb_msleep(1);
+        time = tb_mclock() - time;
+        tb_thread_pool_task_wait_all(g_pool, -1);
+
+        // trace
+        tb_trace_i("perf: %s: workers: %lu, finished: %ld tasks in %lld ms"
+            , mode == TB_THREAD_POOL_MODE_STEALING? "stealing" : "shared", tb_thread_pool_worker_size(g_pool), tb_atomic_get(&g_finished), time);
+
+        // exit pool
+        tb_thread_pool_exit(g_pool);
+        g_pool = tb_null;
+    }
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
  */
 tb_int_t tb_demo_platform_thread_pool_main(tb_int_t argc, tb_char_t** argv)
 {
+    // perf test for the shared and work-stealing modes
+    if (argv[1] && !tb_strcmp(argv[1], "perf"))
+    {
+        tb_demo_thread_pool_perf(TB_THREAD_POOL_MODE_SHARED);
+        tb_demo_thread_pool_perf(TB_THREAD_POOL_MODE_STEALING);
+        return 0;
+    }
+
 #if 0
     // post task: 60s
     tb_thread_pool_task_post(tb_thread_pool(), "60000ms", tb_demo_task_time_done, tb_null, (tb_cpointer_t)60000, tb_false);
@@ -0,0 +1,138 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the pipelines count
+#define TB_DEMO_PIPELINE_COUNT      (64)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the pipeline item type
+typedef struct __tb_demo_item_t
+{
+    // the finished stage
+    tb_size_t           stage;
+
+    // the data
+    tb_size_t           data;
+
+}tb_demo_item_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the pipeline items
+static tb_demo_item_t   g_items[TB_DEMO_PIPELINE_COUNT];
+
+// the merged result
+static tb_size_t        g_result = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * test
+ */
+static tb_void_t tb_demo_parse_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    tb_demo_item_t* item = (tb_demo_item_t*)priv;
+    tb_assert(item->stage == 0);
+    item->data  = (tb_size_t)(item - g_items) + 1;
+    item->stage = 1;
+}
+static tb_void_t tb_demo_transform_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    tb_demo_item_t* item = (tb_demo_item_t*)priv;
+    tb_assert(item->stage == 1);
+    item->data *= 2;
+    item->stage = 2;
+}
+static tb_void_t tb_demo_compress_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    tb_demo_item_t* item = (tb_demo_item_t*)priv;
+    tb_assert(item->stage == 2);
+    item->data += 1;
+    item->stage = 3;
+}
+static tb_void_t tb_demo_merge_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // merge all items
+    tb_size_t i = 0;
+    g_result = 0;
+    for (i = 0; i < TB_DEMO_PIPELINE_COUNT; i++)
+    {
+        tb_assert(g_items[i].stage == 3);
+        g_result += g_items[i].data;
+    }
+}
+static tb_void_t tb_demo_thread_pool_graph_test(tb_size_t mode)
+{
+    // init thread pool
+    tb_thread_pool_ref_t pool = tb_thread_pool_init_with_mode(4, 0, mode);
+    tb_assert_and_check_return(pool);
+
+    // init graph
+    tb_thread_pool_graph_ref_t graph = tb_thread_pool_graph_init(pool);
+    if (graph)
+    {
+        // add the parse -> transform -> compress pipelines and merge them
+        tb_size_t i = 0;
+        tb_thread_pool_graph_task_ref_t merge = tb_thread_pool_graph_task_add(graph, "merge", tb_demo_merge_done, tb_null, tb_null, 0);
+        for (i = 0; i < TB_DEMO_PIPELINE_COUNT; i++)
+        {
+            tb_thread_pool_graph_task_ref_t parse       = tb_thread_pool_graph_task_add(graph, "parse", tb_demo_parse_done, tb_null, &g_items[i], 0);
+            tb_thread_pool_graph_task_ref_t transform   = tb_thread_pool_graph_task_then(graph, parse, "transform", tb_demo_transform_done, tb_null, &g_items[i]);
+            tb_thread_pool_graph_task_ref_t compress    = tb_thread_pool_graph_task_add(graph, "compress", tb_demo_compress_done, tb_null, &g_items[i], 0);
+            tb_thread_pool_graph_task_depend(graph, compress, transform);
+            tb_thread_pool_graph_task_depend(graph, merge, compress);
+        }
+
+        // run it twice
+        tb_size_t n = 0;
+        for (n = 0; n < 2; n++)
+        {
+            // reset items
+            tb_memset(g_items, 0, sizeof(g_items));
+            g_result = 0;
+
+            // run it
+            tb_hong_t time = tb_mclock();
+            if (tb_thread_pool_graph_start(graph))
+            {
+                tb_long_t ok = tb_thread_pool_graph_wait(graph, -1);
+                time = tb_mclock() - time;
+
+                // trace
+                tb_trace_i("%s: run[%lu]: %lu tasks, result: %lu, ok: %ld, %lld ms", mode == TB_THREAD_POOL_MODE_STEALING? "stealing" : "shared", n, tb_thread_pool_graph_size(graph), g_result, ok, time);
+            }
+        }
+
+        // the cyclic graph cannot be started
+        tb_thread_pool_graph_task_ref_t cycle = tb_thread_pool_graph_task_add(graph, "cycle", tb_demo_merge_done, tb_null, tb_null, 0);
+        tb_thread_pool_graph_task_depend(graph, cycle, merge);
+        tb_thread_pool_graph_task_depend(graph, merge, cycle);
+        tb_trace_i("%s: start the cyclic graph: %s", mode == TB_THREAD_POOL_MODE_STEALING? "stealing" : "shared", tb_thread_pool_graph_start(graph)? "ok" : "failed");
+
+        // exit graph
+        tb_thread_pool_graph_exit(graph);
+    }
+
+    // exit thread pool
+    tb_thread_pool_exit(pool);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_thread_pool_graph_main(tb_int_t argc, tb_char_t** argv)
+{
+    // run the graph in the shared and work-stealing modes
+    tb_demo_thread_pool_graph_test(TB_THREAD_POOL_MODE_SHARED);
+    tb_demo_thread_pool_graph_test(TB_THREAD_POOL_MODE_STEALING);
+    return 0;
+}
@@ -0,0 +1,185 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the tasks count
+#define TB_DEMO_TASK_MAXN       (1000)
+
+// the connections count
+#define TB_DEMO_ARM_MAXN        (100000)
+
+// the re-arming rounds count
+#define TB_DEMO_ROUND_MAXN      (1000000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the demo task type
+typedef struct __tb_demo_task_t
+{
+    // the timer task
+    tb_wtimer_task_ref_t    task;
+
+    // the expected time
+    tb_hong_t               when;
+
+    // the done time
+    tb_hong_t               done;
+
+    // is cancelled?
+    tb_bool_t               cancelled;
+
+}tb_demo_task_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * func
+ */
+static tb_hong_t tb_demo_wtimer_now()
+{
+    tb_timeval_t tv = {0};
+    return tb_gettimeofday(&tv, tb_null)? ((tb_hong_t)tv.tv_sec * 1000 + tv.tv_usec / 1000) : 0;
+}
+static tb_void_t tb_demo_wtimer_task_func(tb_bool_t killed, tb_cpointer_t priv)
+{
+    tb_demo_task_t* task = (tb_demo_task_t*)priv;
+    if (task && !task->done) task->done = tb_demo_wtimer_now();
+}
+static tb_void_t tb_demo_wtimer_every_func(tb_bool_t killed, tb_cpointer_t priv)
+{
+    tb_size_t* count = (tb_size_t*)priv;
+    if (count) (*count)++;
+}
+static tb_void_t tb_demo_wtimer_null_func(tb_bool_t killed, tb_cpointer_t priv)
+{
+}
+static tb_void_t tb_demo_wtimer_check(tb_size_t maxn)
+{
+    // init timer
+    tb_wtimer_ref_t timer = tb_wtimer_init(0, tb_false);
+    tb_assert_and_check_return(timer);
+
+    // trace
+    tb_trace_i("check: %d tasks in %lu ms, limit: %llu ms", TB_DEMO_TASK_MAXN, maxn, tb_wtimer_limit(timer));
+
+    // post the random tasks
+    tb_size_t       i = 0;
+    tb_demo_task_t* tasks = tb_nalloc0_type(TB_DEMO_TASK_MAXN, tb_demo_task_t);
+    if (tasks)
+    {
+        tb_hong_t now = tb_demo_wtimer_now();
+        for (i = 0; i < TB_DEMO_TASK_MAXN; i++)
+        {
+            tb_size_t delay = tb_random_range(1, maxn);
+            tasks[i].when = now + delay;
+            tasks[i].task = tb_wtimer_task_init(timer, delay, tb_false, tb_demo_wtimer_task_func, &tasks[i]);
+        }
+
+        // cancel the odd tasks
+        for (i = 1; i < TB_DEMO_TASK_MAXN; i += 2)
+        {
+            tb_wtimer_task_exit(timer, tasks[i].task);
+            tasks[i].task = tb_null;
+            tasks[i].cancelled = tb_true;
+        }
+
+        // kill a task, it will be done at the next tick
+        tasks[0].when = now;
+        tb_wtimer_task_kill(timer, tasks[0].task);
+
+        // post the repeat task
+        tb_size_t every = 0;
+        tb_wtimer_task_post(timer, 100, tb_true, tb_demo_wtimer_every_func, &every);
+
+        // loop it
+        tb_hong_t stop = now + maxn + 100;
+        while (tb_demo_wtimer_now() <= stop)
+        {
+            tb_size_t delay = tb_wtimer_delay(timer);
+            if (delay) tb_msleep(tb_min(delay, 50));
+            if (!tb_wtimer_spak(timer)) break;
+        }
+
+        // check the tasks
+        tb_size_t early = 0;
+        tb_size_t missed = 0;
+        tb_size_t wrong = 0;
+        tb_hong_t late = 0;
+        for (i = 0; i < TB_DEMO_TASK_MAXN; i++)
+        {
+            if (tasks[i].cancelled)
+            {
+                if (tasks[i].done) wrong++;
+            }
+            else if (!tasks[i].done) missed++;
+            else if (tasks[i].done < tasks[i].when) early++;
+            else late = tb_max(late, tasks[i].done - tasks[i].when);
+
+            // exit the timer task
+            if (tasks[i].task) tb_wtimer_task_exit(timer, tasks[i].task);
+        }
+
+        // trace
+        tb_trace_i("check: early: %lu, missed: %lu, cancelled but done: %lu, late: %lld ms, every: %lu, %s"
+            , early, missed, wrong, late, every, (!early && !missed && !wrong && every)? "ok" : "failed");
+
+        // exit tasks
+        tb_free(tasks);
+    }
+
+    // exit timer
+    tb_wtimer_exit(timer);
+}
+static tb_void_t tb_demo_wtimer_bench()
+{
+    // init tasks
+    tb_wtimer_task_ref_t* tasks = tb_nalloc0_type(TB_DEMO_ARM_MAXN, tb_wtimer_task_ref_t);
+    tb_assert_and_check_return(tasks);
+
+    // init timer
+    tb_wtimer_ref_t timer = tb_wtimer_init(4096, tb_true);
+    if (timer)
+    {
+        // arm the timeouts of all connections
+        tb_size_t i = 0;
+        tb_hong_t time = tb_mclock();
+        for (i = 0; i < TB_DEMO_ARM_MAXN; i++)
+            tasks[i] = tb_wtimer_task_init(timer, 1000 + (i % 60000), tb_false, tb_demo_wtimer_null_func, tb_null);
+
+        // cancel and re-arm the timeouts of the random connections, e.g. the io waits are finished before timeout
+        for (i = 0; i < TB_DEMO_ROUND_MAXN; i++)
+        {
+            tb_size_t j = tb_random_range(0, TB_DEMO_ARM_MAXN);
+            tb_wtimer_task_exit(timer, tasks[j]);
+            tasks[j] = tb_wtimer_task_init(timer, tb_random_range(1000, 60000), tb_false, tb_demo_wtimer_null_func, tb_null);
+        }
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("bench: %d connections, re-arm %d timeouts: %lld ms", TB_DEMO_ARM_MAXN, TB_DEMO_ROUND_MAXN, time);
+
+        // exit timer
+        tb_wtimer_exit(timer);
+    }
+
+    // exit tasks
+    tb_free(tasks);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_platform_wtimer_main(tb_int_t argc, tb_char_t** argv)
+{
+    // check the random tasks in the given time range, e.g. 20000 ms for cascading the second node wheel
+    tb_demo_wtimer_check(argv[1]? tb_atoi(argv[1]) : 3000);
+
+    // arm and cancel the massive timeouts
+    tb_demo_wtimer_bench();
+    return 0;
+}
@@ -50,8 +50,10 @@ target "demo"
     add_files "platform/thread.c"
     add_files "platform/thread_local.c"
     add_files "platform/thread_pool.c"
+    add_files "platform/thread_pool_graph.c"
     add_files "platform/timer.c"
     add_files "platform/utils.c"
+    add_files "platform/wtimer.c"
     add_files "container/*.c"
     add_files "algorithm/*.c"
     add_files "stream/stream.c"
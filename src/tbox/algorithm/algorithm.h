@@ -51,5 +51,6 @@
 #include "remove_if.h"
 #include "remove_first.h"
 #include "remove_first_if.h"
+#include "parallel.h"
 
 #endif
@@ -0,0 +1,679 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        parallel.c
+ * @ingroup     algorithm
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "parallel"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "parallel.h"
+#include "sort.h"
+#include "../libc/libc.h"
+#include "../platform/cpu.h"
+#include "../platform/event.h"
+#include "../platform/atomic.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the workers maxn
+#define TB_PARALLEL_WORKER_MAXN         (64)
+
+// the minimum items count of the adaptive chunk
+#ifdef __tb_small__
+#   define TB_PARALLEL_GRAIN_MIN        (256)
+#else
+#   define TB_PARALLEL_GRAIN_MIN        (1024)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/* the parallel chunk func type
+ *
+ * @param priv      the algorithm private data
+ * @param slot      the worker slot, [0, workn)
+ * @param begin     the begin index of the chunk
+ * @param end       the end index of the chunk
+ *
+ * @return          tb_false: stop all workers
+ */
+typedef tb_bool_t   (*tb_parallel_chunk_func_t)(tb_cpointer_t priv, tb_size_t slot, tb_size_t begin, tb_size_t end);
+
+/* the parallel type
+ *
+ * it's allocated on the heap and shared by the calling thread and all helper tasks,
+ * because the helper tasks may be exited by the thread pool after the calling thread has returned.
+ */
+typedef struct __tb_parallel_t
+{
+    // the items count
+    tb_size_t                   count;
+
+    // the minimum items count of the chunk
+    tb_size_t                   grain;
+
+    // the workers count, including the calling thread
+    tb_size_t                   workn;
+
+    // the chunk func
+    tb_parallel_chunk_func_t    func;
+
+    // the chunk func private data, it's only accessed before all items have been finished
+    tb_cpointer_t               priv;
+
+    // the next item index
+    tb_atomic_t                 next;
+
+    // the finished items count
+    tb_atomic_t                 finished;
+
+    // the allocated worker slots
+    tb_atomic_t                 slots;
+
+    // has been stopped?
+    tb_atomic_t                 stopped;
+
+    // the reference count
+    tb_atomic_t                 refn;
+
+    // the finished event
+    tb_event_ref_t              event;
+
+}tb_parallel_t;
+
+// the parallel walk type
+typedef struct __tb_parallel_walk_t
+{
+    tb_iterator_ref_t           iterator;
+    tb_size_t                   head;
+    tb_walk_func_t              func;
+    tb_cpointer_t               priv;
+    tb_atomic_t                 count;
+
+}tb_parallel_walk_t;
+
+// the parallel reduce type
+typedef struct __tb_parallel_reduce_t
+{
+    tb_iterator_ref_t           iterator;
+    tb_size_t                   head;
+    tb_parallel_reduce_func_t   reduce;
+    tb_cpointer_t               priv;
+    tb_byte_t*                  results;
+    tb_size_t                   step;
+
+}tb_parallel_reduce_t;
+
+// the parallel predicate type for count and find
+typedef struct __tb_parallel_pred_t
+{
+    tb_iterator_ref_t           iterator;
+    tb_size_t                   head;
+    tb_predicate_ref_t          pred;
+    tb_cpointer_t               value;
+    tb_atomic_t                 result;
+
+}tb_parallel_pred_t;
+
+// the parallel sort type
+typedef struct __tb_parallel_sort_t
+{
+    tb_iterator_ref_t           iterator;
+    tb_size_t                   head;
+    tb_iterator_comp_t          comp;
+
+    // the items count
+    tb_size_t                   count;
+
+    // the item size and is the reference item?
+    tb_size_t                   step;
+    tb_bool_t                   is_ref;
+
+    // the item size in the buffer
+    tb_size_t                   isize;
+
+    // the temporary buffer
+    tb_byte_t*                  buffer;
+
+    // the run width of the current level
+    tb_size_t                   width;
+
+    // the parts count of each merging
+    tb_size_t                   partn;
+
+    // the source items are in the buffer?
+    tb_bool_t                   from_buffer;
+
+}tb_parallel_sort_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_size_t tb_parallel_workn(tb_size_t count, tb_size_t grain)
+{
+    // the chunks count
+    tb_size_t chunkn = (count + grain - 1) / grain;
+
+    // the workers count
+    tb_size_t workn = tb_cpu_count();
+    if (workn > TB_PARALLEL_WORKER_MAXN) workn = TB_PARALLEL_WORKER_MAXN;
+    if (workn > chunkn) workn = chunkn;
+    return workn? workn : 1;
+}
+static tb_void_t tb_parallel_exit(tb_parallel_t* parallel)
+{
+    // the last reference? free it
+    if (tb_atomic_fetch_and_sub(&parallel->refn, 1) == 1)
+    {
+        if (parallel->event) tb_event_exit(parallel->event);
+        tb_free(parallel);
+    }
+}
+static tb_bool_t tb_parallel_claim(tb_parallel_t* parallel, tb_size_t* pbegin, tb_size_t* pend)
+{
+    /* claim the next adaptive chunk
+     *
+     * the chunk size is decreased with the remaining items, so the large chunks reduce the contention at first
+     * and the small chunks balance the load at last.
+     */
+    tb_size_t count = parallel->count;
+    tb_long_t begin = tb_atomic_get(&parallel->next);
+    while ((tb_size_t)begin < count)
+    {
+        // compute the chunk size
+        tb_size_t left = count - (tb_size_t)begin;
+        tb_size_t size = left / (parallel->workn << 1);
+        if (size < parallel->grain) size = parallel->grain;
+        if (size > left) size = left;
+
+        // claim it
+        if (tb_atomic_compare_and_swap(&parallel->next, &begin, begin + size))
+        {
+            *pbegin = (tb_size_t)begin;
+            *pend   = (tb_size_t)begin + size;
+            return tb_true;
+        }
+    }
+    return tb_false;
+}
+static tb_bool_t tb_parallel_run(tb_parallel_t* parallel)
+{
+    // get the worker slot
+    tb_size_t slot = (tb_size_t)tb_atomic_fetch_and_add(&parallel->slots, 1);
+    tb_assert(slot < parallel->workn);
+
+    // run all chunks
+    tb_size_t begin;
+    tb_size_t end;
+    tb_bool_t last = tb_false;
+    while (tb_parallel_claim(parallel, &begin, &end))
+    {
+        // run it if not stopped, the claimed items are always finished
+        if (!tb_atomic_get(&parallel->stopped) && !parallel->func(parallel->priv, slot, begin, end))
+            tb_atomic_set(&parallel->stopped, 1);
+
+        // finish it
+        tb_size_t size = end - begin;
+        last = ((tb_size_t)tb_atomic_fetch_and_add(&parallel->finished, size) + size == parallel->count);
+    }
+
+    // have we finished the last chunk?
+    return last;
+}
+static tb_void_t tb_parallel_task_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // run the chunks and notify the calling thread if we have finished the last chunk
+    tb_parallel_t* parallel = (tb_parallel_t*)priv;
+    if (tb_parallel_run(parallel)) tb_event_post(parallel->event);
+}
+static tb_void_t tb_parallel_task_exit(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // release it
+    tb_parallel_exit((tb_parallel_t*)priv);
+}
+static tb_void_t tb_parallel_done(tb_thread_pool_ref_t pool, tb_size_t count, tb_size_t grain, tb_size_t workn, tb_parallel_chunk_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return(count && grain && workn && func);
+
+    // only one worker? run it directly
+    if (workn == 1)
+    {
+        func(priv, 0, 0, count);
+        return ;
+    }
+
+    // done
+    tb_bool_t      ok = tb_false;
+    tb_parallel_t* parallel = tb_null;
+    do
+    {
+        // make parallel
+        parallel = tb_malloc0_type(tb_parallel_t);
+        tb_assert_and_check_break(parallel);
+
+        // init parallel
+        parallel->count = count;
+        parallel->grain = grain;
+        parallel->workn = workn;
+        parallel->func  = func;
+        parallel->priv  = priv;
+        tb_atomic_init(&parallel->next, 0);
+        tb_atomic_init(&parallel->finished, 0);
+        tb_atomic_init(&parallel->slots, 0);
+        tb_atomic_init(&parallel->stopped, 0);
+        tb_atomic_init(&parallel->refn, 1);
+
+        // init event
+        parallel->event = tb_event_init();
+        tb_assert_and_check_break(parallel->event);
+
+        // post the helper tasks, the chunks of the failed tasks will be run by the other workers
+        tb_size_t i = 0;
+        if (!pool) pool = tb_thread_pool();
+        for (i = 1; i < workn && pool; i++)
+        {
+            tb_atomic_fetch_and_add(&parallel->refn, 1);
+            if (!tb_thread_pool_task_post(pool, "parallel", tb_parallel_task_done, tb_parallel_task_exit, parallel, tb_false))
+            {
+                tb_atomic_fetch_and_sub(&parallel->refn, 1);
+                break;
+            }
+        }
+
+        // run the chunks in the calling thread
+        tb_parallel_run(parallel);
+
+        // wait the chunks of the helper tasks
+        while ((tb_size_t)tb_atomic_get(&parallel->finished) < count)
+        {
+            if (tb_event_wait(parallel->event, -1) < 0) break;
+        }
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed? run it directly, no helper tasks have been posted
+    if (!ok) func(priv, 0, 0, count);
+
+    // release it
+    if (parallel) tb_parallel_exit(parallel);
+}
+static tb_bool_t tb_parallel_walk_chunk(tb_cpointer_t priv, tb_size_t slot, tb_size_t begin, tb_size_t end)
+{
+    // walk items
+    tb_bool_t               ok = tb_true;
+    tb_size_t               i = begin;
+    tb_parallel_walk_t*     walk = (tb_parallel_walk_t*)priv;
+    for (; i < end; i++)
+    {
+        if (!walk->func(walk->iterator, tb_iterator_item(walk->iterator, walk->head + i), walk->priv))
+        {
+            ok = tb_false;
+            break;
+        }
+    }
+
+    // update the walked count
+    tb_atomic_fetch_and_add(&walk->count, i - begin);
+    return ok;
+}
+static tb_bool_t tb_parallel_reduce_chunk(tb_cpointer_t priv, tb_size_t slot, tb_size_t begin, tb_size_t end)
+{
+    // reduce items to the partial result of this worker
+    tb_size_t               i = begin;
+    tb_parallel_reduce_t*   reduce = (tb_parallel_reduce_t*)priv;
+    tb_pointer_t            result = reduce->results + slot * reduce->step;
+    for (; i < end; i++)
+        reduce->reduce(reduce->iterator, result, tb_iterator_item(reduce->iterator, reduce->head + i), reduce->priv);
+    return tb_true;
+}
+static tb_bool_t tb_parallel_count_chunk(tb_cpointer_t priv, tb_size_t slot, tb_size_t begin, tb_size_t end)
+{
+    // count items
+    tb_size_t               i = begin;
+    tb_size_t               count = 0;
+    tb_parallel_pred_t*     pred = (tb_parallel_pred_t*)priv;
+    for (; i < end; i++)
+        if (pred->pred(pred->iterator, tb_iterator_item(pred->iterator, pred->head + i), pred->value)) count++;
+
+    // update the total count
+    if (count) tb_atomic_fetch_and_add(&pred->result, count);
+    return tb_true;
+}
+static tb_bool_t tb_parallel_find_chunk(tb_cpointer_t priv, tb_size_t slot, tb_size_t begin, tb_size_t end)
+{
+    // find the first item, we need not scan it if one previous item has been found
+    tb_size_t               i = begin;
+    tb_parallel_pred_t*     pred = (tb_parallel_pred_t*)priv;
+    for (; i < end; i++)
+    {
+        // one previous item has been found? check it sometimes
+        if (!(i & 0x3f) && (tb_size_t)tb_atomic_get(&pred->result) < i) break;
+
+        // found?
+        if (pred->pred(pred->iterator, tb_iterator_item(pred->iterator, pred->head + i), pred->value))
+        {
+            // save the minimum index
+            tb_long_t found = tb_atomic_get(&pred->result);
+            while ((tb_size_t)found > i && !tb_atomic_compare_and_swap(&pred->result, &found, (tb_long_t)i)) ;
+            break;
+        }
+    }
+    return tb_true;
+}
+static __tb_inline__ tb_cpointer_t tb_parallel_sort_item(tb_parallel_sort_t* sort, tb_bool_t in_buffer, tb_size_t index)
+{
+    // get the item from the iterator or the buffer
+    if (!in_buffer) return tb_iterator_item(sort->iterator, sort->head + index);
+    return sort->is_ref? (tb_cpointer_t)(sort->buffer + index * sort->isize) : ((tb_cpointer_t*)sort->buffer)[index];
+}
+static __tb_inline__ tb_void_t tb_parallel_sort_save(tb_parallel_sort_t* sort, tb_bool_t in_buffer, tb_size_t index, tb_cpointer_t item)
+{
+    // save the item to the iterator or the buffer
+    if (!in_buffer) tb_iterator_copy(sort->iterator, sort->head + index, item);
+    else if (sort->is_ref) tb_memcpy(sort->buffer + index * sort->isize, item, sort->step);
+    else ((tb_cpointer_t*)sort->buffer)[index] = item;
+}
+static tb_size_t tb_parallel_sort_corank(tb_parallel_sort_t* sort, tb_size_t lo, tb_size_t m, tb_size_t n, tb_size_t k)
+{
+    /* find the split position of the left run for the k-th output item
+     *
+     * the output items [0, k) are the left items [0, i) and the right items [0, k - i),
+     * and the left item is placed first if they are equal, so the merging is stable.
+     */
+    tb_size_t           i = tb_min(k, m);
+    tb_size_t           j = k - i;
+    tb_size_t           i_low = k > n? k - n : 0;
+    tb_size_t           j_low = k > m? k - m : 0;
+    tb_size_t           mid = lo + m;
+    tb_bool_t           from = sort->from_buffer;
+    tb_iterator_comp_t  comp = sort->comp;
+    while (1)
+    {
+        if (i > 0 && j < n && comp(sort->iterator, tb_parallel_sort_item(sort, from, lo + i - 1), tb_parallel_sort_item(sort, from, mid + j)) > 0)
+        {
+            tb_size_t delta = (i - i_low + 1) >> 1;
+            j_low = j;
+            i -= delta;
+            j += delta;
+        }
+        else if (j > 0 && i < m && comp(sort->iterator, tb_parallel_sort_item(sort, from, mid + j - 1), tb_parallel_sort_item(sort, from, lo + i)) >= 0)
+        {
+            tb_size_t delta = (j - j_low + 1) >> 1;
+            i_low = i;
+            i += delta;
+            j -= delta;
+        }
+        else break;
+    }
+    return i;
+}
+static tb_bool_t tb_parallel_sort_chunk(tb_cpointer_t priv, tb_size_t slot, tb_size_t begin, tb_size_t end)
+{
+    // sort the runs in place
+    tb_parallel_sort_t* sort = (tb_parallel_sort_t*)priv;
+    for (; begin < end; begin++)
+    {
+        tb_size_t lo = begin * sort->width;
+        tb_size_t hi = tb_min(lo + sort->width, sort->count);
+        tb_sort(sort->iterator, sort->head + lo, sort->head + hi, sort->comp);
+    }
+    return tb_true;
+}
+static tb_bool_t tb_parallel_merge_chunk(tb_cpointer_t priv, tb_size_t slot, tb_size_t begin, tb_size_t end)
+{
+    // merge the parts of the adjacent runs
+    tb_parallel_sort_t* sort = (tb_parallel_sort_t*)priv;
+    tb_bool_t           from = sort->from_buffer;
+    tb_bool_t           to = !from;
+    tb_iterator_comp_t  comp = sort->comp;
+    for (; begin < end; begin++)
+    {
+        // the left run [lo, mid) and the right run [mid, hi)
+        tb_size_t pair = begin / sort->partn;
+        tb_size_t part = begin % sort->partn;
+        tb_size_t lo = pair * (sort->width << 1);
+        tb_size_t mid = tb_min(lo + sort->width, sort->count);
+        tb_size_t hi = tb_min(mid + sort->width, sort->count);
+
+        // the output range [k0, k1) of this part
+        tb_size_t size = hi - lo;
+        tb_size_t k0 = (tb_size_t)(((tb_hize_t)size * part) / sort->partn);
+        tb_size_t k1 = (tb_size_t)(((tb_hize_t)size * (part + 1)) / sort->partn);
+        tb_check_continue(k0 < k1);
+
+        // split the left and right runs
+        tb_size_t m = mid - lo;
+        tb_size_t n = hi - mid;
+        tb_size_t i = tb_parallel_sort_corank(sort, lo, m, n, k0);
+        tb_size_t j = k0 - i;
+        tb_size_t ie = tb_parallel_sort_corank(sort, lo, m, n, k1);
+        tb_size_t je = k1 - ie;
+
+        // merge them
+        tb_size_t out = lo + k0;
+        while (i < ie && j < je)
+        {
+            tb_cpointer_t litem = tb_parallel_sort_item(sort, from, lo + i);
+            tb_cpointer_t ritem = tb_parallel_sort_item(sort, from, mid + j);
+            if (comp(sort->iterator, ritem, litem) < 0)
+            {
+                tb_parallel_sort_save(sort, to, out++, ritem);
+                j++;
+            }
+            else
+            {
+                tb_parallel_sort_save(sort, to, out++, litem);
+                i++;
+            }
+        }
+        for (; i < ie; i++) tb_parallel_sort_save(sort, to, out++, tb_parallel_sort_item(sort, from, lo + i));
+        for (; j < je; j++) tb_parallel_sort_save(sort, to, out++, tb_parallel_sort_item(sort, from, mid + j));
+    }
+    return tb_true;
+}
+static tb_bool_t tb_parallel_copy_chunk(tb_cpointer_t priv, tb_size_t slot, tb_size_t begin, tb_size_t end)
+{
+    // copy the sorted items from the buffer to the iterator
+    tb_parallel_sort_t* sort = (tb_parallel_sort_t*)priv;
+    for (; begin < end; begin++)
+        tb_parallel_sort_save(sort, tb_false, begin, tb_parallel_sort_item(sort, tb_true, begin));
+    return tb_true;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_size_t tb_parallel_walk(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_size_t head, tb_size_t tail, tb_walk_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(iterator && (tb_iterator_mode(iterator) & TB_ITERATOR_MODE_RACCESS) && func, 0);
+
+    // null?
+    tb_check_return_val(head < tail, 0);
+
+    // walk it
+    tb_size_t           count = tail - head;
+    tb_parallel_walk_t  walk = {iterator, head, func, priv, 0};
+    tb_parallel_done(pool, count, TB_PARALLEL_GRAIN_MIN, tb_parallel_workn(count, TB_PARALLEL_GRAIN_MIN), tb_parallel_walk_chunk, &walk);
+    return (tb_size_t)tb_atomic_get(&walk.count);
+}
+tb_size_t tb_parallel_walk_all(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_walk_func_t func, tb_cpointer_t priv)
+{
+    return tb_parallel_walk(pool, iterator, tb_iterator_head(iterator), tb_iterator_tail(iterator), func, priv);
+}
+tb_bool_t tb_parallel_reduce(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_size_t head, tb_size_t tail, tb_pointer_t result, tb_size_t size, tb_parallel_reduce_func_t reduce, tb_parallel_merge_func_t merge, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(iterator && (tb_iterator_mode(iterator) & TB_ITERATOR_MODE_RACCESS) && result && size && reduce && merge, tb_false);
+
+    // null?
+    tb_check_return_val(head < tail, tb_true);
+
+    // the workers count
+    tb_size_t count = tail - head;
+    tb_size_t workn = tb_parallel_workn(count, TB_PARALLEL_GRAIN_MIN);
+
+    // only one worker? reduce it to the result directly
+    tb_parallel_reduce_t ctx = {iterator, head, reduce, priv, (tb_byte_t*)result, size};
+    if (workn == 1) return tb_parallel_reduce_chunk(&ctx, 0, 0, count);
+
+    // make the partial results, we align them to the cache line to avoid the false sharing
+    ctx.step    = tb_align(size, TB_L1_CACHE_BYTES);
+    ctx.results = tb_malloc_bytes(workn * ctx.step);
+    tb_assert_and_check_return_val(ctx.results, tb_false);
+
+    // init all partial results with the identity value
+    tb_size_t i = 0;
+    for (i = 0; i < workn; i++) tb_memcpy(ctx.results + i * ctx.step, result, size);
+
+    // reduce it
+    tb_parallel_done(pool, count, TB_PARALLEL_GRAIN_MIN, workn, tb_parallel_reduce_chunk, &ctx);
+
+    // merge all partial results
+    for (i = 0; i < workn; i++) merge(result, ctx.results + i * ctx.step, priv);
+
+    // exit the partial results
+    tb_free(ctx.results);
+    return tb_true;
+}
+tb_bool_t tb_parallel_reduce_all(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_pointer_t result, tb_size_t size, tb_parallel_reduce_func_t reduce, tb_parallel_merge_func_t merge, tb_cpointer_t priv)
+{
+    return tb_parallel_reduce(pool, iterator, tb_iterator_head(iterator), tb_iterator_tail(iterator), result, size, reduce, merge, priv);
+}
+tb_size_t tb_parallel_count_if(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_size_t head, tb_size_t tail, tb_predicate_ref_t pred, tb_cpointer_t value)
+{
+    // check
+    tb_assert_and_check_return_val(iterator && (tb_iterator_mode(iterator) & TB_ITERATOR_MODE_RACCESS) && pred, 0);
+
+    // null?
+    tb_check_return_val(head < tail, 0);
+
+    // count it
+    tb_size_t           count = tail - head;
+    tb_parallel_pred_t  ctx = {iterator, head, pred, value, 0};
+    tb_parallel_done(pool, count, TB_PARALLEL_GRAIN_MIN, tb_parallel_workn(count, TB_PARALLEL_GRAIN_MIN), tb_parallel_count_chunk, &ctx);
+    return (tb_size_t)tb_atomic_get(&ctx.result);
+}
+tb_size_t tb_parallel_count_all_if(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_predicate_ref_t pred, tb_cpointer_t value)
+{
+    return tb_parallel_count_if(pool, iterator, tb_iterator_head(iterator), tb_iterator_tail(iterator), pred, value);
+}
+tb_size_t tb_parallel_find_if(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_size_t head, tb_size_t tail, tb_predicate_ref_t pred, tb_cpointer_t value)
+{
+    // check
+    tb_assert_and_check_return_val(iterator && (tb_iterator_mode(iterator) & TB_ITERATOR_MODE_RACCESS) && pred, tb_iterator_tail(iterator));
+
+    // null?
+    tb_check_return_val(head < tail, tb_iterator_tail(iterator));
+
+    // find it, the result is the minimum found index
+    tb_size_t           count = tail - head;
+    tb_parallel_pred_t  ctx = {iterator, head, pred, value, (tb_long_t)count};
+    tb_parallel_done(pool, count, TB_PARALLEL_GRAIN_MIN, tb_parallel_workn(count, TB_PARALLEL_GRAIN_MIN), tb_parallel_find_chunk, &ctx);
+
+    // found?
+    tb_size_t found = (tb_size_t)tb_atomic_get(&ctx.result);
+    return found < count? head + found : tb_iterator_tail(iterator);
+}
+tb_size_t tb_parallel_find_all_if(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_predicate_ref_t pred, tb_cpointer_t value)
+{
+    return tb_parallel_find_if(pool, iterator, tb_iterator_head(iterator), tb_iterator_tail(iterator), pred, value);
+}
+tb_void_t tb_parallel_sort(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_size_t head, tb_size_t tail, tb_iterator_comp_t comp)
+{
+    // check
+    tb_assert_and_check_return(iterator && (tb_iterator_mode(iterator) & TB_ITERATOR_MODE_RACCESS));
+
+    // readonly?
+    tb_assert_and_check_return(!(tb_iterator_mode(iterator) & TB_ITERATOR_MODE_READONLY));
+
+    // no elements?
+    tb_check_return(head < tail);
+
+    // only one worker? sort it directly
+    tb_size_t count = tail - head;
+    tb_size_t workn = tb_parallel_workn(count, TB_PARALLEL_GRAIN_MIN);
+    if (workn == 1)
+    {
+        tb_sort(iterator, head, tail, comp);
+        return ;
+    }
+
+    // init sort
+    tb_parallel_sort_t sort;
+    tb_memset(&sort, 0, sizeof(tb_parallel_sort_t));
+    sort.iterator   = iterator;
+    sort.head       = head;
+    sort.comp       = comp? comp : tb_iterator_comp;
+    sort.count      = count;
+    sort.step       = tb_iterator_step(iterator);
+    sort.is_ref     = (tb_iterator_flag(iterator) & TB_ITERATOR_FLAG_ITEM_REF) || (!tb_iterator_flag(iterator) && sort.step > sizeof(tb_pointer_t));
+    sort.isize      = sort.is_ref? sort.step : sizeof(tb_pointer_t);
+
+    // make the temporary buffer
+    sort.buffer = tb_malloc_bytes(count * sort.isize);
+    if (!sort.buffer)
+    {
+        // no enough memory? sort it directly
+        tb_sort(iterator, head, tail, comp);
+        return ;
+    }
+
+    // sort the runs in parallel, each worker has a few runs for balancing the load
+    tb_size_t part = tb_max((count + (workn << 2) - 1) / (workn << 2), TB_PARALLEL_GRAIN_MIN);
+    sort.width = part;
+    tb_parallel_done(pool, (count + part - 1) / part, 1, workn, tb_parallel_sort_chunk, &sort);
+
+    // merge the runs level by level, iterator => buffer => iterator ...
+    while (sort.width < count)
+    {
+        // each merging is split to the parts
+        tb_size_t pairn = (count + (sort.width << 1) - 1) / (sort.width << 1);
+        sort.partn = ((tb_min(sort.width << 1, count)) + part - 1) / part;
+        tb_parallel_done(pool, pairn * sort.partn, 1, workn, tb_parallel_merge_chunk, &sort);
+
+        // the next level
+        sort.from_buffer = !sort.from_buffer;
+        sort.width <<= 1;
+    }
+
+    // copy the sorted items back to the iterator
+    if (sort.from_buffer) tb_parallel_done(pool, count, TB_PARALLEL_GRAIN_MIN, workn, tb_parallel_copy_chunk, &sort);
+
+    // exit the temporary buffer
+    tb_free(sort.buffer);
+}
+tb_void_t tb_parallel_sort_all(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_iterator_comp_t comp)
+{
+    tb_parallel_sort(pool, iterator, tb_iterator_head(iterator), tb_iterator_tail(iterator), comp);
+}
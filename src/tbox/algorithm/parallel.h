@@ -0,0 +1,216 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        parallel.h
+ * @ingroup     algorithm
+ *
+ */
+#ifndef TB_ALGORITHM_PARALLEL_H
+#define TB_ALGORITHM_PARALLEL_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "walk.h"
+#include "predicate.h"
+#include "../platform/thread_pool.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the parallel reduce func type
+ *
+ * @param iterator  the iterator
+ * @param result    the partial result of the current worker
+ * @param item      the inner item of the container
+ * @param priv      the func private data
+ */
+typedef tb_void_t   (*tb_parallel_reduce_func_t)(tb_iterator_ref_t iterator, tb_pointer_t result, tb_cpointer_t item, tb_cpointer_t priv);
+
+/*! the parallel merge func type
+ *
+ * @param result    the final result
+ * @param partial   the partial result of one worker
+ * @param priv      the func private data
+ */
+typedef tb_void_t   (*tb_parallel_merge_func_t)(tb_pointer_t result, tb_cpointer_t partial, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! walk items in parallel
+ *
+ * the items are split into the adaptive chunks which are run by the calling thread and the thread pool,
+ * all workers will stop as soon as possible if the walker func returns tb_false.
+ *
+ * @note the iterator must be random access, and the walker func will be called concurrently
+ *
+ * @param pool      the thread pool, using the default thread pool if be null
+ * @param iterator  the iterator
+ * @param head      the iterator head
+ * @param tail      the iterator tail
+ * @param func      the walker func
+ * @param priv      the func private data
+ *
+ * @return          the walked item count
+ */
+tb_size_t           tb_parallel_walk(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_size_t head, tb_size_t tail, tb_walk_func_t func, tb_cpointer_t priv);
+
+/*! walk all items in parallel
+ *
+ * @param pool      the thread pool, using the default thread pool if be null
+ * @param iterator  the iterator
+ * @param func      the walker func
+ * @param priv      the func private data
+ *
+ * @return          the walked item count
+ */
+tb_size_t           tb_parallel_walk_all(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_walk_func_t func, tb_cpointer_t priv);
+
+/*! reduce items in parallel
+ *
+ * each worker reduces its items to a private copy of the initial result,
+ * and all partial results will be merged to the final result after all items have been reduced.
+ *
+ * @code
+    static tb_void_t sum_reduce(tb_iterator_ref_t iterator, tb_pointer_t result, tb_cpointer_t item, tb_cpointer_t priv)
+    {
+        *((tb_hize_t*)result) += tb_p2u32(item);
+    }
+    static tb_void_t sum_merge(tb_pointer_t result, tb_cpointer_t partial, tb_cpointer_t priv)
+    {
+        *((tb_hize_t*)result) += *((tb_hize_t const*)partial);
+    }
+
+    tb_hize_t sum = 0;
+    tb_parallel_reduce_all(tb_null, vector, &sum, sizeof(sum), sum_reduce, sum_merge, tb_null);
+ * @endcode
+ *
+ * @note the merge func must be associative and commutative, the merging order of the partial results is not fixed
+ *
+ * @param pool      the thread pool, using the default thread pool if be null
+ * @param iterator  the iterator
+ * @param head      the iterator head
+ * @param tail      the iterator tail
+ * @param result    the result, it must be initialized as the identity value, e.g. zero for sum
+ * @param size      the result size
+ * @param reduce    the reduce func
+ * @param merge     the merge func
+ * @param priv      the func private data
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_parallel_reduce(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_size_t head, tb_size_t tail, tb_pointer_t result, tb_size_t size, tb_parallel_reduce_func_t reduce, tb_parallel_merge_func_t merge, tb_cpointer_t priv);
+
+/*! reduce all items in parallel
+ *
+ * @param pool      the thread pool, using the default thread pool if be null
+ * @param iterator  the iterator
+ * @param result    the result, it must be initialized as the identity value, e.g. zero for sum
+ * @param size      the result size
+ * @param reduce    the reduce func
+ * @param merge     the merge func
+ * @param priv      the func private data
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_parallel_reduce_all(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_pointer_t result, tb_size_t size, tb_parallel_reduce_func_t reduce, tb_parallel_merge_func_t merge, tb_cpointer_t priv);
+
+/*! count items in parallel if pred(item, value)
+ *
+ * @param pool      the thread pool, using the default thread pool if be null
+ * @param iterator  the iterator
+ * @param head      the iterator head
+ * @param tail      the iterator tail
+ * @param pred      the predicate
+ * @param value     the value of the predicate
+ *
+ * @return          the real count
+ */
+tb_size_t           tb_parallel_count_if(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_size_t head, tb_size_t tail, tb_predicate_ref_t pred, tb_cpointer_t value);
+
+/*! count items for all in parallel if pred(item, value)
+ *
+ * @param pool      the thread pool, using the default thread pool if be null
+ * @param iterator  the iterator
+ * @param pred      the predicate
+ * @param value     the value of the predicate
+ *
+ * @return          the real count
+ */
+tb_size_t           tb_parallel_count_all_if(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_predicate_ref_t pred, tb_cpointer_t value);
+
+/*! find the first item in parallel if pred(item, value)
+ *
+ * the chunks after the found item will be skipped, so it returns the same item as tb_find_if()
+ *
+ * @param pool      the thread pool, using the default thread pool if be null
+ * @param iterator  the iterator
+ * @param head      the iterator head
+ * @param tail      the iterator tail
+ * @param pred      the predicate
+ * @param value     the value of the predicate
+ *
+ * @return          the iterator itor, return tb_iterator_tail(iterator) if not found
+ */
+tb_size_t           tb_parallel_find_if(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_size_t head, tb_size_t tail, tb_predicate_ref_t pred, tb_cpointer_t value);
+
+/*! find the first item for all in parallel if pred(item, value)
+ *
+ * @param pool      the thread pool, using the default thread pool if be null
+ * @param iterator  the iterator
+ * @param pred      the predicate
+ * @param value     the value of the predicate
+ *
+ * @return          the iterator itor, return tb_iterator_tail(iterator) if not found
+ */
+tb_size_t           tb_parallel_find_all_if(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_predicate_ref_t pred, tb_cpointer_t value);
+
+/*! sort items in parallel using the merge sort
+ *
+ * the chunks are sorted by tb_sort() in parallel first, and then they are merged level by level,
+ * each merging is split into the balanced parts by the binary search, so the last levels are parallel too.
+ *
+ * @param pool      the thread pool, using the default thread pool if be null
+ * @param iterator  the iterator
+ * @param head      the iterator head
+ * @param tail      the iterator tail
+ * @param comp      the comparer, using the default comparer of the iterator if be null
+ */
+tb_void_t           tb_parallel_sort(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_size_t head, tb_size_t tail, tb_iterator_comp_t comp);
+
+/*! sort all items in parallel using the merge sort
+ *
+ * @param pool      the thread pool, using the default thread pool if be null
+ * @param iterator  the iterator
+ * @param comp      the comparer, using the default comparer of the iterator if be null
+ */
+tb_void_t           tb_parallel_sort_all(tb_thread_pool_ref_t pool, tb_iterator_ref_t iterator, tb_iterator_comp_t comp);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+#endif
@@ -74,282 +74,72 @@ typedef struct __tb_co_channel_t
     tb_cpointer_t                   priv;
 
     // the waiting send coroutines
-    tb_single_list_entry_head_t     waiting_send;
+    tb_list_entry_head_t            waiting_send;
 
     // the waiting recv coroutines
-    tb_single_list_entry_head_t     waiting_recv;
+    tb_list_entry_head_t            waiting_recv;
 
 }tb_co_channel_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
-static tb_bool_t tb_co_channel_send_resume(tb_co_channel_t* channel, tb_pointer_t* pdata)
+static tb_co_channel_waiter_ref_t tb_co_channel_waiter_pop(tb_list_entry_head_ref_t waiting)
 {
-    // check
-    tb_assert(channel);
-
-    // resume the first waiting send coroutine and recv data
-    tb_bool_t ok = tb_false;
-    if (tb_single_list_entry_size(&channel->waiting_send))
-    {
-        // get the next entry from head
-        tb_single_list_entry_ref_t entry = tb_single_list_entry_head(&channel->waiting_send);
-        tb_assert(entry);
-
-        // remove it from the waiting send coroutines
-        tb_single_list_entry_remove_head(&channel->waiting_send);
-
-        // get the waiting send coroutine
-        tb_coroutine_ref_t waiting = (tb_coroutine_ref_t)tb_single_list_entry(&channel->waiting_send, entry);
-
-        // resume this coroutine and recv data
-        tb_pointer_t data = tb_coroutine_resume(waiting, tb_null);
-
-        // save data
-        if (pdata) *pdata = data;
-
-        // ok
-        ok = tb_true;
-    }
-
-    // ok?
-    return ok;
+    // no waiters?
+    tb_check_return_val(tb_list_entry_size(waiting), tb_null);
+
+    // remove the first waiter
+    tb_co_channel_waiter_ref_t waiter = (tb_co_channel_waiter_ref_t)tb_list_entry(waiting, tb_list_entry_head(waiting));
+    tb_list_entry_remove_head(waiting);
+    waiter->waiting = tb_null;
+    return waiter;
 }
-static tb_void_t tb_co_channel_recv_resume(tb_co_channel_t* channel)
+static tb_void_t tb_co_channel_waiter_wake(tb_co_channel_waiter_ref_t waiter)
 {
     // check
-    tb_assert(channel);
-
-    // resume the first waiting recv coroutine
-    if (tb_single_list_entry_size(&channel->waiting_recv))
-    {
-        // get the next entry from head
-        tb_single_list_entry_ref_t entry = tb_single_list_entry_head(&channel->waiting_recv);
-        tb_assert(entry);
+    tb_assert(waiter && waiter->coroutine);
 
-        // remove it from the waiting recv coroutines
-        tb_single_list_entry_remove_head(&channel->waiting_recv);
-
-        // get the waiting recv coroutine
-        tb_coroutine_ref_t waiting = (tb_coroutine_ref_t)tb_single_list_entry(&channel->waiting_recv, entry);
-
-        // resume this coroutine
-        tb_coroutine_resume(waiting, tb_null);
-    }
+    // is selecting? notify the select, it will stop waiting the other cases
+    if (waiter->select) tb_co_select_wake(waiter->select, waiter);
+    // resume the waiting coroutine
+    else tb_coroutine_resume((tb_coroutine_ref_t)waiter->coroutine, tb_null);
 }
-static tb_void_t tb_co_channel_send_suspend(tb_co_channel_t* channel, tb_cpointer_t data)
+static tb_void_t tb_co_channel_wait(tb_co_channel_t* channel, tb_co_channel_waiter_ref_t waiter, tb_bool_t send)
 {
     // check
-    tb_assert(channel);
+    tb_assert(channel && waiter);
 
     // get the running coroutine
-    tb_coroutine_t* running = (tb_coroutine_t*)tb_coroutine_self();
-    tb_assert(running);
+    waiter->coroutine = (tb_coroutine_t*)tb_coroutine_self();
+    waiter->select = tb_null;
+    tb_assert(waiter->coroutine);
 
-    // save this coroutine to the waiting send coroutines
-    tb_single_list_entry_insert_tail(&channel->waiting_send, &running->rs.single_entry);
-
-    // send data and wait it
-    tb_coroutine_suspend(data);
-}
-static tb_void_t tb_co_channel_recv_suspend(tb_co_channel_t* channel)
-{
-    // check
-    tb_assert(channel);
-
-    // get the running coroutine
-    tb_coroutine_t* running = (tb_coroutine_t*)tb_coroutine_self();
-    tb_assert(running);
-
-    // save this coroutine to the waiting recv coroutines
-    tb_single_list_entry_insert_tail(&channel->waiting_recv, &running->rs.single_entry);
-
-    // wait data
-    tb_coroutine_suspend(tb_null);
-}
-static tb_void_t tb_co_channel_send_buffer(tb_co_channel_t* channel, tb_cpointer_t data)
-{
-    // check
-    tb_assert_and_check_return(channel && channel->queue.data);
-
-    // done
-    do
-    {
-        // put data into queue if be not full
-        if (channel->queue.size + 1 < channel->queue.maxn)
-        {
-            // trace
-            tb_trace_d("send[%p]: put data(%p)", tb_coroutine_self(), data);
-
-            // put data
-            channel->queue.data[channel->queue.tail] = data;
-            channel->queue.tail = (channel->queue.tail + 1) % channel->queue.maxn;
-            channel->queue.size++;
-
-            // notify to recv data
-            tb_co_channel_recv_resume(channel);
-
-            // send ok
-            break;
-        }
-        // wait it if be full
-        else
-        {
-            // trace
-            tb_trace_d("send[%p]: wait ..", tb_coroutine_self());
-
-            // wait send
-            tb_co_channel_send_suspend(channel, tb_null);
-
-            // trace
-            tb_trace_d("send[%p]: wait ok", tb_coroutine_self());
-        }
-
-    } while (1);
+    // append it to the waiting send or recv coroutines
+    tb_co_channel_waiter_insert((tb_co_channel_ref_t)channel, waiter, send);
 
     // trace
-    tb_trace_d("send[%p]: ok", tb_coroutine_self());
-}
-static tb_pointer_t tb_co_channel_recv_buffer(tb_co_channel_t* channel)
-{
-    // check
-    tb_assert_and_check_return_val(channel && channel->queue.data, tb_null);
-
-    // done
-    tb_pointer_t data = tb_null;
-    do
-    {
-        // recv data from channel if be not null
-        if (channel->queue.size)
-        {
-            // get data
-            data = (tb_pointer_t)channel->queue.data[channel->queue.head];
-
-            // pop data
-            channel->queue.head = (channel->queue.head + 1) % channel->queue.maxn;
-            channel->queue.size--;
-
-            // trace
-            tb_trace_d("recv[%p]: get data(%p)", tb_coroutine_self(), data);
+    tb_trace_d("%s[%p]: wait ..", send? "send" : "recv", waiter->coroutine);
 
-            // notify to send data
-            tb_co_channel_send_resume(channel, tb_null);
-
-            // recv ok
-            break;
-        }
-        // wait it if be null
-        else
-        {
-            // trace
-            tb_trace_d("recv[%p]: wait ..", tb_coroutine_self());
-
-            // wait recv
-            tb_co_channel_recv_suspend(channel);
-
-            // trace
-            tb_trace_d("recv[%p]: wait ok", tb_coroutine_self());
-        }
-
-    } while (1);
+    // wait the peer, the data will be passed by the waiter
+    tb_coroutine_suspend(tb_null);
 
     // trace
-    tb_trace_d("recv[%p]: ok", tb_coroutine_self());
-
-    // get data
-    return data;
+    tb_trace_d("%s[%p]: wait ok", send? "send" : "recv", waiter->coroutine);
 }
-static tb_bool_t tb_co_channel_send_buffer_try(tb_co_channel_t* channel, tb_cpointer_t data)
+static tb_void_t tb_co_channel_queue_put(tb_co_channel_t* channel, tb_cpointer_t data)
 {
-    // check
-    tb_assert_and_check_return_val(channel && channel->queue.data, tb_false);
-
-    // put data into queue if be not full
-    if (channel->queue.size + 1 < channel->queue.maxn)
-    {
-        // trace
-        tb_trace_d("send[%p]: put data(%p)", tb_coroutine_self(), data);
-
-        // put data
-        channel->queue.data[channel->queue.tail] = data;
-        channel->queue.tail = (channel->queue.tail + 1) % channel->queue.maxn;
-        channel->queue.size++;
-
-        // notify to recv data
-        tb_co_channel_recv_resume(channel);
-
-        // send ok
-        return tb_true;
-    }
-
-    // failed
-    return tb_false;
+    // put data
+    channel->queue.data[channel->queue.tail] = data;
+    channel->queue.tail = (channel->queue.tail + 1) % channel->queue.maxn;
+    channel->queue.size++;
 }
-static tb_bool_t tb_co_channel_recv_buffer_try(tb_co_channel_t* channel, tb_pointer_t* pdata)
+static tb_pointer_t tb_co_channel_queue_pop(tb_co_channel_t* channel)
 {
-    // check
-    tb_assert_and_check_return_val(channel && channel->queue.data && pdata, tb_false);
-
-    // recv data from channel if be not null
-    if (channel->queue.size)
-    {
-        // get data
-        *pdata = (tb_pointer_t)channel->queue.data[channel->queue.head];
-
-        // pop data
-        channel->queue.head = (channel->queue.head + 1) % channel->queue.maxn;
-        channel->queue.size--;
-
-        // trace
-        tb_trace_d("recv[%p]: get data(%p)", tb_coroutine_self(), *pdata);
-
-        // notify to send data
-        tb_co_channel_send_resume(channel, tb_null);
-
-        // recv ok
-        return tb_true;
-    }
-
-    // failed
-    return tb_false;
-}
-static tb_void_t tb_co_channel_send_buffer0(tb_co_channel_t* channel, tb_cpointer_t data)
-{
-    // check
-    tb_assert(channel);
-
-    // resume one waiting recv coroutine
-    tb_co_channel_recv_resume(channel);
-
-    // send data and wait it
-    tb_co_channel_send_suspend(channel, data);
-}
-static tb_pointer_t tb_co_channel_recv_buffer0(tb_co_channel_t* channel)
-{
-    // check
-    tb_assert(channel);
-
-    // done
-    tb_pointer_t data = tb_null;
-    do
-    {
-        // resume the first waiting send coroutine and recv data
-        if (tb_co_channel_send_resume(channel, &data))
-        {
-            // recv ok
-            break;
-        }
-        // no data?
-        else
-        {
-            // wait data
-            tb_co_channel_recv_suspend(channel);
-        }
-
-    } while (1);
-
-    // ok?
+    // pop data
+    tb_pointer_t data = (tb_pointer_t)channel->queue.data[channel->queue.head];
+    channel->queue.head = (channel->queue.head + 1) % channel->queue.maxn;
+    channel->queue.size--;
     return data;
 }
 
@@ -368,10 +158,10 @@ tb_co_channel_ref_t tb_co_channel_init(tb_size_t size, tb_co_channel_free_func_t
         tb_assert_and_check_break(channel);
 
         // init waiting send coroutines
-        tb_single_list_entry_init(&channel->waiting_send, tb_coroutine_t, rs.single_entry, tb_null);
+        tb_list_entry_init(&channel->waiting_send, tb_co_channel_waiter_t, entry, tb_null);
 
         // init waiting recv coroutines
-        tb_single_list_entry_init(&channel->waiting_recv, tb_coroutine_t, rs.single_entry, tb_null);
+        tb_list_entry_init(&channel->waiting_recv, tb_co_channel_waiter_t, entry, tb_null);
 
         // init free function and data
         channel->free = free;
@@ -433,12 +223,12 @@ tb_void_t tb_co_channel_exit(tb_co_channel_ref_t self)
     channel->queue.size = 0;
 
     // check waiting coroutines
-    tb_assert(!tb_single_list_entry_size(&channel->waiting_send));
-    tb_assert(!tb_single_list_entry_size(&channel->waiting_recv));
+    tb_assert(!tb_list_entry_size(&channel->waiting_send));
+    tb_assert(!tb_list_entry_size(&channel->waiting_recv));
 
     // exit waiting coroutines
-    tb_single_list_entry_exit(&channel->waiting_send);
-    tb_single_list_entry_exit(&channel->waiting_recv);
+    tb_list_entry_exit(&channel->waiting_send);
+    tb_list_entry_exit(&channel->waiting_recv);
 
     // exit the channel
     tb_free(channel);
@@ -449,9 +239,16 @@ tb_void_t tb_co_channel_send(tb_co_channel_ref_t self, tb_cpointer_t data)
     tb_co_channel_t* channel = (tb_co_channel_t*)self;
     tb_assert_and_check_return(channel);
 
-    // send it
-    if (channel->queue.data) tb_co_channel_send_buffer(channel, data);
-    else tb_co_channel_send_buffer0(channel, data);
+    // send it directly?
+    if (tb_co_channel_send_try(self, data)) return ;
+
+    // wait it if no receivers and the buffer is full, the data will be taken away by the receiver
+    tb_co_channel_waiter_t waiter;
+    waiter.data = data;
+    tb_co_channel_wait(channel, &waiter, tb_true);
+
+    // trace
+    tb_trace_d("send[%p]: ok", tb_coroutine_self());
 }
 tb_pointer_t tb_co_channel_recv(tb_co_channel_ref_t self)
 {
@@ -459,8 +256,20 @@ tb_pointer_t tb_co_channel_recv(tb_co_channel_ref_t self)
     tb_co_channel_t* channel = (tb_co_channel_t*)self;
     tb_assert_and_check_return_val(channel, tb_null);
 
-    // recv it
-    return channel->queue.data? tb_co_channel_recv_buffer(channel) : tb_co_channel_recv_buffer0(channel);
+    // recv it directly?
+    tb_pointer_t data = tb_null;
+    if (tb_co_channel_recv_try(self, &data)) return data;
+
+    // wait it if no data, the data will be passed by the sender
+    tb_co_channel_waiter_t waiter;
+    waiter.data = tb_null;
+    tb_co_channel_wait(channel, &waiter, tb_false);
+
+    // trace
+    tb_trace_d("recv[%p]: get data(%p)", tb_coroutine_self(), waiter.data);
+
+    // get data
+    return (tb_pointer_t)waiter.data;
 }
 tb_bool_t tb_co_channel_send_try(tb_co_channel_ref_t self, tb_cpointer_t data)
 {
@@ -468,8 +277,32 @@ tb_bool_t tb_co_channel_send_try(tb_co_channel_ref_t self, tb_cpointer_t data)
     tb_co_channel_t* channel = (tb_co_channel_t*)self;
     tb_assert_and_check_return_val(channel, tb_false);
 
-    // try sending it
-    return channel->queue.data? tb_co_channel_send_buffer_try(channel, data) : tb_false;
+    // pass data to the waiting receiver directly, the buffer must be empty now
+    tb_co_channel_waiter_ref_t waiter = tb_co_channel_waiter_pop(&channel->waiting_recv);
+    if (waiter)
+    {
+        // trace
+        tb_trace_d("send[%p]: pass data(%p) to recv[%p]", tb_coroutine_self(), data, waiter->coroutine);
+
+        // pass data
+        waiter->data = data;
+        tb_co_channel_waiter_wake(waiter);
+        return tb_true;
+    }
+
+    // put data into queue if be not full
+    if (channel->queue.data && channel->queue.size + 1 < channel->queue.maxn)
+    {
+        // trace
+        tb_trace_d("send[%p]: put data(%p)", tb_coroutine_self(), data);
+
+        // put data
+        tb_co_channel_queue_put(channel, data);
+        return tb_true;
+    }
+
+    // failed
+    return tb_false;
 }
 tb_bool_t tb_co_channel_recv_try(tb_co_channel_ref_t self, tb_pointer_t* pdata)
 {
@@ -477,7 +310,61 @@ tb_bool_t tb_co_channel_recv_try(tb_co_channel_ref_t self, tb_pointer_t* pdata)
     tb_co_channel_t* channel = (tb_co_channel_t*)self;
     tb_assert_and_check_return_val(channel && pdata, tb_false);
 
-    // try recving it
-    return channel->queue.data? tb_co_channel_recv_buffer_try(channel, pdata) : tb_false;
+    // get the first waiting sender
+    tb_co_channel_waiter_ref_t waiter = tb_co_channel_waiter_pop(&channel->waiting_send);
+
+    // recv data from queue if be not null
+    if (channel->queue.size)
+    {
+        // get data
+        *pdata = tb_co_channel_queue_pop(channel);
+
+        // trace
+        tb_trace_d("recv[%p]: get data(%p)", tb_coroutine_self(), *pdata);
+
+        // move the data of the waiting sender into the queue, it's full before
+        if (waiter)
+        {
+            tb_co_channel_queue_put(channel, waiter->data);
+            tb_co_channel_waiter_wake(waiter);
+        }
+        return tb_true;
+    }
+
+    // recv data from the waiting sender directly if no buffer
+    if (waiter)
+    {
+        // trace
+        tb_trace_d("recv[%p]: get data(%p) from send[%p]", tb_coroutine_self(), waiter->data, waiter->coroutine);
+
+        // get data
+        *pdata = (tb_pointer_t)waiter->data;
+        tb_co_channel_waiter_wake(waiter);
+        return tb_true;
+    }
+
+    // failed
+    return tb_false;
+}
+tb_void_t tb_co_channel_waiter_insert(tb_co_channel_ref_t self, tb_co_channel_waiter_ref_t waiter, tb_bool_t send)
+{
+    // check
+    tb_co_channel_t* channel = (tb_co_channel_t*)self;
+    tb_assert(channel && waiter && waiter->coroutine);
+
+    // append it to the waiting send or recv coroutines
+    waiter->waiting = send? &channel->waiting_send : &channel->waiting_recv;
+    tb_list_entry_insert_tail(waiter->waiting, &waiter->entry);
 }
+tb_void_t tb_co_channel_waiter_remove(tb_co_channel_waiter_ref_t waiter)
+{
+    // check
+    tb_assert(waiter);
 
+    // remove it if it's still waiting
+    if (waiter->waiting)
+    {
+        tb_list_entry_remove(waiter->waiting, &waiter->entry);
+        waiter->waiting = tb_null;
+    }
+}
@@ -86,9 +86,9 @@ tb_void_t               tb_co_channel_send(tb_co_channel_ref_t channel, tb_cpoin
  */
 tb_pointer_t            tb_co_channel_recv(tb_co_channel_ref_t channel);
 
-/*! try sending data into channel only with buffer
+/*! try sending data into channel
  *
- * the current coroutine will be suspend if this channel is full
+ * it will never suspend the current coroutine, and it will be failed if no waiting receivers and the buffer is full
  *
  * @param channel       the channel
  * @param data          the channel data
@@ -97,9 +97,9 @@ tb_pointer_t            tb_co_channel_recv(tb_co_channel_ref_t channel);
  */
 tb_bool_t               tb_co_channel_send_try(tb_co_channel_ref_t channel, tb_cpointer_t data);
 
-/*! try recving data from channel only with buffer
+/*! try recving data from channel
  *
- * the current coroutine will be suspend if no data
+ * it will never suspend the current coroutine, and it will be failed if no data and no waiting senders
  *
  * @param channel       the channel
  * @param pdata         the channel data pointer
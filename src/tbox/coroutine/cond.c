@@ -0,0 +1,107 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        cond.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "cond"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "cond.h"
+#include "impl/impl.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the coroutine condition variable type
+typedef struct __tb_co_cond_t
+{
+    // the waiting coroutines
+    tb_co_waitq_t               waitq;
+
+}tb_co_cond_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_co_cond_ref_t tb_co_cond_init()
+{
+    // make cond
+    tb_co_cond_t* cond = tb_malloc0_type(tb_co_cond_t);
+    tb_assert_and_check_return_val(cond, tb_null);
+
+    // init the waiting coroutines
+    tb_co_waitq_init(&cond->waitq);
+
+    // ok
+    return (tb_co_cond_ref_t)cond;
+}
+tb_void_t tb_co_cond_exit(tb_co_cond_ref_t self)
+{
+    // check
+    tb_co_cond_t* cond = (tb_co_cond_t*)self;
+    tb_assert_and_check_return(cond);
+
+    // exit the waiting coroutines
+    tb_co_waitq_exit(&cond->waitq);
+
+    // exit it
+    tb_free(cond);
+}
+tb_long_t tb_co_cond_wait(tb_co_cond_ref_t self, tb_co_lock_ref_t lock, tb_long_t timeout)
+{
+    // check
+    tb_co_cond_t* cond = (tb_co_cond_t*)self;
+    tb_assert_and_check_return_val(cond, -1);
+
+    // leave lock, the waiting coroutines will be resumed after we are suspended
+    if (lock) tb_co_lock_leave(lock);
+
+    // wait it
+    tb_long_t ok = tb_co_waitq_wait(&cond->waitq, 0, timeout, tb_true);
+
+    // enter lock again
+    if (lock) tb_co_lock_enter(lock);
+    return ok;
+}
+tb_void_t tb_co_cond_signal(tb_co_cond_ref_t self)
+{
+    // check
+    tb_co_cond_t* cond = (tb_co_cond_t*)self;
+    tb_assert_and_check_return(cond);
+
+    // wake up the first waiting coroutine
+    tb_co_waitq_wake(&cond->waitq);
+}
+tb_void_t tb_co_cond_broadcast(tb_co_cond_ref_t self)
+{
+    // check
+    tb_co_cond_t* cond = (tb_co_cond_t*)self;
+    tb_assert_and_check_return(cond);
+
+    // wake up all waiting coroutines
+    tb_co_waitq_wake_all(&cond->waitq);
+}
@@ -0,0 +1,95 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        cond.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_COND_H
+#define TB_COROUTINE_COND_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "lock.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the coroutine condition variable ref type
+typedef __tb_typeref__(co_cond);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init condition variable
+ *
+ * @return              the cond
+ */
+tb_co_cond_ref_t        tb_co_cond_init(tb_noarg_t);
+
+/*! exit condition variable
+ *
+ * @param cond          the cond
+ */
+tb_void_t               tb_co_cond_exit(tb_co_cond_ref_t cond);
+
+/*! wait condition variable
+ *
+ * leave the lock and suspend the current coroutine until it's signaled or timeout,
+ * and the lock will be entered again before returning.
+ *
+ * @code
+    tb_co_lock_enter(lock);
+    while (!ready) tb_co_cond_wait(cond, lock, -1);
+    tb_co_lock_leave(lock);
+ * @endcode
+ *
+ * @param cond          the cond
+ * @param lock          the entered lock, it can be null if we need not the lock
+ * @param timeout       the timeout, infinity: -1
+ *
+ * @return              ok: 1, timeout: 0, fail or cancelled: -1
+ */
+tb_long_t               tb_co_cond_wait(tb_co_cond_ref_t cond, tb_co_lock_ref_t lock, tb_long_t timeout);
+
+/*! wake up one waiting coroutine
+ *
+ * @param cond          the cond
+ */
+tb_void_t               tb_co_cond_signal(tb_co_cond_ref_t cond);
+
+/*! wake up all waiting coroutines
+ *
+ * @param cond          the cond
+ */
+tb_void_t               tb_co_cond_broadcast(tb_co_cond_ref_t cond);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -44,6 +44,90 @@ tb_bool_t tb_coroutine_start(tb_co_scheduler_ref_t scheduler, tb_coroutine_func_
     // start it
     return tb_co_scheduler_start((tb_co_scheduler_t*)scheduler, func, priv, stacksize);
 }
+tb_co_handle_ref_t tb_coroutine_spawn(tb_co_scheduler_ref_t scheduler, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize)
+{
+    // check
+    tb_assert_and_check_return_val(func, tb_null);
+
+    // make handle, it's held by the coroutine and the user
+    tb_co_handle_t* handle = tb_malloc0_type(tb_co_handle_t);
+    tb_assert_and_check_return_val(handle, tb_null);
+
+    // init handle
+    handle->refn = 2;
+    tb_co_waitq_init(&handle->joiners);
+
+    // start it
+    if (!tb_co_scheduler_start_handle((tb_co_scheduler_t*)scheduler, func, priv, stacksize, handle))
+    {
+        tb_co_waitq_exit(&handle->joiners);
+        tb_free(handle);
+        handle = tb_null;
+    }
+
+    // ok?
+    return (tb_co_handle_ref_t)handle;
+}
+tb_long_t tb_coroutine_join(tb_co_handle_ref_t self, tb_long_t timeout)
+{
+    // check
+    tb_co_handle_t* handle = (tb_co_handle_t*)self;
+    tb_assert_and_check_return_val(handle, -1);
+
+    // has been finished?
+    tb_check_return_val(handle->coroutine, 1);
+
+    // cannot join itself
+    tb_assert_and_check_return_val(handle->coroutine != (tb_coroutine_t*)tb_coroutine_self(), -1);
+
+    // wait it
+    return tb_co_waitq_wait(&handle->joiners, 0, timeout, tb_true);
+}
+tb_void_t tb_coroutine_cancel(tb_co_handle_ref_t self)
+{
+    // check
+    tb_co_handle_t* handle = (tb_co_handle_t*)self;
+    tb_assert_and_check_return(handle);
+
+    // has been finished?
+    tb_coroutine_t* coroutine = handle->coroutine;
+    tb_check_return(coroutine);
+
+    // trace
+    tb_trace_d("cancel coroutine(%p)", coroutine);
+
+    // mark it as cancelled
+    coroutine->cancelled = 1;
+
+    /* interrupt the current waiting, it will be resumed with the failed result
+     *
+     * it has been posted to the inbox of the owner scheduler? it will be resumed soon
+     */
+    tb_coroutine_interrupt_func_t interrupt = coroutine->interrupt;
+    if (interrupt && !tb_atomic32_get_explicit(&coroutine->remote_posted, TB_ATOMIC_RELAXED))
+    {
+        coroutine->interrupt = tb_null;
+        interrupt(coroutine, coroutine->interrupt_priv);
+    }
+}
+tb_void_t tb_coroutine_handle_exit(tb_co_handle_ref_t self)
+{
+    // check
+    tb_co_handle_t* handle = (tb_co_handle_t*)self;
+    tb_assert_and_check_return(handle);
+
+    // check joiners
+    tb_assert(!tb_co_waitq_size(&handle->joiners));
+
+    // release the reference of the user
+    tb_coroutine_handle_release(handle);
+}
+tb_bool_t tb_coroutine_is_cancelled()
+{
+    // get the current coroutine
+    tb_coroutine_t* coroutine = (tb_coroutine_t*)tb_coroutine_self();
+    return coroutine? (tb_bool_t)coroutine->cancelled : tb_false;
+}
 tb_bool_t tb_coroutine_yield()
 {
     // get current scheduler
@@ -100,6 +184,22 @@ tb_long_t tb_coroutine_waitfs(tb_poller_object_ref_t object, tb_fwatcher_event_t
     // wait fwatcher event
     return scheduler? tb_co_scheduler_wait_fwatcher(scheduler, object, pevent, timeout) : -1;
 }
+tb_long_t tb_coroutine_waitcall(tb_coroutine_call_func_t func, tb_coroutine_call_exit_func_t exit, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(func, -1);
+
+    // get current scheduler
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+
+    // wait the blocking call in coroutine
+    if (scheduler && scheduler->running) return tb_co_scheduler_wait_call(scheduler, func, exit, priv);
+
+    // call it directly
+    tb_long_t result = func(priv);
+    if (exit) exit(priv);
+    return result;
+}
 tb_coroutine_ref_t tb_coroutine_self()
 {
     // get coroutine
@@ -26,7 +26,13 @@
  * includes
  */
 #include "lock.h"
+#include "rwlock.h"
+#include "cond.h"
+#include "waitgroup.h"
 #include "channel.h"
+#include "select.h"
+#include "local.h"
+#include "mpmc_channel.h"
 #include "semaphore.h"
 #include "scheduler.h"
 #include "../platform/poller.h"
@@ -45,9 +51,18 @@ __tb_extern_c_enter__
 /// the coroutine ref type
 typedef __tb_typeref__(coroutine);
 
+/// the coroutine handle ref type
+typedef __tb_typeref__(co_handle);
+
 /// the coroutine function type
 typedef tb_void_t       (*tb_coroutine_func_t)(tb_cpointer_t priv);
 
+/// the blocking call function type for tb_coroutine_waitcall()
+typedef tb_long_t       (*tb_coroutine_call_func_t)(tb_cpointer_t priv);
+
+/// the blocking call exit function type for tb_coroutine_waitcall()
+typedef tb_void_t       (*tb_coroutine_call_exit_func_t)(tb_cpointer_t priv);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -63,6 +78,53 @@ typedef tb_void_t       (*tb_coroutine_func_t)(tb_cpointer_t priv);
  */
 tb_bool_t               tb_coroutine_start(tb_co_scheduler_ref_t scheduler, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize);
 
+/*! start coroutine and get its handle for joining and cancelling it
+ *
+ * the handle is not thread-safe, so we need join and cancel it in the same scheduler,
+ * and this coroutine will be pinned to the current worker (M:N).
+ *
+ * @note the handle need be released by tb_coroutine_handle_exit()
+ *
+ * @param scheduler     the scheduler, uses the current scheduler if be null
+ * @param func          the coroutine function
+ * @param priv          the passed user private data as the argument of function
+ * @param stacksize     the stack size
+ *
+ * @return              the coroutine handle
+ */
+tb_co_handle_ref_t      tb_coroutine_spawn(tb_co_scheduler_ref_t scheduler, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize);
+
+/*! wait the coroutine of the given handle to be finished
+ *
+ * @param handle        the coroutine handle
+ * @param timeout       the timeout, infinity: -1
+ *
+ * @return              ok: 1, timeout: 0, fail or cancelled: -1
+ */
+tb_long_t               tb_coroutine_join(tb_co_handle_ref_t handle, tb_long_t timeout);
+
+/*! cancel the coroutine of the given handle
+ *
+ * the cancellation is cooperative, the pending sleep, waitio, waitproc, waitfs, tb_co_select(),
+ * tb_co_cond_wait(), tb_co_waitgroup_wait() and tb_coroutine_join() will be interrupted and failed,
+ * and the next waits of this coroutine will be failed directly, so it can leave quickly.
+ *
+ * @param handle        the coroutine handle
+ */
+tb_void_t               tb_coroutine_cancel(tb_co_handle_ref_t handle);
+
+/*! exit the coroutine handle, the coroutine will be still running if it has been not finished
+ *
+ * @param handle        the coroutine handle
+ */
+tb_void_t               tb_coroutine_handle_exit(tb_co_handle_ref_t handle);
+
+/*! the current coroutine has been cancelled?
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_coroutine_is_cancelled(tb_noarg_t);
+
 /*! yield the current coroutine
  *
  * @return              tb_true(yield ok) or tb_false(yield failed, no more coroutines)
@@ -124,6 +186,24 @@ tb_long_t               tb_coroutine_waitproc(tb_poller_object_ref_t object, tb_
  */
 tb_long_t               tb_coroutine_waitfs(tb_poller_object_ref_t object, tb_fwatcher_event_t* pevent, tb_long_t timeout);
 
+/*! wait the blocking call
+ *
+ * the blocking function (e.g. the disk io) will be called on the global thread pool,
+ * and the current coroutine will be suspended until it's finished, so it will not block the other coroutines.
+ *
+ * it will be called directly if we are not in coroutine.
+ *
+ * the private data will be passed to exit() after the blocking call is finished and released by the waiting coroutine,
+ * and the scheduler will wait the in-flight blocking calls before exiting, so they can still access the stack of the waiting coroutine.
+ *
+ * @param func          the blocking function, it cannot access the coroutine and scheduler
+ * @param exit          the exit function of the private data, e.g. free it, it can be null
+ * @param priv          the user private data
+ *
+ * @return              the result of the blocking function, -1 if the current coroutine has been cancelled
+ */
+tb_long_t               tb_coroutine_waitcall(tb_coroutine_call_func_t func, tb_coroutine_call_exit_func_t exit, tb_cpointer_t priv);
+
 /*! get the current coroutine
  *
  * @return              the current coroutine
@@ -0,0 +1,94 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        channel.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_IMPL_CHANNEL_H
+#define TB_COROUTINE_IMPL_CHANNEL_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the coroutine type
+struct __tb_coroutine_t;
+
+// the select type
+struct __tb_co_select_t;
+
+/* the waiter type of the channel
+ *
+ * it's placed on the stack of the waiting coroutine or the select,
+ * and the sent or received data will be passed by it directly.
+ */
+typedef struct __tb_co_channel_waiter_t
+{
+    // the list entry
+    tb_list_entry_t                 entry;
+
+    // the waiting list of the channel, it's null if this waiter has been removed from the channel
+    tb_list_entry_head_ref_t        waiting;
+
+    // the waiting coroutine
+    struct __tb_coroutine_t*        coroutine;
+
+    // the select, it's null if it's not selecting
+    struct __tb_co_select_t*        select;
+
+    // the sending data or the received data
+    tb_cpointer_t                   data;
+
+}tb_co_channel_waiter_t, *tb_co_channel_waiter_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* append the waiter to the waiting send or recv list of the channel
+ *
+ * the waiter will be removed and waked up after the peer has passed the data to it
+ *
+ * @param channel       the channel
+ * @param waiter        the waiter
+ * @param send          is sending?
+ */
+tb_void_t               tb_co_channel_waiter_insert(tb_co_channel_ref_t channel, tb_co_channel_waiter_ref_t waiter, tb_bool_t send);
+
+/* remove the waiter from the channel if it's still waiting
+ *
+ * @param waiter        the waiter
+ */
+tb_void_t               tb_co_channel_waiter_remove(tb_co_channel_waiter_ref_t waiter);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -31,6 +31,7 @@
  */
 #include "coroutine.h"
 #include "scheduler.h"
+#include "local.h"
 #include "../../memory/memory.h"
 #if defined(__tb_valgrind__) && defined(TB_CONFIG_VALGRIND_HAVE_VALGRIND_STACK_REGISTER)
 #   include "valgrind/valgrind.h"
@@ -43,12 +44,67 @@
 // the stack guard magic
 #define TB_COROUTINE_STACK_GUARD            (0xbeef)
 
+// the space of the stack guard magic at the stack top, keep the stack base aligned
+#define TB_COROUTINE_STACK_GUARD_SIZE       (16)
+
+// the coroutine head size at the stack top
+#define TB_COROUTINE_HEAD_SIZE              (tb_align(sizeof(tb_coroutine_t), 16) + TB_COROUTINE_STACK_GUARD_SIZE)
+
+// the stack watermark for profiling the stack depth
+#define TB_COROUTINE_STACK_WATERMARK        (0xcc)
+
+/* the watermark size at the stack top for profiling the stack depth
+ *
+ * it's less than the hot pages of the stack pool, so the cold pages will not be committed by filling it
+ */
+#define TB_COROUTINE_STACK_WATERMARK_SIZE   (8 * 1024)
+
 // the default stack size, @note we will allocate it from large/virtual allocator if size >= TB_VIRTUAL_MEMORY_DATA_MINN
 #define TB_COROUTINE_STACK_DEFSIZE          TB_VIRTUAL_MEMORY_DATA_MINN
 
 /* //////////////////////////////////////////////////////////////////////////////////////
- * implementation
+ * private implementation
  */
+static tb_coroutine_t* tb_coroutine_stack_init(tb_co_stack_pool_t* stack_pool, tb_size_t stacksize)
+{
+    // check
+    tb_assert(stack_pool);
+
+    // make stack
+    tb_size_t   mapsize = tb_coroutine_stack_mapsize(stacksize);
+    tb_byte_t*  stackdata = tb_co_stack_pool_malloc(stack_pool, mapsize);
+    tb_check_return_val(stackdata, tb_null);
+
+    // make coroutine at the stack top
+    tb_coroutine_t* coroutine = (tb_coroutine_t*)(stackdata + mapsize - tb_align(sizeof(tb_coroutine_t), 16));
+    tb_memset(coroutine, 0, sizeof(tb_coroutine_t));
+
+    // init stack
+    coroutine->stackbase = (tb_byte_t*)coroutine - TB_COROUTINE_STACK_GUARD_SIZE;
+    coroutine->stacksize = mapsize - TB_COROUTINE_HEAD_SIZE;
+    return coroutine;
+}
+static tb_void_t tb_coroutine_stack_exit(tb_co_stack_pool_t* stack_pool, tb_coroutine_t* coroutine)
+{
+    // check
+    tb_assert(stack_pool && coroutine);
+
+    // free stack, @note the coroutine will be overwritten after freeing it
+    tb_co_stack_pool_free(stack_pool, coroutine->stackbase - coroutine->stacksize, coroutine->stacksize + TB_COROUTINE_HEAD_SIZE);
+}
+static tb_void_t tb_coroutine_stack_fill(tb_coroutine_t* coroutine)
+{
+    // check
+    tb_assert(coroutine && coroutine->stackbase && coroutine->stacksize);
+
+    /* fill the watermark region at the stack top for profiling, the context will be made at the stack top later
+     *
+     * we do not fill the whole stack, because it will commit all pages and the stack pool will regard it as a deep stack
+     */
+    tb_size_t size = tb_min(coroutine->stacksize, TB_COROUTINE_STACK_WATERMARK_SIZE);
+    tb_memset_(coroutine->stackbase - size, TB_COROUTINE_STACK_WATERMARK, size);
+    coroutine->stack_filled = 1;
+}
 static tb_void_t tb_coroutine_entry(tb_context_from_t from)
 {
     // get the from-coroutine
@@ -99,34 +155,22 @@ tb_coroutine_t* tb_coroutine_init(tb_co_scheduler_ref_t scheduler, tb_coroutine_
     tb_coroutine_t* coroutine = tb_null;
     do
     {
-        // init stack size
-        if (!stacksize) stacksize = TB_COROUTINE_STACK_DEFSIZE;
-
-#ifdef __tb_debug__
-        // patch debug stack size for (assert, trace ..)
-        stacksize <<= 1;
-#endif
-
-        /* make coroutine
+        /* make coroutine from the stack pool of scheduler
          *
-         * TODO:
+         * the stack overflow will hit the guard pages and fault immediately
          *
-         * - segment stack
-         *
-         *  -----------------------------------------------
-         * | coroutine | guard | ... stacksize ... | guard |
-         *  -----------------------------------------------
+         *  -------------------------------------------------------
+         * | guard pages | ... stacksize ... | guard | coroutine |
+         *  -------------------------------------------------------
+         *                                   |
+         *                               stackbase
          */
-        coroutine = (tb_coroutine_t*)tb_malloc_bytes(sizeof(tb_coroutine_t) + stacksize + sizeof(tb_uint16_t));
+        coroutine = tb_coroutine_stack_init(((tb_co_scheduler_t*)scheduler)->stack_pool, stacksize);
         tb_assert_and_check_break(coroutine);
 
         // save scheduler
         coroutine->scheduler = scheduler;
 
-        // init stack
-        coroutine->stackbase = (tb_byte_t*)&(coroutine[1]) + stacksize;
-        coroutine->stacksize = stacksize;
-
         // fill guard
         coroutine->guard = TB_COROUTINE_STACK_GUARD;
         tb_bits_set_u16_ne(coroutine->stackbase, TB_COROUTINE_STACK_GUARD);
@@ -135,6 +179,9 @@ tb_coroutine_t* tb_coroutine_init(tb_co_scheduler_ref_t scheduler, tb_coroutine_
         coroutine->rs.func.func = func;
         coroutine->rs.func.priv = priv;
 
+        // fill the stack watermark if the profiling is enabled
+        if (((tb_co_scheduler_t*)scheduler)->profile) tb_coroutine_stack_fill(coroutine);
+
         // make context
         coroutine->context = tb_context_make(coroutine->stackbase - stacksize, stacksize, tb_coroutine_entry);
         tb_assert_and_check_break(coroutine->context);
@@ -177,13 +224,7 @@ tb_coroutine_t* tb_coroutine_reinit(tb_coroutine_t* coroutine, tb_coroutine_func
     tb_bool_t ok = tb_false;
     do
     {
-        // init stack size
-        if (!stacksize) stacksize = TB_COROUTINE_STACK_DEFSIZE;
-
 #ifdef __tb_debug__
-        // patch debug stack size for (assert, trace ..)
-        stacksize <<= 1;
-
         // check coroutine
         tb_coroutine_check(coroutine);
 #endif
@@ -193,15 +234,21 @@ tb_coroutine_t* tb_coroutine_reinit(tb_coroutine_t* coroutine, tb_coroutine_func
         VALGRIND_STACK_DEREGISTER(coroutine->valgrind_stack_id);
 #endif
 
-        // remake coroutine
-        if (stacksize > coroutine->stacksize)
-            coroutine = (tb_coroutine_t*)tb_ralloc_bytes(coroutine, sizeof(tb_coroutine_t) + stacksize + sizeof(tb_uint16_t));
-        else stacksize = coroutine->stacksize;
-        tb_assert_and_check_break(coroutine && coroutine->scheduler);
-
-        // init stack
-        coroutine->stackbase = (tb_byte_t*)&(coroutine[1]) + stacksize;
-        coroutine->stacksize = stacksize;
+        // remake coroutine with the larger stack
+        tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)coroutine->scheduler;
+        tb_assert_and_check_break(scheduler);
+        if (tb_coroutine_stack_mapsize(stacksize) > coroutine->stacksize + TB_COROUTINE_HEAD_SIZE)
+        {
+            // make the new coroutine
+            tb_coroutine_t* coroutine_new = tb_coroutine_stack_init(scheduler->stack_pool, stacksize);
+            tb_assert_and_check_break(coroutine_new);
+
+            // free the old stack
+            tb_coroutine_stack_exit(scheduler->stack_pool, coroutine);
+            coroutine = coroutine_new;
+            coroutine->scheduler = (tb_co_scheduler_ref_t)scheduler;
+        }
+        stacksize = coroutine->stacksize;
 
         // fill guard
         coroutine->guard = TB_COROUTINE_STACK_GUARD;
@@ -211,6 +258,31 @@ tb_coroutine_t* tb_coroutine_reinit(tb_coroutine_t* coroutine, tb_coroutine_func
         coroutine->rs.func.func = func;
         coroutine->rs.func.priv = priv;
 
+        // reset the worker states
+        coroutine->remote_next  = tb_null;
+        coroutine->remote_priv  = tb_null;
+        coroutine->pinned       = 0;
+        tb_atomic32_init(&coroutine->remote_posted, 0);
+        coroutine->internal     = 0;
+
+        // reset the cancellation and waiting states
+        coroutine->cancelled        = 0;
+        coroutine->waitcalled       = 0;
+        coroutine->handle           = tb_null;
+        coroutine->select           = tb_null;
+        coroutine->interrupt        = tb_null;
+        coroutine->interrupt_priv   = tb_null;
+
+        // the local slots have been cleared after finishing it
+        tb_assert(!coroutine->locals_mask);
+
+        // reset the profile and fill the stack watermark again if the profiling is enabled
+        tb_memset(&coroutine->profile, 0, sizeof(coroutine->profile));
+        coroutine->profile_suspended    = 0;
+        coroutine->profile_waiting      = TB_COROUTINE_WAITING_NONE;
+        coroutine->stack_filled         = 0;
+        if (scheduler->profile) tb_coroutine_stack_fill(coroutine);
+
         // make context
         coroutine->context = tb_context_make(coroutine->stackbase - stacksize, stacksize, tb_coroutine_entry);
         tb_assert_and_check_break(coroutine->context);
@@ -225,8 +297,12 @@ tb_coroutine_t* tb_coroutine_reinit(tb_coroutine_t* coroutine, tb_coroutine_func
 
     } while (0);
 
-    // failed? reset it
-    if (!ok) coroutine = tb_null;
+    // failed? exit it
+    if (!ok)
+    {
+        if (coroutine) tb_coroutine_exit(coroutine);
+        coroutine = tb_null;
+    }
 
     // trace
     tb_trace_d("reinit %p", coroutine);
@@ -252,8 +328,95 @@ tb_void_t tb_coroutine_exit(tb_coroutine_t* coroutine)
     VALGRIND_STACK_DEREGISTER(coroutine->valgrind_stack_id);
 #endif
 
+    // free all local data if this coroutine has been not finished
+    if (coroutine->locals_mask) tb_co_local_clear(coroutine);
+
+    // release the handle if this coroutine has been not finished, e.g. the scheduler is exited
+    if (coroutine->handle)
+    {
+        coroutine->handle->coroutine = tb_null;
+        tb_coroutine_handle_release(coroutine->handle);
+        coroutine->handle = tb_null;
+    }
+
     // exit it
-    tb_free(coroutine);
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)coroutine->scheduler;
+    if (scheduler) tb_coroutine_stack_exit(scheduler->stack_pool, coroutine);
+}
+tb_void_t tb_coroutine_handle_finish(tb_coroutine_t* coroutine)
+{
+    // check
+    tb_assert(coroutine);
+
+    // get the handle
+    tb_co_handle_t* handle = coroutine->handle;
+    tb_check_return(handle);
+
+    // detach the handle from this coroutine
+    coroutine->handle = tb_null;
+    handle->coroutine = tb_null;
+
+    // wake up all joiners
+    tb_co_waitq_wake_all(&handle->joiners);
+
+    // release the reference of this coroutine
+    tb_coroutine_handle_release(handle);
+}
+tb_void_t tb_coroutine_handle_release(tb_co_handle_t* handle)
+{
+    // check
+    tb_assert(handle && handle->refn);
+
+    // exit it if no more references
+    if (!--handle->refn)
+    {
+        tb_co_waitq_exit(&handle->joiners);
+        tb_free(handle);
+    }
+}
+tb_size_t tb_coroutine_stack_mapsize(tb_size_t stacksize)
+{
+    // init stack size
+    if (!stacksize) stacksize = TB_COROUTINE_STACK_DEFSIZE;
+
+#ifdef __tb_debug__
+    // patch debug stack size for (assert, trace ..)
+    stacksize <<= 1;
+#endif
+
+    // the mapped size of the coroutine and its stack
+    return tb_align(stacksize + TB_COROUTINE_HEAD_SIZE, tb_page_size());
+}
+tb_size_t tb_coroutine_stack_depth(tb_coroutine_t* coroutine)
+{
+    // check
+    tb_assert(coroutine);
+
+    // the stack has been not filled?
+    tb_check_return_val(coroutine->stack_filled, 0);
+
+    // find the first overwritten word from the bottom of the watermark region
+    tb_size_t const     size = tb_min(coroutine->stacksize, TB_COROUTINE_STACK_WATERMARK_SIZE);
+    tb_size_t const     watermark = ((tb_size_t)-1 / 0xff) * TB_COROUTINE_STACK_WATERMARK;
+    tb_byte_t const*    b = coroutine->stackbase - size;
+    tb_size_t const*    p = (tb_size_t const*)b;
+    tb_size_t const*    e = (tb_size_t const*)coroutine->stackbase;
+    while (p < e && *p == watermark) p++;
+
+    // the stack depth is in the watermark region?
+    if ((tb_byte_t const*)p > b) return (tb_size_t)(coroutine->stackbase - (tb_byte_t const*)p);
+
+    /* the watermark region has been overwritten, we find the committed pages below it
+     *
+     * @note it will be only the size of the watermark region if the committed pages cannot be queried
+     */
+    tb_size_t           pagesize = tb_page_size();
+    tb_byte_t const*    bottom = coroutine->stackbase - coroutine->stacksize;
+    tb_byte_t const*    page = (tb_byte_t const*)((tb_size_t)b & ~(pagesize - 1));
+    while (page > bottom && tb_virtual_memory_committed((tb_pointer_t)(page - pagesize), pagesize) > 0) page -= pagesize;
+
+    // get the stack depth
+    return (tb_size_t)(coroutine->stackbase - tb_min(page, b));
 }
 #ifdef __tb_debug__
 tb_void_t tb_coroutine_check(tb_coroutine_t* coroutine)
@@ -26,6 +26,7 @@
  * includes
  */
 #include "prefix.h"
+#include "waitq.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -46,6 +47,41 @@ __tb_extern_c_enter__
  * types
  */
 
+// the coroutine type
+struct __tb_coroutine_t;
+
+// the select type
+struct __tb_co_select_t;
+
+/* the interrupt function type of the current waiting
+ *
+ * it will remove the given coroutine from the waiting objects and resume it with the failed result
+ */
+typedef tb_void_t                   (*tb_coroutine_interrupt_func_t)(struct __tb_coroutine_t* coroutine, tb_cpointer_t priv);
+
+// the coroutine handle type for joining and cancelling it
+typedef struct __tb_co_handle_t
+{
+    // the coroutine, it will be null after finishing it
+    struct __tb_coroutine_t*        coroutine;
+
+    // the waiting joiners
+    tb_co_waitq_t                   joiners;
+
+    // the reference count, it's held by the coroutine and the user
+    tb_size_t                       refn;
+
+}tb_co_handle_t;
+
+// the coroutine waiting type for profiling
+typedef enum __tb_coroutine_waiting_e
+{
+    TB_COROUTINE_WAITING_NONE       = 0     //!< wait the other objects, e.g. locks and channels
+,   TB_COROUTINE_WAITING_IO         = 1     //!< wait io events, processes and file watchers
+,   TB_COROUTINE_WAITING_TIMER      = 2     //!< wait timers, e.g. sleep()
+
+}tb_coroutine_waiting_e;
+
 // the coroutine function type
 typedef struct __tb_coroutine_rs_func_t
 {
@@ -63,7 +99,7 @@ typedef struct __tb_coroutine_rs_wait_t
     // the waited poller object
     tb_poller_object_t              object;
 
-    // the timer task pointer for ltimer or timer
+    // the timer task pointer
     tb_cpointer_t                   task;
 
     // the object event, (process status or fwatcher event)
@@ -75,9 +111,6 @@ typedef struct __tb_coroutine_rs_wait_t
     // waiting process?
     tb_uint16_t                     object_waiting  : 1;
 
-    // is ltimer?
-    tb_uint16_t                     is_ltimer     : 1;
-
 }tb_coroutine_rs_wait_t;
 
 // the coroutine type
@@ -118,9 +151,60 @@ typedef struct __tb_coroutine_t
 
     }                               rs;
 
+    // the next resumed coroutine in the inbox of the owner scheduler, it's resumed from the other thread
+    struct __tb_coroutine_t*        remote_next;
+
+    // the passed user private data of resume(priv) from the other thread
+    tb_cpointer_t                   remote_priv;
+
+    // has it been posted to the inbox? it cannot be interrupted until the owner scheduler takes it
+    tb_atomic32_t                   remote_posted;
+
     // the guard
     tb_uint16_t                     guard;
 
+    // is pinned? it cannot be migrated to the other workers after attaching to the poller of the current worker (M:N)
+    tb_uint8_t                      pinned;
+
+    // is internal coroutine? e.g. io loop, it will be pinned and not be counted for the worker group (M:N)
+    tb_uint8_t                      internal;
+
+    // has been cancelled? all interruptible waits will be failed
+    tb_uint8_t                      cancelled;
+
+    // has been suspended by tb_coroutine_waitcall()? the cached socket events may be stale
+    tb_uint8_t                      waitcalled;
+
+    // the handle of this coroutine, it's only for tb_coroutine_spawn()
+    tb_co_handle_t*                 handle;
+
+    // the current select if it's waiting multiple channels and io objects
+    struct __tb_co_select_t*        select;
+
+    // the interrupt function of the current waiting, it will be cleared after resuming it
+    tb_coroutine_interrupt_func_t   interrupt;
+
+    // the private data of the interrupt function
+    tb_cpointer_t                   interrupt_priv;
+
+    // the mask of the used local slots
+    tb_uint32_t                     locals_mask;
+
+    // the local slots, it will be cleared after finishing this coroutine
+    tb_cpointer_t                   locals[TB_CO_LOCAL_MAXN];
+
+    // the profile, it's only updated if the profiling is enabled
+    tb_co_profile_t                 profile;
+
+    // the suspended time (us) for profiling
+    tb_hong_t                       profile_suspended;
+
+    // the waiting type for profiling
+    tb_uint8_t                      profile_waiting;
+
+    // has the stack been filled with the watermark?
+    tb_uint8_t                      stack_filled;
+
 #if defined(__tb_valgrind__) && defined(TB_CONFIG_VALGRIND_HAVE_VALGRIND_STACK_REGISTER)
     // the valgrind stack id, helo valgrind to understand coroutine
     tb_uint_t                       valgrind_stack_id;
@@ -143,7 +227,7 @@ typedef struct __tb_coroutine_t
  */
 tb_coroutine_t*         tb_coroutine_init(tb_co_scheduler_ref_t scheduler, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize);
 
-/* reinit the given coroutine
+/* reinit the given coroutine, it will be exited if failed
  *
  * @param coroutine     the coroutine
  * @param func          the coroutine function
@@ -154,12 +238,42 @@ tb_coroutine_t*         tb_coroutine_init(tb_co_scheduler_ref_t scheduler, tb_co
  */
 tb_coroutine_t*         tb_coroutine_reinit(tb_coroutine_t* coroutine, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize);
 
-/* exit coroutine
+/* exit coroutine, the handle of it will be released
  *
  * @param coroutine     the coroutine
  */
 tb_void_t               tb_coroutine_exit(tb_coroutine_t* coroutine);
 
+/* finish the handle of the given coroutine, it will wake up all joiners and release the handle
+ *
+ * @param coroutine     the coroutine
+ */
+tb_void_t               tb_coroutine_handle_finish(tb_coroutine_t* coroutine);
+
+/* release the coroutine handle
+ *
+ * @param handle        the handle
+ */
+tb_void_t               tb_coroutine_handle_release(tb_co_handle_t* handle);
+
+/* get the mapped size of the coroutine and its stack
+ *
+ * @param stacksize     the stack size, uses the default stack size if be zero
+ *
+ * @return              the mapped size, be aligned by page size
+ */
+tb_size_t               tb_coroutine_stack_mapsize(tb_size_t stacksize);
+
+/* get the maximum stack depth by scanning the watermark at the stack top
+ *
+ * we will find the committed pages below the watermark region if it has been overwritten
+ *
+ * @param coroutine     the coroutine
+ *
+ * @return              the stack depth, return 0 if the stack has been not filled
+ */
+tb_size_t               tb_coroutine_stack_depth(tb_coroutine_t* coroutine);
+
 #ifdef __tb_debug__
 /* check coroutine
  *
@@ -28,6 +28,10 @@
 #include "coroutine.h"
 #include "scheduler.h"
 #include "scheduler_io.h"
+#include "waitq.h"
+#include "channel.h"
+#include "select.h"
+#include "local.h"
 #include "stackless/stackless.h"
 
 #endif
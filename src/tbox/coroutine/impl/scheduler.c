@@ -32,6 +32,7 @@
 #include "scheduler.h"
 #include "coroutine.h"
 #include "scheduler_io.h"
+#include "local.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -44,9 +45,77 @@
 #   define TB_SCHEDULER_DEAD_CACHE_MAXN     (256)
 #endif
 
+// the maximum count of the pulled coroutines from the run queue of worker at once (M:N)
+#ifdef __tb_small__
+#   define TB_SCHEDULER_PULL_MAXN           (8)
+#else
+#   define TB_SCHEDULER_PULL_MAXN           (32)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
+static tb_void_t tb_co_scheduler_call_release(tb_co_scheduler_call_t* call)
+{
+    // check
+    tb_assert(call);
+
+    // the last reference? exit the user private data and free it
+    if (tb_atomic32_fetch_and_sub(&call->refn, 1) == 1)
+    {
+        if (call->exit) call->exit(call->priv);
+        tb_free(call);
+    }
+}
+static tb_void_t tb_co_scheduler_call_resume(tb_co_scheduler_call_t* call)
+{
+    /* resume the waiting coroutine on its scheduler if it has not been orphaned
+     *
+     * the scheduler cannot be exited before leaving this lock
+     */
+    tb_spinlock_enter(&call->lock);
+    if (call->scheduler)
+    {
+        tb_co_scheduler_post(call->scheduler, call->coroutine, (tb_cpointer_t)call->result);
+        call->scheduler = tb_null;
+    }
+    tb_spinlock_leave(&call->lock);
+}
+static tb_void_t tb_co_scheduler_call_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_co_scheduler_call_t* call = (tb_co_scheduler_call_t*)priv;
+    tb_assert(call && call->func);
+
+    // do the blocking call on the thread pool
+    call->result = call->func(call->priv);
+    call->done = tb_true;
+
+    // the thread pool will not access the buffers of the waiting coroutine now
+    tb_atomic32_set(&call->finished, 1);
+
+    // resume the waiting coroutine now, the task exit function may be called lazily
+    tb_co_scheduler_call_resume(call);
+}
+static tb_void_t tb_co_scheduler_call_exit(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_co_scheduler_call_t* call = (tb_co_scheduler_call_t*)priv;
+    tb_assert(call);
+
+    // the task has been killed? resume the waiting coroutine with the failed result
+    if (!call->done)
+    {
+        call->result = -1;
+        tb_co_scheduler_call_resume(call);
+    }
+
+    // it has been finished or killed
+    tb_atomic32_set(&call->finished, 1);
+
+    // release the reference of the thread pool
+    tb_co_scheduler_call_release(call);
+}
 static tb_void_t tb_co_scheduler_make_dead(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine)
 {
     // check
@@ -61,7 +130,7 @@ static tb_void_t tb_co_scheduler_make_dead(tb_co_scheduler_t* scheduler, tb_coro
     // append this coroutine to dead coroutines
     tb_list_entry_insert_tail(&scheduler->coroutines_dead, (tb_list_entry_ref_t)coroutine);
 }
-static tb_void_t tb_co_scheduler_make_ready(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine)
+static tb_void_t tb_co_scheduler_make_runnable(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine)
 {
     // check
     tb_assert(scheduler && coroutine);
@@ -78,6 +147,18 @@ static tb_void_t tb_co_scheduler_make_ready(tb_co_scheduler_t* scheduler, tb_cor
         tb_list_entry_insert_prev(&scheduler->coroutines_ready, (tb_list_entry_ref_t)scheduler->running, (tb_list_entry_ref_t)coroutine);
     }
 }
+static tb_void_t tb_co_scheduler_make_ready(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine)
+{
+    // check
+    tb_assert(scheduler && coroutine);
+
+    // push it to the run queue of worker first, it can be stolen by the other idle workers (M:N)
+    if (scheduler->worker && !coroutine->pinned && tb_co_worker_push(scheduler->worker, coroutine))
+        return ;
+
+    // insert this coroutine to ready coroutines
+    tb_co_scheduler_make_runnable(scheduler, coroutine);
+}
 static tb_void_t tb_co_scheduler_make_suspend(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine)
 {
     // check
@@ -109,10 +190,101 @@ static __tb_inline__ tb_coroutine_t* tb_co_scheduler_next_ready(tb_co_scheduler_
     return (tb_coroutine_t*)tb_list_entry0(entry_next);
 }
 
-/* //////////////////////////////////////////////////////////////////////////////////////
- * implementation
- */
-tb_bool_t tb_co_scheduler_start(tb_co_scheduler_t* scheduler, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize)
+static tb_void_t tb_co_scheduler_settings_apply(tb_co_scheduler_t* scheduler, tb_size_t flags, tb_co_scheduler_settings_t const* settings)
+{
+    // check
+    tb_assert(scheduler && settings);
+
+    // enable or disable the profiling, the running time will be restarted at the next switch
+    if (flags & TB_CO_SCHEDULER_SETTING_PROFILE)
+    {
+        scheduler->profile_clock    = 0;
+        scheduler->profile          = settings->profile;
+    }
+
+    // set the slow coroutine function
+    if (flags & TB_CO_SCHEDULER_SETTING_SLOW)
+    {
+        scheduler->slow_threshold   = settings->slow_threshold;
+        scheduler->slow_priv        = settings->slow_priv;
+        scheduler->slow_func        = settings->slow_func;
+    }
+
+    // set the busy-polling timeout
+    if (flags & TB_CO_SCHEDULER_SETTING_BUSYPOLL)
+        scheduler->busypoll = settings->busypoll;
+
+    // set the io timeout slack
+    if (flags & TB_CO_SCHEDULER_SETTING_TIMEOUT_SLACK)
+        scheduler->timeout_slack = settings->timeout_slack;
+}
+static tb_void_t tb_co_scheduler_settings_take(tb_co_scheduler_t* scheduler)
+{
+    // take the posted settings
+    tb_co_scheduler_settings_t settings;
+    tb_spinlock_enter(&scheduler->settings_lock);
+    tb_size_t flags = (tb_size_t)tb_atomic32_fetch_and_set(&scheduler->settings_flags, 0);
+    settings = scheduler->settings;
+    tb_spinlock_leave(&scheduler->settings_lock);
+
+    // apply them
+    tb_co_scheduler_settings_apply(scheduler, flags, &settings);
+}
+static tb_void_t tb_co_scheduler_profile_switch(tb_co_scheduler_t* scheduler, tb_coroutine_t* running)
+{
+    // the running time without yielding, the profiling may be just enabled
+    tb_hong_t now = tb_uclock();
+    tb_hong_t runtime = scheduler->profile_clock? now - scheduler->profile_clock : 0;
+
+    // update the profile of the running coroutine
+    tb_co_profile_t* profile = &running->profile;
+    profile->switches++;
+    profile->runtime        += runtime;
+    profile->runtime_last   = runtime;
+    if (runtime > profile->runtime_max) profile->runtime_max = runtime;
+
+    // sample the current stack depth, the original coroutine has no stack
+    if (!tb_coroutine_is_original(running))
+    {
+        tb_size_t stackdepth = (tb_size_t)(running->stackbase - (tb_byte_t const*)&now);
+        if (stackdepth > profile->stackdepth) profile->stackdepth = stackdepth;
+
+        // it has been run for a long time without yielding?
+        if (scheduler->slow_func && !running->internal && runtime >= (tb_hong_t)scheduler->slow_threshold)
+        {
+            // scan the watermark for the max stack depth, it's more accurate than the sampled depth
+            stackdepth = tb_coroutine_stack_depth(running);
+            if (stackdepth > profile->stackdepth) profile->stackdepth = stackdepth;
+
+            // report it
+            profile->coroutine = (tb_cpointer_t)running;
+            profile->stacksize = running->stacksize;
+            scheduler->slow_func((tb_co_scheduler_ref_t)scheduler, profile, scheduler->slow_priv);
+
+            // do not count the time of the slow function
+            now = tb_uclock();
+        }
+    }
+
+    // restart it for the next coroutine
+    scheduler->profile_clock = now;
+}
+static tb_void_t tb_co_scheduler_profile_resume(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine)
+{
+    // it's suspended before enabling the profiling?
+    tb_check_return(coroutine->profile_suspended);
+
+    // account the suspended time
+    tb_hong_t suspended = tb_uclock() - coroutine->profile_suspended;
+    switch (coroutine->profile_waiting)
+    {
+    case TB_COROUTINE_WAITING_IO:       coroutine->profile.iotime += suspended;     break;
+    case TB_COROUTINE_WAITING_TIMER:    coroutine->profile.timertime += suspended;  break;
+    default:                            coroutine->profile.waittime += suspended;   break;
+    }
+    coroutine->profile_suspended = 0;
+}
+static tb_bool_t tb_co_scheduler_start_impl(tb_co_scheduler_t* scheduler, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize, tb_bool_t internal, tb_co_handle_t* handle)
 {
     // check
     tb_assert(func);
@@ -129,6 +301,14 @@ tb_bool_t tb_co_scheduler_start(tb_co_scheduler_t* scheduler, tb_coroutine_func_
         if (!scheduler) scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
         tb_assert_and_check_break(scheduler);
 
+        // we can only push coroutines to the run queue of the current worker (M:N)
+        if (scheduler->worker && !internal)
+        {
+            tb_co_scheduler_t* scheduler_self = (tb_co_scheduler_t*)tb_co_scheduler_self();
+            if (scheduler_self && scheduler_self->worker && scheduler_self->worker->group == scheduler->worker->group)
+                scheduler = scheduler_self;
+        }
+
         // have been stopped? do not continue to start new coroutines
         tb_check_break(!scheduler->stopped);
 
@@ -145,17 +325,34 @@ tb_bool_t tb_co_scheduler_start(tb_co_scheduler_t* scheduler, tb_coroutine_func_
             // get the dead coroutine
             tb_coroutine_t* coroutine_dead = (tb_coroutine_t*)tb_list_entry0(entry);
 
-            // reinit this coroutine
+            // reinit this coroutine, it will be exited if failed
             coroutine = tb_coroutine_reinit(coroutine_dead, func, priv, stacksize);
-
-            // failed? exit this coroutine
-            if (!coroutine) tb_coroutine_exit(coroutine_dead);
         }
 
         // init coroutine
         if (!coroutine) coroutine = tb_coroutine_init((tb_co_scheduler_ref_t)scheduler, func, priv, stacksize);
         tb_assert_and_check_break(coroutine);
 
+        // mark the internal coroutine, it will be pinned to this scheduler
+        if (internal)
+        {
+            coroutine->internal = 1;
+            coroutine->pinned = 1;
+        }
+        // count the user coroutines of the worker group (M:N)
+        else if (scheduler->worker) tb_co_worker_group_enter(scheduler->worker->group);
+
+        /* attach the handle, it will be pinned to this scheduler (M:N)
+         *
+         * the handle is not thread-safe, so the coroutine cannot be migrated to the other workers
+         */
+        if (handle)
+        {
+            coroutine->handle = handle;
+            coroutine->pinned = 1;
+            handle->coroutine = coroutine;
+        }
+
         // ready coroutine
         tb_co_scheduler_make_ready(scheduler, coroutine);
 
@@ -184,6 +381,134 @@ tb_bool_t tb_co_scheduler_start(tb_co_scheduler_t* scheduler, tb_coroutine_func_
     // ok?
     return ok;
 }
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_bool_t tb_co_scheduler_start(tb_co_scheduler_t* scheduler, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize)
+{
+    return tb_co_scheduler_start_impl(scheduler, func, priv, stacksize, tb_false, tb_null);
+}
+tb_bool_t tb_co_scheduler_start_handle(tb_co_scheduler_t* scheduler, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize, tb_co_handle_t* handle)
+{
+    return tb_co_scheduler_start_impl(scheduler, func, priv, stacksize, tb_false, handle);
+}
+tb_bool_t tb_co_scheduler_start_internal(tb_co_scheduler_t* scheduler, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize)
+{
+    return tb_co_scheduler_start_impl(scheduler, func, priv, stacksize, tb_true, tb_null);
+}
+tb_void_t tb_co_scheduler_post(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine, tb_cpointer_t priv)
+{
+    // check
+    tb_assert(scheduler && coroutine && coroutine->scheduler == (tb_co_scheduler_ref_t)scheduler);
+
+    // trace
+    tb_trace_d("post coroutine(%p) to scheduler(%p)", coroutine, scheduler);
+
+    // save the user private data, it will be passed to suspend() by the owner scheduler
+    coroutine->remote_priv = priv;
+
+    /* it has been waked up, we cannot interrupt it again
+     *
+     * @note we cannot clear the interrupt function here, it will be cleared by the owner scheduler
+     */
+    tb_atomic32_set_explicit(&coroutine->remote_posted, 1, TB_ATOMIC_RELAXED);
+
+    // push it to the inbox
+    tb_long_t inbox = tb_atomic_get_explicit(&scheduler->inbox, TB_ATOMIC_RELAXED);
+    do
+    {
+        coroutine->remote_next = (tb_coroutine_t*)inbox;
+
+    } while (!tb_atomic_compare_and_swap(&scheduler->inbox, &inbox, (tb_long_t)coroutine));
+
+    /* wake up the io loop of the owner scheduler if the inbox was empty
+     *
+     * the io loop will take all posted coroutines at once, so we need not wake it again (batched)
+     */
+    if (!inbox && scheduler->scheduler_io && scheduler->scheduler_io->poller)
+        tb_poller_spak(scheduler->scheduler_io->poller);
+}
+tb_size_t tb_co_scheduler_schedule(tb_co_scheduler_t* scheduler)
+{
+    // check
+    tb_assert(scheduler);
+
+    // apply the posted settings from the other threads
+    if (tb_atomic32_get_explicit(&scheduler->settings_flags, TB_ATOMIC_RELAXED))
+        tb_co_scheduler_settings_take(scheduler);
+
+    // take all posted coroutines from the other threads
+    tb_size_t       count = 0;
+    tb_coroutine_t* coroutine = tb_null;
+    tb_coroutine_t* coroutine_next = tb_null;
+    tb_coroutine_t* posted = tb_null;
+    if (tb_atomic_get_explicit(&scheduler->inbox, TB_ATOMIC_RELAXED))
+        posted = (tb_coroutine_t*)tb_atomic_fetch_and_set(&scheduler->inbox, 0);
+
+    // reverse them to resume them in the posted order
+    for (coroutine = posted, posted = tb_null; coroutine; coroutine = coroutine_next)
+    {
+        coroutine_next = coroutine->remote_next;
+        coroutine->remote_next = posted;
+        posted = coroutine;
+    }
+
+    // resume them
+    for (coroutine = posted; coroutine; coroutine = coroutine_next)
+    {
+        // get the next posted coroutine
+        coroutine_next = coroutine->remote_next;
+        coroutine->remote_next = tb_null;
+
+        // pass the user private data to suspend()
+        coroutine->rs_priv = coroutine->remote_priv;
+        coroutine->remote_priv = tb_null;
+
+        // it has been waked up, we cannot interrupt it again
+        coroutine->interrupt = tb_null;
+        tb_atomic32_set_explicit(&coroutine->remote_posted, 0, TB_ATOMIC_RELAXED);
+
+        // remove it from the suspend coroutines
+        tb_list_entry_remove(&scheduler->coroutines_suspend, (tb_list_entry_ref_t)coroutine);
+
+        // account the suspended time for profiling
+        if (scheduler->profile) tb_co_scheduler_profile_resume(scheduler, coroutine);
+        coroutine->profile_waiting = TB_COROUTINE_WAITING_NONE;
+
+        // make it as ready
+        tb_co_scheduler_make_ready(scheduler, coroutine);
+        count++;
+    }
+
+    // not worker? ok
+    tb_co_worker_ref_t worker = scheduler->worker;
+    tb_check_return_val(worker, count);
+
+    /* pull some ready coroutines from the top of the local run queue (fifo),
+     * the rest of them can be stolen by the other workers
+     */
+    tb_size_t pulln = 0;
+    while (pulln < TB_SCHEDULER_PULL_MAXN && (coroutine = (tb_coroutine_t*)tb_ws_deque_steal(&worker->runq)))
+    {
+        tb_co_scheduler_make_runnable(scheduler, coroutine);
+        pulln++;
+    }
+    count += pulln;
+
+    // no more ready coroutines except for the io loop? steal it from the other workers
+    if (!count && tb_co_scheduler_ready_count(scheduler) <= 1 && (coroutine = tb_co_worker_steal(worker)))
+    {
+        // trace
+        tb_trace_d("migrate coroutine(%p) to worker[%lu]", coroutine, worker->index);
+
+        // migrate it to this scheduler
+        coroutine->scheduler = (tb_co_scheduler_ref_t)scheduler;
+        tb_co_scheduler_make_runnable(scheduler, coroutine);
+        count++;
+    }
+    return count;
+}
 tb_bool_t tb_co_scheduler_yield(tb_co_scheduler_t* scheduler)
 {
     // check
@@ -229,9 +554,26 @@ tb_pointer_t tb_co_scheduler_resume(tb_co_scheduler_t* scheduler, tb_coroutine_t
     // trace
     tb_trace_d("resume coroutine(%p)", coroutine);
 
+    /* the coroutine is suspended on the other scheduler? post it to the owner scheduler
+     *
+     * we cannot get the passed private data from suspend(priv) now, it may be still suspending on the other thread
+     */
+    if (coroutine->scheduler != (tb_co_scheduler_ref_t)scheduler)
+    {
+        tb_co_scheduler_post((tb_co_scheduler_t*)coroutine->scheduler, coroutine, priv);
+        return tb_null;
+    }
+
+    // it has been waked up, we cannot interrupt it again
+    coroutine->interrupt = tb_null;
+
     // remove it from the suspend coroutines
     tb_list_entry_remove(&scheduler->coroutines_suspend, (tb_list_entry_ref_t)coroutine);
 
+    // account the suspended time for profiling
+    if (scheduler->profile) tb_co_scheduler_profile_resume(scheduler, coroutine);
+    coroutine->profile_waiting = TB_COROUTINE_WAITING_NONE;
+
     // get the passed private data from suspend(priv)
     tb_pointer_t retval = (tb_pointer_t)coroutine->rs_priv;
 
@@ -262,16 +604,20 @@ tb_pointer_t tb_co_scheduler_suspend(tb_co_scheduler_t* scheduler, tb_cpointer_t
 #endif
 
     // pass the private data to resume() first
-    scheduler->running->rs_priv = priv;
+    tb_coroutine_t* running = scheduler->running;
+    running->rs_priv = priv;
+
+    // save the suspended time for profiling
+    if (scheduler->profile) running->profile_suspended = tb_uclock();
 
     // get the next ready coroutine first
     tb_coroutine_t* coroutine_next = tb_co_scheduler_next_ready(scheduler);
 
     // make the running coroutine as suspend
-    tb_co_scheduler_make_suspend(scheduler, scheduler->running);
+    tb_co_scheduler_make_suspend(scheduler, running);
 
     // switch to next coroutine
-    if (coroutine_next != scheduler->running) tb_co_scheduler_switch(scheduler, coroutine_next);
+    if (coroutine_next != running) tb_co_scheduler_switch(scheduler, coroutine_next);
     // no more coroutine?
     else
     {
@@ -282,11 +628,8 @@ tb_pointer_t tb_co_scheduler_suspend(tb_co_scheduler_t* scheduler, tb_cpointer_t
         tb_co_scheduler_switch(scheduler, &scheduler->original);
     }
 
-    // check
-    tb_assert(scheduler->running);
-
-    // return the user private data from resume(priv)
-    return (tb_pointer_t)scheduler->running->rs_priv;
+    // return the user private data from resume(priv), it may have been migrated to the other worker (M:N)
+    return (tb_pointer_t)running->rs_priv;
 }
 tb_void_t tb_co_scheduler_finish(tb_co_scheduler_t* scheduler)
 {
@@ -302,6 +645,16 @@ tb_void_t tb_co_scheduler_finish(tb_co_scheduler_t* scheduler)
     tb_coroutine_check(scheduler->running);
 #endif
 
+    // leave the worker group (M:N)
+    if (scheduler->worker && !scheduler->running->internal && !scheduler->stopped)
+        tb_co_worker_group_leave(scheduler->worker->group);
+
+    // free all local data before waking up the joiners
+    if (scheduler->running->locals_mask) tb_co_local_clear(scheduler->running);
+
+    // wake up all joiners and release the handle
+    if (scheduler->running->handle) tb_coroutine_handle_finish(scheduler->running);
+
     // get the next ready coroutine first
     tb_coroutine_t* coroutine_next = tb_co_scheduler_next_ready(scheduler);
 
@@ -326,13 +679,14 @@ tb_pointer_t tb_co_scheduler_sleep(tb_co_scheduler_t* scheduler, tb_long_t inter
     tb_assert(scheduler && scheduler->running);
     tb_assert(scheduler->running == (tb_coroutine_t*)tb_coroutine_self());
 
-    // have been stopped? return it directly
-    tb_check_return_val(!scheduler->stopped, tb_null);
+    // have been stopped or cancelled? return it directly
+    tb_check_return_val(!scheduler->stopped && !scheduler->running->cancelled, tb_null);
 
     // need io scheduler
     if (!tb_co_scheduler_io_need(scheduler)) return tb_null;
 
     // sleep it
+    scheduler->running->profile_waiting = TB_COROUTINE_WAITING_TIMER;
     return tb_co_scheduler_io_sleep(scheduler->scheduler_io, interval);
 }
 tb_void_t tb_co_scheduler_switch(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine)
@@ -350,6 +704,9 @@ tb_void_t tb_co_scheduler_switch(tb_co_scheduler_t* scheduler, tb_coroutine_t* c
     // trace
     tb_trace_d("switch to coroutine(%p) from coroutine(%p)", coroutine, running);
 
+    // update the profile of the running coroutine
+    if (scheduler->profile) tb_co_scheduler_profile_switch(scheduler, running);
+
     // jump to the given coroutine
     tb_context_from_t from = tb_context_jump(coroutine->context, running);
 
@@ -365,19 +722,35 @@ tb_void_t tb_co_scheduler_switch(tb_co_scheduler_t* scheduler, tb_coroutine_t* c
     // update the context
     coroutine_from->context = from.context;
 }
+tb_void_t tb_co_scheduler_profile_sync(tb_co_scheduler_t* scheduler)
+{
+    // check
+    tb_assert(scheduler && scheduler->running);
+
+    // account the running time of the current coroutine
+    tb_hong_t now = tb_uclock();
+    if (scheduler->profile_clock) scheduler->running->profile.runtime += now - scheduler->profile_clock;
+
+    // restart it
+    scheduler->profile_clock = now;
+}
 tb_long_t tb_co_scheduler_wait(tb_co_scheduler_t* scheduler, tb_poller_object_ref_t object, tb_size_t events, tb_long_t timeout)
 {
     // check
     tb_assert(scheduler && scheduler->running);
     tb_assert(scheduler->running == (tb_coroutine_t*)tb_coroutine_self());
 
-    // have been stopped? return it directly
-    tb_check_return_val(!scheduler->stopped, -1);
+    // have been stopped or cancelled? return it directly
+    tb_check_return_val(!scheduler->stopped && !scheduler->running->cancelled, -1);
 
     // need io scheduler
     if (!tb_co_scheduler_io_need(scheduler)) return -1;
 
+    // pin it, the poller object will be attached to the poller of this worker (M:N)
+    scheduler->running->pinned = 1;
+
     // wait it
+    scheduler->running->profile_waiting = TB_COROUTINE_WAITING_IO;
     return tb_co_scheduler_io_wait(scheduler->scheduler_io, object, events, timeout);
 }
 tb_long_t tb_co_scheduler_wait_proc(tb_co_scheduler_t* scheduler, tb_poller_object_ref_t object, tb_long_t* pstatus, tb_long_t timeout)
@@ -386,13 +759,17 @@ tb_long_t tb_co_scheduler_wait_proc(tb_co_scheduler_t* scheduler, tb_poller_obje
     tb_assert(scheduler && scheduler->running);
     tb_assert(scheduler->running == (tb_coroutine_t*)tb_coroutine_self());
 
-    // have been stopped? return it directly
-    tb_check_return_val(!scheduler->stopped, -1);
+    // have been stopped or cancelled? return it directly
+    tb_check_return_val(!scheduler->stopped && !scheduler->running->cancelled, -1);
 
     // need io scheduler
     if (!tb_co_scheduler_io_need(scheduler)) return -1;
 
+    // pin it, the poller object will be attached to the poller of this worker (M:N)
+    scheduler->running->pinned = 1;
+
     // wait it
+    scheduler->running->profile_waiting = TB_COROUTINE_WAITING_IO;
     return tb_co_scheduler_io_wait_proc(scheduler->scheduler_io, object, pstatus, timeout);
 }
 tb_long_t tb_co_scheduler_wait_fwatcher(tb_co_scheduler_t* scheduler, tb_poller_object_ref_t object, tb_fwatcher_event_t* pevent, tb_long_t timeout)
@@ -401,12 +778,152 @@ tb_long_t tb_co_scheduler_wait_fwatcher(tb_co_scheduler_t* scheduler, tb_poller_
     tb_assert(scheduler && scheduler->running);
     tb_assert(scheduler->running == (tb_coroutine_t*)tb_coroutine_self());
 
-    // have been stopped? return it directly
-    tb_check_return_val(!scheduler->stopped, -1);
+    // have been stopped or cancelled? return it directly
+    tb_check_return_val(!scheduler->stopped && !scheduler->running->cancelled, -1);
 
     // need io scheduler
     if (!tb_co_scheduler_io_need(scheduler)) return -1;
 
+    // pin it, the poller object will be attached to the poller of this worker (M:N)
+    scheduler->running->pinned = 1;
+
     // wait it
+    scheduler->running->profile_waiting = TB_COROUTINE_WAITING_IO;
     return tb_co_scheduler_io_wait_fwatcher(scheduler->scheduler_io, object, pevent, timeout);
 }
+tb_long_t tb_co_scheduler_wait_call(tb_co_scheduler_t* scheduler, tb_coroutine_call_func_t func, tb_coroutine_call_exit_func_t exit, tb_cpointer_t priv)
+{
+    // check
+    tb_assert(scheduler && scheduler->running && func);
+    tb_assert(scheduler->running == (tb_coroutine_t*)tb_coroutine_self());
+
+    // done
+    tb_long_t               result = -1;
+    tb_co_scheduler_call_t* call = tb_null;
+    do
+    {
+        // have been stopped or cancelled?
+        tb_check_break(!scheduler->stopped && !scheduler->running->cancelled);
+
+        // need io scheduler, the io loop will be waked up by tb_co_scheduler_post()
+        tb_check_break(tb_co_scheduler_io_need(scheduler));
+
+        // make the blocking call, it may be still referenced by the thread pool after the scheduler is exited
+        call = tb_malloc0_type(tb_co_scheduler_call_t);
+        tb_assert_and_check_break(call);
+
+        // init it
+        tb_atomic32_init(&call->refn, 2);
+        tb_atomic32_init(&call->finished, 0);
+        tb_spinlock_init(&call->lock);
+        call->scheduler = scheduler;
+        call->coroutine = scheduler->running;
+        call->func      = func;
+        call->exit      = exit;
+        call->priv      = priv;
+        call->result    = -1;
+
+        // post it to the thread pool, we call it directly if failed
+        tb_thread_pool_ref_t pool = tb_thread_pool();
+        if (!pool || !tb_thread_pool_task_post(pool, "co_waitcall", tb_co_scheduler_call_done, tb_co_scheduler_call_exit, call, tb_false))
+        {
+            tb_free(call);
+            call = tb_null;
+            result = func(priv);
+            break;
+        }
+
+        // append it to the in-flight calls, it will be orphaned if the scheduler is exited
+        tb_list_entry_insert_tail(&scheduler->calls, &call->entry);
+
+        /* suspend the current coroutine and wait the result, it cannot be interrupted
+         * because the thread pool may be still accessing the buffers of this coroutine
+         *
+         * the result may be posted before suspending it, but the inbox is only handled by the io loop on this thread
+         */
+        scheduler->running->profile_waiting = TB_COROUTINE_WAITING_IO;
+        result = (tb_long_t)tb_co_scheduler_suspend(scheduler, tb_null);
+
+        // the cached socket events may be stale now, we need check them again when waiting them
+        scheduler->running->waitcalled = 1;
+
+        // remove it from the in-flight calls
+        tb_list_entry_remove(&scheduler->calls, &call->entry);
+
+        // release the reference of the waiting coroutine, the user private data will be exited with the last reference
+        tb_co_scheduler_call_release(call);
+        return result;
+
+    } while (0);
+
+    // exit the user private data
+    if (exit) exit(priv);
+    return result;
+}
+tb_void_t tb_co_scheduler_settings_set(tb_co_scheduler_t* scheduler, tb_size_t flags, tb_co_scheduler_settings_t const* settings)
+{
+    // check
+    tb_assert(scheduler && settings);
+
+    // apply them directly if we are in this scheduler or it's not a worker
+    if (!scheduler->worker || scheduler == (tb_co_scheduler_t*)tb_co_scheduler_self())
+    {
+        tb_co_scheduler_settings_apply(scheduler, flags, settings);
+        return ;
+    }
+
+    // post them to the owner scheduler, the later settings will override the previous settings
+    tb_spinlock_enter(&scheduler->settings_lock);
+    if (flags & TB_CO_SCHEDULER_SETTING_PROFILE)
+        scheduler->settings.profile = settings->profile;
+    if (flags & TB_CO_SCHEDULER_SETTING_SLOW)
+    {
+        scheduler->settings.slow_threshold  = settings->slow_threshold;
+        scheduler->settings.slow_func       = settings->slow_func;
+        scheduler->settings.slow_priv       = settings->slow_priv;
+    }
+    if (flags & TB_CO_SCHEDULER_SETTING_BUSYPOLL)
+        scheduler->settings.busypoll = settings->busypoll;
+    if (flags & TB_CO_SCHEDULER_SETTING_TIMEOUT_SLACK)
+        scheduler->settings.timeout_slack = settings->timeout_slack;
+    tb_atomic32_fetch_and_or(&scheduler->settings_flags, (tb_int32_t)flags);
+    tb_spinlock_leave(&scheduler->settings_lock);
+
+    // wake up the io loop of the owner scheduler to apply them
+    if (scheduler->scheduler_io && scheduler->scheduler_io->poller)
+        tb_poller_spak(scheduler->scheduler_io->poller);
+}
+tb_void_t tb_co_scheduler_call_orphan(tb_co_scheduler_t* scheduler)
+{
+    // check
+    tb_assert(scheduler);
+
+    // orphan all in-flight calls and wait them
+    while (tb_list_entry_size(&scheduler->calls))
+    {
+        // get the next call
+        tb_co_scheduler_call_t* call = (tb_co_scheduler_call_t*)tb_list_entry0(tb_list_entry_head(&scheduler->calls));
+        tb_assert(call);
+
+        // trace
+        tb_trace_d("orphan the blocking call of coroutine(%p)", call->coroutine);
+
+        // remove it from the in-flight calls
+        tb_list_entry_remove_head(&scheduler->calls);
+
+        // the waiting coroutine will not be resumed
+        tb_spinlock_enter(&call->lock);
+        call->scheduler = tb_null;
+        tb_spinlock_leave(&call->lock);
+
+        /* wait the thread pool to finish it
+         *
+         * the blocking function may be still accessing the buffers on the stack of the waiting coroutine,
+         * so we cannot free this coroutine and its stack before finishing it
+         */
+        while (!tb_atomic32_get(&call->finished)) tb_msleep(1);
+
+        // release the reference of the waiting coroutine
+        tb_co_scheduler_call_release(call);
+    }
+}
@@ -27,6 +27,8 @@
  */
 #include "prefix.h"
 #include "coroutine.h"
+#include "stack_pool.h"
+#include "worker.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -56,6 +58,84 @@ __tb_extern_c_enter__
 // the io scheduler type
 struct __tb_co_scheduler_io_t;
 
+// the scheduler type
+struct __tb_co_scheduler_t;
+
+// the scheduler setting flag enum
+typedef enum __tb_co_scheduler_setting_e
+{
+    TB_CO_SCHEDULER_SETTING_PROFILE         = 1
+,   TB_CO_SCHEDULER_SETTING_SLOW            = 2
+,   TB_CO_SCHEDULER_SETTING_BUSYPOLL        = 4
+,   TB_CO_SCHEDULER_SETTING_TIMEOUT_SLACK   = 8
+
+}tb_co_scheduler_setting_e;
+
+// the scheduler settings type, they may be posted from the other threads
+typedef struct __tb_co_scheduler_settings_t
+{
+    // enable the coroutine profiling?
+    tb_bool_t                       profile;
+
+    // the slow coroutine threshold (us)
+    tb_size_t                       slow_threshold;
+
+    // the slow coroutine function
+    tb_co_scheduler_slow_func_t     slow_func;
+
+    // the user private data of the slow coroutine function
+    tb_cpointer_t                   slow_priv;
+
+    // the busy-polling timeout (us) before blocking in the poller
+    tb_size_t                       busypoll;
+
+    // the io timeout slack (ms) of the deadline timeout mode
+    tb_size_t                       timeout_slack;
+
+}tb_co_scheduler_settings_t;
+
+/* the blocking call type of tb_coroutine_waitcall()
+ *
+ * it's referenced by the waiting coroutine and the thread pool task,
+ * and it will be orphaned if the scheduler is exited before finishing it.
+ */
+typedef struct __tb_co_scheduler_call_t
+{
+    // the list entry of the in-flight calls of the scheduler
+    tb_list_entry_t                 entry;
+
+    // the reference count
+    tb_atomic32_t                   refn;
+
+    // the lock of the owner scheduler
+    tb_spinlock_t                   lock;
+
+    // the owner scheduler, it will be cleared if this call has been orphaned
+    struct __tb_co_scheduler_t*     scheduler;
+
+    // the waiting coroutine
+    tb_coroutine_t*                 coroutine;
+
+    // the blocking function
+    tb_coroutine_call_func_t        func;
+
+    // the exit function of the user private data
+    tb_coroutine_call_exit_func_t   exit;
+
+    // the user private data
+    tb_cpointer_t                   priv;
+
+    // the result
+    tb_long_t                       result;
+
+    // has been done on the thread pool?
+    tb_bool_t                       done;
+
+    // has been finished or killed on the thread pool? the waiting coroutine cannot be freed before it
+    tb_atomic32_t                   finished;
+
+}tb_co_scheduler_call_t;
+
 // the scheduler type
 typedef struct __tb_co_scheduler_t
 {
@@ -74,6 +154,51 @@ typedef struct __tb_co_scheduler_t
     // the io scheduler
     struct __tb_co_scheduler_io_t*  scheduler_io;
 
+    // the stack pool
+    tb_co_stack_pool_t*             stack_pool;
+
+    // the worker for the M:N mode, it's null for the single-threaded scheduler
+    tb_co_worker_t*                 worker;
+
+    // the busy-polling timeout (us) before blocking in the poller, disabled if be zero
+    tb_size_t                       busypoll;
+
+    // the io timeout slack (ms) of the deadline timeout mode, disabled if be zero
+    tb_size_t                       timeout_slack;
+
+    // the stats, it's only updated by the io loop
+    tb_co_scheduler_stats_t         stats;
+
+    // enable the coroutine profiling?
+    tb_bool_t                       profile;
+
+    // the last switched time (us) for profiling
+    tb_hong_t                       profile_clock;
+
+    // the slow coroutine threshold (us)
+    tb_size_t                       slow_threshold;
+
+    // the slow coroutine function
+    tb_co_scheduler_slow_func_t     slow_func;
+
+    // the user private data of the slow coroutine function
+    tb_cpointer_t                   slow_priv;
+
+    // the lock of the posted settings
+    tb_spinlock_t                   settings_lock;
+
+    // the flags of the posted settings, they will be applied by the io loop of this scheduler
+    tb_atomic32_t                   settings_flags;
+
+    // the posted settings
+    tb_co_scheduler_settings_t      settings;
+
+    /* the inbox of the suspended coroutines which are resumed from the other threads
+     *
+     * it's a lock-free stack linked by coroutine->remote_next and it will be taken all at once by the io loop
+     */
+    tb_atomic_t                     inbox;
+
     // the dead coroutines
     tb_list_entry_head_t            coroutines_dead;
 
@@ -88,6 +213,9 @@ typedef struct __tb_co_scheduler_t
     // the suspend coroutines
     tb_list_entry_head_t            coroutines_suspend;
 
+    // the in-flight blocking calls on the thread pool
+    tb_list_entry_head_t            calls;
+
 }tb_co_scheduler_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -105,6 +233,50 @@ typedef struct __tb_co_scheduler_t
  */
 tb_bool_t                   tb_co_scheduler_start(tb_co_scheduler_t* scheduler, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize);
 
+/* start the coroutine function with the given handle, it will be pinned to this scheduler
+ *
+ * @param scheduler         the scheduler, uses the default scheduler if be null
+ * @param func              the coroutine function
+ * @param priv              the passed user private data as the argument of function
+ * @param stacksize         the stack size
+ * @param handle            the coroutine handle
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_co_scheduler_start_handle(tb_co_scheduler_t* scheduler, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize, tb_co_handle_t* handle);
+
+/* start the internal coroutine function, it will be pinned to this scheduler, e.g. io loop
+ *
+ * @param scheduler         the scheduler
+ * @param func              the coroutine function
+ * @param priv              the passed user private data as the argument of function
+ * @param stacksize         the stack size
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_co_scheduler_start_internal(tb_co_scheduler_t* scheduler, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize);
+
+/* post a suspended coroutine to the owner scheduler from the other thread and wake up its io loop
+ *
+ * @param scheduler         the owner scheduler of this coroutine
+ * @param coroutine         the suspended coroutine
+ * @param priv              the user private data as the return value of suspend()
+ */
+tb_void_t                   tb_co_scheduler_post(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine, tb_cpointer_t priv);
+
+/* schedule the ready coroutines from the other threads
+ *
+ * resume the posted coroutines from the other threads,
+ * and pull some ready coroutines from the local run queue or steal them from the other workers (M:N)
+ *
+ * @note it's only called in the io loop, so the posted coroutines have been suspended completely
+ *
+ * @param scheduler         the scheduler
+ *
+ * @return                  the new ready coroutines count
+ */
+tb_size_t                   tb_co_scheduler_schedule(tb_co_scheduler_t* scheduler);
+
 /* yield the current coroutine
  *
  * @param scheduler         the scheduler
@@ -154,6 +326,14 @@ tb_pointer_t                tb_co_scheduler_sleep(tb_co_scheduler_t* scheduler,
  */
 tb_void_t                   tb_co_scheduler_switch(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine);
 
+/* account the running time of the current coroutine for profiling and restart it
+ *
+ * the io loop will call it before blocking in the poller, so the blocking time will be not counted
+ *
+ * @param scheduler         the scheduler
+ */
+tb_void_t                   tb_co_scheduler_profile_sync(tb_co_scheduler_t* scheduler);
+
 /* wait io events
  *
  * @param scheduler         the scheduler
@@ -187,6 +367,37 @@ tb_long_t                   tb_co_scheduler_wait_proc(tb_co_scheduler_t* schedul
  */
 tb_long_t                   tb_co_scheduler_wait_fwatcher(tb_co_scheduler_t* scheduler, tb_poller_object_ref_t object, tb_fwatcher_event_t* pevent, tb_long_t timeout);
 
+/* wait the blocking call on the global thread pool
+ *
+ * @param scheduler         the scheduler
+ * @param func              the blocking function
+ * @param exit              the exit function of the user private data
+ * @param priv              the user private data
+ *
+ * @return                  the result of the blocking function, -1 if it has been stopped or cancelled
+ */
+tb_long_t                   tb_co_scheduler_wait_call(tb_co_scheduler_t* scheduler, tb_coroutine_call_func_t func, tb_coroutine_call_exit_func_t exit, tb_cpointer_t priv);
+
+/* change the settings of the scheduler
+ *
+ * they will be applied directly if we are in this scheduler or it's not a worker,
+ * otherwise they will be posted to the scheduler and be applied by its io loop.
+ *
+ * @param scheduler         the scheduler
+ * @param flags             the changed setting flags
+ * @param settings          the settings
+ */
+tb_void_t                   tb_co_scheduler_settings_set(tb_co_scheduler_t* scheduler, tb_size_t flags, tb_co_scheduler_settings_t const* settings);
+
+/* orphan all in-flight blocking calls and wait them before exiting the scheduler
+ *
+ * it will block until the thread pool has finished them, because they may be accessing the stacks of the waiting coroutines,
+ * and the late completions will only release their references and will not resume the waiting coroutines
+ *
+ * @param scheduler         the scheduler
+ */
+tb_void_t                   tb_co_scheduler_call_orphan(tb_co_scheduler_t* scheduler);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -31,21 +31,19 @@
  */
 #include "scheduler_io.h"
 #include "coroutine.h"
+#include "select.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
  */
 
-// the ltimer grow
+// the timer grow
 #ifdef __tb_small__
-#   define TB_SCHEDULER_IO_LTIMER_GROW      (64)
+#   define TB_SCHEDULER_IO_TIMER_GROW       (64)
 #else
-#   define TB_SCHEDULER_IO_LTIMER_GROW      (4096)
+#   define TB_SCHEDULER_IO_TIMER_GROW       (4096)
 #endif
 
-// the timer grow
-#define TB_SCHEDULER_IO_TIMER_GROW          (TB_SCHEDULER_IO_LTIMER_GROW >> 4)
-
 // the poller object data grow
 #ifdef __tb_small__
 #   define TB_SCHEDULER_IO_POLLERDATA_GROW    (64)
@@ -67,14 +65,25 @@ static tb_void_t tb_co_scheduler_io_resume(tb_co_scheduler_t* scheduler, tb_coro
         tb_assert(scheduler_io && scheduler_io->poller);
 
         // remove the timer task
-        if (coroutine->rs.wait.is_ltimer) tb_ltimer_task_exit(scheduler_io->ltimer, (tb_ltimer_task_ref_t)task);
-        else tb_timer_task_exit(scheduler_io->timer, (tb_timer_task_ref_t)task);
+        tb_wtimer_task_exit(scheduler_io->timer, (tb_wtimer_task_ref_t)task);
         coroutine->rs.wait.task = tb_null;
     }
 
     // resume the coroutine
     tb_co_scheduler_resume(scheduler, coroutine,  (tb_cpointer_t)((events & TB_POLLER_EVENT_ERROR)? -1 : events));
 }
+static tb_void_t tb_co_scheduler_io_unwait(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine)
+{
+    // reset the waited coroutines in the poller object data
+    tb_size_t object_type = coroutine->rs.wait.object.type;
+    if (object_type == TB_POLLER_OBJECT_PROC || object_type == TB_POLLER_OBJECT_FWATCHER)
+        coroutine->rs.wait.object_waiting = 0;
+    else if (object_type)
+    {
+        tb_co_scheduler_io_ref_t scheduler_io = tb_co_scheduler_io(scheduler);
+        if (scheduler_io) tb_co_scheduler_io_wait_remove(scheduler_io, coroutine, &coroutine->rs.wait.object);
+    }
+}
 static tb_void_t tb_co_scheduler_io_timeout(tb_bool_t killed, tb_cpointer_t priv)
 {
     // check
@@ -91,33 +100,46 @@ static tb_void_t tb_co_scheduler_io_timeout(tb_bool_t killed, tb_cpointer_t priv
     // resume the waited coroutine if timer task has been not canceled
     if (!killed)
     {
-        // reset the waited coroutines in the poller object data
-        tb_size_t object_type = coroutine->rs.wait.object.type;
-        if (object_type == TB_POLLER_OBJECT_PROC || object_type == TB_POLLER_OBJECT_FWATCHER)
-            coroutine->rs.wait.object_waiting = 0;
-        else if (object_type)
-        {
-            tb_co_scheduler_io_ref_t   scheduler_io = tb_co_scheduler_io(scheduler);
-            tb_co_pollerdata_io_ref_t  pollerdata = (tb_co_pollerdata_io_ref_t)(scheduler_io? tb_pollerdata_get(&scheduler_io->pollerdata, &coroutine->rs.wait.object) : tb_null);
-            if (pollerdata)
-            {
-                if (coroutine == pollerdata->co_recv)
-                    pollerdata->co_recv = tb_null;
-                if (coroutine == pollerdata->co_send)
-                    pollerdata->co_send = tb_null;
-            }
-        }
+        // stop waiting the poller object
+        tb_co_scheduler_io_unwait(scheduler, coroutine);
 
         // resume the coroutine
         tb_co_scheduler_io_resume(scheduler, coroutine, TB_POLLER_EVENT_NONE);
     }
 }
+static tb_void_t tb_co_scheduler_io_interrupt(tb_coroutine_t* coroutine, tb_cpointer_t priv)
+{
+    // check
+    tb_assert(coroutine);
+
+    // get scheduler
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)tb_coroutine_scheduler(coroutine);
+    tb_assert(scheduler);
+
+    // trace
+    tb_trace_d("coroutine(%p): %s interrupted", coroutine, coroutine->rs.wait.object.type? "poller object" : "sleep");
+
+    // stop waiting the poller object
+    tb_co_scheduler_io_unwait(scheduler, coroutine);
+
+    // resume the coroutine with the failed result
+    tb_co_scheduler_io_resume(scheduler, coroutine, TB_POLLER_EVENT_ERROR);
+}
+static tb_void_t tb_co_scheduler_io_resume_object(tb_co_scheduler_io_ref_t scheduler_io, tb_coroutine_t* coroutine, tb_poller_object_ref_t object, tb_size_t events)
+{
+    // is selecting? notify the select, it will stop waiting the other cases
+    if (coroutine->select) tb_co_select_wake_io(coroutine->select, object, events);
+    else tb_co_scheduler_io_resume(scheduler_io->scheduler, coroutine, events);
+}
 static tb_void_t tb_co_scheduler_io_events(tb_poller_ref_t poller, tb_poller_object_ref_t object, tb_long_t events, tb_cpointer_t priv)
 {
     // check
     tb_co_scheduler_io_ref_t scheduler_io = (tb_co_scheduler_io_ref_t)tb_poller_priv(poller);
     tb_assert(scheduler_io && scheduler_io->scheduler && object);
 
+    // update the events count
+    scheduler_io->scheduler->stats.events++;
+
     // is process/fwatcher object?
     if (object->type == TB_POLLER_OBJECT_PROC || object->type == TB_POLLER_OBJECT_FWATCHER)
     {
@@ -165,20 +187,20 @@ static tb_void_t tb_co_scheduler_io_events(tb_poller_ref_t poller, tb_poller_obj
     {
         pollerdata->co_recv = tb_null;
         pollerdata->co_send = tb_null;
-        tb_co_scheduler_io_resume(scheduler_io->scheduler, co_recv, events);
+        tb_co_scheduler_io_resume_object(scheduler_io, co_recv, object, events);
     }
     else
     {
         if (co_recv)
         {
             pollerdata->co_recv = tb_null;
-            tb_co_scheduler_io_resume(scheduler_io->scheduler, co_recv, events & ~TB_POLLER_EVENT_SEND);
+            tb_co_scheduler_io_resume_object(scheduler_io, co_recv, object, events & ~TB_POLLER_EVENT_SEND);
             events &= ~TB_POLLER_EVENT_RECV;
         }
         if (co_send)
         {
             pollerdata->co_send = tb_null;
-            tb_co_scheduler_io_resume(scheduler_io->scheduler, co_send, events & ~TB_POLLER_EVENT_RECV);
+            tb_co_scheduler_io_resume_object(scheduler_io, co_send, object, events & ~TB_POLLER_EVENT_RECV);
             events &= ~TB_POLLER_EVENT_SEND;
         }
 
@@ -194,28 +216,240 @@ static tb_void_t tb_co_scheduler_io_events(tb_poller_ref_t poller, tb_poller_obj
         }
     }
 }
+static tb_hong_t tb_co_scheduler_io_deadline_next(tb_co_pollerdata_io_ref_t pollerdata)
+{
+    // get the nearest deadline of the waiting coroutines, the deadlines of the finished waitings are stale
+    tb_hong_t deadline = 0;
+    if (pollerdata->co_recv && pollerdata->deadline_recv) deadline = pollerdata->deadline_recv;
+    if (pollerdata->co_send && pollerdata->deadline_send && (!deadline || pollerdata->deadline_send < deadline))
+        deadline = pollerdata->deadline_send;
+    return deadline;
+}
+static tb_void_t tb_co_scheduler_io_deadline_link(tb_co_scheduler_io_ref_t scheduler_io, tb_co_pollerdata_io_ref_t pollerdata, tb_hong_t deadline)
+{
+    // get the window of this deadline, it will be never linked to the expired windows
+    tb_size_t slack = scheduler_io->deadline_slack;
+    tb_hong_t window = (deadline + slack - 1) / slack;
+    if (window < scheduler_io->deadline_window) window = scheduler_io->deadline_window;
+
+    // has been linked?
+    if (pollerdata->deadline_window)
+    {
+        // it's linked to the earlier window, we need not move it and it will be re-linked lazily after this window is expired
+        tb_check_return(pollerdata->deadline_window > window);
+
+        // move it to the earlier window
+        tb_list_entry_remove(&scheduler_io->deadline_slots[pollerdata->deadline_window % TB_CO_SCHEDULER_IO_DEADLINE_SLOTS], &pollerdata->deadline_entry);
+        scheduler_io->deadline_size--;
+    }
+
+    // link it to the slot of this window
+    tb_list_entry_insert_tail(&scheduler_io->deadline_slots[window % TB_CO_SCHEDULER_IO_DEADLINE_SLOTS], &pollerdata->deadline_entry);
+    pollerdata->deadline_window = window;
+    scheduler_io->deadline_size++;
+}
+static tb_void_t tb_co_scheduler_io_deadline_slack(tb_co_scheduler_io_ref_t scheduler_io, tb_size_t slack)
+{
+    // check
+    tb_assert(slack);
+
+    // detach all linked deadlines
+    tb_size_t               i = 0;
+    tb_list_entry_head_t    linked;
+    tb_list_entry_init(&linked, tb_co_pollerdata_io_t, deadline_entry, tb_null);
+    for (i = 0; i < TB_CO_SCHEDULER_IO_DEADLINE_SLOTS; i++)
+        tb_list_entry_splice_tail(&linked, &scheduler_io->deadline_slots[i]);
+
+    // reset the deadline windows with the new slack
+    scheduler_io->deadline_slack    = slack;
+    scheduler_io->deadline_window   = tb_cache_time_mclock() / slack;
+    scheduler_io->deadline_size     = 0;
+
+    // re-link them to the new windows
+    while (tb_list_entry_size(&linked))
+    {
+        tb_co_pollerdata_io_ref_t pollerdata = (tb_co_pollerdata_io_ref_t)tb_list_entry(&linked, tb_list_entry_head(&linked));
+        tb_list_entry_remove_head(&linked);
+        pollerdata->deadline_window = 0;
+
+        tb_hong_t deadline = tb_co_scheduler_io_deadline_next(pollerdata);
+        if (deadline) tb_co_scheduler_io_deadline_link(scheduler_io, pollerdata, deadline);
+    }
+    tb_list_entry_exit(&linked);
+}
+static tb_void_t tb_co_scheduler_io_deadline_check(tb_co_scheduler_io_ref_t scheduler_io, tb_co_pollerdata_io_ref_t pollerdata, tb_hong_t now)
+{
+    // the waiting recv is timeout?
+    tb_coroutine_t* coroutine = pollerdata->co_recv;
+    if (coroutine && pollerdata->deadline_recv && pollerdata->deadline_recv <= now)
+    {
+        // the same coroutine may wait recv and send at same time
+        pollerdata->deadline_recv = 0;
+        if (coroutine == pollerdata->co_send) pollerdata->deadline_send = 0;
+
+        // stop waiting and resume it with the timeout result
+        tb_co_scheduler_io_timeout(tb_false, coroutine);
+    }
+
+    // the waiting send is timeout?
+    coroutine = pollerdata->co_send;
+    if (coroutine && pollerdata->deadline_send && pollerdata->deadline_send <= now)
+    {
+        pollerdata->deadline_send = 0;
+        tb_co_scheduler_io_timeout(tb_false, coroutine);
+    }
+
+    // re-link the later deadline if it's still waiting
+    tb_hong_t deadline = tb_co_scheduler_io_deadline_next(pollerdata);
+    if (deadline) tb_co_scheduler_io_deadline_link(scheduler_io, pollerdata, deadline);
+}
+static tb_void_t tb_co_scheduler_io_deadline_spak(tb_co_scheduler_io_ref_t scheduler_io)
+{
+    // no deadlines?
+    tb_check_return(scheduler_io->deadline_size);
+
+    // get the current window, all windows before it and itself are expired
+    tb_size_t slack         = scheduler_io->deadline_slack;
+    tb_hong_t now           = tb_cache_time_mclock();
+    tb_hong_t window_now    = now / slack;
+    tb_hong_t window        = scheduler_io->deadline_window;
+    tb_check_return(window <= window_now);
+
+    // each slot need be only checked once if too many windows are expired
+    if (window + TB_CO_SCHEDULER_IO_DEADLINE_SLOTS <= window_now)
+        window = window_now - TB_CO_SCHEDULER_IO_DEADLINE_SLOTS + 1;
+
+    // the later deadlines will be re-linked after the current window
+    scheduler_io->deadline_window = window_now + 1;
+
+    // check the deadlines of all expired windows in batch, they are coalesced into the same wakeup
+    tb_list_entry_head_t expired;
+    tb_list_entry_init(&expired, tb_co_pollerdata_io_t, deadline_entry, tb_null);
+    for (; window <= window_now && scheduler_io->deadline_size; window++)
+    {
+        // detach the deadlines of this slot
+        tb_list_entry_head_ref_t slot = &scheduler_io->deadline_slots[window % TB_CO_SCHEDULER_IO_DEADLINE_SLOTS];
+        tb_check_continue(tb_list_entry_size(slot));
+        tb_list_entry_splice_tail(&expired, slot);
+        scheduler_io->deadline_size -= tb_list_entry_size(&expired);
+
+        // check them, the stale deadlines of the finished waitings will be dropped
+        while (tb_list_entry_size(&expired))
+        {
+            tb_co_pollerdata_io_ref_t pollerdata = (tb_co_pollerdata_io_ref_t)tb_list_entry(&expired, tb_list_entry_head(&expired));
+            tb_list_entry_remove_head(&expired);
+            pollerdata->deadline_window = 0;
+            tb_co_scheduler_io_deadline_check(scheduler_io, pollerdata, now);
+        }
+    }
+    tb_list_entry_exit(&expired);
+}
+static tb_size_t tb_co_scheduler_io_deadline_delay(tb_co_scheduler_io_ref_t scheduler_io)
+{
+    // no deadlines?
+    tb_check_return_val(scheduler_io->deadline_size, -1);
+
+    // find the nearest linked window, it may be earlier than the real deadline if it is linked in the later round
+    tb_size_t i = 0;
+    tb_hong_t window = scheduler_io->deadline_window;
+    for (i = 0; i < TB_CO_SCHEDULER_IO_DEADLINE_SLOTS; i++, window++)
+    {
+        if (tb_list_entry_size(&scheduler_io->deadline_slots[window % TB_CO_SCHEDULER_IO_DEADLINE_SLOTS])) break;
+    }
+
+    // wait until the end of this window
+    tb_hong_t now = tb_cache_time_mclock();
+    tb_hong_t when = window * scheduler_io->deadline_slack;
+    return when > now? (tb_size_t)(when - now) : 0;
+}
+static tb_void_t tb_co_scheduler_io_deadline_insert(tb_co_scheduler_io_ref_t scheduler_io, tb_poller_object_ref_t object, tb_size_t events, tb_long_t timeout)
+{
+    // get the poller object data, it has been allocated when inserting the poller object
+    tb_co_pollerdata_io_ref_t pollerdata = (tb_co_pollerdata_io_ref_t)tb_pollerdata_get(&scheduler_io->pollerdata, object);
+    tb_assert_and_check_return(pollerdata);
+
+    // the slack has been changed? re-link all deadlines
+    tb_size_t slack = scheduler_io->scheduler->timeout_slack;
+    if (slack != scheduler_io->deadline_slack) tb_co_scheduler_io_deadline_slack(scheduler_io, slack);
+
+    // coalesce the deadline to the end of the slack window
+    tb_hong_t now = tb_cache_time_mclock();
+    if (!scheduler_io->deadline_size) scheduler_io->deadline_window = now / slack;
+    tb_hong_t deadline = ((now + timeout + slack - 1) / slack) * slack;
+
+    // save the deadline to the poller object data, it need not be removed after waiting
+    if (events & TB_POLLER_EVENT_RECV) pollerdata->deadline_recv = deadline;
+    if (events & TB_POLLER_EVENT_SEND) pollerdata->deadline_send = deadline;
+
+    // link it to the deadline slot
+    tb_co_scheduler_io_deadline_link(scheduler_io, pollerdata, deadline);
+}
 static tb_bool_t tb_co_scheduler_io_timer_spak(tb_co_scheduler_io_ref_t scheduler_io)
 {
     // check
-    tb_assert(scheduler_io && scheduler_io->timer && scheduler_io->ltimer);
+    tb_assert(scheduler_io && scheduler_io->timer);
 
     // spak ctime
     tb_cache_time_spak();
 
+    // spak the deadlines
+    tb_co_scheduler_io_deadline_spak(scheduler_io);
+
     // spak timer
-    if (!tb_timer_spak(scheduler_io->timer)) return tb_false;
+    return tb_wtimer_spak(scheduler_io->timer);
+}
+static tb_bool_t tb_co_scheduler_io_spin(tb_co_scheduler_io_ref_t scheduler_io, tb_size_t timeout)
+{
+    // check
+    tb_co_scheduler_t* scheduler = scheduler_io->scheduler;
+    tb_assert(scheduler && scheduler->busypoll);
+
+    /* init the adaptive busy-polling timeout
+     *
+     * the waked up thread need run on the other cpu, so spinning will only delay it on the single cpu
+     */
+    tb_size_t busypoll_maxn = scheduler->busypoll;
+    tb_size_t busypoll_minn = tb_max(busypoll_maxn >> 4, 1);
+    if (!scheduler_io->busypoll || scheduler_io->busypoll > busypoll_maxn)
+        scheduler_io->busypoll = tb_cpu_count() > 1? busypoll_maxn : 0;
+    tb_check_return_val(scheduler_io->busypoll, tb_false);
+
+    // the busy-polling timeout (us), it cannot exceed the timer delay (ms)
+    tb_hong_t busypoll = scheduler_io->busypoll;
+    if (timeout < busypoll / 1000) busypoll = (tb_hong_t)timeout * 1000;
+    tb_check_return_val(busypoll > 0, tb_false);
+
+    // update the spins count
+    scheduler->stats.spins++;
+
+    // poll the io events, the posted and stolen coroutines without blocking
+    tb_hong_t stop = tb_uclock() + busypoll;
+    do
+    {
+        // poll the io events, the waiting coroutines will be resumed and all of them are only queued to the ready list
+        tb_long_t wait = tb_poller_wait(scheduler_io->poller, tb_co_scheduler_io_events, 0);
+        tb_check_break(wait >= 0);
+        scheduler->stats.waits++;
+
+        // got some ready coroutines? we need not block it now, and spin longer next time
+        if (tb_co_scheduler_schedule(scheduler) || tb_co_scheduler_ready_count(scheduler) > 1)
+        {
+            scheduler_io->busypoll = tb_min(scheduler_io->busypoll << 1, busypoll_maxn);
+            scheduler->stats.spin_hits++;
+            return tb_true;
+        }
 
-    // spak ltimer
-    if (!tb_ltimer_spak(scheduler_io->ltimer)) return tb_false;
+    } while (!scheduler->stopped && tb_uclock() < stop);
 
-    // pk
-    return tb_true;
+    // missed, spin shorter next time
+    scheduler_io->busypoll = tb_max(scheduler_io->busypoll >> 1, busypoll_minn);
+    return tb_false;
 }
 static tb_void_t tb_co_scheduler_io_loop(tb_cpointer_t priv)
 {
     // check
     tb_co_scheduler_io_ref_t scheduler_io = (tb_co_scheduler_io_ref_t)priv;
-    tb_assert_and_check_return(scheduler_io && scheduler_io->timer && scheduler_io->ltimer);
+    tb_assert_and_check_return(scheduler_io && scheduler_io->timer);
 
     // the scheduler
     tb_co_scheduler_t* scheduler = scheduler_io->scheduler;
@@ -225,35 +459,80 @@ static tb_void_t tb_co_scheduler_io_loop(tb_cpointer_t priv)
     tb_poller_ref_t poller = scheduler_io->poller;
     tb_assert_and_check_return(poller);
 
+    // the worker (M:N)
+    tb_co_worker_ref_t worker = scheduler->worker;
+
     // loop
     while (!scheduler->stopped)
     {
+        // resume the posted coroutines from the other threads and pull the ready coroutines of the worker group first
+        tb_co_scheduler_schedule(scheduler);
+
         // finish all other ready coroutines first
         while (tb_co_scheduler_yield(scheduler))
         {
             // spak timer
             if (!tb_co_scheduler_io_timer_spak(scheduler_io)) break;
-        }
 
-        // no more suspended coroutines? loop end
-        tb_check_break(tb_co_scheduler_suspend_count(scheduler));
+            // resume and pull more ready coroutines
+            tb_co_scheduler_schedule(scheduler);
+        }
 
-        // the delay
-        tb_size_t delay = tb_timer_delay(scheduler_io->timer);
+        /* no more suspended coroutines? loop end
+         *
+         * the worker will wait and steal the ready coroutines until the worker group is stopped (M:N)
+         */
+        if (worker)
+        {
+            if (tb_co_scheduler_schedule(scheduler)) continue;
+        }
+        else tb_check_break(tb_co_scheduler_suspend_count(scheduler));
 
-        // the ldelay
-        tb_size_t ldelay = tb_ltimer_delay(scheduler_io->ltimer);
+        // the delay of the nearest timer task or deadline window
+        tb_size_t delay = tb_min(tb_wtimer_delay(scheduler_io->timer), tb_co_scheduler_io_deadline_delay(scheduler_io));
 
         // trace
-        tb_trace_d("loop: wait %lu ms, %lu pending coroutines ..", tb_min(delay, ldelay), tb_co_scheduler_suspend_count(scheduler));
+        tb_trace_d("loop: wait %lu ms, %lu pending coroutines ..", delay, tb_co_scheduler_suspend_count(scheduler));
 
-        // no more ready coroutines? wait io events and timers
-        if (tb_poller_wait(poller, tb_co_scheduler_io_events, tb_min(delay, ldelay)) < 0)
+        // busy-poll it for a while before blocking in the poller if be enabled, it reduces the wakeup latency
+        if (scheduler->busypoll && tb_co_scheduler_io_spin(scheduler_io, delay))
+        {
+            // spak timer
+            if (!tb_co_scheduler_io_timer_spak(scheduler_io)) break;
+            continue;
+        }
+
+        // enter idle, it will be waked up by the other workers if there are new ready coroutines (M:N)
+        if (worker && !tb_co_worker_idle_enter(worker)) continue;
+
+        // account the running time of the io loop, the blocking time will be not counted
+        if (scheduler->profile) tb_co_scheduler_profile_sync(scheduler);
+
+        /* no more ready coroutines? wait io events and timers
+         *
+         * all events of this wakeup will be collected into the ready list first,
+         * because the callback only queues the waiting coroutines and does not switch to them,
+         * so we will run them in batch after waiting.
+         */
+        tb_long_t wait = tb_poller_wait(poller, tb_co_scheduler_io_events, delay);
+
+        // leave idle (M:N)
+        if (worker) tb_co_worker_idle_leave(worker);
+
+        // restart the running time of the io loop
+        if (scheduler->profile) scheduler->profile_clock = tb_uclock();
+
+        // failed?
+        if (wait < 0)
         {
             tb_trace_e("loop: wait poller failed!");
             break;
         }
 
+        // update the waits and wakeups count
+        scheduler->stats.waits++;
+        scheduler->stats.wakeups++;
+
         // trace
         tb_trace_d("loop: wait ok, left %lu pending coroutines ..", tb_co_scheduler_suspend_count(scheduler));
 
@@ -280,13 +559,9 @@ tb_co_scheduler_io_ref_t tb_co_scheduler_io_init(tb_co_scheduler_t* scheduler)
         scheduler_io->scheduler = (tb_co_scheduler_t*)scheduler;
 
         // init timer and using cache time
-        scheduler_io->timer = tb_timer_init(TB_SCHEDULER_IO_TIMER_GROW, tb_true);
+        scheduler_io->timer = tb_wtimer_init(TB_SCHEDULER_IO_TIMER_GROW, tb_true);
         tb_assert_and_check_break(scheduler_io->timer);
 
-        // init ltimer and using cache time
-        scheduler_io->ltimer = tb_ltimer_init(TB_SCHEDULER_IO_LTIMER_GROW, TB_LTIMER_TICK_S, tb_true);
-        tb_assert_and_check_break(scheduler_io->ltimer);
-
         // init poller
         scheduler_io->poller = tb_poller_init(scheduler_io);
         tb_assert_and_check_break(scheduler_io->poller);
@@ -301,8 +576,13 @@ tb_co_scheduler_io_ref_t tb_co_scheduler_io_init(tb_co_scheduler_t* scheduler)
         // init poller object data
         tb_pollerdata_init(&scheduler_io->pollerdata);
 
+        // init the deadline slots
+        tb_size_t i = 0;
+        for (i = 0; i < TB_CO_SCHEDULER_IO_DEADLINE_SLOTS; i++)
+            tb_list_entry_init(&scheduler_io->deadline_slots[i], tb_co_pollerdata_io_t, deadline_entry, tb_null);
+
         // start the io loop coroutine
-        if (!tb_co_scheduler_start(scheduler_io->scheduler, tb_co_scheduler_io_loop, scheduler_io, 0)) break;
+        if (!tb_co_scheduler_start_internal(scheduler_io->scheduler, tb_co_scheduler_io_loop, scheduler_io, 0)) break;
 
         // ok
         ok = tb_true;
@@ -325,6 +605,12 @@ tb_void_t tb_co_scheduler_io_exit(tb_co_scheduler_io_ref_t scheduler_io)
     // check
     tb_assert_and_check_return(scheduler_io);
 
+    // exit the deadline slots
+    tb_size_t i = 0;
+    for (i = 0; i < TB_CO_SCHEDULER_IO_DEADLINE_SLOTS; i++)
+        tb_list_entry_exit(&scheduler_io->deadline_slots[i]);
+    scheduler_io->deadline_size = 0;
+
     // exit poller object data
     tb_pollerdata_exit(&scheduler_io->pollerdata);
 
@@ -337,13 +623,9 @@ tb_void_t tb_co_scheduler_io_exit(tb_co_scheduler_io_ref_t scheduler_io)
     scheduler_io->poller = tb_null;
 
     // exit timer
-    if (scheduler_io->timer) tb_timer_exit(scheduler_io->timer);
+    if (scheduler_io->timer) tb_wtimer_exit(scheduler_io->timer);
     scheduler_io->timer = tb_null;
 
-    // exit ltimer
-    if (scheduler_io->ltimer) tb_ltimer_exit(scheduler_io->ltimer);
-    scheduler_io->ltimer = tb_null;
-
     // clear scheduler
     scheduler_io->scheduler = tb_null;
 
@@ -374,10 +656,7 @@ tb_void_t tb_co_scheduler_io_kill(tb_co_scheduler_io_ref_t scheduler_io)
     tb_trace_d("kill: ..");
 
     // kill timer
-    if (scheduler_io->timer) tb_timer_kill(scheduler_io->timer);
-
-    // kill ltimer
-    if (scheduler_io->ltimer) tb_ltimer_kill(scheduler_io->ltimer);
+    if (scheduler_io->timer) tb_wtimer_kill(scheduler_io->timer);
 
     // kill poller
     if (scheduler_io->poller) tb_poller_kill(scheduler_io->poller);
@@ -404,39 +683,27 @@ tb_pointer_t tb_co_scheduler_io_sleep(tb_co_scheduler_io_ref_t scheduler_io, tb_
     // infinity?
     if (interval > 0)
     {
-        // high-precision interval?
-        if (interval % 1000)
-        {
-            // post task to timer
-            tb_timer_task_post(scheduler_io->timer, interval, tb_false, tb_co_scheduler_io_timeout, coroutine);
-        }
-        // low-precision interval?
-        else
-        {
-            // post task to ltimer (faster)
-            tb_ltimer_task_post(scheduler_io->ltimer, interval, tb_false, tb_co_scheduler_io_timeout, coroutine);
-        }
+        // init task for timer, it will be removed if the sleeping coroutine is interrupted
+        coroutine->rs.wait.task = tb_wtimer_task_init(scheduler_io->timer, interval, tb_false, tb_co_scheduler_io_timeout, coroutine);
+        tb_assert_and_check_return_val(coroutine->rs.wait.task, tb_null);
     }
 
+    // it can be interrupted by tb_coroutine_cancel()
+    coroutine->interrupt        = tb_co_scheduler_io_interrupt;
+    coroutine->interrupt_priv   = tb_null;
+
     // suspend it
     return tb_co_scheduler_suspend(scheduler_io->scheduler, tb_null);
 }
-tb_long_t tb_co_scheduler_io_wait(tb_co_scheduler_io_ref_t scheduler_io, tb_poller_object_ref_t object, tb_size_t events, tb_long_t timeout)
+tb_long_t tb_co_scheduler_io_wait_insert(tb_co_scheduler_io_ref_t scheduler_io, tb_coroutine_t* coroutine, tb_poller_object_ref_t object, tb_size_t events)
 {
     // check
-    tb_assert(scheduler_io && object && scheduler_io->poller && scheduler_io->scheduler && events);
-
-    // get the current coroutine
-    tb_coroutine_t* coroutine = tb_co_scheduler_running(scheduler_io->scheduler);
-    tb_assert(coroutine);
+    tb_assert(scheduler_io && coroutine && object && scheduler_io->poller && scheduler_io->scheduler && events);
 
     // get the poller
     tb_poller_ref_t poller = scheduler_io->poller;
     tb_assert(poller);
 
-    // trace
-    tb_trace_d("coroutine(%p): wait events(%lu) with %ld ms for object(%p) ..", coroutine, events, timeout, object->ref.ptr);
-
     // get and allocate a poller object data
     tb_co_pollerdata_io_ref_t pollerdata = (tb_co_pollerdata_io_ref_t)tb_pollerdata_get(&scheduler_io->pollerdata, object);
     if (!pollerdata)
@@ -470,8 +737,17 @@ tb_long_t tb_co_scheduler_io_wait(tb_co_scheduler_io_ref_t scheduler_io, tb_poll
             // clear cache events
             pollerdata->poller_events_save = (tb_uint16_t)(events_prev_save & ~events);
 
-            // return the cached events
-            return events_prev_save & events;
+#ifndef TB_CONFIG_OS_WINDOWS
+            /* the cached edge-trigger events may be stale if this coroutine was suspended by tb_coroutine_waitcall(),
+             * and the socket has been read or written after these events were triggered,
+             * so we poll the socket again and we will wait the next events if it's not ready now
+             */
+            if (!coroutine->waitcalled || object->type != TB_POLLER_OBJECT_SOCK || tb_socket_wait(object->ref.sock, events & TB_SOCKET_EVENT_EALL, 0))
+#endif
+            {
+                // return the cached events
+                return events_prev_save & events;
+            }
         }
 
         // modify the wait events and reserve the pending events in other coroutine
@@ -509,42 +785,84 @@ tb_long_t tb_co_scheduler_io_wait(tb_co_scheduler_io_ref_t scheduler_io, tb_poll
         }
     }
 
-    // exists timeout?
-    tb_cpointer_t   task = tb_null;
-    tb_bool_t       is_ltimer = tb_false;
+    // save waiting events
+    pollerdata->poller_events_wait = (tb_uint16_t)events_wait;
+    pollerdata->poller_events_save = 0;
+
+    // the next events will be triggered after waiting them now
+    coroutine->waitcalled = 0;
+
+    // save the current coroutine, it has no deadline by default
+    if (events & TB_POLLER_EVENT_RECV)
+    {
+        pollerdata->co_recv         = coroutine;
+        pollerdata->deadline_recv   = 0;
+    }
+    if (events & TB_POLLER_EVENT_SEND)
+    {
+        pollerdata->co_send         = coroutine;
+        pollerdata->deadline_send   = 0;
+    }
+
+    // waiting now
+    return 0;
+}
+tb_void_t tb_co_scheduler_io_wait_remove(tb_co_scheduler_io_ref_t scheduler_io, tb_coroutine_t* coroutine, tb_poller_object_ref_t object)
+{
+    // check
+    tb_assert(scheduler_io && coroutine && object);
+
+    // reset the waited coroutine in the poller object data, the poller object is still attached to the poller
+    tb_co_pollerdata_io_ref_t pollerdata = (tb_co_pollerdata_io_ref_t)tb_pollerdata_get(&scheduler_io->pollerdata, object);
+    if (pollerdata)
+    {
+        if (coroutine == pollerdata->co_recv)
+            pollerdata->co_recv = tb_null;
+        if (coroutine == pollerdata->co_send)
+            pollerdata->co_send = tb_null;
+    }
+}
+tb_long_t tb_co_scheduler_io_wait(tb_co_scheduler_io_ref_t scheduler_io, tb_poller_object_ref_t object, tb_size_t events, tb_long_t timeout)
+{
+    // check
+    tb_assert(scheduler_io && object && scheduler_io->poller && scheduler_io->scheduler && events);
+
+    // get the current coroutine
+    tb_coroutine_t* coroutine = tb_co_scheduler_running(scheduler_io->scheduler);
+    tb_assert(coroutine);
+
+    // trace
+    tb_trace_d("coroutine(%p): wait events(%lu) with %ld ms for object(%p) ..", coroutine, events, timeout, object->ref.ptr);
+
+    // insert poller object to poller, return the cached events directly if exists
+    tb_long_t ok = tb_co_scheduler_io_wait_insert(scheduler_io, coroutine, object, events);
+    tb_check_return_val(!ok, ok);
+
+    /* exists timeout?
+     *
+     * we only save the deadline to the poller object data in the deadline timeout mode,
+     * it will be checked lazily and need not allocate and remove the timer task.
+     */
+    tb_cpointer_t task = tb_null;
     if (timeout >= 0)
     {
-        // high-precision interval?
-        if (timeout % 1000)
-        {
-            // init task for timer
-            task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-        }
-        // low-precision interval?
+        if (scheduler_io->scheduler->timeout_slack)
+            tb_co_scheduler_io_deadline_insert(scheduler_io, object, events, timeout);
         else
         {
-            // init task for ltimer (faster)
-            task = tb_ltimer_task_init(scheduler_io->ltimer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
+            // init task for timer
+            task = tb_wtimer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
             tb_assert_and_check_return_val(task, tb_false);
-
-            // mark as low-precision timer
-            is_ltimer = tb_true;
         }
     }
 
     // save the timer task to coroutine
     coroutine->rs.wait.task         = task;
     coroutine->rs.wait.object       = *object;
-    coroutine->rs.wait.is_ltimer    = is_ltimer;
 
-    // save waiting events
-    pollerdata->poller_events_wait = (tb_uint16_t)events_wait;
-    pollerdata->poller_events_save = 0;
-
-    // save the current coroutine
-    if (events & TB_POLLER_EVENT_RECV) pollerdata->co_recv = coroutine;
-    if (events & TB_POLLER_EVENT_SEND) pollerdata->co_send = coroutine;
+    // it can be interrupted by tb_coroutine_cancel()
+    coroutine->interrupt        = tb_co_scheduler_io_interrupt;
+    coroutine->interrupt_priv   = tb_null;
 
     // suspend the current coroutine and return the waited result
     return (tb_long_t)tb_co_scheduler_suspend(scheduler_io->scheduler, tb_null);
@@ -583,37 +901,25 @@ tb_long_t tb_co_scheduler_io_wait_proc(tb_co_scheduler_io_ref_t scheduler_io, tb
     }
 
     // exists timeout?
-    tb_cpointer_t   task = tb_null;
-    tb_bool_t       is_ltimer = tb_false;
+    tb_cpointer_t task = tb_null;
     if (timeout >= 0)
     {
-        // high-precision interval?
-        if (timeout % 1000)
-        {
-            // init task for timer
-            task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-        }
-        // low-precision interval?
-        else
-        {
-            // init task for ltimer (faster)
-            task = tb_ltimer_task_init(scheduler_io->ltimer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-
-            // mark as low-precision timer
-            is_ltimer = tb_true;
-        }
+        // init task for timer
+        task = tb_wtimer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
+        tb_assert_and_check_return_val(task, tb_false);
     }
 
     // save the timer task to coroutine
     coroutine->rs.wait.task           = task;
     coroutine->rs.wait.object         = *object;
-    coroutine->rs.wait.is_ltimer      = is_ltimer;
     coroutine->rs.wait.object_event   = 0;
     coroutine->rs.wait.object_pending = 0;
     coroutine->rs.wait.object_waiting = 1;
 
+    // it can be interrupted by tb_coroutine_cancel()
+    coroutine->interrupt        = tb_co_scheduler_io_interrupt;
+    coroutine->interrupt_priv   = tb_null;
+
     // suspend the current coroutine and return the waited result
     tb_long_t ok = (tb_long_t)tb_co_scheduler_suspend(scheduler_io->scheduler, tb_null);
     if (ok > 0 && pstatus) *pstatus = coroutine->rs.wait.object_event;
@@ -653,37 +959,25 @@ tb_long_t tb_co_scheduler_io_wait_fwatcher(tb_co_scheduler_io_ref_t scheduler_io
     }
 
     // exists timeout?
-    tb_cpointer_t   task = tb_null;
-    tb_bool_t       is_ltimer = tb_false;
+    tb_cpointer_t task = tb_null;
     if (timeout >= 0)
     {
-        // high-precision interval?
-        if (timeout % 1000)
-        {
-            // init task for timer
-            task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-        }
-        // low-precision interval?
-        else
-        {
-            // init task for ltimer (faster)
-            task = tb_ltimer_task_init(scheduler_io->ltimer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-
-            // mark as low-precision timer
-            is_ltimer = tb_true;
-        }
+        // init task for timer
+        task = tb_wtimer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
+        tb_assert_and_check_return_val(task, tb_false);
     }
 
     // save the timer task to coroutine
     coroutine->rs.wait.task           = task;
     coroutine->rs.wait.object         = *object;
-    coroutine->rs.wait.is_ltimer      = is_ltimer;
     coroutine->rs.wait.object_event   = 0;
     coroutine->rs.wait.object_pending = 0;
     coroutine->rs.wait.object_waiting = 1;
 
+    // it can be interrupted by tb_coroutine_cancel()
+    coroutine->interrupt        = tb_co_scheduler_io_interrupt;
+    coroutine->interrupt_priv   = tb_null;
+
     // suspend the current coroutine and return the waited result
     tb_long_t ok = (tb_long_t)tb_co_scheduler_suspend(scheduler_io->scheduler, tb_null);
     if (ok > 0 && pevent) *pevent = *((tb_fwatcher_event_t*)coroutine->rs.wait.object_event);
@@ -35,6 +35,17 @@
  */
 __tb_extern_c_enter__
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the deadline slots count of the deadline timeout mode
+#ifdef __tb_small__
+#   define TB_CO_SCHEDULER_IO_DEADLINE_SLOTS        (64)
+#else
+#   define TB_CO_SCHEDULER_IO_DEADLINE_SLOTS        (512)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -54,6 +65,22 @@ typedef struct __tb_co_pollerdata_io_t
     // the saved events for poller (triggered)
     tb_uint16_t         poller_events_save;
 
+    /* the deadline entry for the deadline timeout mode
+     *
+     * it's only linked to the deadline slot of the io scheduler and will be never removed when the waiting is finished,
+     * the stale deadlines will be dropped lazily when this slot is expired.
+     */
+    tb_list_entry_t     deadline_entry;
+
+    // the linked deadline window, it's not linked if be zero
+    tb_hong_t           deadline_window;
+
+    // the coalesced deadline (ms) for waiting recv, no timeout if be zero
+    tb_hong_t           deadline_recv;
+
+    // the coalesced deadline (ms) for waiting send, no timeout if be zero
+    tb_hong_t           deadline_send;
+
 }tb_co_pollerdata_io_t, *tb_co_pollerdata_io_ref_t;
 
 // the io scheduler type
@@ -69,10 +96,7 @@ typedef struct __tb_co_scheduler_io_t
     tb_poller_ref_t     poller;
 
     // the timer
-    tb_timer_ref_t      timer;
-
-    // the low-precision timer (faster)
-    tb_ltimer_ref_t     ltimer;
+    tb_wtimer_ref_t     timer;
 
     // the poller data
     tb_pollerdata_t     pollerdata;
@@ -80,6 +104,21 @@ typedef struct __tb_co_scheduler_io_t
     // the poller data pool
     tb_fixed_pool_ref_t pollerdata_pool;
 
+    // the current adaptive busy-polling timeout (us), it's grown on hits and shrunk on misses
+    tb_size_t           busypoll;
+
+    // the timeout slack (ms) of the linked deadlines, each deadline slot is one window of this slack
+    tb_size_t           deadline_slack;
+
+    // the next unexpired deadline window
+    tb_hong_t           deadline_window;
+
+    // the linked poller object data count
+    tb_size_t           deadline_size;
+
+    // the deadline slots, the deadline window is hashed to the slot by (window % slots)
+    tb_list_entry_head_t deadline_slots[TB_CO_SCHEDULER_IO_DEADLINE_SLOTS];
+
 }tb_co_scheduler_io_t, *tb_co_scheduler_io_ref_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -136,6 +175,27 @@ tb_pointer_t                tb_co_scheduler_io_sleep(tb_co_scheduler_io_ref_t sc
  */
 tb_long_t                   tb_co_scheduler_io_wait(tb_co_scheduler_io_ref_t scheduler_io, tb_poller_object_ref_t object, tb_size_t events, tb_long_t timeout);
 
+/*! insert the poller object for waiting io events of the given coroutine, but do not suspend it
+ *
+ * it's used to wait multiple poller objects in tb_co_select()
+ *
+ * @param scheduler_io      the io scheduler
+ * @param coroutine         the waiting coroutine
+ * @param object            the poller object, socket or pipe
+ * @param events            the waited events
+ *
+ * @return                  > 0: the cached events, 0: waiting, -1: failed
+ */
+tb_long_t                   tb_co_scheduler_io_wait_insert(tb_co_scheduler_io_ref_t scheduler_io, tb_coroutine_t* coroutine, tb_poller_object_ref_t object, tb_size_t events);
+
+/*! remove the waiting coroutine from the poller object, the next events will be cached
+ *
+ * @param scheduler_io      the io scheduler
+ * @param coroutine         the waiting coroutine
+ * @param object            the poller object, socket or pipe
+ */
+tb_void_t                   tb_co_scheduler_io_wait_remove(tb_co_scheduler_io_ref_t scheduler_io, tb_coroutine_t* coroutine, tb_poller_object_ref_t object);
+
 /*! wait process status
  *
  * @param scheduler_io      the io scheduler
@@ -0,0 +1,93 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        select.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_IMPL_SELECT_H
+#define TB_COROUTINE_IMPL_SELECT_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "channel.h"
+#include "../select.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the coroutine type
+struct __tb_coroutine_t;
+
+/* the select type
+ *
+ * it's placed on the stack of the selecting coroutine,
+ * and all waiting cases will be removed when one case is ready, timeout or interrupted,
+ * so it will be never resumed twice.
+ */
+typedef struct __tb_co_select_t
+{
+    // the selecting coroutine
+    struct __tb_coroutine_t*        coroutine;
+
+    // the cases
+    tb_co_select_case_ref_t         cases;
+
+    // the cases count
+    tb_size_t                       count;
+
+    // the channel waiters of all cases
+    tb_co_channel_waiter_ref_t      waiters;
+
+    // the timer task
+    tb_cpointer_t                   task;
+
+}tb_co_select_t, *tb_co_select_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* wake up the select after the channel operation of the given waiter has been done
+ *
+ * @param select        the select
+ * @param waiter        the channel waiter, it has been removed from the channel
+ */
+tb_void_t               tb_co_select_wake(tb_co_select_ref_t select, tb_co_channel_waiter_ref_t waiter);
+
+/* wake up the select after the io events of the given poller object have been triggered
+ *
+ * @param select        the select
+ * @param object        the poller object
+ * @param events        the triggered events
+ */
+tb_void_t               tb_co_select_wake_io(tb_co_select_ref_t select, tb_poller_object_ref_t object, tb_size_t events);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,181 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        stack_pool.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "stack_pool"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "stack_pool.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the free stack maximum count
+#ifdef __tb_small__
+#   define TB_CO_STACK_POOL_MAXN            (64)
+#else
+#   define TB_CO_STACK_POOL_MAXN            (256)
+#endif
+
+// the guard page count
+#define TB_CO_STACK_POOL_GUARDN             (1)
+
+// the hot size of the stack top, these pages will be kept when the stack is freed
+#define TB_CO_STACK_POOL_HOT                (16 * 1024)
+
+// the marks of the hot pages bottom, some of them will be overwritten if the stack was deeper
+#define TB_CO_STACK_POOL_MARK               ((tb_size_t)0xdeadbeef)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_co_stack_pool_mark(tb_co_stack_pool_t* pool, tb_byte_t* data, tb_size_t size)
+{
+    // no cold pages or the committed pages can be queried?
+    tb_check_return(size > pool->hot && pool->markn);
+
+    // fill the marks page at the bottom of the hot pages, it will only commit one page
+    tb_size_t* marks = (tb_size_t*)(data + size - pool->hot);
+    tb_size_t  i = 0;
+    for (i = 0; i < pool->markn; i++) marks[i] = TB_CO_STACK_POOL_MARK;
+}
+static tb_bool_t tb_co_stack_pool_deep(tb_co_stack_pool_t* pool, tb_byte_t* data, tb_size_t size)
+{
+    // no cold pages?
+    tb_check_return_val(size > pool->hot, tb_false);
+
+    /* have some cold pages been touched?
+     *
+     * @note we cannot check only one mark, because a large frame may skip over it
+     */
+    tb_size_t cold = size - pool->hot;
+    if (!pool->markn) return tb_virtual_memory_committed(data, cold) != 0;
+
+    // have some marks been overwritten?
+    tb_size_t* marks = (tb_size_t*)(data + cold);
+    tb_size_t  i = 0;
+    for (i = 0; i < pool->markn; i++)
+    {
+        if (marks[i] != TB_CO_STACK_POOL_MARK) return tb_true;
+    }
+    return tb_false;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_co_stack_pool_t* tb_co_stack_pool_init(tb_size_t size)
+{
+    // check
+    tb_size_t pagesize = tb_page_size();
+    tb_assert_and_check_return_val(pagesize && size && !(size & (pagesize - 1)), tb_null);
+
+    // make pool
+    tb_co_stack_pool_t* pool = tb_malloc0_type(tb_co_stack_pool_t);
+    tb_assert_and_check_return_val(pool, tb_null);
+
+    // init pool
+    pool->size  = size;
+    pool->guard = TB_CO_STACK_POOL_GUARDN * pagesize;
+    pool->hot   = tb_align(TB_CO_STACK_POOL_HOT, pagesize);
+
+    /* we need the marks page if we cannot query the committed pages
+     *
+     * @note the page of the pool has been touched, so it must be committed if it is supported
+     */
+    if (tb_virtual_memory_committed((tb_pointer_t)((tb_size_t)pool & ~(pagesize - 1)), pagesize) < 0)
+        pool->markn = pagesize / sizeof(tb_size_t);
+    return pool;
+}
+tb_void_t tb_co_stack_pool_exit(tb_co_stack_pool_t* pool)
+{
+    // check
+    tb_assert_and_check_return(pool);
+
+    // unmap all free stacks
+    while (pool->stacks)
+    {
+        tb_co_stack_free_t* stack = pool->stacks;
+        pool->stacks = stack->next;
+        tb_virtual_memory_guard_free((tb_byte_t*)&stack[1] - pool->size, pool->size, pool->guard);
+    }
+    pool->count = 0;
+
+    // exit it
+    tb_free(pool);
+}
+tb_byte_t* tb_co_stack_pool_malloc(tb_co_stack_pool_t* pool, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(pool && size, tb_null);
+
+    // reuse a free stack
+    tb_byte_t* data = tb_null;
+    if (size == pool->size && pool->stacks)
+    {
+        tb_co_stack_free_t* stack = pool->stacks;
+        pool->stacks = stack->next;
+        pool->count--;
+        data = (tb_byte_t*)&stack[1] - size;
+    }
+    // map a new stack
+    else data = (tb_byte_t*)tb_virtual_memory_guard_malloc(size, pool->guard);
+    tb_check_return_val(data, tb_null);
+
+    // set the marks
+    tb_co_stack_pool_mark(pool, data, size);
+
+    // trace
+    tb_trace_d("malloc: %p, size: %lu, free: %lu", data, size, pool->count);
+    return data;
+}
+tb_void_t tb_co_stack_pool_free(tb_co_stack_pool_t* pool, tb_byte_t* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return(pool && data && size);
+
+    // trace
+    tb_trace_d("free: %p, size: %lu, free: %lu", data, size, pool->count);
+
+    // unmap it if the stack size is not cached or the free stacks are too much
+    if (size != pool->size || pool->count >= TB_CO_STACK_POOL_MAXN)
+    {
+        tb_virtual_memory_guard_free(data, size, pool->guard);
+        return ;
+    }
+
+    // this stack was deeper than the hot pages? give the cold pages back to the system
+    if (tb_co_stack_pool_deep(pool, data, size))
+        tb_virtual_memory_decommit(data, size - pool->hot);
+
+    // cache it
+    tb_co_stack_free_t* stack = (tb_co_stack_free_t*)(data + size) - 1;
+    stack->next = pool->stacks;
+    pool->stacks = stack;
+    pool->count++;
+}
@@ -0,0 +1,126 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        stack_pool.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_IMPL_STACK_POOL_H
+#define TB_COROUTINE_IMPL_STACK_POOL_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the free stack type, be placed at the top of the free stack
+typedef struct __tb_co_stack_free_t
+{
+    // the next free stack
+    struct __tb_co_stack_free_t*    next;
+
+}tb_co_stack_free_t;
+
+/* the coroutine stack pool type
+ *
+ * the stacks are mapped with the guard pages, and the pages will be committed only when they are touched.
+ *
+ * <pre>
+ *
+ *  ----------------------------------------------------------------------
+ * | guard pages | ...... cold pages ...... | marks | hot pages  | head  |
+ *  ----------------------------------------------------------------------
+ *       fault  <-----------------------------  stack grows       |
+ *                                                              stack top
+ * </pre>
+ *
+ * the free stacks of the cached size will be recycled, and the cold pages of the deep stacks
+ * will be given back to the system when they are freed. we query the committed cold pages (e.g. mincore)
+ * to know whether the stack was deeper than the hot pages, or check the marks page if it is not supported.
+ */
+typedef struct __tb_co_stack_pool_t
+{
+    // the free stacks
+    tb_co_stack_free_t*             stacks;
+
+    // the free stack count
+    tb_size_t                       count;
+
+    // the cached stack size
+    tb_size_t                       size;
+
+    // the guard size
+    tb_size_t                       guard;
+
+    // the hot size
+    tb_size_t                       hot;
+
+    // the mark count at the bottom of the hot pages, only used if we cannot query the committed pages
+    tb_size_t                       markn;
+
+}tb_co_stack_pool_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init the stack pool
+ *
+ * @param size          the cached stack size, must be aligned by page size
+ *
+ * @return              the stack pool
+ */
+tb_co_stack_pool_t*     tb_co_stack_pool_init(tb_size_t size);
+
+/* exit the stack pool
+ *
+ * @param pool          the stack pool
+ */
+tb_void_t               tb_co_stack_pool_exit(tb_co_stack_pool_t* pool);
+
+/* allocate a stack
+ *
+ * @param pool          the stack pool
+ * @param size          the stack size, must be aligned by page size
+ *
+ * @return              the stack data (the lowest address)
+ */
+tb_byte_t*              tb_co_stack_pool_malloc(tb_co_stack_pool_t* pool, tb_size_t size);
+
+/* free the stack
+ *
+ * @param pool          the stack pool
+ * @param data          the stack data
+ * @param size          the stack size
+ */
+tb_void_t               tb_co_stack_pool_free(tb_co_stack_pool_t* pool, tb_byte_t* data, tb_size_t size);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
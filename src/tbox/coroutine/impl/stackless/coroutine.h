@@ -42,12 +42,9 @@ typedef struct __tb_lo_coroutine_rs_wait_t
     tb_poller_object_t          object;
 
 #ifndef TB_CONFIG_MICRO_ENABLE
-    // the timer task pointer for ltimer or timer
+    // the timer task pointer
     tb_cpointer_t               task;
 
-    // is ltimer?
-    tb_sint32_t                 is_ltimer     : 1;
-
     // the process status
     tb_long_t                   object_event;
 
@@ -84,12 +81,26 @@ typedef struct __tb_lo_coroutine_t
     // the scheduler
     tb_lo_scheduler_ref_t       scheduler;
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+    // the owner slab, it's null if this coroutine was allocated from the global allocator
+    tb_fixed_pool_ref_t         pool;
+
+    // the next posted coroutine in the inbox of scheduler
+    struct __tb_lo_coroutine_t* remote_next;
+
+    // is internal coroutine? e.g. the io loop
+    tb_uint8_t                  internal;
+#endif
+
     // the passed private data between resume() and suspend()
     union
     {
         // the arguments for wait()
         tb_lo_coroutine_rs_wait_t   wait;
 
+        // the next waiting coroutine in the wait queue, e.g. for rwlock, cond and waitgroup
+        struct __tb_lo_coroutine_t* waitq_next;
+
     }                           rs;
 
 }tb_lo_coroutine_t;
@@ -101,13 +112,14 @@ typedef struct __tb_lo_coroutine_t
 /* init coroutine
  *
  * @param scheduler     the scheduler
+ * @param pool          the coroutine slab, we will use the global allocator if it's null
  * @param func          the coroutine function
  * @param priv          the passed user private data as the argument of function
  * @param free          the user private data free function
  *
  * @return              the coroutine
  */
-tb_lo_coroutine_t*      tb_lo_coroutine_init(tb_lo_scheduler_ref_t scheduler, tb_lo_coroutine_func_t func, tb_cpointer_t priv, tb_lo_coroutine_free_t free);
+tb_lo_coroutine_t*      tb_lo_coroutine_init(tb_lo_scheduler_ref_t scheduler, tb_fixed_pool_ref_t pool, tb_lo_coroutine_func_t func, tb_cpointer_t priv, tb_lo_coroutine_free_t free);
 
 /* reinit the given coroutine
  *
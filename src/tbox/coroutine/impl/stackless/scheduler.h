@@ -25,6 +25,7 @@
  * includes
  */
 #include "coroutine.h"
+#include "worker.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -66,6 +67,20 @@ typedef struct __tb_lo_scheduler_t
     // the io scheduler
     struct __tb_lo_scheduler_io_t*  scheduler_io;
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+    // the worker of the sharded scheduler, it's null for the single-threaded scheduler
+    tb_lo_worker_ref_t              worker;
+
+    /* the inbox of the new coroutines which are started from the other workers
+     *
+     * it's a lock-free stack linked by coroutine->remote_next and it will be taken all at once by the io loop
+     */
+    tb_atomic_t                     inbox;
+
+    // the coroutine slab, the coroutines will be allocated from it and the global allocator is not touched in most cases
+    tb_fixed_pool_ref_t             coroutine_pool;
+#endif
+
     // the dead coroutines
     tb_list_entry_head_t            coroutines_dead;
 
@@ -97,6 +112,18 @@ typedef struct __tb_lo_scheduler_t
  */
 tb_bool_t               tb_lo_scheduler_start(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_func_t func, tb_cpointer_t priv, tb_lo_coroutine_free_t free);
 
+/* start an internal coroutine on the given scheduler, e.g. the io loop
+ *
+ * it will be not distributed to the other workers and not be counted as the user coroutines of the worker group
+ *
+ * @param scheduler     the scheduler
+ * @param func          the coroutine function
+ * @param priv          the passed user private data as the argument of function
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_lo_scheduler_start_internal(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_func_t func, tb_cpointer_t priv);
+
 /* resume the given coroutine
  *
  * @param scheduler     the scheduler
@@ -104,6 +131,23 @@ tb_bool_t               tb_lo_scheduler_start(tb_lo_scheduler_t* scheduler, tb_l
  */
 tb_void_t               tb_lo_scheduler_resume(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_t* coroutine);
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+/* post a new coroutine to the inbox of the given scheduler from the other threads
+ *
+ * @param scheduler     the owner scheduler of the coroutine
+ * @param coroutine     the new coroutine
+ */
+tb_void_t               tb_lo_scheduler_post(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_t* coroutine);
+
+/* take all posted coroutines from the inbox and make them as ready, it's called in the io loop
+ *
+ * @param scheduler     the scheduler
+ *
+ * @return              the taken coroutines count
+ */
+tb_size_t               tb_lo_scheduler_schedule(tb_lo_scheduler_t* scheduler);
+#endif
+
 /* get the current scheduler
  *
  * @return              the scheduler
@@ -37,16 +37,13 @@
  * macros
  */
 
-// the ltimer grow
+// the timer grow
 #ifdef __tb_small__
-#   define TB_SCHEDULER_IO_LTIMER_GROW      (64)
+#   define TB_SCHEDULER_IO_TIMER_GROW       (64)
 #else
-#   define TB_SCHEDULER_IO_LTIMER_GROW      (4096)
+#   define TB_SCHEDULER_IO_TIMER_GROW       (4096)
 #endif
 
-// the timer grow
-#define TB_SCHEDULER_IO_TIMER_GROW          (TB_SCHEDULER_IO_LTIMER_GROW >> 4)
-
 // the poller data grow
 #ifdef __tb_small__
 #   define TB_SCHEDULER_IO_POLLERDATA_GROW    (64)
@@ -69,8 +66,7 @@ static tb_void_t tb_lo_scheduler_io_resume(tb_lo_scheduler_t* scheduler, tb_lo_c
         tb_assert(scheduler_io && scheduler_io->poller);
 
         // remove the timer task
-        if (coroutine->rs.wait.is_ltimer) tb_ltimer_task_exit(scheduler_io->ltimer, (tb_ltimer_task_ref_t)task);
-        else tb_timer_task_exit(scheduler_io->timer, (tb_timer_task_ref_t)task);
+        tb_wtimer_task_exit(scheduler_io->timer, (tb_wtimer_task_ref_t)task);
         coroutine->rs.wait.task = tb_null;
     }
 #endif
@@ -211,33 +207,21 @@ static tb_void_t tb_lo_scheduler_io_events(tb_poller_ref_t poller, tb_poller_obj
 static tb_bool_t tb_lo_scheduler_io_timer_spak(tb_lo_scheduler_io_ref_t scheduler_io)
 {
     // check
-    tb_assert(scheduler_io && scheduler_io->timer && scheduler_io->ltimer);
+    tb_assert(scheduler_io && scheduler_io->timer);
 
     // spak ctime
     tb_cache_time_spak();
 
     // spak timer
-    if (!tb_timer_spak(scheduler_io->timer)) return tb_false;
-
-    // spak ltimer
-    if (!tb_ltimer_spak(scheduler_io->ltimer)) return tb_false;
-
-    // pk
-    return tb_true;
+    return tb_wtimer_spak(scheduler_io->timer);
 }
 static tb_long_t tb_lo_scheduler_io_timer_delay(tb_lo_scheduler_io_ref_t scheduler_io)
 {
     // check
-    tb_assert(scheduler_io && scheduler_io->timer && scheduler_io->ltimer);
-
-    // the delay
-    tb_size_t delay = tb_timer_delay(scheduler_io->timer);
-
-    // the ldelay
-    tb_size_t ldelay = tb_ltimer_delay(scheduler_io->ltimer);
+    tb_assert(scheduler_io && scheduler_io->timer);
 
     // return the timer delay
-    return tb_min(delay, ldelay);
+    return (tb_long_t)tb_wtimer_delay(scheduler_io->timer);
 }
 #else
 static __tb_inline__ tb_long_t tb_lo_scheduler_io_timer_delay(tb_lo_scheduler_io_ref_t scheduler_io)
@@ -270,11 +254,26 @@ static tb_void_t tb_lo_scheduler_io_loop(tb_lo_coroutine_ref_t coroutine, tb_cpo
 #ifndef TB_CONFIG_MICRO_ENABLE
                 // spak timer
                 if (!tb_lo_scheduler_io_timer_spak(scheduler_io)) break;
+
+                // start the new coroutines posted from the other workers (sharded)
+                if (scheduler->worker) tb_lo_scheduler_schedule(scheduler);
 #endif
             }
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+            // start the new coroutines posted from the other workers (sharded)
+            if (scheduler->worker && tb_lo_scheduler_schedule(scheduler)) continue;
+
+            /* no more suspended coroutines? loop end
+             *
+             * the worker need wait the new coroutines from the other workers until all coroutines of group have been finished
+             */
+            if (!tb_lo_scheduler_suspend_count(scheduler) && (!scheduler->worker || tb_atomic32_get(&scheduler->worker->group->finished)))
+                break;
+#else
             // no more suspended coroutines? loop end
             tb_check_break(tb_lo_scheduler_suspend_count(scheduler));
+#endif
 
             // trace
             tb_trace_d("loop: wait %ld ms ..", tb_lo_scheduler_io_timer_delay(scheduler_io));
@@ -316,12 +315,8 @@ tb_lo_scheduler_io_ref_t tb_lo_scheduler_io_init(tb_lo_scheduler_t* scheduler)
 
 #ifndef TB_CONFIG_MICRO_ENABLE
         // init timer and using cache time
-        scheduler_io->timer = tb_timer_init(TB_SCHEDULER_IO_TIMER_GROW, tb_true);
+        scheduler_io->timer = tb_wtimer_init(TB_SCHEDULER_IO_TIMER_GROW, tb_true);
         tb_assert_and_check_break(scheduler_io->timer);
-
-        // init ltimer and using cache time
-        scheduler_io->ltimer = tb_ltimer_init(TB_SCHEDULER_IO_LTIMER_GROW, TB_LTIMER_TICK_S, tb_true);
-        tb_assert_and_check_break(scheduler_io->ltimer);
 #endif
 
         // init poller data pool
@@ -332,7 +327,7 @@ tb_lo_scheduler_io_ref_t tb_lo_scheduler_io_init(tb_lo_scheduler_t* scheduler)
         tb_pollerdata_init(&scheduler_io->pollerdata);
 
         // start the io loop coroutine
-        if (!tb_lo_coroutine_start((tb_lo_scheduler_ref_t)scheduler, tb_lo_scheduler_io_loop, scheduler_io, tb_null)) break;
+        if (!tb_lo_scheduler_start_internal(scheduler, tb_lo_scheduler_io_loop, scheduler_io)) break;
 
         // ok
         ok = tb_true;
@@ -368,12 +363,8 @@ tb_void_t tb_lo_scheduler_io_exit(tb_lo_scheduler_io_ref_t scheduler_io)
 
 #ifndef TB_CONFIG_MICRO_ENABLE
     // exit timer
-    if (scheduler_io->timer) tb_timer_exit(scheduler_io->timer);
+    if (scheduler_io->timer) tb_wtimer_exit(scheduler_io->timer);
     scheduler_io->timer = tb_null;
-
-    // exit ltimer
-    if (scheduler_io->ltimer) tb_ltimer_exit(scheduler_io->ltimer);
-    scheduler_io->ltimer = tb_null;
 #endif
 
     // clear scheduler
@@ -407,10 +398,7 @@ tb_void_t tb_lo_scheduler_io_kill(tb_lo_scheduler_io_ref_t scheduler_io)
 
 #ifndef TB_CONFIG_MICRO_ENABLE
     // kill timer
-    if (scheduler_io->timer) tb_timer_kill(scheduler_io->timer);
-
-    // kill ltimer
-    if (scheduler_io->ltimer) tb_ltimer_kill(scheduler_io->ltimer);
+    if (scheduler_io->timer) tb_wtimer_kill(scheduler_io->timer);
 #endif
 
     // kill poller
@@ -436,18 +424,8 @@ tb_void_t tb_lo_scheduler_io_sleep(tb_lo_scheduler_io_ref_t scheduler_io, tb_lon
     // infinity?
     if (interval > 0)
     {
-        // high-precision interval?
-        if (interval % 1000)
-        {
-            // post task to timer
-            tb_timer_task_post(scheduler_io->timer, interval, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-        }
-        // low-precision interval?
-        else
-        {
-            // post task to ltimer (faster)
-            tb_ltimer_task_post(scheduler_io->ltimer, interval, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-        }
+        // post task to timer
+        tb_wtimer_task_post(scheduler_io->timer, interval, tb_false, tb_lo_scheduler_io_timeout, coroutine);
     }
 #else
     // not impl
@@ -548,32 +526,16 @@ tb_bool_t tb_lo_scheduler_io_wait(tb_lo_scheduler_io_ref_t scheduler_io, tb_poll
 
 #ifndef TB_CONFIG_MICRO_ENABLE
     // exists timeout?
-    tb_cpointer_t   task = tb_null;
-    tb_bool_t       is_ltimer = tb_false;
+    tb_cpointer_t task = tb_null;
     if (timeout >= 0)
     {
-        // high-precision interval?
-        if (timeout % 1000)
-        {
-            // init task for timer
-            task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-        }
-        // low-precision interval?
-        else
-        {
-            // init task for ltimer (faster)
-            task = tb_ltimer_task_init(scheduler_io->ltimer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-
-            // mark as low-precision timer
-            is_ltimer = tb_true;
-        }
+        // init task for timer
+        task = tb_wtimer_task_init(scheduler_io->timer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
+        tb_assert_and_check_return_val(task, tb_false);
     }
 
     // save the timer task to coroutine
     coroutine->rs.wait.task = task;
-    coroutine->rs.wait.is_ltimer = is_ltimer;
 #endif
     coroutine->rs.wait.object = *object;
     coroutine->rs.wait.result = 0;
@@ -625,33 +587,17 @@ tb_bool_t tb_lo_scheduler_io_wait_proc(tb_lo_scheduler_io_ref_t scheduler_io, tb
     }
 
     // exists timeout?
-    tb_cpointer_t   task = tb_null;
-    tb_bool_t       is_ltimer = tb_false;
+    tb_cpointer_t task = tb_null;
     if (timeout >= 0)
     {
-        // high-precision interval?
-        if (timeout % 1000)
-        {
-            // init task for timer
-            task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-        }
-        // low-precision interval?
-        else
-        {
-            // init task for ltimer (faster)
-            task = tb_ltimer_task_init(scheduler_io->ltimer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-
-            // mark as low-precision timer
-            is_ltimer = tb_true;
-        }
+        // init task for timer
+        task = tb_wtimer_task_init(scheduler_io->timer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
+        tb_assert_and_check_return_val(task, tb_false);
     }
 
     // save the timer task to coroutine
     coroutine->rs.wait.task           = task;
     coroutine->rs.wait.object         = *object;
-    coroutine->rs.wait.is_ltimer      = is_ltimer;
     coroutine->rs.wait.object_event   = 0;
     coroutine->rs.wait.object_pending = 0;
     coroutine->rs.wait.object_waiting = 1;
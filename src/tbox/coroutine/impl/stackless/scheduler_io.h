@@ -70,10 +70,7 @@ typedef struct __tb_lo_scheduler_io_t
 
 #ifndef TB_CONFIG_MICRO_ENABLE
     // the timer
-    tb_timer_ref_t      timer;
-
-    // the low-precision timer (faster)
-    tb_ltimer_ref_t     ltimer;
+    tb_wtimer_ref_t     timer;
 #endif
 
     // the poller data
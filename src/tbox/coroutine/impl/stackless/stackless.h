@@ -27,5 +27,6 @@
 #include "coroutine.h"
 #include "scheduler.h"
 #include "scheduler_io.h"
+#include "worker.h"
 
 #endif
@@ -0,0 +1,263 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        worker.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "worker"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "worker.h"
+#include "scheduler.h"
+#include "scheduler_io.h"
+#include "../../stackless/scheduler.h"
+
+#ifndef TB_CONFIG_MICRO_ENABLE
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_int_t tb_lo_worker_loop(tb_cpointer_t priv)
+{
+    // check
+    tb_lo_worker_ref_t worker = (tb_lo_worker_ref_t)priv;
+    tb_assert_and_check_return_val(worker && worker->scheduler, -1);
+
+    // trace
+    tb_trace_d("worker[%lu]: loop ..", worker->index);
+
+    // run the scheduler loop of this worker, we cannot use the exclusive mode for multiple threads
+    tb_lo_scheduler_loop((tb_lo_scheduler_ref_t)worker->scheduler, tb_false);
+
+    // trace
+    tb_trace_d("worker[%lu]: exited", worker->index);
+    return 0;
+}
+static tb_void_t tb_lo_worker_spak(tb_lo_worker_ref_t worker)
+{
+    // check
+    tb_assert(worker && worker->scheduler);
+
+    // spak the poller of this worker
+    tb_lo_scheduler_io_ref_t scheduler_io = tb_lo_scheduler_io(worker->scheduler);
+    if (scheduler_io && scheduler_io->poller) tb_poller_spak(scheduler_io->poller);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_lo_worker_group_ref_t tb_lo_worker_group_init(tb_lo_scheduler_t* scheduler, tb_size_t workern)
+{
+    // check
+    tb_assert_and_check_return_val(scheduler && !scheduler->worker && workern, tb_null);
+
+    // done
+    tb_bool_t                   ok = tb_false;
+    tb_lo_worker_group_ref_t    group = tb_null;
+    do
+    {
+        // make group
+        group = tb_malloc0_type(tb_lo_worker_group_t);
+        tb_assert_and_check_break(group);
+
+        // make workers
+        group->workers = tb_nalloc0_type(workern, tb_lo_worker_t);
+        tb_assert_and_check_break(group->workers);
+        group->workern = workern;
+
+        // init workers
+        tb_size_t i = 0;
+        for (i = 0; i < workern; i++)
+        {
+            // init worker
+            tb_lo_worker_ref_t worker = &group->workers[i];
+            worker->group = group;
+            worker->index = i;
+
+            // init the scheduler of this worker, the first worker uses the given scheduler
+            worker->scheduler = i? (tb_lo_scheduler_t*)tb_lo_scheduler_init() : scheduler;
+            tb_assert_and_check_break(worker->scheduler);
+            worker->scheduler->worker = worker;
+
+            // init the own poller and timers of this worker and start its io loop
+            if (!tb_lo_scheduler_io_need(worker->scheduler)) break;
+        }
+        tb_check_break(i == workern);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit group
+        if (group)
+        {
+            // all workers will not be run
+            tb_lo_worker_group_kill(group);
+            tb_lo_worker_group_exit(group);
+        }
+        group = tb_null;
+    }
+
+    // ok?
+    return group;
+}
+tb_void_t tb_lo_worker_group_exit(tb_lo_worker_group_ref_t group)
+{
+    // check
+    tb_assert_and_check_return(group);
+
+    // exit workers
+    if (group->workers)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < group->workern; i++)
+        {
+            // check
+            tb_lo_worker_ref_t worker = &group->workers[i];
+            tb_assert(!worker->thread);
+
+            // detach and exit the scheduler of this worker, the first scheduler will be exited by the caller
+            if (worker->scheduler)
+            {
+                worker->scheduler->worker = tb_null;
+                if (i) tb_lo_scheduler_exit((tb_lo_scheduler_ref_t)worker->scheduler);
+                worker->scheduler = tb_null;
+            }
+        }
+
+        // exit workers
+        tb_free(group->workers);
+        group->workers = tb_null;
+    }
+
+    // exit group
+    tb_free(group);
+}
+tb_bool_t tb_lo_worker_group_start(tb_lo_worker_group_ref_t group)
+{
+    // check
+    tb_assert_and_check_return_val(group && group->workers, tb_false);
+
+    // no coroutines? finish it directly
+    if (!tb_atomic_get(&group->count)) tb_lo_worker_group_finish(group);
+
+    // the new coroutines need be posted to the other workers after starting threads
+    tb_atomic32_set(&group->started, 1);
+
+    // start the other workers, the first worker will be run on the current thread
+    tb_size_t i = 1;
+    for (i = 1; i < group->workern; i++)
+    {
+        tb_lo_worker_ref_t worker = &group->workers[i];
+        worker->thread = tb_thread_init("lo_worker", tb_lo_worker_loop, worker, 0);
+        tb_assert_and_check_break(worker->thread);
+    }
+
+    // ok?
+    return i == group->workern;
+}
+tb_void_t tb_lo_worker_group_wait(tb_lo_worker_group_ref_t group)
+{
+    // check
+    tb_assert_and_check_return(group && group->workers);
+
+    // wait all worker threads
+    tb_size_t i = 1;
+    for (i = 1; i < group->workern; i++)
+    {
+        tb_lo_worker_ref_t worker = &group->workers[i];
+        if (worker->thread)
+        {
+            tb_thread_wait(worker->thread, -1, tb_null);
+            tb_thread_exit(worker->thread);
+            worker->thread = tb_null;
+        }
+    }
+}
+tb_void_t tb_lo_worker_group_finish(tb_lo_worker_group_ref_t group)
+{
+    // check
+    tb_assert_and_check_return(group && group->workers);
+
+    // trace
+    tb_trace_d("finish all workers ..");
+
+    // mark all coroutines as finished
+    tb_atomic32_set(&group->finished, 1);
+
+    // wake up all workers, their io loops will be exited
+    tb_size_t i = 0;
+    for (i = 0; i < group->workern; i++)
+    {
+        tb_lo_worker_ref_t worker = &group->workers[i];
+        if (worker->scheduler) tb_lo_worker_spak(worker);
+    }
+}
+tb_void_t tb_lo_worker_group_kill(tb_lo_worker_group_ref_t group)
+{
+    // check
+    tb_assert_and_check_return(group && group->workers);
+
+    // kill all workers
+    tb_size_t i = 0;
+    for (i = 0; i < group->workern; i++)
+    {
+        tb_lo_worker_ref_t worker = &group->workers[i];
+        if (worker->scheduler)
+        {
+            worker->scheduler->stopped = tb_true;
+            if (worker->scheduler->scheduler_io) tb_lo_scheduler_io_kill(worker->scheduler->scheduler_io);
+        }
+    }
+}
+tb_void_t tb_lo_worker_group_enter(tb_lo_worker_group_ref_t group)
+{
+    // check
+    tb_assert(group);
+
+    // increase the coroutines count
+    tb_atomic_fetch_and_add(&group->count, 1);
+}
+tb_void_t tb_lo_worker_group_leave(tb_lo_worker_group_ref_t group)
+{
+    // check
+    tb_assert(group);
+
+    // the last coroutine has been finished? finish all workers
+    if (tb_atomic_fetch_and_sub(&group->count, 1) == 1) tb_lo_worker_group_finish(group);
+}
+tb_lo_worker_ref_t tb_lo_worker_group_next(tb_lo_worker_group_ref_t group)
+{
+    // check
+    tb_assert(group && group->workers && group->workern);
+
+    // get the next worker by round-robin
+    tb_uint32_t next = (tb_uint32_t)tb_atomic32_fetch_and_add_explicit(&group->next, 1, TB_ATOMIC_RELAXED);
+    return &group->workers[next % group->workern];
+}
+#endif
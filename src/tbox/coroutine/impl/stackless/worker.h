@@ -0,0 +1,173 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        worker.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_IMPL_STACKLESS_WORKER_H
+#define TB_COROUTINE_IMPL_STACKLESS_WORKER_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the scheduler type
+struct __tb_lo_scheduler_t;
+
+// the worker group type
+struct __tb_lo_worker_group_t;
+
+/* the stackless coroutine worker type for the sharded scheduler
+ *
+ * each worker runs an own scheduler (shard) with the poller, timers and coroutine slab on its own thread.
+ *
+ * <pre>
+ *
+ * worker0: [ready: io loop <-> running <-> ...] [inbox] [slab] [poller]
+ *                                                  |
+ *                                           start (hand-off)
+ *                                                  |
+ * worker1: [ready: io loop <-> running <-> ...] [inbox] [slab] [poller]
+ *
+ * </pre>
+ *
+ * the new coroutines are distributed to the workers by round-robin, they will be inserted to the ready coroutines directly
+ * if the target worker is the current worker, otherwise they will be posted to the lock-free inbox of the target worker.
+ *
+ * the coroutines are never migrated after starting, so the resumed coroutines need not any locks.
+ */
+typedef struct __tb_lo_worker_t
+{
+    // the worker group
+    struct __tb_lo_worker_group_t*  group;
+
+    // the scheduler of this worker
+    struct __tb_lo_scheduler_t*     scheduler;
+
+    // the worker thread, the first worker will be run on the thread of loop()
+    tb_thread_ref_t                 thread;
+
+    // the worker index
+    tb_size_t                       index;
+
+}tb_lo_worker_t, *tb_lo_worker_ref_t;
+
+// the worker group type
+typedef struct __tb_lo_worker_group_t
+{
+    // the workers
+    tb_lo_worker_t*                 workers;
+
+    // the worker count
+    tb_size_t                       workern;
+
+    // the started and not finished coroutines count
+    tb_atomic_t                     count;
+
+    // the next worker index for distributing the new coroutines
+    tb_atomic32_t                   next;
+
+    // have the other worker threads been started?
+    tb_atomic32_t                   started;
+
+    // have all coroutines been finished?
+    tb_atomic32_t                   finished;
+
+}tb_lo_worker_group_t, *tb_lo_worker_group_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init the worker group
+ *
+ * @param scheduler     the scheduler of the first worker
+ * @param workern       the worker count
+ *
+ * @return              the worker group
+ */
+tb_lo_worker_group_ref_t    tb_lo_worker_group_init(struct __tb_lo_scheduler_t* scheduler, tb_size_t workern);
+
+/* exit the worker group, the first scheduler will be detached and not be exited
+ *
+ * @param group         the worker group
+ */
+tb_void_t                   tb_lo_worker_group_exit(tb_lo_worker_group_ref_t group);
+
+/* start the other worker threads
+ *
+ * @param group         the worker group
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t                   tb_lo_worker_group_start(tb_lo_worker_group_ref_t group);
+
+/* wait all worker threads exited
+ *
+ * @param group         the worker group
+ */
+tb_void_t                   tb_lo_worker_group_wait(tb_lo_worker_group_ref_t group);
+
+/* finish all workers, their io loops will be exited if there are no suspended coroutines
+ *
+ * @param group         the worker group
+ */
+tb_void_t                   tb_lo_worker_group_finish(tb_lo_worker_group_ref_t group);
+
+/* kill all workers
+ *
+ * @param group         the worker group
+ */
+tb_void_t                   tb_lo_worker_group_kill(tb_lo_worker_group_ref_t group);
+
+/* a coroutine has been started in the worker group
+ *
+ * @param group         the worker group
+ */
+tb_void_t                   tb_lo_worker_group_enter(tb_lo_worker_group_ref_t group);
+
+/* a coroutine has been finished in the worker group, all workers will be finished if no more coroutines
+ *
+ * @param group         the worker group
+ */
+tb_void_t                   tb_lo_worker_group_leave(tb_lo_worker_group_ref_t group);
+
+/* get the next worker for the new coroutine by round-robin
+ *
+ * @param group         the worker group
+ *
+ * @return              the worker
+ */
+tb_lo_worker_ref_t          tb_lo_worker_group_next(tb_lo_worker_group_ref_t group);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,192 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        waitq.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "waitq"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "waitq.h"
+#include "scheduler.h"
+#include "scheduler_io.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_co_waitq_task_exit(tb_co_waiter_ref_t waiter)
+{
+    // exists the timer task? remove it
+    tb_cpointer_t task = waiter->task;
+    if (task)
+    {
+        // get io scheduler of the waiting coroutine
+        tb_co_scheduler_io_ref_t scheduler_io = tb_co_scheduler_io((tb_co_scheduler_t*)waiter->coroutine->scheduler);
+        tb_assert(scheduler_io);
+
+        // remove the timer task
+        tb_wtimer_task_exit(scheduler_io->timer, (tb_wtimer_task_ref_t)task);
+        waiter->task = tb_null;
+    }
+}
+static tb_void_t tb_co_waitq_resume(tb_co_waiter_ref_t waiter, tb_long_t ok)
+{
+    // remove it from the wait queue
+    tb_list_entry_remove(&waiter->waitq->waiters, &waiter->entry);
+
+    // remove the timer task
+    tb_co_waitq_task_exit(waiter);
+
+    /* resume the waiting coroutine, the waiter will be invalid after resuming it
+     *
+     * it will be posted to the owner scheduler if we are not in the scheduler thread
+     */
+    tb_coroutine_t*     coroutine = waiter->coroutine;
+    tb_co_scheduler_t*  scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+    if (scheduler) tb_co_scheduler_resume(scheduler, coroutine, (tb_cpointer_t)ok);
+    else tb_co_scheduler_post((tb_co_scheduler_t*)coroutine->scheduler, coroutine, (tb_cpointer_t)ok);
+}
+static tb_void_t tb_co_waitq_timeout(tb_bool_t killed, tb_cpointer_t priv)
+{
+    // check
+    tb_co_waiter_ref_t waiter = (tb_co_waiter_ref_t)priv;
+    tb_assert(waiter && waiter->coroutine && waiter->waitq);
+
+    // trace
+    tb_trace_d("coroutine(%p): wait %s", waiter->coroutine, killed? "killed" : "timeout");
+
+    // resume the waiting coroutine if the timer task has been not canceled
+    if (!killed) tb_co_waitq_resume(waiter, 0);
+}
+static tb_void_t tb_co_waitq_interrupt(tb_coroutine_t* coroutine, tb_cpointer_t priv)
+{
+    // check
+    tb_co_waiter_ref_t waiter = (tb_co_waiter_ref_t)priv;
+    tb_assert(waiter && waiter->coroutine == coroutine && waiter->waitq);
+
+    // trace
+    tb_trace_d("coroutine(%p): wait interrupted", coroutine);
+
+    // resume the waiting coroutine with the failed result
+    tb_co_waitq_resume(waiter, -1);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_co_waitq_init(tb_co_waitq_ref_t waitq)
+{
+    // check
+    tb_assert(waitq);
+
+    // init waiters
+    tb_list_entry_init(&waitq->waiters, tb_co_waiter_t, entry, tb_null);
+}
+tb_void_t tb_co_waitq_exit(tb_co_waitq_ref_t waitq)
+{
+    // check
+    tb_assert(waitq);
+
+    // check waiters
+    tb_assert(!tb_list_entry_size(&waitq->waiters));
+
+    // exit waiters
+    tb_list_entry_exit(&waitq->waiters);
+}
+tb_long_t tb_co_waitq_wait(tb_co_waitq_ref_t waitq, tb_size_t udata, tb_long_t timeout, tb_bool_t cancelable)
+{
+    // check
+    tb_assert(waitq);
+
+    // no wait?
+    tb_check_return_val(timeout, 0);
+
+    // get the current scheduler, we can only wait it in coroutine
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+    tb_assert_and_check_return_val(scheduler && scheduler->running && !tb_coroutine_is_original(scheduler->running), -1);
+
+    // have been stopped or cancelled?
+    tb_check_return_val(!scheduler->stopped && (!cancelable || !scheduler->running->cancelled), -1);
+
+    // init waiter
+    tb_co_waiter_t waiter;
+    waiter.coroutine    = scheduler->running;
+    waiter.waitq        = waitq;
+    waiter.task         = tb_null;
+    waiter.udata        = udata;
+
+    // post the timer task
+    if (timeout > 0)
+    {
+        // need io scheduler
+        tb_co_scheduler_io_ref_t scheduler_io = tb_co_scheduler_io_need(scheduler);
+        tb_assert_and_check_return_val(scheduler_io, -1);
+
+        // init the timer task
+        waiter.task = tb_wtimer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_waitq_timeout, &waiter);
+        tb_assert_and_check_return_val(waiter.task, -1);
+    }
+
+    // append this waiter to the wait queue
+    tb_list_entry_insert_tail(&waitq->waiters, &waiter.entry);
+
+    // it can be interrupted by tb_coroutine_cancel()
+    if (cancelable)
+    {
+        waiter.coroutine->interrupt         = tb_co_waitq_interrupt;
+        waiter.coroutine->interrupt_priv    = &waiter;
+    }
+
+    // trace
+    tb_trace_d("coroutine(%p): wait %ld ms ..", waiter.coroutine, timeout);
+
+    // suspend it, it will be removed from the wait queue after resuming it
+    return (tb_long_t)tb_co_scheduler_suspend(scheduler, tb_null);
+}
+tb_co_waiter_ref_t tb_co_waitq_head(tb_co_waitq_ref_t waitq)
+{
+    // check
+    tb_assert(waitq);
+
+    // get the first waiter
+    return tb_list_entry_size(&waitq->waiters)? (tb_co_waiter_ref_t)tb_list_entry(&waitq->waiters, tb_list_entry_head(&waitq->waiters)) : tb_null;
+}
+tb_bool_t tb_co_waitq_wake(tb_co_waitq_ref_t waitq)
+{
+    // get the first waiter
+    tb_co_waiter_ref_t waiter = tb_co_waitq_head(waitq);
+    tb_check_return_val(waiter, tb_false);
+
+    // wake it up
+    tb_co_waitq_resume(waiter, 1);
+    return tb_true;
+}
+tb_size_t tb_co_waitq_wake_all(tb_co_waitq_ref_t waitq)
+{
+    // wake up all waiters
+    tb_size_t count = 0;
+    while (tb_co_waitq_wake(waitq)) count++;
+    return count;
+}
@@ -0,0 +1,137 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        waitq.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_IMPL_WAITQ_H
+#define TB_COROUTINE_IMPL_WAITQ_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// get the waiting coroutines count
+#define tb_co_waitq_size(waitq)         tb_list_entry_size(&(waitq)->waiters)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the coroutine type
+struct __tb_coroutine_t;
+
+/* the waiter type of the wait queue
+ *
+ * it's placed on the stack of the waiting coroutine, so the timed out waiter can be removed quickly,
+ * and it will be never resumed twice by the timer and the waker.
+ */
+typedef struct __tb_co_waiter_t
+{
+    // the list entry
+    tb_list_entry_t                 entry;
+
+    // the waiting coroutine
+    struct __tb_coroutine_t*        coroutine;
+
+    // the wait queue
+    struct __tb_co_waitq_t*         waitq;
+
+    // the timer task
+    tb_cpointer_t                   task;
+
+    // the user data, e.g. the rwlock mode
+    tb_size_t                       udata;
+
+}tb_co_waiter_t, *tb_co_waiter_ref_t;
+
+// the wait queue type for the coroutine lock, cond and waitgroup
+typedef struct __tb_co_waitq_t
+{
+    // the waiters
+    tb_list_entry_head_t            waiters;
+
+}tb_co_waitq_t, *tb_co_waitq_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init the wait queue
+ *
+ * @param waitq         the wait queue
+ */
+tb_void_t               tb_co_waitq_init(tb_co_waitq_ref_t waitq);
+
+/* exit the wait queue
+ *
+ * @param waitq         the wait queue
+ */
+tb_void_t               tb_co_waitq_exit(tb_co_waitq_ref_t waitq);
+
+/* suspend the current coroutine and wait it in the given wait queue
+ *
+ * @param waitq         the wait queue
+ * @param udata         the user data of this waiter
+ * @param timeout       the timeout, infinity: -1
+ * @param cancelable    can it be interrupted by tb_coroutine_cancel()?
+ *
+ * @return              ok: 1, timeout: 0, fail or cancelled: -1
+ */
+tb_long_t               tb_co_waitq_wait(tb_co_waitq_ref_t waitq, tb_size_t udata, tb_long_t timeout, tb_bool_t cancelable);
+
+/* get the first waiter
+ *
+ * @param waitq         the wait queue
+ *
+ * @return              the first waiter, null if no waiters
+ */
+tb_co_waiter_ref_t      tb_co_waitq_head(tb_co_waitq_ref_t waitq);
+
+/* wake up the first waiter
+ *
+ * @param waitq         the wait queue
+ *
+ * @return              tb_true or tb_false (no waiters)
+ */
+tb_bool_t               tb_co_waitq_wake(tb_co_waitq_ref_t waitq);
+
+/* wake up all waiters
+ *
+ * @param waitq         the wait queue
+ *
+ * @return              the waked up waiters count
+ */
+tb_size_t               tb_co_waitq_wake_all(tb_co_waitq_ref_t waitq);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
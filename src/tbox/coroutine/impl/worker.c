@@ -0,0 +1,348 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        worker.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "worker"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "worker.h"
+#include "coroutine.h"
+#include "scheduler.h"
+#include "scheduler_io.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_int_t tb_co_worker_loop(tb_cpointer_t priv)
+{
+    // check
+    tb_co_worker_ref_t worker = (tb_co_worker_ref_t)priv;
+    tb_assert_and_check_return_val(worker && worker->scheduler, -1);
+
+    // trace
+    tb_trace_d("worker[%lu]: loop ..", worker->index);
+
+    // run the scheduler loop of this worker, we cannot use the exclusive mode for multiple threads
+    tb_co_scheduler_loop((tb_co_scheduler_ref_t)worker->scheduler, tb_false);
+
+    // trace
+    tb_trace_d("worker[%lu]: exited", worker->index);
+    return 0;
+}
+static tb_void_t tb_co_worker_spak(tb_co_worker_ref_t worker)
+{
+    // check
+    tb_assert(worker && worker->scheduler);
+
+    // spak the poller of this worker
+    tb_co_scheduler_io_ref_t scheduler_io = tb_co_scheduler_io(worker->scheduler);
+    if (scheduler_io && scheduler_io->poller) tb_poller_spak(scheduler_io->poller);
+}
+static tb_bool_t tb_co_worker_wake(tb_co_worker_ref_t worker)
+{
+    // check
+    tb_assert(worker && worker->group);
+
+    // wake it if it's idle
+    if (tb_atomic32_fetch_and_cmpset(&worker->idle, 1, 0) == 1)
+    {
+        tb_atomic32_fetch_and_sub(&worker->group->idlen, 1);
+        tb_co_worker_spak(worker);
+        return tb_true;
+    }
+    return tb_false;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_co_worker_group_ref_t tb_co_worker_group_init(tb_co_scheduler_t* scheduler, tb_size_t workern)
+{
+    // check
+    tb_assert_and_check_return_val(scheduler && !scheduler->worker && workern, tb_null);
+
+    // done
+    tb_bool_t                   ok = tb_false;
+    tb_co_worker_group_ref_t    group = tb_null;
+    do
+    {
+        // make group
+        group = tb_malloc0_type(tb_co_worker_group_t);
+        tb_assert_and_check_break(group);
+
+        // make workers
+        group->workers = tb_nalloc0_type(workern, tb_co_worker_t);
+        tb_assert_and_check_break(group->workers);
+        group->workern = workern;
+
+        // init workers
+        tb_size_t i = 0;
+        for (i = 0; i < workern; i++)
+        {
+            // init worker
+            tb_co_worker_ref_t worker = &group->workers[i];
+            worker->group = group;
+            worker->index = i;
+
+            // init the local run queue
+            if (!tb_ws_deque_init(&worker->runq, 0)) break;
+
+            // init the scheduler of this worker, the first worker uses the given scheduler
+            worker->scheduler = i? (tb_co_scheduler_t*)tb_co_scheduler_init() : scheduler;
+            tb_assert_and_check_break(worker->scheduler);
+            worker->scheduler->worker = worker;
+
+            // init the own poller and timers of this worker and start its io loop
+            if (!tb_co_scheduler_io_need(worker->scheduler)) break;
+        }
+        tb_check_break(i == workern);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit group
+        if (group)
+        {
+            // all workers will not be run
+            tb_co_worker_group_stop(group);
+            tb_co_worker_group_exit(group);
+        }
+        group = tb_null;
+    }
+
+    // ok?
+    return group;
+}
+tb_void_t tb_co_worker_group_exit(tb_co_worker_group_ref_t group)
+{
+    // check
+    tb_assert_and_check_return(group);
+
+    // exit workers
+    if (group->workers)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < group->workern; i++)
+        {
+            // check
+            tb_co_worker_ref_t worker = &group->workers[i];
+            tb_assert(!worker->thread);
+
+            // exit the left ready coroutines in the run queue
+            tb_coroutine_t* coroutine = tb_null;
+            while ((coroutine = (tb_coroutine_t*)tb_ws_deque_steal(&worker->runq)))
+                tb_coroutine_exit(coroutine);
+
+            // exit the run queue
+            tb_ws_deque_exit(&worker->runq);
+
+            // detach and exit the scheduler of this worker, the first scheduler will be exited by the caller
+            if (worker->scheduler)
+            {
+                worker->scheduler->worker = tb_null;
+                if (i) tb_co_scheduler_exit((tb_co_scheduler_ref_t)worker->scheduler);
+                worker->scheduler = tb_null;
+            }
+        }
+
+        // exit workers
+        tb_free(group->workers);
+        group->workers = tb_null;
+    }
+
+    // exit group
+    tb_free(group);
+}
+tb_bool_t tb_co_worker_group_start(tb_co_worker_group_ref_t group)
+{
+    // check
+    tb_assert_and_check_return_val(group && group->workers, tb_false);
+
+    // no coroutines? stop it directly
+    if (!tb_atomic_get(&group->count)) tb_co_worker_group_stop(group);
+
+    // start the other workers, the first worker will be run on the current thread
+    tb_size_t i = 1;
+    for (i = 1; i < group->workern; i++)
+    {
+        tb_co_worker_ref_t worker = &group->workers[i];
+        worker->thread = tb_thread_init("co_worker", tb_co_worker_loop, worker, 0);
+        tb_assert_and_check_break(worker->thread);
+    }
+
+    // ok?
+    return i == group->workern;
+}
+tb_void_t tb_co_worker_group_wait(tb_co_worker_group_ref_t group)
+{
+    // check
+    tb_assert_and_check_return(group && group->workers);
+
+    // wait all worker threads
+    tb_size_t i = 1;
+    for (i = 1; i < group->workern; i++)
+    {
+        tb_co_worker_ref_t worker = &group->workers[i];
+        if (worker->thread)
+        {
+            tb_thread_wait(worker->thread, -1, tb_null);
+            tb_thread_exit(worker->thread);
+            worker->thread = tb_null;
+        }
+    }
+}
+tb_void_t tb_co_worker_group_stop(tb_co_worker_group_ref_t group)
+{
+    // check
+    tb_assert_and_check_return(group && group->workers);
+
+    // trace
+    tb_trace_d("stop all workers ..");
+
+    // stop all workers and wake them
+    tb_size_t i = 0;
+    for (i = 0; i < group->workern; i++)
+    {
+        tb_co_worker_ref_t worker = &group->workers[i];
+        if (worker->scheduler)
+        {
+            worker->scheduler->stopped = tb_true;
+            tb_co_worker_spak(worker);
+        }
+    }
+}
+tb_void_t tb_co_worker_group_kill(tb_co_worker_group_ref_t group)
+{
+    // check
+    tb_assert_and_check_return(group && group->workers);
+
+    // kill all workers
+    tb_size_t i = 0;
+    for (i = 0; i < group->workern; i++)
+    {
+        tb_co_worker_ref_t worker = &group->workers[i];
+        if (worker->scheduler)
+        {
+            worker->scheduler->stopped = tb_true;
+            if (worker->scheduler->scheduler_io) tb_co_scheduler_io_kill(worker->scheduler->scheduler_io);
+        }
+    }
+}
+tb_void_t tb_co_worker_group_enter(tb_co_worker_group_ref_t group)
+{
+    // check
+    tb_assert(group);
+
+    // increase the coroutines count
+    tb_atomic_fetch_and_add(&group->count, 1);
+}
+tb_void_t tb_co_worker_group_leave(tb_co_worker_group_ref_t group)
+{
+    // check
+    tb_assert(group);
+
+    // the last coroutine has been finished? stop all workers
+    if (tb_atomic_fetch_and_sub(&group->count, 1) == 1) tb_co_worker_group_stop(group);
+}
+tb_bool_t tb_co_worker_push(tb_co_worker_ref_t worker, tb_coroutine_t* coroutine)
+{
+    // check
+    tb_assert(worker && worker->group && coroutine);
+
+    // push it to the bottom of the run queue
+    if (!tb_ws_deque_push(&worker->runq, coroutine)) return tb_false;
+
+    // wake up an idle worker to steal it
+    tb_co_worker_group_ref_t group = worker->group;
+    if (tb_atomic32_get_explicit(&group->idlen, TB_ATOMIC_RELAXED) > 0)
+    {
+        tb_size_t i = 1;
+        for (i = 1; i < group->workern; i++)
+        {
+            if (tb_co_worker_wake(&group->workers[(worker->index + i) % group->workern]))
+                break;
+        }
+    }
+    return tb_true;
+}
+tb_coroutine_t* tb_co_worker_steal(tb_co_worker_ref_t worker)
+{
+    // check
+    tb_assert(worker && worker->group);
+
+    // steal it from the top of the other run queues
+    tb_co_worker_group_ref_t    group = worker->group;
+    tb_coroutine_t*             coroutine = tb_null;
+    tb_size_t                   i = 1;
+    for (i = 1; i < group->workern && !coroutine; i++)
+        coroutine = (tb_coroutine_t*)tb_ws_deque_steal(&group->workers[(worker->index + i) % group->workern].runq);
+
+    // trace
+    tb_trace_d("worker[%lu]: steal coroutine(%p)", worker->index, coroutine);
+    return coroutine;
+}
+tb_bool_t tb_co_worker_idle_enter(tb_co_worker_ref_t worker)
+{
+    // check
+    tb_assert(worker && worker->group && worker->scheduler);
+
+    // mark this worker as idle first, the atomic exchange is also a full memory barrier
+    tb_co_worker_group_ref_t group = worker->group;
+    tb_atomic32_fetch_and_set(&worker->idle, 1);
+    tb_atomic32_fetch_and_add(&group->idlen, 1);
+
+    // check again, we may lose the wakeup from the other workers
+    tb_bool_t ready = worker->scheduler->stopped || tb_atomic_get(&worker->scheduler->inbox);
+    if (!ready)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < group->workern && !ready; i++)
+            ready = tb_ws_deque_size(&group->workers[i].runq) > 0;
+    }
+
+    // there are new ready coroutines? do not wait it
+    if (ready)
+    {
+        tb_co_worker_idle_leave(worker);
+        return tb_false;
+    }
+    return tb_true;
+}
+tb_void_t tb_co_worker_idle_leave(tb_co_worker_ref_t worker)
+{
+    // check
+    tb_assert(worker && worker->group);
+
+    // leave the idle state if it has been not waked up
+    if (tb_atomic32_fetch_and_cmpset(&worker->idle, 1, 0) == 1)
+        tb_atomic32_fetch_and_sub(&worker->group->idlen, 1);
+}
@@ -0,0 +1,199 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        worker.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_IMPL_WORKER_H
+#define TB_COROUTINE_IMPL_WORKER_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../../platform/impl/ws_deque.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the scheduler and coroutine type
+struct __tb_co_scheduler_t;
+struct __tb_coroutine_t;
+
+// the worker group type
+struct __tb_co_worker_group_t;
+
+/* the coroutine worker type for the M:N scheduler
+ *
+ * each worker runs an own scheduler with the poller and timers on its own thread.
+ *
+ * <pre>
+ *
+ * worker0: [ready: io loop <-> running <-> ...] [runq: top <- ... -> bottom] [poller]
+ *                                                        |
+ *                                                     steal
+ *                                                        |
+ * worker1: [ready: io loop <-> ...]             [runq: top <- ... -> bottom] [poller]
+ *
+ * </pre>
+ *
+ * the new and resumed coroutines will be pushed to the local run queue (runq) first,
+ * the idle workers will steal them from the top and migrate them to their own schedulers.
+ *
+ * the coroutines which have been attached to the poller of worker are pinned and cannot be migrated,
+ * and the suspended coroutines which are resumed from the other workers will be posted to the inbox of scheduler.
+ */
+typedef struct __tb_co_worker_t
+{
+    // the local run queue, it can be stolen by the other workers
+    tb_ws_deque_t                   runq;
+
+    // the worker group
+    struct __tb_co_worker_group_t*  group;
+
+    // the scheduler of this worker
+    struct __tb_co_scheduler_t*     scheduler;
+
+    // the worker thread, the first worker will be run on the thread of loop()
+    tb_thread_ref_t                 thread;
+
+    // the worker index
+    tb_size_t                       index;
+
+    // is idle? it's waiting for the poller events
+    tb_atomic32_t                   idle;
+
+}tb_co_worker_t, *tb_co_worker_ref_t;
+
+// the worker group type
+typedef struct __tb_co_worker_group_t
+{
+    // the workers
+    tb_co_worker_t*                 workers;
+
+    // the worker count
+    tb_size_t                       workern;
+
+    // the started and not finished coroutines count
+    tb_atomic_t                     count;
+
+    // the idle workers count
+    tb_atomic32_t                   idlen;
+
+}tb_co_worker_group_t, *tb_co_worker_group_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init the worker group
+ *
+ * @param scheduler     the scheduler of the first worker
+ * @param workern       the worker count
+ *
+ * @return              the worker group
+ */
+tb_co_worker_group_ref_t    tb_co_worker_group_init(struct __tb_co_scheduler_t* scheduler, tb_size_t workern);
+
+/* exit the worker group, the first scheduler will be detached and not be exited
+ *
+ * @param group         the worker group
+ */
+tb_void_t                   tb_co_worker_group_exit(tb_co_worker_group_ref_t group);
+
+/* start the other worker threads
+ *
+ * @param group         the worker group
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t                   tb_co_worker_group_start(tb_co_worker_group_ref_t group);
+
+/* wait all worker threads exited
+ *
+ * @param group         the worker group
+ */
+tb_void_t                   tb_co_worker_group_wait(tb_co_worker_group_ref_t group);
+
+/* stop all workers
+ *
+ * @param group         the worker group
+ */
+tb_void_t                   tb_co_worker_group_stop(tb_co_worker_group_ref_t group);
+
+/* kill all workers
+ *
+ * @param group         the worker group
+ */
+tb_void_t                   tb_co_worker_group_kill(tb_co_worker_group_ref_t group);
+
+/* a coroutine has been started in the worker group
+ *
+ * @param group         the worker group
+ */
+tb_void_t                   tb_co_worker_group_enter(tb_co_worker_group_ref_t group);
+
+/* a coroutine has been finished in the worker group, all workers will be stopped if no more coroutines
+ *
+ * @param group         the worker group
+ */
+tb_void_t                   tb_co_worker_group_leave(tb_co_worker_group_ref_t group);
+
+/* push a ready coroutine to the run queue of the current worker and wake up an idle worker
+ *
+ * @param worker        the current worker
+ * @param coroutine     the ready coroutine
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t                   tb_co_worker_push(tb_co_worker_ref_t worker, struct __tb_coroutine_t* coroutine);
+
+/* steal a ready coroutine from the other workers
+ *
+ * @param worker        the current worker
+ *
+ * @return              the stolen coroutine
+ */
+struct __tb_coroutine_t*    tb_co_worker_steal(tb_co_worker_ref_t worker);
+
+/* enter the idle state before waiting the poller
+ *
+ * @param worker        the worker
+ *
+ * @return              tb_true: wait it, tb_false: there are new ready coroutines, do not wait
+ */
+tb_bool_t                   tb_co_worker_idle_enter(tb_co_worker_ref_t worker);
+
+/* leave the idle state after waiting the poller
+ *
+ * @param worker        the worker
+ */
+tb_void_t                   tb_co_worker_idle_leave(tb_co_worker_ref_t worker);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
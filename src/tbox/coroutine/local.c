@@ -0,0 +1,179 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        local.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "co_local"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "local.h"
+#include "impl/impl.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the allocated slots count
+static tb_atomic32_t        g_co_local_count = 0;
+
+// the free functions of all slots
+static tb_co_local_free_t   g_co_local_frees[TB_CO_LOCAL_MAXN];
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_co_local_once(tb_cpointer_t priv)
+{
+    // check
+    tb_value_ref_t tuple = (tb_value_ref_t)priv;
+    tb_check_return_val(tuple, tb_false);
+
+    // the coroutine local
+    tb_co_local_ref_t local = (tb_co_local_ref_t)tuple[0].ptr;
+    tb_check_return_val(local, tb_false);
+
+    // the slots mask is only 32-bits
+    tb_assert_static(TB_CO_LOCAL_MAXN <= 32);
+
+    // allocate a new slot, the count will not exceed the maximum count if it's full
+    tb_int32_t index = tb_atomic32_get(&g_co_local_count);
+    do
+    {
+        if (index >= TB_CO_LOCAL_MAXN)
+        {
+            // trace
+            tb_trace_e("too much coroutine locals, the maximum count is %d!", TB_CO_LOCAL_MAXN);
+            return tb_false;
+        }
+
+    } while (!tb_atomic32_compare_and_swap(&g_co_local_count, &index, index + 1));
+
+    // save the free function
+    local->index = (tb_size_t)index;
+    local->free  = (tb_co_local_free_t)tuple[1].ptr;
+    g_co_local_frees[index] = local->free;
+
+    // init ok
+    local->inited = tb_true;
+    return tb_true;
+}
+static __tb_inline_force__ tb_coroutine_t* tb_co_local_coroutine()
+{
+    // get the running coroutine
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+    return scheduler? scheduler->running : tb_null;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_co_local_clear(tb_coroutine_t* coroutine)
+{
+    // check
+    tb_assert(coroutine);
+
+    // free all local data, the free function may set the new local data again
+    while (coroutine->locals_mask)
+    {
+        // get the first slot
+        tb_size_t index = tb_bits_fb1_u32_le(coroutine->locals_mask);
+        tb_assert_and_check_break(index < TB_CO_LOCAL_MAXN);
+
+        // clear it first
+        coroutine->locals_mask &= ~((tb_uint32_t)1 << index);
+
+        // free it
+        tb_co_local_free_t func = g_co_local_frees[index];
+        if (func) func(coroutine->locals[index]);
+        coroutine->locals[index] = tb_null;
+    }
+}
+tb_bool_t tb_co_local_init(tb_co_local_ref_t local, tb_co_local_free_t func)
+{
+    // check
+    tb_assert_and_check_return_val(local, tb_false);
+
+    // have been initialized?
+    tb_check_return_val(!local->inited, tb_true);
+
+    // run the once function
+    tb_value_t tuple[2];
+    tuple[0].ptr = (tb_pointer_t)local;
+    tuple[1].ptr = (tb_pointer_t)func;
+    return tb_thread_once(&local->once, tb_co_local_once, tuple);
+}
+tb_bool_t tb_co_local_has(tb_co_local_ref_t local)
+{
+    // check
+    tb_assert(local);
+
+    // have been not initialized?
+    tb_check_return_val(local->inited, tb_false);
+
+    // get the running coroutine
+    tb_coroutine_t* coroutine = tb_co_local_coroutine();
+    tb_check_return_val(coroutine, tb_false);
+
+    // has it?
+    return (coroutine->locals_mask & ((tb_uint32_t)1 << local->index))? tb_true : tb_false;
+}
+tb_pointer_t tb_co_local_get(tb_co_local_ref_t local)
+{
+    // check
+    tb_assert(local);
+
+    // have been not initialized?
+    tb_check_return_val(local->inited, tb_null);
+
+    // get the running coroutine
+    tb_coroutine_t* coroutine = tb_co_local_coroutine();
+    tb_check_return_val(coroutine, tb_null);
+
+    // get it, the slot of the recycled coroutine will be always cleared
+    return (tb_pointer_t)coroutine->locals[local->index];
+}
+tb_bool_t tb_co_local_set(tb_co_local_ref_t local, tb_cpointer_t priv)
+{
+    // check
+    tb_assert(local);
+
+    // have been not initialized?
+    tb_assert_and_check_return_val(local->inited, tb_false);
+
+    // get the running coroutine, we cannot set it to the original coroutine
+    tb_coroutine_t* coroutine = tb_co_local_coroutine();
+    tb_assert_and_check_return_val(coroutine && !tb_coroutine_is_original(coroutine), tb_false);
+
+    // free the previous data first if it's changed
+    tb_size_t index = local->index;
+    if (local->free && (coroutine->locals_mask & ((tb_uint32_t)1 << index)) && coroutine->locals[index] != priv)
+        local->free(coroutine->locals[index]);
+
+    // set it
+    coroutine->locals[index] = priv;
+    coroutine->locals_mask |= ((tb_uint32_t)1 << index);
+    return tb_true;
+}
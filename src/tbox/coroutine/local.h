@@ -0,0 +1,165 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        local.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_LOCAL_H
+#define TB_COROUTINE_LOCAL_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/// the coroutine local initial value
+#define TB_CO_LOCAL_INIT        {0, 0, 0, tb_null}
+
+/*! the maximum count of the coroutine locals
+ *
+ * all slots are stored in the coroutine directly, so we need not lookup them.
+ */
+#ifndef TB_CO_LOCAL_MAXN
+#   ifdef __tb_small__
+#       define TB_CO_LOCAL_MAXN (8)
+#   else
+#       define TB_CO_LOCAL_MAXN (16)
+#   endif
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the coroutine local free function type
+ *
+ * @param priv      the coroutine local private data
+ */
+typedef tb_void_t   (*tb_co_local_free_t)(tb_cpointer_t priv);
+
+/// the coroutine local type
+typedef struct __tb_co_local_t
+{
+    // the atomice lock of once function
+    tb_atomic32_t           once;
+
+    // have been initialized?
+    tb_bool_t               inited;
+
+    // the slot index in the coroutine
+    tb_size_t               index;
+
+    // the free function
+    tb_co_local_free_t      free;
+
+}tb_co_local_t, *tb_co_local_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init a coroutine local
+ *
+ * it will allocate a fixed slot index for all coroutines, the slot is stored in the coroutine
+ * and the data will be freed after the coroutine is finished.
+ *
+ * @note support to be called repeatly, thread safely and only init it once,
+ *       the slots will be never released and we can only init TB_CO_LOCAL_MAXN locals.
+ *
+ * @code
+
+    // the coroutine local free function
+    static tb_void_t tb_co_local_free_func(tb_cpointer_t priv)
+    {
+        if (priv) tb_free(priv);
+    }
+
+    // the coroutine function
+    static tb_void_t tb_coroutine_func(tb_cpointer_t priv)
+    {
+        // init the coroutine local, only once
+        static tb_co_local_t s_local = TB_CO_LOCAL_INIT;
+        if (!tb_co_local_init(&s_local, tb_co_local_free_func)) return ;
+
+        // get the coroutine local data
+        tb_char_t const* data = tb_null;
+        if (!(data = tb_co_local_get(&s_local)))
+        {
+            tb_char_t const* cstr = tb_strdup("hello");
+            if (tb_co_local_set(&s_local, cstr))
+                data = cstr;
+            else tb_free(cstr);
+        }
+
+        // trace
+        tb_trace_i("data: %s", data);
+
+        ...
+    }
+
+ * @endcode
+ *
+ * @param local         the global or static coroutine local (need be initialized as TB_CO_LOCAL_INIT)
+ * @param func          the coroutine local free function
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_co_local_init(tb_co_local_ref_t local, tb_co_local_free_t func);
+
+/*! has coroutine local data on the current coroutine?
+ *
+ * @param local         the coroutine local reference
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_co_local_has(tb_co_local_ref_t local);
+
+/*! get coroutine local data from the current coroutine
+ *
+ * @param local         the coroutine local reference
+ *
+ * @return              the coroutine local private data
+ */
+tb_pointer_t            tb_co_local_get(tb_co_local_ref_t local);
+
+/*! set coroutine local data to the current coroutine
+ *
+ * @note the previous data will be freed, and this data will be freed automaticlly after it's coroutine was finished
+ *
+ * @param local         the coroutine local reference
+ * @param priv          the coroutine local private data
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_co_local_set(tb_co_local_ref_t local, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,390 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        mpmc_channel.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "mpmc_channel"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "mpmc_channel.h"
+#include "coroutine.h"
+#include "scheduler.h"
+#include "impl/impl.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the channel cell type
+typedef struct __tb_co_mpmc_channel_cell_t
+{
+    /* the sequence
+     *
+     * seq == pos: it's empty and can be written at pos
+     * seq == pos + 1: it has data and can be read at pos
+     */
+    tb_atomic_t                     seq;
+
+    // the data
+    tb_cpointer_t                   data;
+
+}tb_co_mpmc_channel_cell_t;
+
+/* the thread-safe coroutine channel type
+ *
+ * the queue is a bounded lock-free ring with the sequence cells,
+ * and the waiting lists are only locked in the slow path if it's full or empty.
+ */
+typedef struct __tb_co_mpmc_channel_t
+{
+    // the read position
+    tb_atomic_t                     head;
+
+    // the padding, the head and tail will be modified by the different threads
+    tb_byte_t                       padding0[TB_L1_CACHE_BYTES - sizeof(tb_atomic_t)];
+
+    // the write position
+    tb_atomic_t                     tail;
+
+    // the padding
+    tb_byte_t                       padding1[TB_L1_CACHE_BYTES - sizeof(tb_atomic_t)];
+
+    // the cells
+    tb_co_mpmc_channel_cell_t*      cells;
+
+    // the cells mask
+    tb_size_t                       mask;
+
+    // the free function
+    tb_co_channel_free_func_t       free;
+
+    // the user private data
+    tb_cpointer_t                   priv;
+
+    // the lock of the waiting coroutines
+    tb_spinlock_t                   lock;
+
+    // the waiting send coroutines count, we can check it without lock
+    tb_atomic_t                     waiting_sendn;
+
+    // the waiting recv coroutines count
+    tb_atomic_t                     waiting_recvn;
+
+    // the waiting send coroutines
+    tb_single_list_entry_head_t     waiting_send;
+
+    // the waiting recv coroutines
+    tb_single_list_entry_head_t     waiting_recv;
+
+}tb_co_mpmc_channel_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_co_mpmc_channel_queue_put(tb_co_mpmc_channel_t* channel, tb_cpointer_t data)
+{
+    // reserve a cell at the tail
+    tb_co_mpmc_channel_cell_t*  cell = tb_null;
+    tb_long_t                   pos = tb_atomic_get_explicit(&channel->tail, TB_ATOMIC_RELAXED);
+    while (1)
+    {
+        cell = &channel->cells[pos & channel->mask];
+        tb_long_t diff = tb_atomic_get(&cell->seq) - pos;
+        if (!diff)
+        {
+            // take it, pos will be updated if it has been taken by the other senders
+            if (tb_atomic_compare_and_swap(&channel->tail, &pos, pos + 1)) break;
+        }
+        // full?
+        else if (diff < 0) return tb_false;
+        // it has been taken by the other senders, reload it
+        else pos = tb_atomic_get_explicit(&channel->tail, TB_ATOMIC_RELAXED);
+    }
+
+    /* save data and publish it
+     *
+     * we use the sequential consistency to ensure the receivers which are going to wait will see it
+     */
+    cell->data = data;
+    tb_atomic_set(&cell->seq, pos + 1);
+    return tb_true;
+}
+static tb_bool_t tb_co_mpmc_channel_queue_pop(tb_co_mpmc_channel_t* channel, tb_pointer_t* pdata)
+{
+    // reserve a cell at the head
+    tb_co_mpmc_channel_cell_t*  cell = tb_null;
+    tb_long_t                   pos = tb_atomic_get_explicit(&channel->head, TB_ATOMIC_RELAXED);
+    while (1)
+    {
+        cell = &channel->cells[pos & channel->mask];
+        tb_long_t diff = tb_atomic_get(&cell->seq) - (pos + 1);
+        if (!diff)
+        {
+            // take it, pos will be updated if it has been taken by the other receivers
+            if (tb_atomic_compare_and_swap(&channel->head, &pos, pos + 1)) break;
+        }
+        // empty?
+        else if (diff < 0) return tb_false;
+        // it has been taken by the other receivers, reload it
+        else pos = tb_atomic_get_explicit(&channel->head, TB_ATOMIC_RELAXED);
+    }
+
+    // get data and release this cell for the next round
+    *pdata = (tb_pointer_t)cell->data;
+    tb_atomic_set(&cell->seq, pos + channel->mask + 1);
+    return tb_true;
+}
+static tb_void_t tb_co_mpmc_channel_wake(tb_co_mpmc_channel_t* channel, tb_single_list_entry_head_ref_t waiting, tb_atomic_t* waitingn)
+{
+    // no waiting coroutines? return it directly without lock
+    tb_check_return(tb_atomic_get(waitingn));
+
+    // get the first waiting coroutine
+    tb_coroutine_t* coroutine = tb_null;
+    tb_spinlock_enter(&channel->lock);
+    if (tb_single_list_entry_size(waiting))
+    {
+        tb_single_list_entry_ref_t entry = tb_single_list_entry_head(waiting);
+        tb_single_list_entry_remove_head(waiting);
+        tb_atomic_fetch_and_sub(waitingn, 1);
+        coroutine = (tb_coroutine_t*)tb_single_list_entry(waiting, entry);
+    }
+    tb_spinlock_leave(&channel->lock);
+    tb_check_return(coroutine);
+
+    // trace
+    tb_trace_d("wake coroutine(%p) on scheduler(%p)", coroutine, coroutine->scheduler);
+
+    /* resume it
+     *
+     * it will be posted to the inbox of the owner scheduler if it's suspended on the other scheduler,
+     * and we post it directly if we are not in the coroutine
+     */
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+    if (scheduler) tb_co_scheduler_resume(scheduler, coroutine, tb_null);
+    else tb_co_scheduler_post((tb_co_scheduler_t*)coroutine->scheduler, coroutine, tb_null);
+}
+static tb_bool_t tb_co_mpmc_channel_wait(tb_co_mpmc_channel_t* channel, tb_bool_t send, tb_cpointer_t data, tb_pointer_t* pdata)
+{
+    // get the current scheduler and the running coroutine
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+    tb_assert_and_check_return_val(scheduler && scheduler->running, tb_false);
+
+    // we need the io loop to wait the wakeup from the other schedulers
+    if (!tb_co_scheduler_io_need(scheduler)) return tb_false;
+
+    // register this coroutine first and try it again, we may lose the wakeup
+    tb_coroutine_t*                 running = scheduler->running;
+    tb_single_list_entry_head_ref_t waiting = send? &channel->waiting_send : &channel->waiting_recv;
+    tb_atomic_t*                    waitingn = send? &channel->waiting_sendn : &channel->waiting_recvn;
+    tb_bool_t                       ok = tb_false;
+    tb_spinlock_enter(&channel->lock);
+    tb_atomic_fetch_and_add(waitingn, 1);
+    ok = send? tb_co_mpmc_channel_queue_put(channel, data) : tb_co_mpmc_channel_queue_pop(channel, pdata);
+    if (ok) tb_atomic_fetch_and_sub(waitingn, 1);
+    else tb_single_list_entry_insert_tail(waiting, &running->rs.single_entry);
+    tb_spinlock_leave(&channel->lock);
+
+    // wait it
+    if (!ok)
+    {
+        // trace
+        tb_trace_d("%s[%p]: wait ..", send? "send" : "recv", running);
+
+        // suspend it, it may be resumed from the other scheduler
+        tb_coroutine_suspend(tb_null);
+
+        // trace
+        tb_trace_d("%s[%p]: wait ok", send? "send" : "recv", running);
+    }
+    return ok;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_co_mpmc_channel_ref_t tb_co_mpmc_channel_init(tb_size_t size, tb_co_channel_free_func_t free, tb_cpointer_t priv)
+{
+    // done
+    tb_bool_t               ok = tb_false;
+    tb_co_mpmc_channel_t*   channel = tb_null;
+    do
+    {
+        // make channel
+        channel = tb_malloc0_type(tb_co_mpmc_channel_t);
+        tb_assert_and_check_break(channel);
+
+        // init lock
+        if (!tb_spinlock_init(&channel->lock)) break;
+
+        // init waiting send coroutines
+        tb_single_list_entry_init(&channel->waiting_send, tb_coroutine_t, rs.single_entry, tb_null);
+
+        // init waiting recv coroutines
+        tb_single_list_entry_init(&channel->waiting_recv, tb_coroutine_t, rs.single_entry, tb_null);
+
+        // init free function and data
+        channel->free = free;
+        channel->priv = priv;
+
+        // make cells
+        if (size < 2) size = 2;
+        size = tb_align_pow2(size);
+        channel->cells = tb_nalloc0_type(size, tb_co_mpmc_channel_cell_t);
+        tb_assert_and_check_break(channel->cells);
+        channel->mask = size - 1;
+
+        // init cells
+        tb_size_t i = 0;
+        for (i = 0; i < size; i++)
+            tb_atomic_init(&channel->cells[i].seq, (tb_long_t)i);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (channel) tb_co_mpmc_channel_exit((tb_co_mpmc_channel_ref_t)channel);
+        channel = tb_null;
+    }
+
+    // ok?
+    return (tb_co_mpmc_channel_ref_t)channel;
+}
+tb_void_t tb_co_mpmc_channel_exit(tb_co_mpmc_channel_ref_t self)
+{
+    // check
+    tb_co_mpmc_channel_t* channel = (tb_co_mpmc_channel_t*)self;
+    tb_assert_and_check_return(channel);
+
+    // exit cells
+    if (channel->cells)
+    {
+        // free the left data
+        tb_pointer_t data = tb_null;
+        while (tb_co_mpmc_channel_queue_pop(channel, &data))
+        {
+            if (channel->free) channel->free(data, channel->priv);
+        }
+
+        // free it
+        tb_free(channel->cells);
+        channel->cells = tb_null;
+    }
+
+    // check waiting coroutines
+    tb_assert(!tb_single_list_entry_size(&channel->waiting_send));
+    tb_assert(!tb_single_list_entry_size(&channel->waiting_recv));
+
+    // exit waiting coroutines
+    tb_single_list_entry_exit(&channel->waiting_send);
+    tb_single_list_entry_exit(&channel->waiting_recv);
+
+    // exit lock
+    tb_spinlock_exit(&channel->lock);
+
+    // exit the channel
+    tb_free(channel);
+}
+tb_void_t tb_co_mpmc_channel_send(tb_co_mpmc_channel_ref_t self, tb_cpointer_t data)
+{
+    // check
+    tb_co_mpmc_channel_t* channel = (tb_co_mpmc_channel_t*)self;
+    tb_assert_and_check_return(channel && channel->cells);
+
+    // put data, wait it if be full
+    while (!tb_co_mpmc_channel_queue_put(channel, data))
+    {
+        if (tb_co_mpmc_channel_wait(channel, tb_true, data, tb_null)) break;
+    }
+
+    // trace
+    tb_trace_d("send[%p]: put data(%p)", tb_coroutine_self(), data);
+
+    // notify to recv data
+    tb_co_mpmc_channel_wake(channel, &channel->waiting_recv, &channel->waiting_recvn);
+}
+tb_pointer_t tb_co_mpmc_channel_recv(tb_co_mpmc_channel_ref_t self)
+{
+    // check
+    tb_co_mpmc_channel_t* channel = (tb_co_mpmc_channel_t*)self;
+    tb_assert_and_check_return_val(channel && channel->cells, tb_null);
+
+    // get data, wait it if be empty
+    tb_pointer_t data = tb_null;
+    while (!tb_co_mpmc_channel_queue_pop(channel, &data))
+    {
+        if (tb_co_mpmc_channel_wait(channel, tb_false, tb_null, &data)) break;
+    }
+
+    // trace
+    tb_trace_d("recv[%p]: get data(%p)", tb_coroutine_self(), data);
+
+    // notify to send data
+    tb_co_mpmc_channel_wake(channel, &channel->waiting_send, &channel->waiting_sendn);
+    return data;
+}
+tb_bool_t tb_co_mpmc_channel_send_try(tb_co_mpmc_channel_ref_t self, tb_cpointer_t data)
+{
+    // check
+    tb_co_mpmc_channel_t* channel = (tb_co_mpmc_channel_t*)self;
+    tb_assert_and_check_return_val(channel && channel->cells, tb_false);
+
+    // put data
+    tb_check_return_val(tb_co_mpmc_channel_queue_put(channel, data), tb_false);
+
+    // notify to recv data
+    tb_co_mpmc_channel_wake(channel, &channel->waiting_recv, &channel->waiting_recvn);
+    return tb_true;
+}
+tb_bool_t tb_co_mpmc_channel_recv_try(tb_co_mpmc_channel_ref_t self, tb_pointer_t* pdata)
+{
+    // check
+    tb_co_mpmc_channel_t* channel = (tb_co_mpmc_channel_t*)self;
+    tb_assert_and_check_return_val(channel && channel->cells && pdata, tb_false);
+
+    // get data
+    tb_check_return_val(tb_co_mpmc_channel_queue_pop(channel, pdata), tb_false);
+
+    // notify to send data
+    tb_co_mpmc_channel_wake(channel, &channel->waiting_send, &channel->waiting_sendn);
+    return tb_true;
+}
+tb_size_t tb_co_mpmc_channel_size(tb_co_mpmc_channel_ref_t self)
+{
+    // check
+    tb_co_mpmc_channel_t* channel = (tb_co_mpmc_channel_t*)self;
+    tb_assert_and_check_return_val(channel, 0);
+
+    // get the approximate size
+    tb_long_t head = tb_atomic_get_explicit(&channel->head, TB_ATOMIC_RELAXED);
+    tb_long_t tail = tb_atomic_get_explicit(&channel->tail, TB_ATOMIC_RELAXED);
+    return tail > head? (tb_size_t)(tail - head) : 0;
+}
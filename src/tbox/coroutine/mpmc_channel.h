@@ -0,0 +1,128 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        mpmc_channel.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_MPMC_CHANNEL_H
+#define TB_COROUTINE_MPMC_CHANNEL_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "channel.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the thread-safe coroutine channel ref type
+ *
+ * it can be used between the coroutines on the different schedulers and threads,
+ * e.g. the accept coroutine on one scheduler sends the client sockets to the worker coroutines on the other schedulers.
+ *
+ * the data is stored in a bounded lock-free queue, and the waiting coroutine on the other scheduler
+ * will be posted to the inbox of its scheduler and the poller of this scheduler will be waked up.
+ *
+ * @note the schedulers cannot be run in the exclusive mode
+ */
+typedef __tb_typeref__(co_mpmc_channel);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init channel
+ *
+ * @param size          the buffer size, it will be aligned by pow2 and at least 2
+ * @param free          the free function for the left data
+ * @param priv          the user private data
+ *
+ * @return              the channel
+ */
+tb_co_mpmc_channel_ref_t    tb_co_mpmc_channel_init(tb_size_t size, tb_co_channel_free_func_t free, tb_cpointer_t priv);
+
+/*! exit channel
+ *
+ * @note there must be no waiting coroutines
+ *
+ * @param channel       the channel
+ */
+tb_void_t                   tb_co_mpmc_channel_exit(tb_co_mpmc_channel_ref_t channel);
+
+/*! send data into channel
+ *
+ * the current coroutine will be suspend if this channel is full
+ *
+ * @param channel       the channel
+ * @param data          the channel data
+ */
+tb_void_t                   tb_co_mpmc_channel_send(tb_co_mpmc_channel_ref_t channel, tb_cpointer_t data);
+
+/*! recv data from channel
+ *
+ * the current coroutine will be suspend if no data
+ *
+ * @param channel       the channel
+ *
+ * @return              the channel data
+ */
+tb_pointer_t                tb_co_mpmc_channel_recv(tb_co_mpmc_channel_ref_t channel);
+
+/*! try sending data into channel
+ *
+ * it will not be suspended and can be also called from a non-coroutine thread
+ *
+ * @param channel       the channel
+ * @param data          the channel data
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t                   tb_co_mpmc_channel_send_try(tb_co_mpmc_channel_ref_t channel, tb_cpointer_t data);
+
+/*! try recving data from channel
+ *
+ * it will not be suspended and can be also called from a non-coroutine thread
+ *
+ * @param channel       the channel
+ * @param pdata         the channel data pointer
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t                   tb_co_mpmc_channel_recv_try(tb_co_mpmc_channel_ref_t channel, tb_pointer_t* pdata);
+
+/*! get the approximate data count of channel
+ *
+ * @param channel       the channel
+ *
+ * @return              the data count
+ */
+tb_size_t                   tb_co_mpmc_channel_size(tb_co_mpmc_channel_ref_t channel);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,165 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        rwlock.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "rwlock"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "rwlock.h"
+#include "impl/impl.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the coroutine reader/writer lock type
+typedef struct __tb_co_rwlock_t
+{
+    // the readers count in the lock
+    tb_size_t                   readers;
+
+    // has writer in the lock?
+    tb_bool_t                   writer;
+
+    // the waiting readers
+    tb_co_waitq_t               readers_waitq;
+
+    // the waiting writers
+    tb_co_waitq_t               writers_waitq;
+
+}tb_co_rwlock_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_co_rwlock_ref_t tb_co_rwlock_init()
+{
+    // make rwlock
+    tb_co_rwlock_t* rwlock = tb_malloc0_type(tb_co_rwlock_t);
+    tb_assert_and_check_return_val(rwlock, tb_null);
+
+    // init the waiting readers and writers
+    tb_co_waitq_init(&rwlock->readers_waitq);
+    tb_co_waitq_init(&rwlock->writers_waitq);
+
+    // ok
+    return (tb_co_rwlock_ref_t)rwlock;
+}
+tb_void_t tb_co_rwlock_exit(tb_co_rwlock_ref_t self)
+{
+    // check
+    tb_co_rwlock_t* rwlock = (tb_co_rwlock_t*)self;
+    tb_assert_and_check_return(rwlock);
+
+    // check
+    tb_assert(!rwlock->readers && !rwlock->writer);
+
+    // exit the waiting readers and writers
+    tb_co_waitq_exit(&rwlock->readers_waitq);
+    tb_co_waitq_exit(&rwlock->writers_waitq);
+
+    // exit it
+    tb_free(rwlock);
+}
+tb_void_t tb_co_rwlock_enter_read(tb_co_rwlock_ref_t self)
+{
+    // check
+    tb_co_rwlock_t* rwlock = (tb_co_rwlock_t*)self;
+    tb_assert_and_check_return(rwlock);
+
+    // enter it directly?
+    if (tb_co_rwlock_enter_read_try(self)) return ;
+
+    // wait it, the lock will be handed over to us when we are waked up
+    tb_co_waitq_wait(&rwlock->readers_waitq, 0, -1, tb_false);
+}
+tb_bool_t tb_co_rwlock_enter_read_try(tb_co_rwlock_ref_t self)
+{
+    // check
+    tb_co_rwlock_t* rwlock = (tb_co_rwlock_t*)self;
+    tb_assert_and_check_return_val(rwlock, tb_false);
+
+    // no writer in the lock and no waiting writers? we need not starve the writers
+    tb_check_return_val(!rwlock->writer && !tb_co_waitq_size(&rwlock->writers_waitq), tb_false);
+
+    // enter it
+    rwlock->readers++;
+    return tb_true;
+}
+tb_void_t tb_co_rwlock_enter_write(tb_co_rwlock_ref_t self)
+{
+    // check
+    tb_co_rwlock_t* rwlock = (tb_co_rwlock_t*)self;
+    tb_assert_and_check_return(rwlock);
+
+    // enter it directly?
+    if (tb_co_rwlock_enter_write_try(self)) return ;
+
+    // wait it, the lock will be handed over to us when we are waked up
+    tb_co_waitq_wait(&rwlock->writers_waitq, 0, -1, tb_false);
+}
+tb_bool_t tb_co_rwlock_enter_write_try(tb_co_rwlock_ref_t self)
+{
+    // check
+    tb_co_rwlock_t* rwlock = (tb_co_rwlock_t*)self;
+    tb_assert_and_check_return_val(rwlock, tb_false);
+
+    // no readers and writer in the lock?
+    tb_check_return_val(!rwlock->writer && !rwlock->readers, tb_false);
+
+    // enter it
+    rwlock->writer = tb_true;
+    return tb_true;
+}
+tb_void_t tb_co_rwlock_leave(tb_co_rwlock_ref_t self)
+{
+    // check
+    tb_co_rwlock_t* rwlock = (tb_co_rwlock_t*)self;
+    tb_assert_and_check_return(rwlock && (rwlock->writer || rwlock->readers));
+
+    // leave it
+    if (rwlock->writer)
+    {
+        // leave the writer
+        rwlock->writer = tb_false;
+
+        // hand over the lock to all waiting readers first, the writers have owned it for a while
+        tb_size_t count = tb_co_waitq_size(&rwlock->readers_waitq);
+        if (count)
+        {
+            rwlock->readers = count;
+            tb_co_waitq_wake_all(&rwlock->readers_waitq);
+            return ;
+        }
+    }
+    // leave the reader, other readers are still in the lock?
+    else if (--rwlock->readers) return ;
+
+    // hand over the lock to the next waiting writer
+    if (tb_co_waitq_wake(&rwlock->writers_waitq))
+        rwlock->writer = tb_true;
+}
@@ -0,0 +1,100 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        rwlock.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_RWLOCK_H
+#define TB_COROUTINE_RWLOCK_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the coroutine reader/writer lock ref type
+typedef __tb_typeref__(co_rwlock);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init reader/writer lock
+ *
+ * the readers can enter it concurrently and the writer is exclusive,
+ * the new readers will be suspended if there are waiting writers, so the writers will not be starved.
+ *
+ * @return              the rwlock
+ */
+tb_co_rwlock_ref_t      tb_co_rwlock_init(tb_noarg_t);
+
+/*! exit reader/writer lock
+ *
+ * @param rwlock        the rwlock
+ */
+tb_void_t               tb_co_rwlock_exit(tb_co_rwlock_ref_t rwlock);
+
+/*! enter reader lock
+ *
+ * @param rwlock        the rwlock
+ */
+tb_void_t               tb_co_rwlock_enter_read(tb_co_rwlock_ref_t rwlock);
+
+/*! try to enter reader lock
+ *
+ * @param rwlock        the rwlock
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_co_rwlock_enter_read_try(tb_co_rwlock_ref_t rwlock);
+
+/*! enter writer lock
+ *
+ * @param rwlock        the rwlock
+ */
+tb_void_t               tb_co_rwlock_enter_write(tb_co_rwlock_ref_t rwlock);
+
+/*! try to enter writer lock
+ *
+ * @param rwlock        the rwlock
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_co_rwlock_enter_write_try(tb_co_rwlock_ref_t rwlock);
+
+/*! leave reader or writer lock
+ *
+ * @param rwlock        the rwlock
+ */
+tb_void_t               tb_co_rwlock_leave(tb_co_rwlock_ref_t rwlock);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
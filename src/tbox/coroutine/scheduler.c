@@ -71,6 +71,79 @@ static tb_void_t tb_co_scheduler_free(tb_list_entry_head_ref_t coroutines)
         tb_coroutine_exit((tb_coroutine_t*)tb_list_entry0(entry));
     }
 }
+static tb_void_t tb_co_scheduler_dump_coroutines(tb_co_scheduler_t* scheduler, tb_list_entry_head_ref_t coroutines, tb_char_t const* state)
+{
+    // dump all coroutines
+    tb_for_all_if (tb_coroutine_t*, coroutine, tb_list_entry_itor(coroutines), coroutine)
+    {
+        // get the max stack depth, the watermark is more accurate than the sampled depth
+        tb_co_profile_t const*  profile = &coroutine->profile;
+        tb_size_t               stackdepth = tb_max(profile->stackdepth, tb_coroutine_stack_depth(coroutine));
+
+        // trace
+        tb_trace_i("    coroutine(%p): %s%s, switches: %llu, runtime: %lld us, max: %lld us, io: %lld us, timer: %lld us, wait: %lld us, stack: %lu/%lu"
+            , coroutine, coroutine == scheduler->running? "running" : state, coroutine->internal? "(internal)" : ""
+            , profile->switches, profile->runtime, profile->runtime_max, profile->iotime, profile->timertime, profile->waittime
+            , stackdepth, coroutine->stacksize);
+    }
+}
+static tb_void_t tb_co_scheduler_loop_impl(tb_co_scheduler_t* scheduler, tb_bool_t exclusive)
+{
+    // check
+    tb_assert(scheduler);
+
+#ifdef __tb_thread_local__
+    g_scheduler_self_ex = scheduler;
+#else
+    // is exclusive mode?
+    if (exclusive) g_scheduler_self_ex = scheduler;
+    else
+    {
+        // init self scheduler local
+        if (!tb_thread_local_init(&g_scheduler_self, tb_null)) return ;
+
+        // update and overide the current scheduler
+        tb_thread_local_set(&g_scheduler_self, scheduler);
+    }
+#endif
+
+#ifdef TB_CONFIG_OS_WINDOWS
+    // we need attach poller in the current thread first for iocp/windows
+    tb_co_scheduler_io_need(scheduler);
+#endif
+
+    // schedule all ready coroutines
+    while (tb_list_entry_size(&scheduler->coroutines_ready))
+    {
+        // check
+        tb_assert(tb_coroutine_is_original(scheduler->running));
+
+        // get the next entry from head
+        tb_list_entry_ref_t entry = tb_list_entry_head(&scheduler->coroutines_ready);
+        tb_assert(entry);
+
+        // switch to the next coroutine
+        tb_co_scheduler_switch(scheduler, (tb_coroutine_t*)tb_list_entry0(entry));
+
+        // trace
+        tb_trace_d("[loop]: ready %lu", tb_list_entry_size(&scheduler->coroutines_ready));
+    }
+
+    // stop it
+    scheduler->stopped = tb_true;
+
+#ifdef __tb_thread_local__
+    g_scheduler_self_ex = tb_null;
+#else
+    // is exclusive mode?
+    if (exclusive) g_scheduler_self_ex = tb_null;
+    else
+    {
+        // clear the current scheduler
+        tb_thread_local_set(&g_scheduler_self, tb_null);
+    }
+#endif
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -95,12 +168,22 @@ tb_co_scheduler_ref_t tb_co_scheduler_init()
         // init suspend coroutines
         tb_list_entry_init(&scheduler->coroutines_suspend, tb_coroutine_t, entry, tb_null);
 
+        // init the in-flight blocking calls
+        tb_list_entry_init(&scheduler->calls, tb_co_scheduler_call_t, entry, tb_null);
+
+        // init the lock of the posted settings
+        tb_spinlock_init(&scheduler->settings_lock);
+
         // init original coroutine
         scheduler->original.scheduler = (tb_co_scheduler_ref_t)scheduler;
 
         // init running
         scheduler->running = &scheduler->original;
 
+        // init stack pool
+        scheduler->stack_pool = tb_co_stack_pool_init(tb_coroutine_stack_mapsize(0));
+        tb_assert_and_check_break(scheduler->stack_pool);
+
         // ok
         ok = tb_true;
 
@@ -117,6 +200,23 @@ tb_co_scheduler_ref_t tb_co_scheduler_init()
     // ok?
     return (tb_co_scheduler_ref_t)scheduler;
 }
+tb_co_scheduler_ref_t tb_co_scheduler_init_with_workers(tb_size_t workern)
+{
+    // init the scheduler of the first worker
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)tb_co_scheduler_init();
+    tb_assert_and_check_return_val(scheduler, tb_null);
+
+    // init the worker group
+    if (!tb_co_worker_group_init(scheduler, workern? workern : tb_cpu_count()))
+    {
+        scheduler->stopped = tb_true;
+        tb_co_scheduler_exit((tb_co_scheduler_ref_t)scheduler);
+        scheduler = tb_null;
+    }
+
+    // ok?
+    return (tb_co_scheduler_ref_t)scheduler;
+}
 tb_void_t tb_co_scheduler_exit(tb_co_scheduler_ref_t self)
 {
     // check
@@ -126,6 +226,13 @@ tb_void_t tb_co_scheduler_exit(tb_co_scheduler_ref_t self)
     // must be stopped
     tb_assert(scheduler->stopped);
 
+    // exit the worker group and other workers (M:N)
+    if (scheduler->worker) tb_co_worker_group_exit(scheduler->worker->group);
+    tb_assert(!scheduler->worker);
+
+    // orphan and wait all in-flight blocking calls, they will not access the stacks of the freed coroutines
+    tb_co_scheduler_call_orphan(scheduler);
+
     // exit io scheduler first
     if (scheduler->scheduler_io) tb_co_scheduler_io_exit(scheduler->scheduler_io);
     scheduler->scheduler_io = tb_null;
@@ -146,6 +253,10 @@ tb_void_t tb_co_scheduler_exit(tb_co_scheduler_ref_t self)
     // free all suspend coroutines
     tb_co_scheduler_free(&scheduler->coroutines_suspend);
 
+    // exit stack pool after freeing all coroutines
+    if (scheduler->stack_pool) tb_co_stack_pool_exit(scheduler->stack_pool);
+    scheduler->stack_pool = tb_null;
+
     // exit dead coroutines
     tb_list_entry_exit(&scheduler->coroutines_dead);
 
@@ -155,6 +266,12 @@ tb_void_t tb_co_scheduler_exit(tb_co_scheduler_ref_t self)
     // exit suspend coroutines
     tb_list_entry_exit(&scheduler->coroutines_suspend);
 
+    // exit the in-flight blocking calls
+    tb_list_entry_exit(&scheduler->calls);
+
+    // exit the lock of the posted settings
+    tb_spinlock_exit(&scheduler->settings_lock);
+
     // exit the scheduler
     tb_free(scheduler);
 }
@@ -164,6 +281,13 @@ tb_void_t tb_co_scheduler_kill(tb_co_scheduler_ref_t self)
     tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
     tb_assert_and_check_return(scheduler);
 
+    // kill all workers (M:N)
+    if (scheduler->worker)
+    {
+        tb_co_worker_group_kill(scheduler->worker->group);
+        return ;
+    }
+
     // stop it
     scheduler->stopped = tb_true;
 
@@ -176,57 +300,160 @@ tb_void_t tb_co_scheduler_loop(tb_co_scheduler_ref_t self, tb_bool_t exclusive)
     tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
     tb_assert_and_check_return(scheduler);
 
-#ifdef __tb_thread_local__
-    g_scheduler_self_ex = scheduler;
-#else
-    // is exclusive mode?
-    if (exclusive) g_scheduler_self_ex = scheduler;
-    else
+    // run the first worker on the current thread and the other workers on their own threads (M:N)
+    tb_co_worker_ref_t worker = scheduler->worker;
+    if (worker && !worker->index)
     {
-        // init self scheduler local
-        if (!tb_thread_local_init(&g_scheduler_self, tb_null)) return ;
+        // start the other workers
+        if (tb_co_worker_group_start(worker->group))
+            tb_co_scheduler_loop_impl(scheduler, tb_false);
+        else tb_co_worker_group_kill(worker->group);
+
+        // wait the other workers
+        tb_co_worker_group_wait(worker->group);
+        return ;
+    }
 
-        // update and overide the current scheduler
-        tb_thread_local_set(&g_scheduler_self, self);
+    // run the scheduler loop, we cannot use the global scheduler for multiple workers
+    tb_co_scheduler_loop_impl(scheduler, exclusive && !worker);
+}
+tb_void_t tb_co_scheduler_busypoll_set(tb_co_scheduler_ref_t self, tb_size_t timeout)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return(scheduler);
+
+    // init settings
+    tb_co_scheduler_settings_t settings = {0};
+    settings.busypoll = timeout;
+
+    // set it for all workers (M:N), they will be applied by the io loops of the other workers
+    tb_co_worker_ref_t worker = scheduler->worker;
+    if (worker)
+    {
+        tb_size_t i = 0;
+        tb_co_worker_group_ref_t group = worker->group;
+        for (i = 0; i < group->workern; i++)
+            tb_co_scheduler_settings_set(group->workers[i].scheduler, TB_CO_SCHEDULER_SETTING_BUSYPOLL, &settings);
     }
-#endif
+    else tb_co_scheduler_settings_set(scheduler, TB_CO_SCHEDULER_SETTING_BUSYPOLL, &settings);
+}
+tb_void_t tb_co_scheduler_timeout_slack_set(tb_co_scheduler_ref_t self, tb_size_t slack)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return(scheduler);
 
-#ifdef TB_CONFIG_OS_WINDOWS
-    // we need attach poller in the current thread first for iocp/windows
-    tb_co_scheduler_io_need(scheduler);
-#endif
+    // init settings
+    tb_co_scheduler_settings_t settings = {0};
+    settings.timeout_slack = slack;
 
-    // schedule all ready coroutines
-    while (tb_list_entry_size(&scheduler->coroutines_ready))
+    // set it for all workers (M:N), they will be applied by the io loops of the other workers
+    tb_co_worker_ref_t worker = scheduler->worker;
+    if (worker)
     {
-        // check
-        tb_assert(tb_coroutine_is_original(scheduler->running));
+        tb_size_t i = 0;
+        tb_co_worker_group_ref_t group = worker->group;
+        for (i = 0; i < group->workern; i++)
+            tb_co_scheduler_settings_set(group->workers[i].scheduler, TB_CO_SCHEDULER_SETTING_TIMEOUT_SLACK, &settings);
+    }
+    else tb_co_scheduler_settings_set(scheduler, TB_CO_SCHEDULER_SETTING_TIMEOUT_SLACK, &settings);
+}
+tb_bool_t tb_co_scheduler_stats(tb_co_scheduler_ref_t self, tb_co_scheduler_stats_ref_t stats)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return_val(scheduler && stats, tb_false);
 
-        // get the next entry from head
-        tb_list_entry_ref_t entry = tb_list_entry_head(&scheduler->coroutines_ready);
-        tb_assert(entry);
+    // sum the stats of all workers (M:N)
+    tb_co_worker_ref_t worker = scheduler->worker;
+    if (worker)
+    {
+        tb_size_t i = 0;
+        tb_co_worker_group_ref_t group = worker->group;
+        tb_memset_(stats, 0, sizeof(tb_co_scheduler_stats_t));
+        for (i = 0; i < group->workern; i++)
+        {
+            tb_co_scheduler_stats_ref_t worker_stats = &group->workers[i].scheduler->stats;
+            stats->waits        += worker_stats->waits;
+            stats->wakeups      += worker_stats->wakeups;
+            stats->events       += worker_stats->events;
+            stats->spins        += worker_stats->spins;
+            stats->spin_hits    += worker_stats->spin_hits;
+        }
+    }
+    else *stats = scheduler->stats;
 
-        // switch to the next coroutine
-        tb_co_scheduler_switch(scheduler, (tb_coroutine_t*)tb_list_entry0(entry));
+    // ok
+    return tb_true;
+}
+tb_void_t tb_co_scheduler_profile_set(tb_co_scheduler_ref_t self, tb_bool_t enabled)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return(scheduler);
 
-        // trace
-        tb_trace_d("[loop]: ready %lu", tb_list_entry_size(&scheduler->coroutines_ready));
+    // init settings
+    tb_co_scheduler_settings_t settings = {0};
+    settings.profile = enabled;
+
+    // set it for all workers (M:N), they will be applied by the io loops of the other workers
+    tb_co_worker_ref_t worker = scheduler->worker;
+    if (worker)
+    {
+        tb_size_t i = 0;
+        tb_co_worker_group_ref_t group = worker->group;
+        for (i = 0; i < group->workern; i++)
+            tb_co_scheduler_settings_set(group->workers[i].scheduler, TB_CO_SCHEDULER_SETTING_PROFILE, &settings);
     }
+    else tb_co_scheduler_settings_set(scheduler, TB_CO_SCHEDULER_SETTING_PROFILE, &settings);
+}
+tb_void_t tb_co_scheduler_slow_set(tb_co_scheduler_ref_t self, tb_size_t threshold, tb_co_scheduler_slow_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return(scheduler);
 
-    // stop it
-    scheduler->stopped = tb_true;
+    // init settings, enable the profiling for detecting the slow coroutines
+    tb_size_t                   flags = TB_CO_SCHEDULER_SETTING_SLOW;
+    tb_co_scheduler_settings_t  settings = {0};
+    settings.slow_threshold = threshold;
+    settings.slow_func      = func;
+    settings.slow_priv      = priv;
+    if (func)
+    {
+        settings.profile = tb_true;
+        flags |= TB_CO_SCHEDULER_SETTING_PROFILE;
+    }
 
-#ifdef __tb_thread_local__
-    g_scheduler_self_ex = tb_null;
-#else
-    // is exclusive mode?
-    if (exclusive) g_scheduler_self_ex = tb_null;
-    else
+    // set it for all workers (M:N), they will be applied by the io loops of the other workers
+    tb_co_worker_ref_t worker = scheduler->worker;
+    if (worker)
     {
-        // clear the current scheduler
-        tb_thread_local_set(&g_scheduler_self, tb_null);
+        tb_size_t i = 0;
+        tb_co_worker_group_ref_t group = worker->group;
+        for (i = 0; i < group->workern; i++)
+            tb_co_scheduler_settings_set(group->workers[i].scheduler, flags, &settings);
     }
-#endif
+    else tb_co_scheduler_settings_set(scheduler, flags, &settings);
+}
+tb_void_t tb_co_scheduler_dump(tb_co_scheduler_ref_t self)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return(scheduler);
+
+    // trace
+    tb_trace_i("scheduler(%p): ready: %lu, suspend: %lu, dead: %lu, profile: %s"
+        , scheduler
+        , tb_list_entry_size(&scheduler->coroutines_ready)
+        , tb_list_entry_size(&scheduler->coroutines_suspend)
+        , tb_list_entry_size(&scheduler->coroutines_dead)
+        , scheduler->profile? "on" : "off");
+
+    // dump the running, ready and suspended coroutines
+    tb_co_scheduler_dump_coroutines(scheduler, &scheduler->coroutines_ready, "ready");
+    tb_co_scheduler_dump_coroutines(scheduler, &scheduler->coroutines_suspend, "suspend");
 }
 tb_co_scheduler_ref_t tb_co_scheduler_self()
 {
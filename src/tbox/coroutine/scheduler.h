@@ -39,6 +39,69 @@ __tb_extern_c_enter__
 /// the coroutine scheduler ref type
 typedef __tb_typeref__(co_scheduler);
 
+/// the coroutine scheduler stats type
+typedef struct __tb_co_scheduler_stats_t
+{
+    /// the poller waits count, including the non-blocking waits of busy-polling
+    tb_hize_t               waits;
+
+    /// the blocking poller waits count, the io loop is waked up after each of them
+    tb_hize_t               wakeups;
+
+    /// the dispatched io events count, events per wait: events / waits
+    tb_hize_t               events;
+
+    /// the busy-polling rounds count
+    tb_hize_t               spins;
+
+    /// the busy-polling rounds which have got the ready coroutines without blocking
+    tb_hize_t               spin_hits;
+
+}tb_co_scheduler_stats_t, *tb_co_scheduler_stats_ref_t;
+
+/// the coroutine profile type
+typedef struct __tb_co_profile_t
+{
+    /// the coroutine
+    tb_cpointer_t           coroutine;
+
+    /// the switched out count
+    tb_hize_t               switches;
+
+    /// the total running time (us)
+    tb_hong_t               runtime;
+
+    /// the last running time (us) without yielding
+    tb_hong_t               runtime_last;
+
+    /// the maximum running time (us) without yielding
+    tb_hong_t               runtime_max;
+
+    /// the suspended time (us) on io events, processes and file watchers
+    tb_hong_t               iotime;
+
+    /// the suspended time (us) on timers, e.g. sleep()
+    tb_hong_t               timertime;
+
+    /// the suspended time (us) on the other objects, e.g. locks, channels and conditions
+    tb_hong_t               waittime;
+
+    /// the maximum observed stack depth (bytes)
+    tb_size_t               stackdepth;
+
+    /// the stack size (bytes)
+    tb_size_t               stacksize;
+
+}tb_co_profile_t, *tb_co_profile_ref_t;
+
+/*! the slow coroutine function type
+ *
+ * @param scheduler         the scheduler
+ * @param profile           the profile of the slow coroutine
+ * @param priv              the user private data
+ */
+typedef tb_void_t           (*tb_co_scheduler_slow_func_t)(tb_co_scheduler_ref_t scheduler, tb_co_profile_ref_t profile, tb_cpointer_t priv);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -49,6 +112,23 @@ typedef __tb_typeref__(co_scheduler);
  */
 tb_co_scheduler_ref_t   tb_co_scheduler_init(tb_noarg_t);
 
+/*! init scheduler with the given worker threads (M:N)
+ *
+ * each worker has its own run queue, poller and timers, the first worker is run on the thread of loop(),
+ * and the idle workers will steal the ready coroutines from the other workers.
+ *
+ * the new and resumed coroutines may be migrated to the other workers,
+ * but the coroutines which have waited io, process or fwatcher events will be pinned to the current worker.
+ *
+ * @note the coroutine lock, semaphore and channel are not thread-safe,
+ * we can only use them between the coroutines on the same worker.
+ *
+ * @param workern       the worker count, uses the cpu count if be zero
+ *
+ * @return              the scheduler
+ */
+tb_co_scheduler_ref_t   tb_co_scheduler_init_with_workers(tb_size_t workern);
+
 /*! exit scheduler
  *
  * @param scheduler     the scheduler
@@ -69,6 +149,83 @@ tb_void_t               tb_co_scheduler_kill(tb_co_scheduler_ref_t scheduler);
  */
 tb_void_t               tb_co_scheduler_loop(tb_co_scheduler_ref_t schedule, tb_bool_t exclusive);
 
+/*! set the busy-polling timeout
+ *
+ * the io loop will poll the io events and the posted coroutines without blocking
+ * for the given microseconds before blocking in the poller, it reduces the wakeup latency
+ * at the cost of burning cpu, e.g. for the low-latency rpc server.
+ *
+ * @note it will be applied to all workers for the M:N scheduler, and it's disabled by default.
+ *
+ * @param scheduler     the scheduler
+ * @param timeout       the busy-polling timeout (us), disable it if be zero
+ */
+tb_void_t               tb_co_scheduler_busypoll_set(tb_co_scheduler_ref_t scheduler, tb_size_t timeout);
+
+/*! set the io timeout slack and enable the deadline timeout mode
+ *
+ * the timeouts of tb_coroutine_waitio() will be only saved as the deadlines of the waiting poller objects
+ * and checked lazily, so setting and cancelling them need not allocate and maintain the timer tasks.
+ * all deadlines in the same slack window will be coalesced and expired at the end of this window,
+ * so the timeout may be delayed by the given slack at most, e.g. 10ms for the network servers.
+ *
+ * @note it will be applied to all workers for the M:N scheduler, and it's disabled by default.
+ *
+ * @param scheduler     the scheduler
+ * @param slack         the timeout slack (ms), disable the deadline timeout mode if be zero
+ */
+tb_void_t               tb_co_scheduler_timeout_slack_set(tb_co_scheduler_ref_t scheduler, tb_size_t slack);
+
+/*! get the scheduler stats
+ *
+ * the stats of all workers will be summed for the M:N scheduler,
+ * it's only approximate if the scheduler is running on the other threads.
+ *
+ * @param scheduler     the scheduler
+ * @param stats         the stats
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_co_scheduler_stats(tb_co_scheduler_ref_t scheduler, tb_co_scheduler_stats_ref_t stats);
+
+/*! enable or disable the coroutine profiling
+ *
+ * it will measure the running time between switches, the switches count,
+ * the suspended time on io and timers and the stack depth of each coroutine.
+ *
+ * the stacks of the new coroutines will be filled with the watermark for scanning the max stack depth,
+ * so it will commit all stack pages and we should only enable it for diagnosis.
+ *
+ * @note it will be applied to all workers for the M:N scheduler, and it's disabled by default.
+ *
+ * @param scheduler     the scheduler
+ * @param enabled       enable it?
+ */
+tb_void_t               tb_co_scheduler_profile_set(tb_co_scheduler_ref_t scheduler, tb_bool_t enabled);
+
+/*! set the slow coroutine callback
+ *
+ * it will be called when one coroutine has been run for a long time without yielding,
+ * and we can only detect it after the coroutine is switched out.
+ *
+ * @note the profiling will be enabled if the function is not null, the internal coroutines will be ignored.
+ *
+ * @param scheduler     the scheduler
+ * @param threshold     the running time threshold (us)
+ * @param func          the slow coroutine function, disable it if be null
+ * @param priv          the user private data
+ */
+tb_void_t               tb_co_scheduler_slow_set(tb_co_scheduler_ref_t scheduler, tb_size_t threshold, tb_co_scheduler_slow_func_t func, tb_cpointer_t priv);
+
+/*! dump the running, ready and suspended coroutines with their profiles
+ *
+ * @note it's not thread-safe, we need call it in the coroutine or after the scheduler loop is finished,
+ * and it only dumps the coroutines of the current worker for the M:N scheduler.
+ *
+ * @param scheduler     the scheduler
+ */
+tb_void_t               tb_co_scheduler_dump(tb_co_scheduler_ref_t scheduler);
+
 /*! get the scheduler of the current coroutine
  *
  * @return              the scheduler
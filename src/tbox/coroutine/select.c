@@ -0,0 +1,324 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        select.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "select"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "select.h"
+#include "coroutine.h"
+#include "scheduler.h"
+#include "impl/impl.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the channel waiters count on the stack
+#define TB_CO_SELECT_WAITERS_STACK      (8)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_co_select_unwait(tb_co_select_ref_t select, tb_size_t count)
+{
+    // check
+    tb_assert(select && select->coroutine && count <= select->count);
+
+    // remove the waiting channel and io cases
+    tb_size_t                   i;
+    tb_coroutine_t*             coroutine = select->coroutine;
+    tb_co_scheduler_io_ref_t    scheduler_io = tb_co_scheduler_io((tb_co_scheduler_t*)coroutine->scheduler);
+    for (i = 0; i < count; i++)
+    {
+        tb_co_select_case_ref_t scase = &select->cases[i];
+        if (scase->op == TB_CO_SELECT_OP_WAITIO)
+        {
+            if (scheduler_io) tb_co_scheduler_io_wait_remove(scheduler_io, coroutine, &scase->object);
+        }
+        else if (scase->op && select->waiters) tb_co_channel_waiter_remove(&select->waiters[i]);
+    }
+
+    // remove the timer task
+    tb_cpointer_t task = select->task;
+    if (task && scheduler_io)
+    {
+        tb_wtimer_task_exit(scheduler_io->timer, (tb_wtimer_task_ref_t)task);
+        select->task = tb_null;
+    }
+}
+static tb_void_t tb_co_select_resume(tb_co_select_ref_t select, tb_long_t ok)
+{
+    // check
+    tb_assert(select && select->coroutine);
+
+    // stop waiting all cases
+    tb_co_select_unwait(select, select->count);
+
+    /* resume the selecting coroutine, the select will be invalid after resuming it
+     *
+     * it will be posted to the owner scheduler if we are not in the scheduler thread
+     */
+    tb_coroutine_t*     coroutine = select->coroutine;
+    tb_co_scheduler_t*  scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+    coroutine->select = tb_null;
+    if (scheduler) tb_co_scheduler_resume(scheduler, coroutine, (tb_cpointer_t)ok);
+    else tb_co_scheduler_post((tb_co_scheduler_t*)coroutine->scheduler, coroutine, (tb_cpointer_t)ok);
+}
+static tb_void_t tb_co_select_timeout(tb_bool_t killed, tb_cpointer_t priv)
+{
+    // check
+    tb_co_select_ref_t select = (tb_co_select_ref_t)priv;
+    tb_assert(select && select->coroutine);
+
+    // trace
+    tb_trace_d("coroutine(%p): select %s", select->coroutine, killed? "killed" : "timeout");
+
+    // resume the selecting coroutine if the timer task has been not canceled
+    if (!killed) tb_co_select_resume(select, 0);
+}
+static tb_void_t tb_co_select_interrupt(tb_coroutine_t* coroutine, tb_cpointer_t priv)
+{
+    // check
+    tb_co_select_ref_t select = (tb_co_select_ref_t)priv;
+    tb_assert(select && select->coroutine == coroutine);
+
+    // trace
+    tb_trace_d("coroutine(%p): select interrupted", coroutine);
+
+    // resume the selecting coroutine with the failed result
+    tb_co_select_resume(select, -1);
+}
+static tb_bool_t tb_co_select_try(tb_co_select_case_ref_t cases, tb_size_t count)
+{
+    // try the channel cases in order
+    tb_size_t i;
+    for (i = 0; i < count; i++)
+    {
+        tb_co_select_case_ref_t scase = &cases[i];
+        if (scase->op == TB_CO_SELECT_OP_RECV)
+        {
+            tb_pointer_t data = tb_null;
+            if (tb_co_channel_recv_try(scase->channel, &data))
+            {
+                scase->data = data;
+                scase->ready = 1;
+                return tb_true;
+            }
+        }
+        else if (scase->op == TB_CO_SELECT_OP_SEND)
+        {
+            if (tb_co_channel_send_try(scase->channel, scase->data))
+            {
+                scase->ready = 1;
+                return tb_true;
+            }
+        }
+    }
+    return tb_false;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_long_t tb_co_select(tb_co_select_case_ref_t cases, tb_size_t count, tb_long_t timeout)
+{
+    // check
+    tb_assert_and_check_return_val(cases && count, -1);
+
+    // get the current scheduler, we can only select it in coroutine
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+    tb_assert_and_check_return_val(scheduler && scheduler->running && !tb_coroutine_is_original(scheduler->running), -1);
+
+    // have been stopped or cancelled?
+    tb_coroutine_t* coroutine = scheduler->running;
+    tb_check_return_val(!scheduler->stopped && !coroutine->cancelled, -1);
+
+    // reset the ready cases and check the channels
+    tb_size_t i;
+    tb_bool_t has_io = tb_false;
+    for (i = 0; i < count; i++)
+    {
+        tb_co_select_case_ref_t scase = &cases[i];
+        tb_assert_and_check_return_val(scase->op != TB_CO_SELECT_OP_RECV || scase->channel, -1);
+        tb_assert_and_check_return_val(scase->op != TB_CO_SELECT_OP_SEND || scase->channel, -1);
+        if (scase->op == TB_CO_SELECT_OP_WAITIO) has_io = tb_true;
+        scase->ready    = 0;
+        scase->revents  = 0;
+    }
+
+    // try the channel cases first
+    if (tb_co_select_try(cases, count)) return 1;
+
+    // need io scheduler for waiting io events or timeout
+    tb_co_scheduler_io_ref_t scheduler_io = tb_null;
+    if (has_io || timeout > 0)
+    {
+        scheduler_io = tb_co_scheduler_io_need(scheduler);
+        tb_assert_and_check_return_val(scheduler_io, -1);
+    }
+
+    // init select
+    tb_co_select_t select;
+    select.coroutine    = coroutine;
+    select.cases        = cases;
+    select.count        = count;
+    select.waiters      = tb_null;
+    select.task         = tb_null;
+
+    // insert the io cases
+    if (has_io)
+    {
+        // pin it, the poller objects will be attached to the poller of this worker (M:N)
+        coroutine->pinned = 1;
+
+        // insert them and we will return it directly if some events have been cached
+        for (i = 0; i < count; i++)
+        {
+            tb_co_select_case_ref_t scase = &cases[i];
+            tb_check_continue(scase->op == TB_CO_SELECT_OP_WAITIO);
+
+            // return the cached events or the failed events
+            tb_long_t events = tb_co_scheduler_io_wait_insert(scheduler_io, coroutine, &scase->object, scase->events);
+            if (events)
+            {
+                scase->ready    = 1;
+                scase->revents  = events > 0? (tb_size_t)events : TB_POLLER_EVENT_ERROR;
+                tb_co_select_unwait(&select, i + 1);
+                return 1;
+            }
+        }
+    }
+
+    // no wait?
+    if (!timeout)
+    {
+        tb_co_select_unwait(&select, count);
+        return 0;
+    }
+
+    // init the channel waiters
+    tb_co_channel_waiter_t waiters_stack[TB_CO_SELECT_WAITERS_STACK];
+    tb_co_channel_waiter_ref_t waiters = count <= TB_CO_SELECT_WAITERS_STACK? waiters_stack : tb_nalloc_type(count, tb_co_channel_waiter_t);
+    if (!waiters)
+    {
+        tb_co_select_unwait(&select, count);
+        return -1;
+    }
+
+    // append the channel waiters
+    select.waiters = waiters;
+    for (i = 0; i < count; i++)
+    {
+        tb_co_select_case_ref_t     scase = &cases[i];
+        tb_co_channel_waiter_ref_t  waiter = &waiters[i];
+        waiter->waiting     = tb_null;
+        waiter->coroutine   = coroutine;
+        waiter->select      = &select;
+        waiter->data        = scase->op == TB_CO_SELECT_OP_SEND? scase->data : tb_null;
+        if (scase->op == TB_CO_SELECT_OP_RECV || scase->op == TB_CO_SELECT_OP_SEND)
+            tb_co_channel_waiter_insert(scase->channel, waiter, scase->op == TB_CO_SELECT_OP_SEND);
+    }
+
+    // post the timer task
+    if (timeout > 0)
+    {
+        // failed? remove all waiting cases
+        select.task = tb_wtimer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_select_timeout, &select);
+        if (!select.task)
+        {
+            tb_co_select_unwait(&select, count);
+            if (waiters != waiters_stack) tb_free(waiters);
+            return -1;
+        }
+    }
+
+    // trace
+    tb_trace_d("coroutine(%p): select %lu cases with %ld ms ..", coroutine, count, timeout);
+
+    // it can be interrupted by tb_coroutine_cancel()
+    coroutine->select           = &select;
+    coroutine->interrupt        = tb_co_select_interrupt;
+    coroutine->interrupt_priv   = &select;
+
+    // it's waiting io events if has io cases, otherwise it's waiting channels
+    if (has_io) coroutine->profile_waiting = TB_COROUTINE_WAITING_IO;
+
+    // suspend it, all cases will be removed after resuming it
+    tb_long_t ok = (tb_long_t)tb_co_scheduler_suspend(scheduler, tb_null);
+
+    // exit the channel waiters
+    if (waiters != waiters_stack) tb_free(waiters);
+
+    // trace
+    tb_trace_d("coroutine(%p): select %ld", coroutine, ok);
+    return ok;
+}
+tb_void_t tb_co_select_wake(tb_co_select_ref_t select, tb_co_channel_waiter_ref_t waiter)
+{
+    // check
+    tb_assert(select && select->waiters && waiter);
+    tb_assert(waiter >= select->waiters && waiter < select->waiters + select->count);
+
+    // mark this case as ready and save the received data
+    tb_co_select_case_ref_t scase = &select->cases[waiter - select->waiters];
+    if (scase->op == TB_CO_SELECT_OP_RECV) scase->data = waiter->data;
+    scase->ready = 1;
+
+    // resume the selecting coroutine
+    tb_co_select_resume(select, 1);
+}
+tb_void_t tb_co_select_wake_io(tb_co_select_ref_t select, tb_poller_object_ref_t object, tb_size_t events)
+{
+    // check
+    tb_assert(select && object);
+
+    // find the waiting case of this poller object
+    tb_size_t               i;
+    tb_co_select_case_ref_t found = tb_null;
+    for (i = 0; i < select->count; i++)
+    {
+        tb_co_select_case_ref_t scase = &select->cases[i];
+        if (scase->op == TB_CO_SELECT_OP_WAITIO && scase->object.type == object->type && scase->object.ref.ptr == object->ref.ptr)
+        {
+            if (!found) found = scase;
+            if ((scase->events & events) || (events & TB_POLLER_EVENT_ERROR))
+            {
+                found = scase;
+                break;
+            }
+        }
+    }
+    tb_assert_and_check_return(found);
+
+    // mark this case as ready and save the returned events
+    found->ready    = 1;
+    found->revents  = events;
+
+    // resume the selecting coroutine
+    tb_co_select_resume(select, 1);
+}
@@ -0,0 +1,169 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        select.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_SELECT_H
+#define TB_COROUTINE_SELECT_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "channel.h"
+#include "../platform/poller.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the select case operation enum
+typedef enum __tb_co_select_op_e
+{
+    TB_CO_SELECT_OP_NONE    = 0     //!< ignore this case
+,   TB_CO_SELECT_OP_RECV    = 1     //!< recv data from the channel
+,   TB_CO_SELECT_OP_SEND    = 2     //!< send data into the channel
+,   TB_CO_SELECT_OP_WAITIO  = 3     //!< wait io events of the poller object
+
+}tb_co_select_op_e;
+
+/// the select case type
+typedef struct __tb_co_select_case_t
+{
+    /// the operation
+    tb_uint8_t              op;
+
+    /// is this case ready? it will be set by tb_co_select()
+    tb_uint8_t              ready;
+
+    /// the channel for recv and send
+    tb_co_channel_ref_t     channel;
+
+    /// the sending data or the received data
+    tb_cpointer_t           data;
+
+    /// the poller object for waitio
+    tb_poller_object_t      object;
+
+    /// the waited events for waitio
+    tb_size_t               events;
+
+    /// the returned events for waitio
+    tb_size_t               revents;
+
+}tb_co_select_case_t, *tb_co_select_case_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * inline implementation
+ */
+
+/* init the select case
+ *
+ * @param scase         the select case
+ * @param op            the operation
+ */
+static __tb_inline__ tb_void_t tb_co_select_case_init(tb_co_select_case_ref_t scase, tb_size_t op)
+{
+    scase->op               = (tb_uint8_t)op;
+    scase->ready            = 0;
+    scase->channel          = tb_null;
+    scase->data             = tb_null;
+    scase->object.type      = TB_POLLER_OBJECT_NONE;
+    scase->object.ref.ptr   = tb_null;
+    scase->events           = 0;
+    scase->revents          = 0;
+}
+
+/*! init the recv case
+ *
+ * @param scase         the select case
+ * @param channel       the channel
+ */
+static __tb_inline__ tb_void_t tb_co_select_case_recv(tb_co_select_case_ref_t scase, tb_co_channel_ref_t channel)
+{
+    tb_co_select_case_init(scase, TB_CO_SELECT_OP_RECV);
+    scase->channel  = channel;
+}
+
+/*! init the send case
+ *
+ * @param scase         the select case
+ * @param channel       the channel
+ * @param data          the sending data
+ */
+static __tb_inline__ tb_void_t tb_co_select_case_send(tb_co_select_case_ref_t scase, tb_co_channel_ref_t channel, tb_cpointer_t data)
+{
+    tb_co_select_case_init(scase, TB_CO_SELECT_OP_SEND);
+    scase->channel  = channel;
+    scase->data     = data;
+}
+
+/*! init the waitio case
+ *
+ * @param scase         the select case
+ * @param object        the poller object, socket or pipe
+ * @param events        the waited events
+ */
+static __tb_inline__ tb_void_t tb_co_select_case_waitio(tb_co_select_case_ref_t scase, tb_poller_object_ref_t object, tb_size_t events)
+{
+    tb_co_select_case_init(scase, TB_CO_SELECT_OP_WAITIO);
+    scase->object   = *object;
+    scase->events   = events;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! wait multiple channel operations and io events together
+ *
+ * only one case will be completed and marked as ready, the other channel operations will not be done,
+ * the channel cases are checked before the io cases and they will be checked in order.
+ *
+ * @code
+    tb_co_select_case_t cases[3];
+    tb_co_select_case_recv(&cases[0], result);
+    tb_co_select_case_send(&cases[1], request, data);
+    tb_co_select_case_waitio(&cases[2], &object, TB_POLLER_EVENT_RECV);
+    if (tb_co_select(cases, 3, 1000) > 0)
+    {
+        if (cases[0].ready) handle_result(cases[0].data);
+        else if (cases[2].ready) handle_client(cases[2].revents);
+    }
+ * @endcode
+ *
+ * @param cases         the select cases
+ * @param count         the cases count
+ * @param timeout       the timeout, infinity: -1
+ *
+ * @return              ok: 1, timeout: 0, fail or cancelled: -1
+ */
+tb_long_t               tb_co_select(tb_co_select_case_ref_t cases, tb_size_t count, tb_long_t timeout);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -33,7 +33,6 @@
 #include "coroutine.h"
 #include "scheduler.h"
 #include "impl/impl.h"
-#include "../container/container.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
@@ -46,7 +45,7 @@ typedef struct __tb_co_semaphore_t
     tb_size_t                       value;
 
     // the waiting coroutines
-    tb_single_list_entry_head_t     waiting;
+    tb_co_waitq_t                   waiting;
 
 }tb_co_semaphore_t;
 
@@ -68,7 +67,7 @@ tb_co_semaphore_ref_t tb_co_semaphore_init(tb_size_t value)
         semaphore->value = value;
 
         // init waiting coroutines
-        tb_single_list_entry_init(&semaphore->waiting, tb_coroutine_t, rs.single_entry, tb_null);
+        tb_co_waitq_init(&semaphore->waiting);
 
         // ok
         ok = tb_true;
@@ -92,11 +91,8 @@ tb_void_t tb_co_semaphore_exit(tb_co_semaphore_ref_t self)
     tb_co_semaphore_t* semaphore = (tb_co_semaphore_t*)self;
     tb_assert_and_check_return(semaphore);
 
-    // check waiting coroutines
-    tb_assert(!tb_single_list_entry_size(&semaphore->waiting));
-
     // exit waiting coroutines
-    tb_single_list_entry_exit(&semaphore->waiting);
+    tb_co_waitq_exit(&semaphore->waiting);
 
     // exit the semaphore
     tb_free(semaphore);
@@ -110,25 +106,8 @@ tb_void_t tb_co_semaphore_post(tb_co_semaphore_ref_t self, tb_size_t post)
     // add the semaphore value
     tb_size_t value = semaphore->value + post;
 
-    // resume the waiting coroutines
-    while (value && tb_single_list_entry_size(&semaphore->waiting))
-    {
-        // get the next entry from head
-        tb_single_list_entry_ref_t entry = tb_single_list_entry_head(&semaphore->waiting);
-        tb_assert_and_check_break(entry);
-
-        // remove it from the waiting coroutines
-        tb_single_list_entry_remove_head(&semaphore->waiting);
-
-        // get the waiting coroutine
-        tb_coroutine_ref_t coroutine = (tb_coroutine_ref_t)tb_single_list_entry(&semaphore->waiting, entry);
-
-        // resume this coroutine
-        tb_coroutine_resume(coroutine, (tb_cpointer_t)tb_true);
-
-        // decrease the semaphore value
-        value--;
-    }
+    // resume the waiting coroutines, the semaphore value will be handed over to them
+    while (value && tb_co_waitq_wake(&semaphore->waiting)) value--;
 
     // update the semaphore value
     semaphore->value = value;
@@ -151,21 +130,12 @@ tb_long_t tb_co_semaphore_wait(tb_co_semaphore_ref_t self, tb_long_t timeout)
     // attempt to get the semaphore value
     tb_long_t ok = 1;
     if (semaphore->value) semaphore->value--;
-    // no semaphore?
-    else if (timeout)
-    {
-        // get the running coroutine
-        tb_coroutine_t* running = (tb_coroutine_t*)tb_coroutine_self();
-        tb_assert(running);
-
-        // save this coroutine to the waiting coroutines
-        tb_single_list_entry_insert_tail(&semaphore->waiting, &running->rs.single_entry);
-
-        // wait semaphore
-        ok = (tb_long_t)tb_coroutine_sleep(timeout);
-    }
-    // timeout and no waiting
-    else ok = 0;
+    /* no semaphore? wait it
+     *
+     * the semaphore value will be handed over to us when we are waked up,
+     * and the timed out waiter has been removed from the waiting coroutines
+     */
+    else ok = tb_co_waitq_wait(&semaphore->waiting, 0, timeout, tb_false);
 
     // ok?
     return ok;
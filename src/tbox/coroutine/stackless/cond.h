@@ -0,0 +1,85 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        cond.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_STACKLESS_COND_H
+#define TB_COROUTINE_STACKLESS_COND_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "coroutine.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/*! init condition variable
+ *
+ * @param cond          the cond pointer
+ */
+#define tb_lo_cond_init(cond)               tb_lo_coroutine_waitq_init(&(cond)->waitq)
+
+/*! exit condition variable
+ *
+ * @param cond          the cond pointer
+ */
+#define tb_lo_cond_exit(cond)               tb_assert(!(cond)->waitq.size)
+
+/*! wait condition variable
+ *
+ * suspend the current coroutine until it's signaled.
+ *
+ * we need not any lock for it, because the stackless coroutines will not be switched
+ * between checking the condition and waiting it.
+ *
+ * @code
+    while (!ready) tb_lo_cond_wait(&cond);
+ * @endcode
+ *
+ * @param cond          the cond pointer
+ */
+#define tb_lo_cond_wait(cond)               tb_lo_coroutine_waitq(&(cond)->waitq)
+
+/*! wake up one waiting coroutine
+ *
+ * @param cond          the cond pointer
+ */
+#define tb_lo_cond_signal(cond)             tb_lo_coroutine_waitq_wake_(&(cond)->waitq)
+
+/*! wake up all waiting coroutines
+ *
+ * @param cond          the cond pointer
+ */
+#define tb_lo_cond_broadcast(cond)          do { while (tb_lo_coroutine_waitq_wake_(&(cond)->waitq)) ; } while (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the stackless condition variable type
+typedef struct __tb_lo_cond_t
+{
+    // the waiting coroutines
+    tb_lo_waitq_t       waitq;
+
+}tb_lo_cond_t, *tb_lo_cond_ref_t;
+
+#endif
@@ -36,7 +36,7 @@
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
-tb_lo_coroutine_t* tb_lo_coroutine_init(tb_lo_scheduler_ref_t scheduler, tb_lo_coroutine_func_t func, tb_cpointer_t priv, tb_lo_coroutine_free_t free)
+tb_lo_coroutine_t* tb_lo_coroutine_init(tb_lo_scheduler_ref_t scheduler, tb_fixed_pool_ref_t pool, tb_lo_coroutine_func_t func, tb_cpointer_t priv, tb_lo_coroutine_free_t free)
 {
     // check
     tb_assert_and_check_return_val(scheduler && func, tb_null);
@@ -47,8 +47,16 @@ tb_lo_coroutine_t* tb_lo_coroutine_init(tb_lo_scheduler_ref_t scheduler, tb_lo_c
     do
     {
         // make coroutine
+#ifndef TB_CONFIG_MICRO_ENABLE
+        coroutine = pool? (tb_lo_coroutine_t*)tb_fixed_pool_malloc0(pool) : tb_malloc0_type(tb_lo_coroutine_t);
+        tb_assert_and_check_break(coroutine);
+
+        // save the owner slab
+        coroutine->pool = pool;
+#else
         coroutine = tb_malloc0_type(tb_lo_coroutine_t);
         tb_assert_and_check_break(coroutine);
+#endif
 
         // init core
         tb_lo_core_init(&coroutine->core);
@@ -97,6 +105,11 @@ tb_bool_t tb_lo_coroutine_reinit(tb_lo_coroutine_t* coroutine, tb_lo_coroutine_f
     // init rs data
     tb_memset(&coroutine->rs, 0, sizeof(coroutine->rs));
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+    // it's an user coroutine by default
+    coroutine->internal = 0;
+#endif
+
     // ok
     return tb_true;
 }
@@ -108,6 +121,18 @@ tb_void_t tb_lo_coroutine_exit(tb_lo_coroutine_t* coroutine)
     // trace
     tb_trace_d("exit: %p", coroutine);
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+    // exit it to the owner slab, it will be reclaimed lazily by the owner if we are on the other worker
+    tb_fixed_pool_ref_t pool = coroutine->pool;
+    if (pool)
+    {
+        tb_lo_scheduler_t* scheduler = (tb_lo_scheduler_t*)coroutine->scheduler;
+        if (scheduler && scheduler->coroutine_pool == pool) tb_fixed_pool_free(pool, coroutine);
+        else tb_fixed_pool_free_remote(pool, coroutine);
+        return ;
+    }
+#endif
+
     // exit it
     tb_free(coroutine);
 }
@@ -179,6 +204,37 @@ tb_long_t tb_lo_coroutine_proc_status_(tb_lo_coroutine_ref_t self)
     return coroutine->rs.wait.object_event;
 }
 #endif
+tb_void_t tb_lo_coroutine_waitq_push_(tb_lo_coroutine_ref_t self, tb_lo_waitq_ref_t waitq)
+{
+    // check
+    tb_lo_coroutine_t* coroutine = (tb_lo_coroutine_t*)self;
+    tb_assert(coroutine && waitq);
+
+    // append it to the tail of the wait queue
+    coroutine->rs.waitq_next = tb_null;
+    if (waitq->tail) ((tb_lo_coroutine_t*)waitq->tail)->rs.waitq_next = coroutine;
+    else waitq->head = self;
+    waitq->tail = self;
+    waitq->size++;
+}
+tb_bool_t tb_lo_coroutine_waitq_wake_(tb_lo_waitq_ref_t waitq)
+{
+    // check
+    tb_assert(waitq);
+
+    // get the first waiting coroutine
+    tb_lo_coroutine_t* coroutine = (tb_lo_coroutine_t*)waitq->head;
+    tb_check_return_val(coroutine, tb_false);
+
+    // remove it from the head of the wait queue
+    waitq->head = (tb_lo_coroutine_ref_t)coroutine->rs.waitq_next;
+    if (!waitq->head) waitq->tail = tb_null;
+    waitq->size--;
+
+    // resume it
+    tb_lo_scheduler_resume((tb_lo_scheduler_t*)coroutine->scheduler, coroutine);
+    return tb_true;
+}
 tb_long_t tb_lo_coroutine_waitret_(tb_lo_coroutine_ref_t self)
 {
     // check
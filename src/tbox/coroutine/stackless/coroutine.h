@@ -216,6 +216,31 @@ do \
     \
 } while(0)
 
+/*! suspend the current coroutine in the given wait queue until it's waked up
+ *
+ * @param waitq         the wait queue pointer
+ */
+#define tb_lo_coroutine_waitq(waitq) \
+do \
+{ \
+    tb_lo_coroutine_waitq_push_(tb_lo_coroutine_self(), waitq); \
+    tb_lo_coroutine_suspend(); \
+    \
+} while(0)
+
+/*! init the wait queue
+ *
+ * @param waitq         the wait queue pointer
+ */
+#define tb_lo_coroutine_waitq_init(waitq) \
+do \
+{ \
+    (waitq)->head = tb_null; \
+    (waitq)->tail = tb_null; \
+    (waitq)->size = 0; \
+    \
+} while(0)
+
 /// wait until coroutine be true
 #define tb_lo_coroutine_wait_until(cond) \
 do \
@@ -334,6 +359,21 @@ tb_bool_t               tb_lo_coroutine_waitio_(tb_lo_coroutine_ref_t coroutine,
  */
 tb_bool_t               tb_lo_coroutine_waitproc_(tb_lo_coroutine_ref_t coroutine, tb_poller_object_ref_t object, tb_long_t timeout);
 
+/* push the current coroutine to the given wait queue, we need suspend it after pushing it
+ *
+ * @param coroutine     the coroutine
+ * @param waitq         the wait queue
+ */
+tb_void_t               tb_lo_coroutine_waitq_push_(tb_lo_coroutine_ref_t coroutine, tb_lo_waitq_ref_t waitq);
+
+/* resume the first waiting coroutine in the given wait queue
+ *
+ * @param waitq         the wait queue
+ *
+ * @return              tb_true or tb_false (no waiting coroutines)
+ */
+tb_bool_t               tb_lo_coroutine_waitq_wake_(tb_lo_waitq_ref_t waitq);
+
 /* get the waited return results
  *
  * @param coroutine     the coroutine
@@ -49,5 +49,19 @@ typedef tb_void_t       (*tb_lo_coroutine_func_t)(tb_lo_coroutine_ref_t coroutin
  */
 typedef tb_void_t       (*tb_lo_coroutine_free_t)(tb_cpointer_t priv);
 
+/// the wait queue type of the suspended coroutines, e.g. for rwlock, cond and waitgroup
+typedef struct __tb_lo_waitq_t
+{
+    /// the first waiting coroutine
+    tb_lo_coroutine_ref_t   head;
+
+    /// the last waiting coroutine
+    tb_lo_coroutine_ref_t   tail;
+
+    /// the waiting coroutines count
+    tb_size_t               size;
+
+}tb_lo_waitq_t, *tb_lo_waitq_ref_t;
+
 
 #endif
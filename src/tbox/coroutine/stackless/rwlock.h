@@ -0,0 +1,169 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        rwlock.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_STACKLESS_RWLOCK_H
+#define TB_COROUTINE_STACKLESS_RWLOCK_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "coroutine.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/*! init reader/writer lock
+ *
+ * @param rwlock        the rwlock pointer
+ */
+#define tb_lo_rwlock_init(rwlock) \
+do \
+{ \
+    (rwlock)->readers = 0; \
+    (rwlock)->writer = tb_false; \
+    tb_lo_coroutine_waitq_init(&(rwlock)->readers_waitq); \
+    tb_lo_coroutine_waitq_init(&(rwlock)->writers_waitq); \
+    \
+} while (0)
+
+/*! exit reader/writer lock
+ *
+ * @param rwlock        the rwlock pointer
+ */
+#define tb_lo_rwlock_exit(rwlock)               tb_assert(!(rwlock)->readers && !(rwlock)->writer)
+
+/*! enter reader lock
+ *
+ * the lock will be handed over to us when we are waked up
+ *
+ * @param rwlock        the rwlock pointer
+ */
+#define tb_lo_rwlock_enter_read(rwlock) \
+do \
+{ \
+    if (!tb_lo_rwlock_enter_read_try(rwlock)) \
+        tb_lo_coroutine_waitq(&(rwlock)->readers_waitq); \
+    \
+} while (0)
+
+/*! try to enter reader lock, it will fail if there are waiting writers
+ *
+ * @param rwlock        the rwlock pointer
+ *
+ * @return              tb_true or tb_false
+ */
+#define tb_lo_rwlock_enter_read_try(rwlock)     tb_lo_rwlock_enter_read_try_(rwlock)
+
+/*! enter writer lock
+ *
+ * the lock will be handed over to us when we are waked up
+ *
+ * @param rwlock        the rwlock pointer
+ */
+#define tb_lo_rwlock_enter_write(rwlock) \
+do \
+{ \
+    if (!tb_lo_rwlock_enter_write_try(rwlock)) \
+        tb_lo_coroutine_waitq(&(rwlock)->writers_waitq); \
+    \
+} while (0)
+
+/*! try to enter writer lock
+ *
+ * @param rwlock        the rwlock pointer
+ *
+ * @return              tb_true or tb_false
+ */
+#define tb_lo_rwlock_enter_write_try(rwlock)    tb_lo_rwlock_enter_write_try_(rwlock)
+
+/*! leave reader or writer lock
+ *
+ * @param rwlock        the rwlock pointer
+ */
+#define tb_lo_rwlock_leave(rwlock)              tb_lo_rwlock_leave_(rwlock)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the stackless reader/writer lock type
+typedef struct __tb_lo_rwlock_t
+{
+    // the readers count in the lock
+    tb_size_t           readers;
+
+    // has writer in the lock?
+    tb_bool_t           writer;
+
+    // the waiting readers
+    tb_lo_waitq_t       readers_waitq;
+
+    // the waiting writers
+    tb_lo_waitq_t       writers_waitq;
+
+}tb_lo_rwlock_t, *tb_lo_rwlock_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_bool_t tb_lo_rwlock_enter_read_try_(tb_lo_rwlock_ref_t rwlock)
+{
+    // no writer in the lock and no waiting writers? we need not starve the writers
+    tb_check_return_val(!rwlock->writer && !rwlock->writers_waitq.size, tb_false);
+    rwlock->readers++;
+    return tb_true;
+}
+static __tb_inline__ tb_bool_t tb_lo_rwlock_enter_write_try_(tb_lo_rwlock_ref_t rwlock)
+{
+    // no readers and writer in the lock?
+    tb_check_return_val(!rwlock->writer && !rwlock->readers, tb_false);
+    rwlock->writer = tb_true;
+    return tb_true;
+}
+static __tb_inline__ tb_void_t tb_lo_rwlock_leave_(tb_lo_rwlock_ref_t rwlock)
+{
+    // check
+    tb_assert_and_check_return(rwlock->writer || rwlock->readers);
+
+    // leave it
+    if (rwlock->writer)
+    {
+        // leave the writer
+        rwlock->writer = tb_false;
+
+        // hand over the lock to all waiting readers first
+        if (rwlock->readers_waitq.size)
+        {
+            rwlock->readers = rwlock->readers_waitq.size;
+            while (tb_lo_coroutine_waitq_wake_(&rwlock->readers_waitq)) ;
+            return ;
+        }
+    }
+    // leave the reader, other readers are still in the lock?
+    else if (--rwlock->readers) return ;
+
+    // hand over the lock to the next waiting writer
+    if (tb_lo_coroutine_waitq_wake_(&rwlock->writers_waitq))
+        rwlock->writer = tb_true;
+}
+
+#endif
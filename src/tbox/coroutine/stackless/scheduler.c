@@ -45,6 +45,13 @@
 #   define TB_SCHEDULER_DEAD_CACHE_MAXN     (256)
 #endif
 
+// the coroutine slab grow
+#ifdef __tb_small__
+#   define TB_SCHEDULER_COROUTINE_POOL_GROW (64)
+#else
+#   define TB_SCHEDULER_COROUTINE_POOL_GROW (1024)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * globals
  */
@@ -118,6 +125,19 @@ static tb_void_t tb_lo_scheduler_make_dead(tb_lo_scheduler_t* scheduler, tb_lo_c
     // remove this coroutine from the ready coroutines
     tb_list_entry_remove(&scheduler->coroutines_ready, &coroutine->entry);
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+    // an user coroutine has been finished in the worker group (sharded)
+    if (scheduler->worker && !coroutine->internal)
+        tb_lo_worker_group_leave(scheduler->worker->group);
+
+    // it was allocated from the other slab? free it to the owner slab directly
+    if (coroutine->pool != scheduler->coroutine_pool)
+    {
+        tb_lo_coroutine_exit(coroutine);
+        return ;
+    }
+#endif
+
     // append this coroutine to dead coroutines
     tb_list_entry_insert_tail(&scheduler->coroutines_dead, &coroutine->entry);
 }
@@ -167,7 +187,38 @@ static tb_void_t tb_lo_scheduler_switch(tb_lo_scheduler_t* scheduler, tb_lo_coro
     // call the coroutine function
     coroutine->func((tb_lo_coroutine_ref_t)coroutine, coroutine->priv);
 }
-tb_bool_t tb_lo_scheduler_start(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_func_t func, tb_cpointer_t priv, tb_lo_coroutine_free_t free)
+static tb_lo_coroutine_t* tb_lo_scheduler_make(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_func_t func, tb_cpointer_t priv, tb_lo_coroutine_free_t free)
+{
+    // check
+    tb_assert(scheduler && func);
+
+    // reuses dead coroutines in init function
+    tb_lo_coroutine_t* coroutine = tb_null;
+    if (tb_list_entry_size(&scheduler->coroutines_dead))
+    {
+        // get the next entry from head
+        tb_list_entry_ref_t entry = tb_list_entry_head(&scheduler->coroutines_dead);
+        tb_assert_and_check_return_val(entry, tb_null);
+
+        // remove it from the ready coroutines
+        tb_list_entry_remove_head(&scheduler->coroutines_dead);
+
+        // get the dead coroutine
+        coroutine = (tb_lo_coroutine_t*)tb_list_entry(&scheduler->coroutines_dead, entry);
+
+        // reinit this coroutine
+        tb_lo_coroutine_reinit(coroutine, func, priv, free);
+    }
+
+    // init coroutine from the slab of scheduler
+#ifndef TB_CONFIG_MICRO_ENABLE
+    if (!coroutine) coroutine = tb_lo_coroutine_init((tb_lo_scheduler_ref_t)scheduler, scheduler->coroutine_pool, func, priv, free);
+#else
+    if (!coroutine) coroutine = tb_lo_coroutine_init((tb_lo_scheduler_ref_t)scheduler, tb_null, func, priv, free);
+#endif
+    return coroutine;
+}
+static tb_bool_t tb_lo_scheduler_start_impl(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_func_t func, tb_cpointer_t priv, tb_lo_coroutine_free_t free, tb_bool_t internal)
 {
     // check
     tb_assert(func);
@@ -187,26 +238,68 @@ tb_bool_t tb_lo_scheduler_start(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_fu
         // have been stopped? do not continue to start new coroutines
         tb_check_break(!scheduler->stopped);
 
-        // reuses dead coroutines in init function
-        if (tb_list_entry_size(&scheduler->coroutines_dead))
+#ifndef TB_CONFIG_MICRO_ENABLE
+        // distribute the user coroutine to the workers by round-robin (sharded)
+        if (scheduler->worker && !internal)
         {
-            // get the next entry from head
-            tb_list_entry_ref_t entry = tb_list_entry_head(&scheduler->coroutines_dead);
-            tb_assert_and_check_break(entry);
-
-            // remove it from the ready coroutines
-            tb_list_entry_remove_head(&scheduler->coroutines_dead);
-
-            // get the dead coroutine
-            coroutine = (tb_lo_coroutine_t*)tb_list_entry(&scheduler->coroutines_dead, entry);
-
-            // reinit this coroutine
-            tb_lo_coroutine_reinit(coroutine, func, priv, free);
+            // get the target worker
+            tb_lo_worker_group_ref_t    group = scheduler->worker->group;
+            tb_lo_scheduler_t*          scheduler_target = tb_lo_worker_group_next(group)->scheduler;
+            tb_assert_and_check_break(scheduler_target);
+
+            /* get the worker scheduler of the current thread
+             *
+             * all workers are still on the current thread if the worker threads have been not started,
+             * so we can insert it to the target worker directly.
+             */
+            tb_lo_scheduler_t* scheduler_self = scheduler_target;
+            if (tb_atomic32_get(&group->started))
+            {
+                scheduler_self = (tb_lo_scheduler_t*)tb_lo_scheduler_self_();
+                if (scheduler_self && (!scheduler_self->worker || scheduler_self->worker->group != group))
+                    scheduler_self = tb_null;
+            }
+
+            // a new user coroutine has been started
+            tb_lo_worker_group_enter(group);
+
+            // hand off it to the other worker?
+            if (scheduler_target != scheduler_self)
+            {
+                /* make coroutine from the slab of the current worker, it will be freed to this slab remotely,
+                 * or from the global allocator if we are not on the worker thread
+                 */
+                coroutine = scheduler_self? tb_lo_scheduler_make(scheduler_self, func, priv, free) : tb_lo_coroutine_init((tb_lo_scheduler_ref_t)scheduler_target, tb_null, func, priv, free);
+                if (!coroutine)
+                {
+                    tb_lo_worker_group_leave(group);
+                    break;
+                }
+
+                // post it to the target worker
+                coroutine->scheduler = (tb_lo_scheduler_ref_t)scheduler_target;
+                tb_lo_scheduler_post(scheduler_target, coroutine);
+
+                // ok
+                ok = tb_true;
+                break;
+            }
+
+            // start it on the current worker
+            scheduler = scheduler_target;
+            coroutine = tb_lo_scheduler_make(scheduler, func, priv, free);
+            if (!coroutine) tb_lo_worker_group_leave(group);
         }
+        else coroutine = tb_lo_scheduler_make(scheduler, func, priv, free);
+        tb_assert_and_check_break(coroutine);
 
-        // init coroutine
-        if (!coroutine) coroutine = tb_lo_coroutine_init((tb_lo_scheduler_ref_t)scheduler, func, priv, free);
+        // mark the internal coroutine
+        coroutine->internal = internal? 1 : 0;
+#else
+        // make coroutine
+        coroutine = tb_lo_scheduler_make(scheduler, func, priv, free);
         tb_assert_and_check_break(coroutine);
+#endif
 
         // ready coroutine
         tb_lo_scheduler_make_ready(scheduler, coroutine);
@@ -236,6 +329,14 @@ tb_bool_t tb_lo_scheduler_start(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_fu
     // ok?
     return ok;
 }
+tb_bool_t tb_lo_scheduler_start(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_func_t func, tb_cpointer_t priv, tb_lo_coroutine_free_t free)
+{
+    return tb_lo_scheduler_start_impl(scheduler, func, priv, free, tb_false);
+}
+tb_bool_t tb_lo_scheduler_start_internal(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_func_t func, tb_cpointer_t priv)
+{
+    return tb_lo_scheduler_start_impl(scheduler, func, priv, tb_null, tb_true);
+}
 tb_void_t tb_lo_scheduler_resume(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_t* coroutine)
 {
     // check
@@ -248,6 +349,63 @@ tb_void_t tb_lo_scheduler_resume(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_t
     // make it as ready
     tb_lo_scheduler_make_ready(scheduler, coroutine);
 }
+#ifndef TB_CONFIG_MICRO_ENABLE
+tb_void_t tb_lo_scheduler_post(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_t* coroutine)
+{
+    // check
+    tb_assert(scheduler && coroutine && coroutine->scheduler == (tb_lo_scheduler_ref_t)scheduler);
+
+    // trace
+    tb_trace_d("post coroutine(%p) to scheduler(%p)", coroutine, scheduler);
+
+    // push it to the inbox
+    tb_long_t inbox = tb_atomic_get_explicit(&scheduler->inbox, TB_ATOMIC_RELAXED);
+    do
+    {
+        coroutine->remote_next = (tb_lo_coroutine_t*)inbox;
+
+    } while (!tb_atomic_compare_and_swap(&scheduler->inbox, &inbox, (tb_long_t)coroutine));
+
+    /* wake up the io loop of the owner scheduler if the inbox was empty
+     *
+     * the io loop will take all posted coroutines at once, so we need not wake it again (batched)
+     */
+    if (!inbox && scheduler->scheduler_io && scheduler->scheduler_io->poller)
+        tb_poller_spak(scheduler->scheduler_io->poller);
+}
+tb_size_t tb_lo_scheduler_schedule(tb_lo_scheduler_t* scheduler)
+{
+    // check
+    tb_assert(scheduler);
+
+    // no posted coroutines?
+    tb_check_return_val(tb_atomic_get_explicit(&scheduler->inbox, TB_ATOMIC_RELAXED), 0);
+
+    // take all posted coroutines from the other threads
+    tb_size_t           count = 0;
+    tb_lo_coroutine_t*  coroutine = tb_null;
+    tb_lo_coroutine_t*  coroutine_next = tb_null;
+    tb_lo_coroutine_t*  posted = (tb_lo_coroutine_t*)tb_atomic_fetch_and_set(&scheduler->inbox, 0);
+
+    // reverse them to start them in the posted order
+    for (coroutine = posted, posted = tb_null; coroutine; coroutine = coroutine_next)
+    {
+        coroutine_next = coroutine->remote_next;
+        coroutine->remote_next = posted;
+        posted = coroutine;
+    }
+
+    // make them as ready
+    for (coroutine = posted; coroutine; coroutine = coroutine_next)
+    {
+        coroutine_next = coroutine->remote_next;
+        coroutine->remote_next = tb_null;
+        tb_lo_scheduler_make_ready(scheduler, coroutine);
+        count++;
+    }
+    return count;
+}
+#endif
 tb_lo_scheduler_ref_t tb_lo_scheduler_self_()
 {
     // get self scheduler on the current thread
@@ -281,6 +439,17 @@ tb_lo_scheduler_ref_t tb_lo_scheduler_init()
         // init suspend coroutines
         tb_list_entry_init(&scheduler->coroutines_suspend, tb_lo_coroutine_t, entry, tb_null);
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+        // init the coroutine slab
+        scheduler->coroutine_pool = tb_fixed_pool_init(tb_null, TB_SCHEDULER_COROUTINE_POOL_GROW, sizeof(tb_lo_coroutine_t), tb_null, tb_null, tb_null);
+        tb_assert_and_check_break(scheduler->coroutine_pool);
+
+        // preallocate the first slot of slab, so starting coroutines will not touch the global allocator at first
+        tb_pointer_t data = tb_fixed_pool_malloc(scheduler->coroutine_pool);
+        tb_assert_and_check_break(data);
+        tb_fixed_pool_free(scheduler->coroutine_pool, data);
+#endif
+
         // ok
         ok = tb_true;
 
@@ -297,6 +466,25 @@ tb_lo_scheduler_ref_t tb_lo_scheduler_init()
     // ok?
     return (tb_lo_scheduler_ref_t)scheduler;
 }
+#ifndef TB_CONFIG_MICRO_ENABLE
+tb_lo_scheduler_ref_t tb_lo_scheduler_init_with_workers(tb_size_t workern)
+{
+    // init the scheduler of the first worker
+    tb_lo_scheduler_t* scheduler = (tb_lo_scheduler_t*)tb_lo_scheduler_init();
+    tb_assert_and_check_return_val(scheduler, tb_null);
+
+    // init the worker group
+    if (!tb_lo_worker_group_init(scheduler, workern? workern : tb_cpu_count()))
+    {
+        scheduler->stopped = tb_true;
+        tb_lo_scheduler_exit((tb_lo_scheduler_ref_t)scheduler);
+        scheduler = tb_null;
+    }
+
+    // ok?
+    return (tb_lo_scheduler_ref_t)scheduler;
+}
+#endif
 tb_void_t tb_lo_scheduler_exit(tb_lo_scheduler_ref_t self)
 {
     // check
@@ -306,6 +494,12 @@ tb_void_t tb_lo_scheduler_exit(tb_lo_scheduler_ref_t self)
     // must be stopped
     tb_assert(scheduler->stopped);
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+    // exit the worker group and other workers (sharded)
+    if (scheduler->worker) tb_lo_worker_group_exit(scheduler->worker->group);
+    tb_assert(!scheduler->worker);
+#endif
+
     // exit io scheduler first
     if (scheduler->scheduler_io) tb_lo_scheduler_io_exit(scheduler->scheduler_io);
     scheduler->scheduler_io = tb_null;
@@ -332,6 +526,12 @@ tb_void_t tb_lo_scheduler_exit(tb_lo_scheduler_ref_t self)
     // exit suspend coroutines
     tb_list_entry_exit(&scheduler->coroutines_suspend);
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+    // exit the coroutine slab after freeing all coroutines
+    if (scheduler->coroutine_pool) tb_fixed_pool_exit(scheduler->coroutine_pool);
+    scheduler->coroutine_pool = tb_null;
+#endif
+
     // exit the scheduler
     tb_free(scheduler);
 }
@@ -341,14 +541,22 @@ tb_void_t tb_lo_scheduler_kill(tb_lo_scheduler_ref_t self)
     tb_lo_scheduler_t* scheduler = (tb_lo_scheduler_t*)self;
     tb_assert_and_check_return(scheduler);
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+    // kill all workers (sharded)
+    if (scheduler->worker)
+    {
+        tb_lo_worker_group_kill(scheduler->worker->group);
+        return ;
+    }
+#endif
+
     // stop it
     scheduler->stopped = tb_true;
 }
-tb_void_t tb_lo_scheduler_loop(tb_lo_scheduler_ref_t self, tb_bool_t exclusive)
+static tb_void_t tb_lo_scheduler_loop_impl(tb_lo_scheduler_t* scheduler, tb_bool_t exclusive)
 {
     // check
-    tb_lo_scheduler_t* scheduler = (tb_lo_scheduler_t*)self;
-    tb_assert_and_check_return(scheduler);
+    tb_assert(scheduler);
 
 #ifdef __tb_thread_local__
     g_scheduler_self_ex = scheduler;
@@ -362,7 +570,7 @@ tb_void_t tb_lo_scheduler_loop(tb_lo_scheduler_ref_t self, tb_bool_t exclusive)
         if (!tb_thread_local_init(&g_scheduler_self, tb_null)) return ;
 
         // update and overide the current scheduler
-        tb_thread_local_set(&g_scheduler_self, self);
+        tb_thread_local_set(&g_scheduler_self, scheduler);
     }
 #   else
     else
@@ -424,4 +632,31 @@ tb_void_t tb_lo_scheduler_loop(tb_lo_scheduler_ref_t self, tb_bool_t exclusive)
 #   endif
 #endif
 }
+tb_void_t tb_lo_scheduler_loop(tb_lo_scheduler_ref_t self, tb_bool_t exclusive)
+{
+    // check
+    tb_lo_scheduler_t* scheduler = (tb_lo_scheduler_t*)self;
+    tb_assert_and_check_return(scheduler);
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+    // run the first worker on the current thread and the other workers on their own threads (sharded)
+    tb_lo_worker_ref_t worker = scheduler->worker;
+    if (worker && !worker->index)
+    {
+        // start the other workers
+        if (tb_lo_worker_group_start(worker->group))
+            tb_lo_scheduler_loop_impl(scheduler, tb_false);
+        else tb_lo_worker_group_kill(worker->group);
+
+        // wait the other workers
+        tb_lo_worker_group_wait(worker->group);
+        return ;
+    }
+
+    // we cannot use the global scheduler for multiple workers
+    if (worker) exclusive = tb_false;
+#endif
+
+    // run the scheduler loop
+    tb_lo_scheduler_loop_impl(scheduler, exclusive);
+}
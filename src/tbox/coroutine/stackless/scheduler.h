@@ -49,6 +49,23 @@ __tb_extern_c_enter__
  */
 tb_lo_scheduler_ref_t   tb_lo_scheduler_init(tb_noarg_t);
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+/*! init scheduler with the given worker threads (sharded)
+ *
+ * each worker has its own scheduler, poller, timers and coroutine slab, the first worker is run on the thread of loop().
+ * the new coroutines will be distributed to the workers by round-robin and handed off to the other workers without locks,
+ * and they are never migrated after starting.
+ *
+ * @note the stackless lock, semaphore, rwlock, cond and waitgroup are not thread-safe,
+ * we can only use them between the coroutines on the same worker.
+ *
+ * @param workern       the worker count, uses the cpu count if be zero
+ *
+ * @return              the scheduler
+ */
+tb_lo_scheduler_ref_t   tb_lo_scheduler_init_with_workers(tb_size_t workern);
+#endif
+
 /*! exit scheduler
  *
  * @param scheduler     the scheduler
@@ -29,6 +29,9 @@
 #include "scheduler.h"
 #include "semaphore.h"
 #include "lock.h"
+#include "rwlock.h"
+#include "cond.h"
+#include "waitgroup.h"
 
 
 #endif
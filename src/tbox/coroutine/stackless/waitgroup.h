@@ -0,0 +1,116 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        waitgroup.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_STACKLESS_WAITGROUP_H
+#define TB_COROUTINE_STACKLESS_WAITGROUP_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "coroutine.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/*! init wait group
+ *
+ * @param group         the wait group pointer
+ */
+#define tb_lo_waitgroup_init(group) \
+do \
+{ \
+    (group)->count = 0; \
+    tb_lo_coroutine_waitq_init(&(group)->waitq); \
+    \
+} while (0)
+
+/*! exit wait group
+ *
+ * @param group         the wait group pointer
+ */
+#define tb_lo_waitgroup_exit(group)         tb_assert(!(group)->waitq.size)
+
+/*! add the pending count, all waiting coroutines will be resumed if it becomes zero
+ *
+ * @param group         the wait group pointer
+ * @param delta         the added count, it can be negative
+ */
+#define tb_lo_waitgroup_add(group, delta)   tb_lo_waitgroup_add_(group, delta)
+
+/*! decrease the pending count
+ *
+ * @param group         the wait group pointer
+ */
+#define tb_lo_waitgroup_done(group)         tb_lo_waitgroup_add_(group, -1)
+
+/*! get the pending count
+ *
+ * @param group         the wait group pointer
+ *
+ * @return              the pending count
+ */
+#define tb_lo_waitgroup_count(group)        ((group)->count)
+
+/*! wait until the pending count becomes zero
+ *
+ * @param group         the wait group pointer
+ */
+#define tb_lo_waitgroup_wait(group) \
+do \
+{ \
+    if ((group)->count) \
+        tb_lo_coroutine_waitq(&(group)->waitq); \
+    \
+} while (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the stackless wait group type
+typedef struct __tb_lo_waitgroup_t
+{
+    // the pending count
+    tb_size_t           count;
+
+    // the waiting coroutines
+    tb_lo_waitq_t       waitq;
+
+}tb_lo_waitgroup_t, *tb_lo_waitgroup_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_void_t tb_lo_waitgroup_add_(tb_lo_waitgroup_ref_t group, tb_long_t delta)
+{
+    // update the pending count
+    tb_assert_and_check_return(delta >= 0 || group->count >= (tb_size_t)-delta);
+    group->count += delta;
+
+    // all are finished? resume all waiting coroutines
+    if (!group->count)
+    {
+        while (tb_lo_coroutine_waitq_wake_(&group->waitq)) ;
+    }
+}
+
+#endif
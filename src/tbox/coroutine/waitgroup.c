@@ -0,0 +1,114 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        waitgroup.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "waitgroup"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "waitgroup.h"
+#include "impl/impl.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the coroutine wait group type
+typedef struct __tb_co_waitgroup_t
+{
+    // the pending count
+    tb_size_t                   count;
+
+    // the waiting coroutines
+    tb_co_waitq_t               waitq;
+
+}tb_co_waitgroup_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_co_waitgroup_ref_t tb_co_waitgroup_init()
+{
+    // make wait group
+    tb_co_waitgroup_t* group = tb_malloc0_type(tb_co_waitgroup_t);
+    tb_assert_and_check_return_val(group, tb_null);
+
+    // init the waiting coroutines
+    tb_co_waitq_init(&group->waitq);
+
+    // ok
+    return (tb_co_waitgroup_ref_t)group;
+}
+tb_void_t tb_co_waitgroup_exit(tb_co_waitgroup_ref_t self)
+{
+    // check
+    tb_co_waitgroup_t* group = (tb_co_waitgroup_t*)self;
+    tb_assert_and_check_return(group);
+
+    // exit the waiting coroutines
+    tb_co_waitq_exit(&group->waitq);
+
+    // exit it
+    tb_free(group);
+}
+tb_void_t tb_co_waitgroup_add(tb_co_waitgroup_ref_t self, tb_long_t delta)
+{
+    // check
+    tb_co_waitgroup_t* group = (tb_co_waitgroup_t*)self;
+    tb_assert_and_check_return(group);
+
+    // update the pending count
+    tb_assert_and_check_return(delta >= 0 || group->count >= (tb_size_t)-delta);
+    group->count += delta;
+
+    // all are finished? resume all waiting coroutines
+    if (!group->count) tb_co_waitq_wake_all(&group->waitq);
+}
+tb_void_t tb_co_waitgroup_done(tb_co_waitgroup_ref_t self)
+{
+    tb_co_waitgroup_add(self, -1);
+}
+tb_size_t tb_co_waitgroup_count(tb_co_waitgroup_ref_t self)
+{
+    // check
+    tb_co_waitgroup_t* group = (tb_co_waitgroup_t*)self;
+    tb_assert_and_check_return_val(group, 0);
+
+    // get the pending count
+    return group->count;
+}
+tb_long_t tb_co_waitgroup_wait(tb_co_waitgroup_ref_t self, tb_long_t timeout)
+{
+    // check
+    tb_co_waitgroup_t* group = (tb_co_waitgroup_t*)self;
+    tb_assert_and_check_return_val(group, -1);
+
+    // all are finished?
+    tb_check_return_val(group->count, 1);
+
+    // wait it
+    return tb_co_waitq_wait(&group->waitq, 0, timeout, tb_true);
+}
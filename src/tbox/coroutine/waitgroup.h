@@ -0,0 +1,104 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        waitgroup.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_WAITGROUP_H
+#define TB_COROUTINE_WAITGROUP_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the coroutine wait group ref type
+typedef __tb_typeref__(co_waitgroup);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init wait group
+ *
+ * wait a group of coroutines to be finished, e.g. fan-out/fan-in rpc calls
+ *
+ * @code
+    tb_co_waitgroup_add(group, n);
+    for (i = 0; i < n; i++)
+        tb_coroutine_start(tb_null, call_func, group, 0); // call_func: ...; tb_co_waitgroup_done(group);
+    tb_co_waitgroup_wait(group, -1);
+ * @endcode
+ *
+ * @return              the wait group
+ */
+tb_co_waitgroup_ref_t   tb_co_waitgroup_init(tb_noarg_t);
+
+/*! exit wait group
+ *
+ * @param group         the wait group
+ */
+tb_void_t               tb_co_waitgroup_exit(tb_co_waitgroup_ref_t group);
+
+/*! add the pending count
+ *
+ * all waiting coroutines will be resumed if the pending count becomes zero
+ *
+ * @param group         the wait group
+ * @param delta         the added count, it can be negative
+ */
+tb_void_t               tb_co_waitgroup_add(tb_co_waitgroup_ref_t group, tb_long_t delta);
+
+/*! decrease the pending count, it is equal to tb_co_waitgroup_add(group, -1)
+ *
+ * @param group         the wait group
+ */
+tb_void_t               tb_co_waitgroup_done(tb_co_waitgroup_ref_t group);
+
+/*! get the pending count
+ *
+ * @param group         the wait group
+ *
+ * @return              the pending count
+ */
+tb_size_t               tb_co_waitgroup_count(tb_co_waitgroup_ref_t group);
+
+/*! wait until the pending count becomes zero
+ *
+ * @param group         the wait group
+ * @param timeout       the timeout, infinity: -1
+ *
+ * @return              ok: 1, timeout: 0, fail or cancelled: -1
+ */
+tb_long_t               tb_co_waitgroup_wait(tb_co_waitgroup_ref_t group, tb_long_t timeout);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -35,6 +35,129 @@
 #include "../utils/utils.h"
 #include "../platform/platform.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the profiler size class count, the class i contains the data size in (2^(i - 1), 2^i]
+#define TB_ALLOCATOR_PROFILER_CLASSN        (TB_CPU_BITSIZE)
+
+// the profiler site and data maxn
+#ifdef __tb_small__
+#   define TB_ALLOCATOR_PROFILER_SITEN      (128)
+#   define TB_ALLOCATOR_PROFILER_DATAN      (1024)
+#else
+#   define TB_ALLOCATOR_PROFILER_SITEN      (512)
+#   define TB_ALLOCATOR_PROFILER_DATAN      (8192)
+#endif
+
+// the profiler site probe count
+#define TB_ALLOCATOR_PROFILER_PROBEN        (16)
+
+// the profiler data bucket size, we only look up one cache-line of the data addresses
+#define TB_ALLOCATOR_PROFILER_BUCKETN       (TB_L1_CACHE_BYTES / sizeof(tb_atomic_t))
+
+// the profiler call stack frame count of each site for the release mode
+#define TB_ALLOCATOR_PROFILER_FRAMEN        (4)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the allocator profiler site type
+typedef struct __tb_allocator_profiler_site_t
+{
+#ifdef __tb_debug__
+    // the func name
+    tb_char_t const*                func;
+
+    // the file name
+    tb_char_t const*                file;
+
+    // the line number
+    tb_size_t                       line;
+#else
+    // the call stack
+    tb_pointer_t                    frames[TB_ALLOCATOR_PROFILER_FRAMEN];
+#endif
+
+    // the sampled count, this site is unused if it's zero
+    tb_size_t                       count;
+
+    // the sampled bytes
+    tb_size_t                       bytes;
+
+    // the sampled live count
+    tb_size_t                       live_count;
+
+    // the sampled live bytes
+    tb_size_t                       live_bytes;
+
+}tb_allocator_profiler_site_t;
+
+// the allocator profiler data type
+typedef struct __tb_allocator_profiler_data_t
+{
+    // the data size
+    tb_size_t                       size;
+
+    // the site index
+    tb_size_t                       site;
+
+}tb_allocator_profiler_data_t;
+
+/* the allocator profiler type
+ *
+ * we only check the profiled allocator and decrease the thread-local sample countdown for the unsampled allocation,
+ * and only look up one cache-line of the sampled data addresses when freeing data, so the overhead is very low.
+ *
+ * the sampled allocation records the call stack and statistics with the lock.
+ */
+typedef struct __tb_allocator_profiler_t
+{
+    // the profiled allocator
+    tb_atomic_t                     allocator;
+
+    // the sample rate
+    tb_atomic_t                     rate;
+
+    // the sampled live data count, we need not look up the sampled data addresses if it's zero
+    tb_atomic_t                     live;
+
+#ifndef __tb_thread_local__
+    // the allocation counter for sampling
+    tb_atomic_t                     counter;
+#endif
+
+    // the lock for the statistics below
+    tb_spinlock_t                   lock;
+
+    // the sampled count
+    tb_size_t                       count;
+
+    // the sampled bytes
+    tb_size_t                       bytes;
+
+    // the dropped count of the sampled live data if the site or data table is full
+    tb_size_t                       dropped;
+
+    // the sampled count of each size class
+    tb_size_t                       class_count[TB_ALLOCATOR_PROFILER_CLASSN];
+
+    // the sampled bytes of each size class
+    tb_size_t                       class_bytes[TB_ALLOCATOR_PROFILER_CLASSN];
+
+    // the sites
+    tb_allocator_profiler_site_t    sites[TB_ALLOCATOR_PROFILER_SITEN];
+
+    // the sampled data addresses
+    tb_atomic_t                     addrs[TB_ALLOCATOR_PROFILER_DATAN];
+
+    // the sampled data
+    tb_allocator_profiler_data_t    datas[TB_ALLOCATOR_PROFILER_DATAN];
+
+}tb_allocator_profiler_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * globals
  */
@@ -42,6 +165,287 @@
 // the allocator
 __tb_extern_c__ tb_allocator_ref_t  g_allocator = tb_null;
 
+// the allocator profiler
+static tb_allocator_profiler_t      g_allocator_profiler;
+
+#ifdef __tb_thread_local__
+// the sample countdown of the current thread
+static __tb_thread_local__ tb_size_t g_allocator_profiler_countdown = 0;
+
+// the random seed of the sample countdown
+static __tb_thread_local__ tb_uint32_t g_allocator_profiler_seed = 0;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_bool_t tb_allocator_profiler_sample(tb_allocator_ref_t allocator)
+{
+    // is this allocator profiled?
+    tb_allocator_profiler_t* profiler = &g_allocator_profiler;
+    if ((tb_allocator_ref_t)tb_atomic_get_explicit(&profiler->allocator, TB_ATOMIC_RELAXED) != allocator) return tb_false;
+
+    // the sample rate
+    tb_size_t rate = (tb_size_t)tb_atomic_get_explicit(&profiler->rate, TB_ATOMIC_RELAXED);
+    tb_check_return_val(rate, tb_false);
+
+    /* sample one of every rate allocations
+     *
+     * we use the random countdown in [0, 2 * rate) to avoid the sampling bias for the periodic allocations
+     */
+#ifdef __tb_thread_local__
+    if (g_allocator_profiler_countdown)
+    {
+        g_allocator_profiler_countdown--;
+        return tb_false;
+    }
+
+    // make the next countdown by xorshift32
+    tb_uint32_t seed = g_allocator_profiler_seed;
+    if (!seed) seed = (tb_uint32_t)(tb_size_t)&g_allocator_profiler_seed | 1;
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    g_allocator_profiler_seed = seed;
+    g_allocator_profiler_countdown = (tb_size_t)(seed % (rate << 1));
+    return tb_true;
+#else
+    return !((tb_size_t)tb_atomic_fetch_and_add_explicit(&profiler->counter, 1, TB_ATOMIC_RELAXED) % rate);
+#endif
+}
+static tb_size_t tb_allocator_profiler_site(tb_allocator_profiler_t* profiler, tb_pointer_t* frames __tb_debug_decl__)
+{
+    // compute the hash value of this site
+#ifdef __tb_debug__
+    tb_size_t hash = ((tb_size_t)file_ >> 4) ^ (line_ * 31);
+#else
+    tb_size_t i = 0;
+    tb_size_t hash = 0;
+    for (i = 0; i < TB_ALLOCATOR_PROFILER_FRAMEN; i++) hash = (hash * 31) ^ ((tb_size_t)frames[i] >> 2);
+#endif
+    hash ^= (hash >> 8) ^ (hash >> 16);
+
+    // find or add this site
+    tb_size_t probe = 0;
+    for (probe = 0; probe < TB_ALLOCATOR_PROFILER_PROBEN; probe++, hash++)
+    {
+        // the site
+        tb_size_t                       index = hash & (TB_ALLOCATOR_PROFILER_SITEN - 1);
+        tb_allocator_profiler_site_t*   site = &profiler->sites[index];
+
+        // unused? add it
+        if (!site->count)
+        {
+#ifdef __tb_debug__
+            site->func = func_;
+            site->file = file_;
+            site->line = line_;
+#else
+            tb_memcpy_(site->frames, frames, sizeof(site->frames));
+#endif
+            return index;
+        }
+
+        // is this site?
+#ifdef __tb_debug__
+        if (site->line == line_ && site->file == file_ && site->func == func_) return index;
+#else
+        if (!tb_memcmp_(site->frames, frames, sizeof(site->frames))) return index;
+#endif
+    }
+
+    // full
+    return TB_ALLOCATOR_PROFILER_SITEN;
+}
+static __tb_inline__ tb_atomic_t* tb_allocator_profiler_bucket(tb_allocator_profiler_t* profiler, tb_cpointer_t data)
+{
+    // compute the hash value of this data address
+    tb_size_t hash = (tb_size_t)data >> 4;
+    hash ^= (hash >> 12) ^ (hash >> 24);
+
+    // the data bucket
+    return &profiler->addrs[(hash * TB_ALLOCATOR_PROFILER_BUCKETN) & (TB_ALLOCATOR_PROFILER_DATAN - 1)];
+}
+static tb_void_t tb_allocator_profiler_record(tb_pointer_t data, tb_size_t size __tb_debug_decl__)
+{
+    // check
+    tb_check_return(data);
+
+    // the profiler
+    tb_allocator_profiler_t* profiler = &g_allocator_profiler;
+
+    // get the call stack outside the lock, skip tb_backtrace_frames(), this function and the allocator entry
+    tb_pointer_t frames[TB_ALLOCATOR_PROFILER_FRAMEN] = {0};
+#ifndef __tb_debug__
+    tb_backtrace_frames(frames, TB_ALLOCATOR_PROFILER_FRAMEN, 3);
+#endif
+
+    // the size class
+    tb_size_t class_index = 0;
+    while (class_index + 1 < TB_ALLOCATOR_PROFILER_CLASSN && ((tb_size_t)1 << class_index) < size) class_index++;
+
+    // enter
+    tb_spinlock_enter(&profiler->lock);
+
+    // update the size-class histogram
+    profiler->count++;
+    profiler->bytes += size;
+    profiler->class_count[class_index]++;
+    profiler->class_bytes[class_index] += size;
+
+    // update the site
+    tb_bool_t   ok = tb_false;
+    tb_size_t   site_index = tb_allocator_profiler_site(profiler, frames __tb_debug_args__);
+    if (site_index < TB_ALLOCATOR_PROFILER_SITEN)
+    {
+        // the site
+        tb_allocator_profiler_site_t* site = &profiler->sites[site_index];
+        site->count++;
+        site->bytes += size;
+
+        // save this data address to the free entry of the bucket for tracking the live bytes
+        tb_size_t       i = 0;
+        tb_atomic_t*    bucket = tb_allocator_profiler_bucket(profiler, data);
+        for (i = 0; i < TB_ALLOCATOR_PROFILER_BUCKETN; i++)
+        {
+            if (!tb_atomic_get_explicit(&bucket[i], TB_ATOMIC_RELAXED))
+            {
+                // save data
+                tb_allocator_profiler_data_t* item = &profiler->datas[bucket + i - profiler->addrs];
+                item->size = size;
+                item->site = site_index;
+                tb_atomic_set(&bucket[i], (tb_long_t)data);
+                tb_atomic_fetch_and_add(&profiler->live, 1);
+
+                // update the live bytes
+                site->live_count++;
+                site->live_bytes += size;
+                ok = tb_true;
+                break;
+            }
+        }
+    }
+
+    // dropped?
+    if (!ok) profiler->dropped++;
+
+    // leave
+    tb_spinlock_leave(&profiler->lock);
+}
+static __tb_inline__ tb_void_t tb_allocator_profiler_remove(tb_allocator_ref_t allocator, tb_cpointer_t data)
+{
+    // no sampled live data of this allocator?
+    tb_allocator_profiler_t* profiler = &g_allocator_profiler;
+    if (    !data
+        ||  (tb_allocator_ref_t)tb_atomic_get_explicit(&profiler->allocator, TB_ATOMIC_RELAXED) != allocator
+        ||  !tb_atomic_get_explicit(&profiler->live, TB_ATOMIC_RELAXED))
+        return ;
+
+    // is this data sampled?
+    tb_size_t       i = 0;
+    tb_atomic_t*    bucket = tb_allocator_profiler_bucket(profiler, data);
+    for (i = 0; i < TB_ALLOCATOR_PROFILER_BUCKETN; i++)
+    {
+        if ((tb_cpointer_t)tb_atomic_get_explicit(&bucket[i], TB_ATOMIC_RELAXED) == data)
+        {
+            // enter
+            tb_spinlock_enter(&profiler->lock);
+
+            // remove it if it has not been reset
+            if ((tb_cpointer_t)tb_atomic_get(&bucket[i]) == data)
+            {
+                // update the live bytes
+                tb_allocator_profiler_data_t* item = &profiler->datas[bucket + i - profiler->addrs];
+                tb_allocator_profiler_site_t* site = &profiler->sites[item->site];
+                site->live_count--;
+                site->live_bytes -= item->size;
+
+                // remove data
+                tb_atomic_set(&bucket[i], 0);
+                tb_atomic_fetch_and_sub(&profiler->live, 1);
+            }
+
+            // leave
+            tb_spinlock_leave(&profiler->lock);
+            break;
+        }
+    }
+}
+static tb_void_t tb_allocator_profiler_dump(tb_allocator_ref_t allocator)
+{
+    // is this allocator profiled?
+    tb_allocator_profiler_t* profiler = &g_allocator_profiler;
+    tb_check_return((tb_allocator_ref_t)tb_atomic_get(&profiler->allocator) == allocator);
+
+    // the sample rate, all values are scaled by it
+    tb_size_t rate = (tb_size_t)tb_atomic_get(&profiler->rate);
+    tb_check_return(rate);
+
+    // enter
+    tb_spinlock_enter(&profiler->lock);
+
+    // the live count and bytes
+    tb_size_t i = 0;
+    tb_size_t live_count = 0;
+    tb_size_t live_bytes = 0;
+    for (i = 0; i < TB_ALLOCATOR_PROFILER_SITEN; i++)
+    {
+        live_count += profiler->sites[i].live_count;
+        live_bytes += profiler->sites[i].live_bytes;
+    }
+
+    // dump summary
+    tb_trace_i("profile: {\"type\": \"summary\", \"allocator\": \"%p\", \"rate\": %lu, \"count\": %lu, \"bytes\": %lu, \"live_count\": %lu, \"live_bytes\": %lu, \"dropped\": %lu}"
+            , allocator, rate, profiler->count * rate, profiler->bytes * rate, live_count * rate, live_bytes * rate, profiler->dropped * rate);
+
+    // dump the size-class histogram
+    for (i = 0; i < TB_ALLOCATOR_PROFILER_CLASSN; i++)
+    {
+        if (profiler->class_count[i])
+        {
+            tb_trace_i("profile: {\"type\": \"class\", \"size\": %lu, \"count\": %lu, \"bytes\": %lu}"
+                    , (tb_size_t)1 << i, profiler->class_count[i] * rate, profiler->class_bytes[i] * rate);
+        }
+    }
+
+    // dump sites
+    for (i = 0; i < TB_ALLOCATOR_PROFILER_SITEN; i++)
+    {
+        // the site
+        tb_allocator_profiler_site_t* site = &profiler->sites[i];
+        tb_check_continue(site->count);
+
+#ifdef __tb_debug__
+        tb_trace_i("profile: {\"type\": \"site\", \"func\": \"%s\", \"file\": \"%s\", \"line\": %lu, \"count\": %lu, \"bytes\": %lu, \"live_count\": %lu, \"live_bytes\": %lu}"
+                , site->func, site->file, site->line, site->count * rate, site->bytes * rate, site->live_count * rate, site->live_bytes * rate);
+#else
+        // the frame symbols, the dump format only supports four frames
+        tb_assert_static(TB_ALLOCATOR_PROFILER_FRAMEN == 4);
+        tb_size_t           j = 0;
+        tb_handle_t         symbols = tb_backtrace_symbols_init(site->frames, TB_ALLOCATOR_PROFILER_FRAMEN);
+        tb_char_t const*    names[TB_ALLOCATOR_PROFILER_FRAMEN] = {0};
+        for (j = 0; j < TB_ALLOCATOR_PROFILER_FRAMEN; j++)
+        {
+            names[j] = symbols? tb_backtrace_symbols_name(symbols, site->frames, TB_ALLOCATOR_PROFILER_FRAMEN, j) : tb_null;
+            if (!names[j]) names[j] = "";
+        }
+
+        // dump site
+        tb_trace_i("profile: {\"type\": \"site\", \"frames\": [\"%p\", \"%p\", \"%p\", \"%p\"], \"symbols\": [\"%s\", \"%s\", \"%s\", \"%s\"], \"count\": %lu, \"bytes\": %lu, \"live_count\": %lu, \"live_bytes\": %lu}"
+                , site->frames[0], site->frames[1], site->frames[2], site->frames[3]
+                , names[0], names[1], names[2], names[3]
+                , site->count * rate, site->bytes * rate, site->live_count * rate, site->live_bytes * rate);
+
+        // exit symbols
+        if (symbols) tb_backtrace_symbols_exit(symbols);
+#endif
+    }
+
+    // leave
+    tb_spinlock_leave(&profiler->lock);
+}
+
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -81,6 +485,9 @@ tb_pointer_t tb_allocator_malloc_(tb_allocator_ref_t allocator, tb_size_t size _
     // leave
     if (lockit) tb_spinlock_leave(&allocator->lock);
 
+    // sample it
+    if (tb_allocator_profiler_sample(allocator)) tb_allocator_profiler_record(data, size __tb_debug_args__);
+
     // ok?
     return data;
 }
@@ -125,6 +532,9 @@ tb_pointer_t tb_allocator_ralloc_(tb_allocator_ref_t allocator, tb_pointer_t dat
     // check
     tb_assert_and_check_return_val(allocator, tb_null);
 
+    // remove the sampled data first
+    tb_allocator_profiler_remove(allocator, data);
+
     // enter
     tb_bool_t lockit = !(allocator->flag & TB_ALLOCATOR_FLAG_NOLOCK);
     if (lockit) tb_spinlock_enter(&allocator->lock);
@@ -158,6 +568,9 @@ tb_pointer_t tb_allocator_ralloc_(tb_allocator_ref_t allocator, tb_pointer_t dat
     // leave
     if (lockit) tb_spinlock_leave(&allocator->lock);
 
+    // sample it
+    if (tb_allocator_profiler_sample(allocator)) tb_allocator_profiler_record(data_new, size __tb_debug_args__);
+
     // ok?
     return data_new;
 }
@@ -166,6 +579,9 @@ tb_bool_t tb_allocator_free_(tb_allocator_ref_t allocator, tb_pointer_t data __t
     // check
     tb_assert_and_check_return_val(allocator, tb_false);
 
+    // remove the sampled data first, it may be reused by other threads after freeing it
+    tb_allocator_profiler_remove(allocator, data);
+
     // enter
     tb_bool_t lockit = !(allocator->flag & TB_ALLOCATOR_FLAG_NOLOCK);
     if (lockit) tb_spinlock_enter(&allocator->lock);
@@ -229,6 +645,9 @@ tb_pointer_t tb_allocator_large_malloc_(tb_allocator_ref_t allocator, tb_size_t
     // leave
     if (lockit) tb_spinlock_leave(&allocator->lock);
 
+    // sample it
+    if (tb_allocator_profiler_sample(allocator)) tb_allocator_profiler_record(data, size __tb_debug_args__);
+
     // ok?
     return data;
 }
@@ -273,6 +692,9 @@ tb_pointer_t tb_allocator_large_ralloc_(tb_allocator_ref_t allocator, tb_pointer
     // check
     tb_assert_and_check_return_val(allocator, tb_null);
 
+    // remove the sampled data first
+    tb_allocator_profiler_remove(allocator, data);
+
     // enter
     tb_bool_t lockit = !(allocator->flag & TB_ALLOCATOR_FLAG_NOLOCK);
     if (lockit) tb_spinlock_enter(&allocator->lock);
@@ -312,6 +734,9 @@ tb_pointer_t tb_allocator_large_ralloc_(tb_allocator_ref_t allocator, tb_pointer
     // leave
     if (lockit) tb_spinlock_leave(&allocator->lock);
 
+    // sample it
+    if (tb_allocator_profiler_sample(allocator)) tb_allocator_profiler_record(data_new, size __tb_debug_args__);
+
     // ok?
     return data_new;
 }
@@ -320,6 +745,9 @@ tb_bool_t tb_allocator_large_free_(tb_allocator_ref_t allocator, tb_pointer_t da
     // check
     tb_assert_and_check_return_val(allocator, tb_false);
 
+    // remove the sampled data first, it may be reused by other threads after freeing it
+    tb_allocator_profiler_remove(allocator, data);
+
     // enter
     tb_bool_t lockit = !(allocator->flag & TB_ALLOCATOR_FLAG_NOLOCK);
     if (lockit) tb_spinlock_enter(&allocator->lock);
@@ -494,7 +922,33 @@ tb_void_t tb_allocator_exit(tb_allocator_ref_t allocator)
     // exit it
     if (allocator->exit) allocator->exit(allocator);
 }
-#ifdef __tb_debug__
+tb_void_t tb_allocator_profiler_enable(tb_allocator_ref_t allocator, tb_size_t rate)
+{
+    // disable the current profiler first
+    tb_allocator_profiler_t* profiler = &g_allocator_profiler;
+    tb_atomic_set(&profiler->allocator, 0);
+    tb_check_return(allocator && rate);
+
+    // enter
+    tb_spinlock_enter(&profiler->lock);
+
+    // reset all statistics
+    tb_atomic_set(&profiler->live, 0);
+    tb_memset_(profiler->class_count, 0, sizeof(profiler->class_count));
+    tb_memset_(profiler->class_bytes, 0, sizeof(profiler->class_bytes));
+    tb_memset_(profiler->sites, 0, sizeof(profiler->sites));
+    tb_memset_((tb_pointer_t)profiler->addrs, 0, sizeof(profiler->addrs));
+    profiler->count     = 0;
+    profiler->bytes     = 0;
+    profiler->dropped   = 0;
+
+    // leave
+    tb_spinlock_leave(&profiler->lock);
+
+    // enable it
+    tb_atomic_set(&profiler->rate, rate);
+    tb_atomic_set(&profiler->allocator, (tb_long_t)allocator);
+}
 tb_void_t tb_allocator_dump(tb_allocator_ref_t allocator)
 {
     // check
@@ -505,11 +959,21 @@ tb_void_t tb_allocator_dump(tb_allocator_ref_t allocator)
     if (lockit) tb_spinlock_enter(&allocator->lock);
 
     // dump it
+#ifdef __tb_debug__
     if (allocator->dump) allocator->dump(allocator);
+#endif
+
+    // dump the profile statistics of the allocator, e.g. the fragmentation of the fixed pools
+    if (allocator->profile && (tb_allocator_ref_t)tb_atomic_get(&g_allocator_profiler.allocator) == allocator)
+        allocator->profile(allocator);
 
     // leave
     if (lockit) tb_spinlock_leave(&allocator->lock);
+
+    // dump the profiler
+    tb_allocator_profiler_dump(allocator);
 }
+#ifdef __tb_debug__
 tb_bool_t tb_allocator_have(tb_allocator_ref_t allocator, tb_cpointer_t data)
 {
     // check
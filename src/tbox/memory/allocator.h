@@ -77,6 +77,7 @@ typedef enum __tb_allocator_type_e
 ,   TB_ALLOCATOR_TYPE_STATIC     = 4
 ,   TB_ALLOCATOR_TYPE_LARGE      = 5
 ,   TB_ALLOCATOR_TYPE_SMALL      = 6
+,   TB_ALLOCATOR_TYPE_REGION     = 7
 
 }tb_allocator_type_e;
 
@@ -170,6 +171,12 @@ typedef struct __tb_allocator_t
      */
     tb_void_t               (*exit)(struct __tb_allocator_t* allocator);
 
+    /*! dump the profile statistics in the json lines format, optional
+     *
+     * @param allocator     the allocator
+     */
+    tb_void_t               (*profile)(struct __tb_allocator_t* allocator);
+
 #ifdef __tb_debug__
     /*! dump allocator
      *
@@ -407,13 +414,43 @@ tb_void_t               tb_allocator_clear(tb_allocator_ref_t allocator);
  */
 tb_void_t               tb_allocator_exit(tb_allocator_ref_t allocator);
 
-#ifdef __tb_debug__
+/*! enable or disable the sampling profiler of the given allocator
+ *
+ * only one allocator can be profiled at the same time and it works in the release mode too.
+ *
+ * it samples one of every rate allocations of this allocator and records the size-class histogram
+ * and the live bytes of each allocation site (file and line in the debug mode, call stack in the release mode),
+ * and all values are scaled by the rate when dumping them.
+ *
+ * the results will be dumped by tb_allocator_dump() in the json lines format, e.g.
+ *
+ * <pre>
+ * profile: {"type": "summary", "allocator": "0x558e23092c48", "rate": 1024, "count": 506880, "bytes": 160676864, "live_count": 0, "live_bytes": 0, "dropped": 0}
+ * profile: {"type": "class", "size": 64, "count": 49152, "bytes": 2361344}
+ * profile: {"type": "site", "func": "tb_demo_default_allocator_profile", "file": "src/demo/memory/default_allocator.c", "line": 335, "count": 1024, "bytes": 81920000, "live_count": 0, "live_bytes": 0}
+ * profile: {"type": "fixed_pool", "item_size": 64, "size": 0, "maxn": 281, "wasted": 17984}
+ * </pre>
+ *
+ * the site is dumped with the frame addresses and symbols in the release mode, e.g.
+ *
+ * <pre>
+ * profile: {"type": "site", "frames": ["0x...", "0x...", "0x...", "0x..."], "symbols": ["tb_demo_default_allocator_profile", ...], "count": 1024, ...}
+ * </pre>
+ *
+ * @param allocator     the allocator
+ * @param rate          the sample rate, disable it if be zero
+ */
+tb_void_t               tb_allocator_profiler_enable(tb_allocator_ref_t allocator, tb_size_t rate);
+
 /*! dump it
+ *
+ * dump the allocator in the debug mode and dump the profile results if the profiler is enabled
  *
  * @param allocator     the allocator
  */
 tb_void_t               tb_allocator_dump(tb_allocator_ref_t allocator);
 
+#ifdef __tb_debug__
 /*! have this given data addess?
  *
  * @param allocator     the allocator
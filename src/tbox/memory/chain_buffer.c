@@ -0,0 +1,592 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        chain_buffer.c
+ * @ingroup     memory
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "chain_buffer"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "memory.h"
+#include "../libc/libc.h"
+#include "../utils/utils.h"
+#include "../platform/platform.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default block size
+#ifdef __tb_small__
+#   define TB_CHAIN_BUFFER_BLOCK_SIZE           (4096)
+#else
+#   define TB_CHAIN_BUFFER_BLOCK_SIZE           (8192)
+#endif
+
+// the block data
+#define tb_chain_buffer_block_data(block)       ((tb_byte_t*)((block) + 1))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the chain buffer block type
+typedef struct __tb_chain_buffer_block_t
+{
+    // the reference count of the segments
+    tb_atomic_t                 refn;
+
+}tb_chain_buffer_block_t;
+
+// the chain buffer segment type
+typedef struct __tb_chain_buffer_segment_t
+{
+    // the list entry
+    tb_list_entry_t             entry;
+
+    // the block
+    tb_chain_buffer_block_t*    block;
+
+    // the data offset of the block
+    tb_size_t                   offset;
+
+    // the data size
+    tb_size_t                   size;
+
+}tb_chain_buffer_segment_t;
+
+// the chain buffer pool type
+typedef struct __tb_chain_buffer_pool_t
+{
+    // the lock
+    tb_spinlock_t               lock;
+
+    // the block pool
+    tb_fixed_pool_ref_t         blocks;
+
+    // the segment pool
+    tb_fixed_pool_ref_t         segments;
+
+    // the block size
+    tb_size_t                   block_size;
+
+}tb_chain_buffer_pool_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_chain_buffer_segment_t* tb_chain_buffer_segment_init(tb_chain_buffer_pool_t* pool, tb_chain_buffer_block_t* block)
+{
+    // check
+    tb_assert(pool);
+
+    // enter
+    tb_spinlock_enter(&pool->lock);
+
+    // make segment
+    tb_chain_buffer_segment_t* segment = (tb_chain_buffer_segment_t*)tb_fixed_pool_malloc0(pool->segments);
+    if (segment)
+    {
+        // share the given block
+        if (block) tb_atomic_fetch_and_add(&block->refn, 1);
+        // make a new block
+        else if ((block = (tb_chain_buffer_block_t*)tb_fixed_pool_malloc(pool->blocks)))
+            tb_atomic_init(&block->refn, 1);
+        // no memory
+        else
+        {
+            tb_fixed_pool_free(pool->segments, segment);
+            segment = tb_null;
+        }
+
+        // save block
+        if (segment) segment->block = block;
+    }
+
+    // leave
+    tb_spinlock_leave(&pool->lock);
+
+    // ok?
+    return segment;
+}
+static tb_void_t tb_chain_buffer_segment_exit(tb_chain_buffer_pool_t* pool, tb_chain_buffer_segment_t* segment)
+{
+    // check
+    tb_assert(pool && segment && segment->block);
+
+    // the last reference? the block may be shared by the segments of the other threads
+    tb_bool_t last = tb_atomic_fetch_and_sub(&segment->block->refn, 1) == 1;
+
+    // enter
+    tb_spinlock_enter(&pool->lock);
+
+    // exit block
+    if (last) tb_fixed_pool_free(pool->blocks, segment->block);
+
+    // exit segment
+    tb_fixed_pool_free(pool->segments, segment);
+
+    // leave
+    tb_spinlock_leave(&pool->lock);
+}
+static __tb_inline__ tb_size_t tb_chain_buffer_segment_left(tb_chain_buffer_pool_t* pool, tb_chain_buffer_segment_t* segment)
+{
+    /* we can write to the free space of the block only if it is not shared with the other segments,
+     * otherwise the split data may be overwritten
+     */
+    return tb_atomic_get(&segment->block->refn) == 1? pool->block_size - segment->offset - segment->size : 0;
+}
+static __tb_inline__ tb_bool_t tb_chain_buffer_segment_prependable(tb_chain_buffer_segment_t* segment)
+{
+    return segment->offset && tb_atomic_get(&segment->block->refn) == 1;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_chain_buffer_pool_ref_t tb_chain_buffer_pool_init(tb_size_t block_size)
+{
+    // done
+    tb_bool_t                   ok = tb_false;
+    tb_chain_buffer_pool_t*     pool = tb_null;
+    do
+    {
+        // make pool
+        pool = tb_malloc0_type(tb_chain_buffer_pool_t);
+        tb_assert_and_check_break(pool);
+
+        // init lock
+        if (!tb_spinlock_init(&pool->lock)) break;
+
+        // init block size
+        pool->block_size = block_size? block_size : TB_CHAIN_BUFFER_BLOCK_SIZE;
+
+        // init blocks
+        pool->blocks = tb_fixed_pool_init(tb_null, 0, sizeof(tb_chain_buffer_block_t) + pool->block_size, tb_null, tb_null, tb_null);
+        tb_assert_and_check_break(pool->blocks);
+
+        // init segments
+        pool->segments = tb_fixed_pool_init(tb_null, 0, sizeof(tb_chain_buffer_segment_t), tb_null, tb_null, tb_null);
+        tb_assert_and_check_break(pool->segments);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (pool) tb_chain_buffer_pool_exit((tb_chain_buffer_pool_ref_t)pool);
+        pool = tb_null;
+    }
+
+    // ok?
+    return (tb_chain_buffer_pool_ref_t)pool;
+}
+tb_void_t tb_chain_buffer_pool_exit(tb_chain_buffer_pool_ref_t self)
+{
+    // check
+    tb_chain_buffer_pool_t* pool = (tb_chain_buffer_pool_t*)self;
+    tb_assert_and_check_return(pool);
+
+    // exit blocks
+    if (pool->blocks) tb_fixed_pool_exit(pool->blocks);
+    pool->blocks = tb_null;
+
+    // exit segments
+    if (pool->segments) tb_fixed_pool_exit(pool->segments);
+    pool->segments = tb_null;
+
+    // exit lock
+    tb_spinlock_exit(&pool->lock);
+
+    // exit it
+    tb_free(pool);
+}
+tb_size_t tb_chain_buffer_pool_block_size(tb_chain_buffer_pool_ref_t self)
+{
+    // check
+    tb_chain_buffer_pool_t* pool = (tb_chain_buffer_pool_t*)self;
+    tb_assert_and_check_return_val(pool, 0);
+
+    // the block size
+    return pool->block_size;
+}
+tb_bool_t tb_chain_buffer_init(tb_chain_buffer_ref_t buffer, tb_chain_buffer_pool_ref_t pool)
+{
+    // check
+    tb_assert_and_check_return_val(buffer && pool, tb_false);
+
+    // init
+    buffer->pool = pool;
+    buffer->size = 0;
+    tb_list_entry_init(&buffer->segments, tb_chain_buffer_segment_t, entry, tb_null);
+
+    // ok
+    return tb_true;
+}
+tb_void_t tb_chain_buffer_exit(tb_chain_buffer_ref_t buffer)
+{
+    if (buffer)
+    {
+        tb_chain_buffer_clear(buffer);
+        tb_list_entry_exit(&buffer->segments);
+        tb_memset(buffer, 0, sizeof(tb_chain_buffer_t));
+    }
+}
+tb_void_t tb_chain_buffer_clear(tb_chain_buffer_ref_t buffer)
+{
+    // check
+    tb_assert_and_check_return(buffer && buffer->pool);
+
+    // the pool
+    tb_chain_buffer_pool_t* pool = (tb_chain_buffer_pool_t*)buffer->pool;
+
+    // exit all segments
+    while (!tb_list_entry_is_null(&buffer->segments))
+    {
+        tb_list_entry_ref_t entry = tb_list_entry_head(&buffer->segments);
+        tb_list_entry_remove(&buffer->segments, entry);
+        tb_chain_buffer_segment_exit(pool, (tb_chain_buffer_segment_t*)tb_list_entry0(entry));
+    }
+    buffer->size = 0;
+}
+tb_size_t tb_chain_buffer_size(tb_chain_buffer_ref_t buffer)
+{
+    // check
+    tb_assert_and_check_return_val(buffer, 0);
+
+    // the size
+    return buffer->size;
+}
+tb_size_t tb_chain_buffer_count(tb_chain_buffer_ref_t buffer)
+{
+    // check
+    tb_assert_and_check_return_val(buffer, 0);
+
+    // the segment count
+    return tb_list_entry_size(&buffer->segments);
+}
+tb_bool_t tb_chain_buffer_append(tb_chain_buffer_ref_t buffer, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(buffer && buffer->pool && (data || !size), tb_false);
+
+    // the pool
+    tb_chain_buffer_pool_t* pool = (tb_chain_buffer_pool_t*)buffer->pool;
+
+    // fill the free space of the tail segment first
+    tb_size_t n = 0;
+    if (size && !tb_list_entry_is_null(&buffer->segments))
+    {
+        tb_chain_buffer_segment_t* segment = (tb_chain_buffer_segment_t*)tb_list_entry0(tb_list_entry_last(&buffer->segments));
+        if ((n = tb_min(size, tb_chain_buffer_segment_left(pool, segment))))
+        {
+            tb_memcpy(tb_chain_buffer_block_data(segment->block) + segment->offset + segment->size, data, n);
+            segment->size   += n;
+            buffer->size    += n;
+            data            += n;
+            size            -= n;
+        }
+    }
+
+    // append the new blocks
+    while (size)
+    {
+        // make segment
+        tb_chain_buffer_segment_t* segment = tb_chain_buffer_segment_init(pool, tb_null);
+        tb_assert_and_check_break(segment);
+
+        // copy data
+        n = tb_min(size, pool->block_size);
+        tb_memcpy(tb_chain_buffer_block_data(segment->block), data, n);
+        segment->size = n;
+        tb_list_entry_insert_tail(&buffer->segments, &segment->entry);
+
+        // next
+        buffer->size    += n;
+        data            += n;
+        size            -= n;
+    }
+
+    // ok?
+    return !size;
+}
+tb_bool_t tb_chain_buffer_prepend(tb_chain_buffer_ref_t buffer, tb_byte_t const* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(buffer && buffer->pool && (data || !size), tb_false);
+
+    // the pool
+    tb_chain_buffer_pool_t* pool = (tb_chain_buffer_pool_t*)buffer->pool;
+
+    // fill the free space before the head segment first
+    tb_size_t n = 0;
+    if (size && !tb_list_entry_is_null(&buffer->segments))
+    {
+        tb_chain_buffer_segment_t* segment = (tb_chain_buffer_segment_t*)tb_list_entry0(tb_list_entry_head(&buffer->segments));
+        if (tb_chain_buffer_segment_prependable(segment))
+        {
+            n = tb_min(size, segment->offset);
+            segment->offset -= n;
+            segment->size   += n;
+            buffer->size    += n;
+            size            -= n;
+            tb_memcpy(tb_chain_buffer_block_data(segment->block) + segment->offset, data + size, n);
+        }
+    }
+
+    // prepend the new blocks and place the data at the block tail, so the next prepending can reuse the free space
+    while (size)
+    {
+        // make segment
+        tb_chain_buffer_segment_t* segment = tb_chain_buffer_segment_init(pool, tb_null);
+        tb_assert_and_check_break(segment);
+
+        // copy data
+        n = tb_min(size, pool->block_size);
+        size -= n;
+        segment->offset = pool->block_size - n;
+        segment->size   = n;
+        tb_memcpy(tb_chain_buffer_block_data(segment->block) + segment->offset, data + size, n);
+        tb_list_entry_insert_head(&buffer->segments, &segment->entry);
+        buffer->size += n;
+    }
+
+    // ok?
+    return !size;
+}
+tb_bool_t tb_chain_buffer_split(tb_chain_buffer_ref_t buffer, tb_size_t size, tb_chain_buffer_ref_t head)
+{
+    // check
+    tb_assert_and_check_return_val(buffer && buffer->pool && head && head != buffer && head->pool == buffer->pool, tb_false);
+
+    // the pool
+    tb_chain_buffer_pool_t* pool = (tb_chain_buffer_pool_t*)buffer->pool;
+    tb_check_return_val(size <= buffer->size, tb_false);
+
+    // move the head segments
+    while (size)
+    {
+        // the head segment
+        tb_list_entry_ref_t         entry = tb_list_entry_head(&buffer->segments);
+        tb_chain_buffer_segment_t*  segment = (tb_chain_buffer_segment_t*)tb_list_entry0(entry);
+
+        // move the whole segment
+        if (segment->size <= size)
+        {
+            tb_list_entry_remove(&buffer->segments, entry);
+            tb_list_entry_insert_tail(&head->segments, entry);
+            buffer->size    -= segment->size;
+            head->size      += segment->size;
+            size            -= segment->size;
+        }
+        // split this segment and share its block
+        else
+        {
+            // make segment
+            tb_chain_buffer_segment_t* part = tb_chain_buffer_segment_init(pool, segment->block);
+            tb_assert_and_check_return_val(part, tb_false);
+
+            // move the part data
+            part->offset        = segment->offset;
+            part->size          = size;
+            segment->offset     += size;
+            segment->size       -= size;
+            tb_list_entry_insert_tail(&head->segments, &part->entry);
+            buffer->size        -= size;
+            head->size          += size;
+            size                = 0;
+        }
+    }
+
+    // ok
+    return tb_true;
+}
+tb_void_t tb_chain_buffer_splice(tb_chain_buffer_ref_t buffer, tb_chain_buffer_ref_t spliced)
+{
+    // check
+    tb_assert_and_check_return(buffer && spliced && buffer != spliced && buffer->pool == spliced->pool);
+
+    // splice all segments
+    tb_list_entry_splice_tail(&buffer->segments, &spliced->segments);
+    buffer->size += spliced->size;
+    spliced->size = 0;
+}
+tb_size_t tb_chain_buffer_skip(tb_chain_buffer_ref_t buffer, tb_size_t size)
+{
+    return tb_chain_buffer_read(buffer, tb_null, size);
+}
+tb_size_t tb_chain_buffer_read(tb_chain_buffer_ref_t buffer, tb_byte_t* data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(buffer && buffer->pool, 0);
+
+    // the pool
+    tb_chain_buffer_pool_t* pool = (tb_chain_buffer_pool_t*)buffer->pool;
+
+    // read and skip the head segments
+    tb_size_t read = 0;
+    while (read < size && !tb_list_entry_is_null(&buffer->segments))
+    {
+        // the head segment
+        tb_list_entry_ref_t         entry = tb_list_entry_head(&buffer->segments);
+        tb_chain_buffer_segment_t*  segment = (tb_chain_buffer_segment_t*)tb_list_entry0(entry);
+
+        // read data
+        tb_size_t n = tb_min(size - read, segment->size);
+        if (data) tb_memcpy(data + read, tb_chain_buffer_block_data(segment->block) + segment->offset, n);
+        segment->offset += n;
+        segment->size   -= n;
+        read            += n;
+
+        // exit the empty segment
+        if (!segment->size)
+        {
+            tb_list_entry_remove(&buffer->segments, entry);
+            tb_chain_buffer_segment_exit(pool, segment);
+        }
+    }
+    buffer->size -= read;
+
+    // ok
+    return read;
+}
+tb_size_t tb_chain_buffer_pull_iovec(tb_chain_buffer_ref_t buffer, tb_iovec_t* list, tb_size_t maxn)
+{
+    // check
+    tb_assert_and_check_return_val(buffer && list && maxn, 0);
+
+    // export the data of all segments
+    tb_size_t           count = 0;
+    tb_list_entry_ref_t entry = tb_list_entry_head(&buffer->segments);
+    tb_list_entry_ref_t tail = tb_list_entry_tail(&buffer->segments);
+    for (; entry != tail && count < maxn; entry = tb_list_entry_next(entry))
+    {
+        tb_chain_buffer_segment_t* segment = (tb_chain_buffer_segment_t*)tb_list_entry0(entry);
+        list[count].data = tb_chain_buffer_block_data(segment->block) + segment->offset;
+        list[count].size = (tb_iovec_size_t)segment->size;
+        count++;
+    }
+
+    // ok
+    return count;
+}
+tb_size_t tb_chain_buffer_push_iovec(tb_chain_buffer_ref_t buffer, tb_iovec_t* list, tb_size_t maxn, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(buffer && buffer->pool && list && maxn && size, 0);
+
+    // the pool
+    tb_chain_buffer_pool_t* pool = (tb_chain_buffer_pool_t*)buffer->pool;
+
+    // export the free space of the tail segment first
+    tb_size_t count = 0;
+    tb_size_t left = 0;
+    if (!tb_list_entry_is_null(&buffer->segments))
+    {
+        tb_chain_buffer_segment_t* segment = (tb_chain_buffer_segment_t*)tb_list_entry0(tb_list_entry_last(&buffer->segments));
+        if ((left = tb_chain_buffer_segment_left(pool, segment)))
+        {
+            list[count].data = tb_chain_buffer_block_data(segment->block) + segment->offset + segment->size;
+            list[count].size = (tb_iovec_size_t)left;
+            size -= tb_min(size, left);
+            count++;
+        }
+    }
+
+    /* reserve the new empty segments
+     *
+     * the empty segments only exist between push_iovec() and push_commit(),
+     * the unused segments will be released after committing
+     */
+    while (size && count < maxn)
+    {
+        // make segment
+        tb_chain_buffer_segment_t* segment = tb_chain_buffer_segment_init(pool, tb_null);
+        tb_assert_and_check_break(segment);
+        tb_list_entry_insert_tail(&buffer->segments, &segment->entry);
+
+        // export it
+        list[count].data = tb_chain_buffer_block_data(segment->block);
+        list[count].size = (tb_iovec_size_t)pool->block_size;
+        size -= tb_min(size, pool->block_size);
+        count++;
+    }
+
+    // ok
+    return count;
+}
+tb_void_t tb_chain_buffer_push_commit(tb_chain_buffer_ref_t buffer, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return(buffer && buffer->pool);
+
+    // the pool
+    tb_chain_buffer_pool_t* pool = (tb_chain_buffer_pool_t*)buffer->pool;
+
+    // find the first reserved empty segment
+    tb_list_entry_ref_t tail = tb_list_entry_tail(&buffer->segments);
+    tb_list_entry_ref_t entry = tail;
+    while (tb_list_entry_prev(entry) != tail && !((tb_chain_buffer_segment_t*)tb_list_entry0(tb_list_entry_prev(entry)))->size)
+        entry = tb_list_entry_prev(entry);
+
+    // commit the free space of the previous segment first
+    tb_size_t n = 0;
+    if (size && tb_list_entry_prev(entry) != tail)
+    {
+        tb_chain_buffer_segment_t* segment = (tb_chain_buffer_segment_t*)tb_list_entry0(tb_list_entry_prev(entry));
+        if ((n = tb_min(size, tb_chain_buffer_segment_left(pool, segment))))
+        {
+            segment->size   += n;
+            buffer->size    += n;
+            size            -= n;
+        }
+    }
+
+    // commit the reserved segments and release the unused segments
+    while (entry != tail)
+    {
+        tb_chain_buffer_segment_t* segment = (tb_chain_buffer_segment_t*)tb_list_entry0(entry);
+        entry = tb_list_entry_next(entry);
+        if (size)
+        {
+            n = tb_min(size, pool->block_size);
+            segment->size   = n;
+            buffer->size    += n;
+            size            -= n;
+        }
+        else
+        {
+            tb_list_entry_remove(&buffer->segments, &segment->entry);
+            tb_chain_buffer_segment_exit(pool, segment);
+        }
+    }
+
+    // check
+    tb_assert(!size);
+}
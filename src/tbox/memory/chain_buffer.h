@@ -0,0 +1,244 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        chain_buffer.h
+ * @ingroup     memory
+ *
+ */
+#ifndef TB_MEMORY_CHAIN_BUFFER_H
+#define TB_MEMORY_CHAIN_BUFFER_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../platform/prefix.h"
+#include "../container/list_entry.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the chain buffer pool ref type
+typedef __tb_typeref__(chain_buffer_pool);
+
+/*! the chain buffer type
+ *
+ * the buffer data is a chain of the segments and each segment refers a part of the refcounted block,
+ * so the data can be split, spliced and exported as iovec without copying.
+ *
+ * <pre>
+ *
+ *  segment:     [offset, size]          [offset, size]          [offset, size]
+ *                    |                       |                       |
+ *  block:     |------|||||||||||------|   |||||||||||||||||||   |||||||||----------|
+ *                                                                             |
+ *                                                                       the free space
+ * </pre>
+ *
+ * @note the chain buffer is not thread-safe, but the chains from the same pool can be used in the different threads.
+ */
+typedef struct __tb_chain_buffer_t
+{
+    /// the pool
+    tb_chain_buffer_pool_ref_t  pool;
+
+    /// the segments
+    tb_list_entry_head_t        segments;
+
+    /// the data size
+    tb_size_t                   size;
+
+}tb_chain_buffer_t, *tb_chain_buffer_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the block pool of the chain buffers
+ *
+ * @param block_size    the block size, uses the default size if be zero
+ *
+ * @return              the pool
+ */
+tb_chain_buffer_pool_ref_t  tb_chain_buffer_pool_init(tb_size_t block_size);
+
+/*! exit the block pool, all chain buffers of this pool must be exited first
+ *
+ * @param pool          the pool
+ */
+tb_void_t                   tb_chain_buffer_pool_exit(tb_chain_buffer_pool_ref_t pool);
+
+/*! the block size of the pool
+ *
+ * @param pool          the pool
+ *
+ * @return              the block size
+ */
+tb_size_t                   tb_chain_buffer_pool_block_size(tb_chain_buffer_pool_ref_t pool);
+
+/*! init buffer
+ *
+ * @param buffer        the buffer
+ * @param pool          the block pool
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t                   tb_chain_buffer_init(tb_chain_buffer_ref_t buffer, tb_chain_buffer_pool_ref_t pool);
+
+/*! exit buffer
+ *
+ * @param buffer        the buffer
+ */
+tb_void_t                   tb_chain_buffer_exit(tb_chain_buffer_ref_t buffer);
+
+/*! clear buffer
+ *
+ * @param buffer        the buffer
+ */
+tb_void_t                   tb_chain_buffer_clear(tb_chain_buffer_ref_t buffer);
+
+/*! the buffer size
+ *
+ * @param buffer        the buffer
+ *
+ * @return              the buffer size
+ */
+tb_size_t                   tb_chain_buffer_size(tb_chain_buffer_ref_t buffer);
+
+/*! the segment count
+ *
+ * @param buffer        the buffer
+ *
+ * @return              the segment count
+ */
+tb_size_t                   tb_chain_buffer_count(tb_chain_buffer_ref_t buffer);
+
+/*! append data to the buffer tail
+ *
+ * @param buffer        the buffer
+ * @param data          the data
+ * @param size          the size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t                   tb_chain_buffer_append(tb_chain_buffer_ref_t buffer, tb_byte_t const* data, tb_size_t size);
+
+/*! prepend data to the buffer head
+ *
+ * @param buffer        the buffer
+ * @param data          the data
+ * @param size          the size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t                   tb_chain_buffer_prepend(tb_chain_buffer_ref_t buffer, tb_byte_t const* data, tb_size_t size);
+
+/*! split the head data of the buffer and append it to the tail of the given buffer without copying
+ *
+ * @code
+    // move the header part of the request to the head buffer
+    tb_chain_buffer_split(&request, header_size, &head);
+ * @endcode
+ *
+ * @param buffer        the buffer
+ * @param size          the split size
+ * @param head          the head buffer of the same pool
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t                   tb_chain_buffer_split(tb_chain_buffer_ref_t buffer, tb_size_t size, tb_chain_buffer_ref_t head);
+
+/*! splice all data of the given buffer to the buffer tail without copying, the given buffer will be empty
+ *
+ * @param buffer        the buffer
+ * @param spliced       the spliced buffer of the same pool
+ */
+tb_void_t                   tb_chain_buffer_splice(tb_chain_buffer_ref_t buffer, tb_chain_buffer_ref_t spliced);
+
+/*! skip the head data
+ *
+ * @param buffer        the buffer
+ * @param size          the skipped size
+ *
+ * @return              the real size
+ */
+tb_size_t                   tb_chain_buffer_skip(tb_chain_buffer_ref_t buffer, tb_size_t size);
+
+/*! read and skip the head data
+ *
+ * @param buffer        the buffer
+ * @param data          the data
+ * @param size          the size
+ *
+ * @return              the real size
+ */
+tb_size_t                   tb_chain_buffer_read(tb_chain_buffer_ref_t buffer, tb_byte_t* data, tb_size_t size);
+
+/*! export the data segments as iovec for tb_socket_sendv()
+ *
+ * @code
+    tb_iovec_t list[16];
+    tb_size_t  count = tb_chain_buffer_pull_iovec(&buffer, list, 16);
+    tb_long_t  real = tb_socket_sendv(sock, list, count);
+    if (real > 0) tb_chain_buffer_skip(&buffer, real);
+ * @endcode
+ *
+ * @param buffer        the buffer
+ * @param list          the iovec list
+ * @param maxn          the iovec maxn
+ *
+ * @return              the iovec count
+ */
+tb_size_t                   tb_chain_buffer_pull_iovec(tb_chain_buffer_ref_t buffer, tb_iovec_t* list, tb_size_t maxn);
+
+/*! reserve the free space of the buffer tail and export it as iovec for tb_socket_recvv()
+ *
+ * @code
+    tb_iovec_t list[4];
+    tb_size_t  count = tb_chain_buffer_push_iovec(&buffer, list, 4, 8192);
+    tb_long_t  real = tb_socket_recvv(sock, list, count);
+    tb_chain_buffer_push_commit(&buffer, real > 0? real : 0);
+ * @endcode
+ *
+ * @param buffer        the buffer
+ * @param list          the iovec list
+ * @param maxn          the iovec maxn
+ * @param size          the reserved size
+ *
+ * @return              the iovec count, the last reserved space may be less than size if the iovec count is not enough
+ */
+tb_size_t                   tb_chain_buffer_push_iovec(tb_chain_buffer_ref_t buffer, tb_iovec_t* list, tb_size_t maxn, tb_size_t size);
+
+/*! commit the written size of the reserved space and release the unused blocks
+ *
+ * @param buffer        the buffer
+ * @param size          the written size
+ */
+tb_void_t                   tb_chain_buffer_push_commit(tb_chain_buffer_ref_t buffer, tb_size_t size);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -35,6 +35,22 @@
 #include "default_allocator.h"
 #include "impl/prefix.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the size class count of the small allocator
+#define TB_DEFAULT_ALLOCATOR_CACHE_CLASSN       TB_SMALL_ALLOCATOR_CLASSN
+
+// the cached data maximum count per-class
+#define TB_DEFAULT_ALLOCATOR_CACHE_MAXN         (64)
+
+// the cached data minimum count per-class
+#define TB_DEFAULT_ALLOCATOR_CACHE_MINN         (8)
+
+// the cached data size per-class
+#define TB_DEFAULT_ALLOCATOR_CACHE_SIZE         (32 * 1024)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -51,17 +67,290 @@ typedef struct __tb_default_allocator_t
     // the small allocator
     tb_allocator_ref_t      small_allocator;
 
+    // enable the thread cache?
+    tb_atomic32_t           cache_enabled;
+
+    // the thread caches of all threads, they will be flushed and detached when the allocator is exited
+    tb_list_entry_head_t    caches;
+
 }tb_default_allocator_t, *tb_default_allocator_ref_t;
 
+// the default allocator cache class type
+typedef struct __tb_default_allocator_cache_class_t
+{
+    // the data count
+    tb_uint16_t             count;
+
+    // the data maximum count
+    tb_uint16_t             maxn;
+
+    // the data list
+    tb_pointer_t            list[TB_DEFAULT_ALLOCATOR_CACHE_MAXN];
+
+}tb_default_allocator_cache_class_t;
+
+/* the default allocator thread cache type
+ *
+ * <pre>
+ *
+ * thread0: [16B: |||||   ] [32B: ||      ] ... [3072B: |       ]
+ * thread1: [16B: ||      ] [32B: ||||||| ] ... [3072B:         ]
+ *              |     ^         |     ^             |     ^
+ *              |     |         |     |             |     |
+ *              v     |         v     |             v     |
+ *                       batch malloc/free with lock
+ *  -----------------------------------------------------------------
+ * |                        small allocator                          |
+ *  -----------------------------------------------------------------
+ *
+ * </pre>
+ */
+typedef struct __tb_default_allocator_cache_t
+{
+    // the list entry of the allocator caches
+    tb_list_entry_t                     entry;
+
+    // the allocator, it's null if the allocator has been exited
+    tb_default_allocator_ref_t          allocator;
+
+    // the cached classes
+    tb_default_allocator_cache_class_t  classes[TB_DEFAULT_ALLOCATOR_CACHE_CLASSN];
+
+}tb_default_allocator_cache_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * declaration
+ */
+__tb_extern_c__ tb_size_t   tb_small_allocator_find_index(tb_size_t size, tb_size_t* pspace);
+__tb_extern_c__ tb_size_t   tb_small_allocator_nmalloc_(tb_allocator_ref_t allocator, tb_size_t size, tb_pointer_t* list, tb_size_t count __tb_debug_decl__);
+__tb_extern_c__ tb_void_t   tb_small_allocator_nfree_(tb_allocator_ref_t allocator, tb_pointer_t* list, tb_size_t count __tb_debug_decl__);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+#ifdef __tb_thread_local__
+
+// the thread cache local for freeing it when the thread is exited
+static tb_thread_local_t                                    g_cache_local = TB_THREAD_LOCAL_INIT;
+
+// the lock of the thread caches list, it's only used when the thread cache is made or exited
+static tb_spinlock_t                                        g_cache_lock = TB_SPINLOCK_INIT;
+
+// the thread cache of the current thread
+static __tb_thread_local__ tb_default_allocator_cache_t*   g_cache = tb_null;
+
+// the thread cache of the current thread has been exited?
+static __tb_thread_local__ tb_bool_t                        g_cache_exited = tb_false;
+
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
+#ifdef __tb_thread_local__
+static tb_void_t tb_default_allocator_cache_flush(tb_default_allocator_cache_t* cache)
+{
+    // check
+    tb_assert_and_check_return(cache && cache->allocator && cache->allocator->small_allocator);
+
+    // give back all cached data to the small allocator
+    tb_size_t i = 0;
+    for (i = 0; i < tb_arrayn(cache->classes); i++)
+    {
+        tb_default_allocator_cache_class_t* cclass = &cache->classes[i];
+        if (cclass->count) tb_small_allocator_nfree_(cache->allocator->small_allocator, cclass->list, cclass->count __tb_debug_vals__);
+        cclass->count = 0;
+    }
+}
+static tb_void_t tb_default_allocator_cache_exit(tb_cpointer_t priv)
+{
+    // check
+    tb_default_allocator_cache_t* cache = (tb_default_allocator_cache_t*)priv;
+    tb_assert_and_check_return(cache);
+
+    // flush and remove it if the allocator has been not exited
+    tb_spinlock_enter(&g_cache_lock);
+    if (cache->allocator)
+    {
+        tb_default_allocator_cache_flush(cache);
+        tb_list_entry_remove(&cache->allocator->caches, &cache->entry);
+        cache->allocator = tb_null;
+    }
+    tb_spinlock_leave(&g_cache_lock);
+
+    // mark it as exited, we cannot make a new cache on this thread after it has been exited
+    g_cache         = tb_null;
+    g_cache_exited  = tb_true;
+
+    // exit it, it does not depend on the allocator lifetime
+    tb_native_memory_free(cache);
+}
+static tb_void_t tb_default_allocator_cache_detach(tb_default_allocator_ref_t allocator)
+{
+    // enter
+    tb_spinlock_enter(&g_cache_lock);
+
+    // flush the thread cache of the current thread
+    tb_default_allocator_cache_t* cache = g_cache;
+    if (cache && cache->allocator == allocator) tb_default_allocator_cache_flush(cache);
+
+    /* detach the caches of all threads
+     *
+     * we cannot flush the caches of other threads here because they are only accessed by their owner threads without lock,
+     * so the data cached by them will be released with the small allocator and they will only be freed on exiting these threads
+     */
+    while (tb_list_entry_size(&allocator->caches))
+    {
+        cache = (tb_default_allocator_cache_t*)tb_list_entry(&allocator->caches, tb_list_entry_head(&allocator->caches));
+        tb_list_entry_remove_head(&allocator->caches);
+        cache->allocator = tb_null;
+    }
+
+    // leave
+    tb_spinlock_leave(&g_cache_lock);
+}
+static tb_default_allocator_cache_t* tb_default_allocator_cache(tb_default_allocator_ref_t allocator)
+{
+    // get the thread cache of the current thread
+    tb_default_allocator_cache_t* cache = g_cache;
+    if (cache) return cache->allocator == allocator? cache : tb_null;
+
+    // has been exited?
+    tb_check_return_val(!g_cache_exited, tb_null);
+
+    /* make a new cache
+     *
+     * we use the native memory because it may be freed by the exiting thread after the allocator has been exited
+     */
+    cache = (tb_default_allocator_cache_t*)tb_native_memory_malloc0(sizeof(tb_default_allocator_cache_t));
+    tb_assert_and_check_return_val(cache, tb_null);
+
+    // save it and it will be exited when the current thread is exited
+    if (!tb_thread_local_set(&g_cache_local, cache))
+    {
+        tb_native_memory_free(cache);
+        return tb_null;
+    }
+    g_cache = cache;
+
+    // attach it to the allocator
+    tb_spinlock_enter(&g_cache_lock);
+    cache->allocator = allocator;
+    tb_list_entry_insert_tail(&allocator->caches, &cache->entry);
+    tb_spinlock_leave(&g_cache_lock);
+
+    // ok
+    return cache;
+}
+static tb_default_allocator_cache_class_t* tb_default_allocator_cache_class(tb_default_allocator_cache_t* cache, tb_size_t size)
+{
+    // the class index
+    tb_size_t space = 0;
+    tb_size_t index = tb_small_allocator_find_index(size, &space);
+    tb_assert_and_check_return_val(index < tb_arrayn(cache->classes) && space, tb_null);
+
+    // init the maximum count of this class
+    tb_default_allocator_cache_class_t* cclass = &cache->classes[index];
+    if (!cclass->maxn)
+    {
+        tb_size_t maxn = TB_DEFAULT_ALLOCATOR_CACHE_SIZE / space;
+        if (maxn < TB_DEFAULT_ALLOCATOR_CACHE_MINN) maxn = TB_DEFAULT_ALLOCATOR_CACHE_MINN;
+        if (maxn > TB_DEFAULT_ALLOCATOR_CACHE_MAXN) maxn = TB_DEFAULT_ALLOCATOR_CACHE_MAXN;
+        cclass->maxn = (tb_uint16_t)maxn;
+    }
+    return cclass;
+}
+static tb_pointer_t tb_default_allocator_cache_malloc(tb_default_allocator_ref_t allocator, tb_size_t size __tb_debug_decl__)
+{
+    // get the thread cache
+    tb_default_allocator_cache_t* cache = tb_default_allocator_cache(allocator);
+    tb_check_return_val(cache, tb_null);
+
+    // get the cached class
+    tb_default_allocator_cache_class_t* cclass = tb_default_allocator_cache_class(cache, size);
+    tb_check_return_val(cclass, tb_null);
+
+    // no cached data? get a batch of data from the small allocator
+    if (!cclass->count) cclass->count = (tb_uint16_t)tb_small_allocator_nmalloc_(allocator->small_allocator, size, cclass->list, cclass->maxn >> 1 __tb_debug_args__);
+    tb_check_return_val(cclass->count, tb_null);
+
+    // get data from the cached class
+    tb_pointer_t data = cclass->list[--cclass->count];
+    tb_assert(data);
+
+    // the data head
+    tb_pool_data_head_t* data_head = &(((tb_pool_data_head_t*)data)[-1]);
+    tb_assert(data_head->debug.magic == TB_POOL_DATA_MAGIC);
+
+#ifdef __tb_debug__
+    // the data space
+    tb_size_t space = 0;
+    tb_small_allocator_find_index(size, &space);
+
+    // fill the patch bytes
+    if (space > size) tb_memset_((tb_byte_t*)data + size, TB_POOL_DATA_PATCH, space - size);
+
+    // update the debug info
+    data_head->debug.file = file_;
+    data_head->debug.func = func_;
+    data_head->debug.line = (tb_uint16_t)line_;
+
+    // save backtrace
+    tb_pool_data_save_backtrace(&data_head->debug, 3);
+#endif
+
+    // update size
+    data_head->size = size;
+
+    // ok
+    return data;
+}
+static tb_bool_t tb_default_allocator_cache_free(tb_default_allocator_ref_t allocator, tb_pointer_t data, tb_size_t size __tb_debug_decl__)
+{
+    // get the thread cache
+    tb_default_allocator_cache_t* cache = tb_default_allocator_cache(allocator);
+    tb_check_return_val(cache, tb_false);
+
+    // get the cached class
+    tb_default_allocator_cache_class_t* cclass = tb_default_allocator_cache_class(cache, size);
+    tb_check_return_val(cclass, tb_false);
+
+#ifdef __tb_debug__
+    // the data space
+    tb_size_t space = 0;
+    tb_small_allocator_find_index(size, &space);
+
+    // check underflow
+    tb_assertf(space == size || ((tb_byte_t*)data)[size] == TB_POOL_DATA_PATCH, "data underflow");
+#endif
+
+    // the cached class is full? give back the half of data to the small allocator
+    if (cclass->count >= cclass->maxn)
+    {
+        tb_size_t half = cclass->maxn >> 1;
+        tb_small_allocator_nfree_(allocator->small_allocator, cclass->list + cclass->count - half, half __tb_debug_args__);
+        cclass->count -= (tb_uint16_t)half;
+    }
+
+    // cache it
+    cclass->list[cclass->count++] = data;
+
+    // ok
+    return tb_true;
+}
+#endif
 static tb_void_t tb_default_allocator_exit(tb_allocator_ref_t self)
 {
     // check
     tb_default_allocator_ref_t allocator = (tb_default_allocator_ref_t)self;
     tb_assert_and_check_return(allocator);
 
+#ifdef __tb_thread_local__
+    // flush and detach the thread caches of all threads
+    tb_default_allocator_cache_detach(allocator);
+#endif
+
     // enter
     tb_spinlock_enter(&allocator->base.lock);
 
@@ -87,6 +376,15 @@ static tb_pointer_t tb_default_allocator_malloc(tb_allocator_ref_t self, tb_size
     // check
     tb_assert_and_check_return_val(allocator->large_allocator && allocator->small_allocator && size, tb_null);
 
+#ifdef __tb_thread_local__
+    // attempt to malloc it from the thread cache
+    if (size <= TB_SMALL_ALLOCATOR_DATA_MAXN && tb_atomic32_get_explicit(&allocator->cache_enabled, TB_ATOMIC_RELAXED))
+    {
+        tb_pointer_t data = tb_default_allocator_cache_malloc(allocator, size __tb_debug_args__);
+        if (data) return data;
+    }
+#endif
+
     // done
     return size <= TB_SMALL_ALLOCATOR_DATA_MAXN? tb_allocator_malloc_(allocator->small_allocator, size __tb_debug_args__) : tb_allocator_large_malloc_(allocator->large_allocator, size, tb_null __tb_debug_args__);
 }
@@ -170,6 +468,16 @@ static tb_bool_t tb_default_allocator_free(tb_allocator_ref_t self, tb_pointer_t
         tb_pool_data_head_t* data_head = &(((tb_pool_data_head_t*)data)[-1]);
         tb_assertf(data_head->debug.magic == TB_POOL_DATA_MAGIC, "free invalid data: %p", data);
 
+#ifdef __tb_thread_local__
+        // attempt to free it to the thread cache
+        if (data_head->size <= TB_SMALL_ALLOCATOR_DATA_MAXN && tb_atomic32_get_explicit(&allocator->cache_enabled, TB_ATOMIC_RELAXED)
+            && tb_default_allocator_cache_free(allocator, data, data_head->size __tb_debug_args__))
+        {
+            ok = tb_true;
+            break;
+        }
+#endif
+
         // free it
         ok = (data_head->size <= TB_SMALL_ALLOCATOR_DATA_MAXN)? tb_allocator_free_(allocator->small_allocator, data __tb_debug_args__) : tb_allocator_large_free_(allocator->large_allocator, data __tb_debug_args__);
 
@@ -178,6 +486,22 @@ static tb_bool_t tb_default_allocator_free(tb_allocator_ref_t self, tb_pointer_t
     // ok?
     return ok;
 }
+static tb_void_t tb_default_allocator_profile(tb_allocator_ref_t self)
+{
+    // check
+    tb_default_allocator_ref_t allocator = (tb_default_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator && allocator->small_allocator);
+
+    // dump the profile statistics of the small allocator
+    tb_allocator_ref_t small_allocator = allocator->small_allocator;
+    if (small_allocator->profile)
+    {
+        tb_bool_t lockit = !(small_allocator->flag & TB_ALLOCATOR_FLAG_NOLOCK);
+        if (lockit) tb_spinlock_enter(&small_allocator->lock);
+        small_allocator->profile(small_allocator);
+        if (lockit) tb_spinlock_leave(&small_allocator->lock);
+    }
+}
 #ifdef __tb_debug__
 static tb_void_t tb_default_allocator_dump(tb_allocator_ref_t self)
 {
@@ -322,6 +646,7 @@ tb_allocator_ref_t tb_default_allocator_init(tb_allocator_ref_t large_allocator)
         allocator->base.ralloc          = tb_default_allocator_ralloc;
         allocator->base.free            = tb_default_allocator_free;
         allocator->base.exit            = tb_default_allocator_exit;
+        allocator->base.profile         = tb_default_allocator_profile;
 #ifdef __tb_debug__
         allocator->base.dump            = tb_default_allocator_dump;
         allocator->base.have            = tb_default_allocator_have;
@@ -330,11 +655,22 @@ tb_allocator_ref_t tb_default_allocator_init(tb_allocator_ref_t large_allocator)
         // init lock
         if (!tb_spinlock_init(&allocator->base.lock)) break;
 
+        // init the thread caches
+        tb_list_entry_init(&allocator->caches, tb_default_allocator_cache_t, entry, tb_null);
+
         // init allocator
         allocator->large_allocator = large_allocator;
         allocator->small_allocator = tb_small_allocator_init(large_allocator);
         tb_assert_and_check_break(allocator->small_allocator);
 
+#ifdef __tb_thread_local__
+        /* the thread caches need not lock, and the shared path is still locked by the small and large allocators themselves,
+         * so we need not lock the default allocator, it's decided only here because the lock mode cannot be changed on a live allocator
+         */
+        if (!(allocator->small_allocator->flag & TB_ALLOCATOR_FLAG_NOLOCK) && !(large_allocator->flag & TB_ALLOCATOR_FLAG_NOLOCK))
+            allocator->base.flag |= TB_ALLOCATOR_FLAG_NOLOCK;
+#endif
+
         // register lock profiler
 #ifdef TB_LOCK_PROFILER_ENABLE
         tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&allocator->base.lock, TB_TRACE_MODULE_NAME);
@@ -355,4 +691,34 @@ tb_allocator_ref_t tb_default_allocator_init(tb_allocator_ref_t large_allocator)
     // ok?
     return (tb_allocator_ref_t)allocator;
 }
+tb_bool_t tb_default_allocator_cache_enable(tb_allocator_ref_t self, tb_bool_t enable)
+{
+    // check
+    tb_default_allocator_ref_t allocator = (tb_default_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && allocator->base.type == TB_ALLOCATOR_TYPE_DEFAULT, tb_false);
 
+#ifdef __tb_thread_local__
+    if (enable)
+    {
+        // init the thread cache local
+        if (!tb_thread_local_init(&g_cache_local, tb_default_allocator_cache_exit)) return tb_false;
+
+        // enable it
+        tb_atomic32_set(&allocator->cache_enabled, 1);
+    }
+    else
+    {
+        // disable it
+        tb_atomic32_set(&allocator->cache_enabled, 0);
+
+        // flush the thread cache of the current thread
+        if (g_cache && g_cache->allocator == allocator) tb_default_allocator_cache_flush(g_cache);
+    }
+
+    // ok
+    return tb_true;
+#else
+    // not supported
+    return !enable;
+#endif
+}
@@ -79,6 +79,22 @@ tb_allocator_ref_t          tb_default_allocator(tb_byte_t* data, tb_size_t size
  */
 tb_allocator_ref_t          tb_default_allocator_init(tb_allocator_ref_t large_allocator);
 
+/*! enable or disable the thread cache of the default allocator
+ *
+ * the small data (<=3KB) will be cached in the per-thread free lists of each size class,
+ * and we only exchange data with the small allocator in batches, so malloc and free need not enter the lock in most cases.
+ *
+ * the cached data will be given back to the small allocator when the thread is exited.
+ *
+ * @note it need be called after tb_init(), and only one default allocator can use the thread cache on the same thread.
+ *
+ * @param allocator         the default allocator
+ * @param enable            enable the thread cache?
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_default_allocator_cache_enable(tb_allocator_ref_t allocator, tb_bool_t enable);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -39,6 +39,23 @@
 // the item belong to this slot?
 #define tb_fixed_pool_slot_exists(slot, item)               (((tb_byte_t*)(item) > (tb_byte_t*)(slot)) && ((tb_byte_t*)(item) < (tb_byte_t*)slot + (slot)->size))
 
+// the aligned slot of the item
+#define tb_fixed_pool_slot_aligned(pool, item)              ((tb_fixed_pool_slot_t*)((tb_size_t)(item) & ~((pool)->slot_align - 1)))
+
+// the cache-line color count of the slot
+#ifdef __tb_small__
+#   define TB_FIXED_POOL_SLOT_COLORN                        (4)
+#else
+#   define TB_FIXED_POOL_SLOT_COLORN                        (8)
+#endif
+
+// the aligned slots count of the chunk
+#ifdef __tb_small__
+#   define TB_FIXED_POOL_CHUNK_SLOTN                        (4)
+#else
+#   define TB_FIXED_POOL_CHUNK_SLOTN                        (8)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -49,6 +66,14 @@ typedef struct __tb_fixed_pool_slot_t
     // the size: sizeof(slot) + data
     tb_size_t                       size;
 
+    // the base address allocated from the large allocator, or the owner chunk of the aligned slot
+    tb_pointer_t                    base;
+
+#ifdef __tb_debug__
+    // the owner fixed pool
+    tb_pointer_t                    owner;
+#endif
+
     // the pool
     tb_static_fixed_pool_ref_t      pool;
 
@@ -57,6 +82,37 @@ typedef struct __tb_fixed_pool_slot_t
 
 }tb_fixed_pool_slot_t;
 
+/* the chunk type of the aligned slots
+ *
+ * the aligned slots are carved out of one over-allocated chunk, so only one slot space is wasted for aligning them,
+ * and the chunk head is placed at the unaligned head or tail space.
+ *
+ * base      slots (aligned)
+ *  |---------|-----------|-----------|- ... -|-----------|---------|
+ *    [head]     slot0       slot1              slotn-1      [head]
+ */
+typedef struct __tb_fixed_pool_chunk_t
+{
+    // the base address allocated from the large allocator
+    tb_pointer_t                    base;
+
+    // the first aligned slot
+    tb_byte_t*                      slots;
+
+    // the used slots count
+    tb_size_t                       refn;
+
+    // the next unused slot index
+    tb_size_t                       next;
+
+    // the freed slots, they are linked by the first pointer of the slot
+    tb_pointer_t                    frees;
+
+    // the list entry of the chunks which have the unused slots
+    tb_list_entry_t                 entry;
+
+}tb_fixed_pool_chunk_t;
+
 // the fixed pool type
 typedef struct __tb_fixed_pool_impl_t
 {
@@ -99,15 +155,27 @@ typedef struct __tb_fixed_pool_impl_t
     // the slot space
     tb_size_t                       slot_space;
 
+    // the slot alignment (power of 2) for the aligned slot mode, it will be zero if disabled
+    tb_size_t                       slot_align;
+
+    // the chunks which have the unused aligned slots
+    tb_list_entry_head_t            chunks;
+
+    // the next cache-line color of the slot
+    tb_size_t                       slot_color;
+
     // for small allocator
     tb_bool_t                       for_small;
 
+    // the remote free list, the freed items are linked by the first pointer of the item data
+    tb_atomic_t                     remote_list;
+
 }tb_fixed_pool_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * declaration
  */
-__tb_extern_c__ tb_fixed_pool_ref_t tb_fixed_pool_init_(tb_allocator_ref_t large_allocator, tb_size_t slot_size, tb_size_t item_size, tb_bool_t for_small, tb_fixed_pool_item_init_func_t item_init, tb_fixed_pool_item_exit_func_t item_exit, tb_cpointer_t priv);
+__tb_extern_c__ tb_fixed_pool_ref_t tb_fixed_pool_init_(tb_allocator_ref_t large_allocator, tb_size_t slot_size, tb_size_t item_size, tb_bool_t for_small, tb_bool_t aligned, tb_fixed_pool_item_init_func_t item_init, tb_fixed_pool_item_exit_func_t item_exit, tb_cpointer_t priv);
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
@@ -124,15 +192,12 @@ static tb_bool_t tb_fixed_pool_item_exit(tb_pointer_t data, tb_cpointer_t priv)
     // continue
     return tb_true;
 }
-static tb_void_t tb_fixed_pool_slot_exit(tb_fixed_pool_t* pool, tb_fixed_pool_slot_t* slot)
+static tb_void_t tb_fixed_pool_slot_list_remove(tb_fixed_pool_t* pool, tb_fixed_pool_slot_t* slot)
 {
     // check
-    tb_assert_and_check_return(pool && pool->large_allocator && slot);
+    tb_assert_and_check_return(pool && slot);
     tb_assert_and_check_return(pool->slot_list && pool->slot_count);
 
-    // trace
-    tb_trace_d("slot[%lu]: exit: size: %lu", pool->item_size, slot->size);
-
     // make the iterator
     tb_array_iterator_t array_iterator;
     tb_iterator_ref_t   iterator = tb_array_iterator_init_ptr(&array_iterator, (tb_pointer_t*)pool->slot_list, pool->slot_count);
@@ -148,9 +213,151 @@ static tb_void_t tb_fixed_pool_slot_exit(tb_fixed_pool_t* pool, tb_fixed_pool_sl
 
     // update the slot count
     pool->slot_count--;
+}
+static tb_bool_t tb_fixed_pool_slot_list_insert(tb_fixed_pool_t* pool, tb_fixed_pool_slot_t* slot)
+{
+    // check
+    tb_assert_and_check_return_val(pool && pool->large_allocator && slot, tb_false);
+
+    // no list?
+    if (!pool->slot_list)
+    {
+        // init the slot list
+        tb_size_t size = 0;
+        pool->slot_list = (tb_fixed_pool_slot_t**)tb_allocator_large_nalloc(pool->large_allocator, 64, sizeof(tb_fixed_pool_slot_t*), &size);
+        tb_assert_and_check_return_val(pool->slot_list && size, tb_false);
+
+        // init the slot count
+        pool->slot_count = 0;
+
+        // init the slot space
+        pool->slot_space = size / sizeof(tb_fixed_pool_slot_t*);
+        tb_assert_and_check_return_val(pool->slot_space, tb_false);
+    }
+    // no enough space?
+    else if (pool->slot_count == pool->slot_space)
+    {
+        // grow the slot list
+        tb_size_t size = 0;
+        pool->slot_list = (tb_fixed_pool_slot_t**)tb_allocator_large_ralloc(pool->large_allocator, pool->slot_list, (pool->slot_space << 1) * sizeof(tb_fixed_pool_slot_t*), &size);
+        tb_assert_and_check_return_val(pool->slot_list && size, tb_false);
+
+        // update the slot space
+        pool->slot_space = size / sizeof(tb_fixed_pool_slot_t*);
+        tb_assert_and_check_return_val(pool->slot_space, tb_false);
+    }
+
+    // check
+    tb_assert_and_check_return_val(pool->slot_count < pool->slot_space, tb_false);
+
+    // insert the slot to the slot list in the increasing order (TODO binary search)
+    tb_size_t i = 0;
+    tb_size_t n = pool->slot_count;
+    for (i = 0; i < n; i++) if (slot <= pool->slot_list[i]) break;
+    if (i < n) tb_memmov_(pool->slot_list + i + 1, pool->slot_list + i, (n - i) * sizeof(tb_fixed_pool_slot_t*));
+    pool->slot_list[i] = slot;
+
+    // update the slot count
+    pool->slot_count++;
+
+    // ok
+    return tb_true;
+}
+static tb_bool_t tb_fixed_pool_chunk_full(tb_fixed_pool_chunk_t* chunk)
+{
+    return !chunk->frees && chunk->next >= TB_FIXED_POOL_CHUNK_SLOTN;
+}
+static tb_fixed_pool_slot_t* tb_fixed_pool_chunk_slot_init(tb_fixed_pool_t* pool)
+{
+    // check
+    tb_assert_and_check_return_val(pool && pool->large_allocator && pool->slot_align, tb_null);
+
+    // get a chunk with the unused slots
+    tb_fixed_pool_chunk_t* chunk = tb_null;
+    if (tb_list_entry_size(&pool->chunks))
+        chunk = (tb_fixed_pool_chunk_t*)tb_list_entry(&pool->chunks, tb_list_entry_head(&pool->chunks));
+    else
+    {
+        // make a new chunk, we need one more slot space for aligning them
+        tb_size_t    align = pool->slot_align;
+        tb_pointer_t base = tb_allocator_large_malloc(pool->large_allocator, (TB_FIXED_POOL_CHUNK_SLOTN + 1) * align, tb_null);
+        tb_assert_and_check_return_val(base, tb_null);
+
+        // the first aligned slot
+        tb_byte_t* slots = (tb_byte_t*)tb_align((tb_size_t)base, align);
+
+        // place the chunk head at the unaligned head space if be enough, otherwise the unaligned tail space is enough
+        if ((tb_size_t)(slots - (tb_byte_t*)base) >= sizeof(tb_fixed_pool_chunk_t))
+            chunk = (tb_fixed_pool_chunk_t*)base;
+        else chunk = (tb_fixed_pool_chunk_t*)(slots + TB_FIXED_POOL_CHUNK_SLOTN * align);
+
+        tb_assert((tb_byte_t*)chunk + sizeof(tb_fixed_pool_chunk_t) <= (tb_byte_t*)base + (TB_FIXED_POOL_CHUNK_SLOTN + 1) * align);
+
+        // init chunk
+        tb_memset_(chunk, 0, sizeof(tb_fixed_pool_chunk_t));
+        chunk->base  = base;
+        chunk->slots = slots;
+        tb_list_entry_insert_head(&pool->chunks, &chunk->entry);
+    }
+
+    // get an unused slot, the freed slots first
+    tb_fixed_pool_slot_t* slot = tb_null;
+    if (chunk->frees)
+    {
+        slot = (tb_fixed_pool_slot_t*)chunk->frees;
+        chunk->frees = *((tb_pointer_t*)slot);
+    }
+    else slot = (tb_fixed_pool_slot_t*)(chunk->slots + chunk->next++ * pool->slot_align);
+    chunk->refn++;
+
+    // the chunk is full now? remove it from the available chunks
+    if (tb_fixed_pool_chunk_full(chunk)) tb_list_entry_remove(&pool->chunks, &chunk->entry);
+
+    // save the owner chunk
+    slot->base = chunk;
+    return slot;
+}
+static tb_void_t tb_fixed_pool_chunk_slot_exit(tb_fixed_pool_t* pool, tb_fixed_pool_slot_t* slot)
+{
+    // the owner chunk
+    tb_fixed_pool_chunk_t* chunk = (tb_fixed_pool_chunk_t*)slot->base;
+    tb_assert_and_check_return(chunk && chunk->refn);
+
+    // give back this slot to the chunk
+    tb_bool_t full = tb_fixed_pool_chunk_full(chunk);
+    *((tb_pointer_t*)slot) = chunk->frees;
+    chunk->frees = (tb_pointer_t)slot;
+    chunk->refn--;
+
+    // all slots are unused? exit this chunk
+    if (!chunk->refn)
+    {
+        if (!full) tb_list_entry_remove(&pool->chunks, &chunk->entry);
+        tb_allocator_large_free(pool->large_allocator, chunk->base);
+    }
+    // it has the unused slots now
+    else if (full) tb_list_entry_insert_head(&pool->chunks, &chunk->entry);
+}
+static tb_void_t tb_fixed_pool_slot_exit(tb_fixed_pool_t* pool, tb_fixed_pool_slot_t* slot)
+{
+    // check
+    tb_assert_and_check_return(pool && pool->large_allocator && slot && slot->base);
+
+    // trace
+    tb_trace_d("slot[%lu]: exit: size: %lu", pool->item_size, slot->size);
+
+    // the aligned slot? give back it to the chunk, it is not in the slot list
+    if (pool->slot_align)
+    {
+        tb_fixed_pool_chunk_slot_exit(pool, slot);
+        return ;
+    }
+
+    // remove it from the slot list
+    tb_fixed_pool_slot_list_remove(pool, slot);
 
     // exit slot
-    tb_allocator_large_free(pool->large_allocator, slot);
+    tb_allocator_large_free(pool->large_allocator, slot->base);
 }
 static tb_fixed_pool_slot_t* tb_fixed_pool_slot_init(tb_fixed_pool_t* pool)
 {
@@ -159,6 +366,7 @@ static tb_fixed_pool_slot_t* tb_fixed_pool_slot_init(tb_fixed_pool_t* pool)
 
     // done
     tb_bool_t               ok = tb_false;
+    tb_pointer_t            base = tb_null;
     tb_fixed_pool_slot_t*   slot = tb_null;
     do
     {
@@ -177,58 +385,56 @@ static tb_fixed_pool_slot_t* tb_fixed_pool_slot_init(tb_fixed_pool_t* pool)
 
         // make slot
         tb_size_t real_space = 0;
-        slot = (tb_fixed_pool_slot_t*)tb_allocator_large_malloc(pool->large_allocator, need_space, &real_space);
-        tb_assert_and_check_break(slot);
-        tb_assert_and_check_break(real_space > sizeof(tb_fixed_pool_slot_t) + item_space);
-
-        // init slot
-        slot->size = real_space;
-        slot->pool = tb_static_fixed_pool_init((tb_byte_t*)&slot[1], real_space - sizeof(tb_fixed_pool_slot_t), pool->item_size, pool->for_small);
-        tb_assert_and_check_break(slot->pool);
-
-        // no list?
-        if (!pool->slot_list)
+        if (pool->slot_align)
         {
-            // init the slot list
-            tb_size_t size = 0;
-            pool->slot_list = (tb_fixed_pool_slot_t**)tb_allocator_large_nalloc(pool->large_allocator, 64, sizeof(tb_fixed_pool_slot_t*), &size);
-            tb_assert_and_check_break(pool->slot_list && size);
-
-            // init the slot count
-            pool->slot_count = 0;
-
-            // init the slot space
-            pool->slot_space = size / sizeof(tb_fixed_pool_slot_t*);
-            tb_assert_and_check_break(pool->slot_space);
+            // make the aligned slot from the chunk, we uses all space of this aligned slot
+            tb_assert_and_check_break(need_space <= pool->slot_align);
+            slot = tb_fixed_pool_chunk_slot_init(pool);
+            tb_assert_and_check_break(slot);
+            real_space = pool->slot_align;
         }
-        // no enough space?
-        else if (pool->slot_count == pool->slot_space)
+        else
         {
-            // grow the slot list
-            tb_size_t size = 0;
-            pool->slot_list = (tb_fixed_pool_slot_t**)tb_allocator_large_ralloc(pool->large_allocator, pool->slot_list, (pool->slot_space << 1) * sizeof(tb_fixed_pool_slot_t*), &size);
-            tb_assert_and_check_break(pool->slot_list && size);
-
-            // update the slot space
-            pool->slot_space = size / sizeof(tb_fixed_pool_slot_t*);
-            tb_assert_and_check_break(pool->slot_space);
+            base = tb_allocator_large_malloc(pool->large_allocator, need_space, &real_space);
+            tb_assert_and_check_break(base);
+
+            // the slot
+            slot = (tb_fixed_pool_slot_t*)base;
         }
+        tb_assert_and_check_break(real_space > sizeof(tb_fixed_pool_slot_t) + item_space);
 
-        // check
-        tb_assert_and_check_break(pool->slot_count < pool->slot_space);
+        /* the cache-line color of this slot
+         *
+         * the slots are page-aligned or slot-aligned, so the hot items of the different slots and pools will alias in L1.
+         * we offset the start of the items by the cache-line color in the unused tail space of the slot,
+         * and the start color of each pool is different.
+         *
+         * slot                                                     slot + real_space
+         *  |---------|-------|---------------------------------|---------|
+         *    head     color            items                      unused
+         */
+        tb_size_t color = 0;
+        if (real_space > need_space)
+        {
+            tb_size_t colorn = (real_space - need_space) / TB_L1_CACHE_BYTES + 1;
+            if (colorn > TB_FIXED_POOL_SLOT_COLORN) colorn = TB_FIXED_POOL_SLOT_COLORN;
+            color = (pool->slot_color++ % colorn) * TB_L1_CACHE_BYTES;
+        }
 
-        // insert the slot to the slot list in the increasing order (TODO binary search)
-        tb_size_t i = 0;
-        tb_size_t n = pool->slot_count;
-        for (i = 0; i < n; i++) if (slot <= pool->slot_list[i]) break;
-        if (i < n) tb_memmov_(pool->slot_list + i + 1, pool->slot_list + i, (n - i) * sizeof(tb_fixed_pool_slot_t*));
-        pool->slot_list[i] = slot;
+        // init slot, the base of the aligned slot is the owner chunk
+        slot->size = real_space;
+        if (!pool->slot_align) slot->base = base;
+#ifdef __tb_debug__
+        slot->owner = pool;
+#endif
+        slot->pool = tb_static_fixed_pool_init((tb_byte_t*)&slot[1] + color, real_space - sizeof(tb_fixed_pool_slot_t) - color, pool->item_size, pool->for_small);
+        tb_assert_and_check_break(slot->pool);
 
-        // update the slot count
-        pool->slot_count++;
+        // insert the slot to the slot list for finding it by the binary search, the aligned slot need not it
+        if (!pool->slot_align && !tb_fixed_pool_slot_list_insert(pool, slot)) break;
 
         // trace
-        tb_trace_d("slot[%lu]: init: size: %lu => %lu, item: %lu => %lu", pool->item_size, need_space, real_space, pool->slot_size, tb_static_fixed_pool_maxn(slot->pool));
+        tb_trace_d("slot[%lu]: init: size: %lu => %lu, item: %lu => %lu, color: %lu", pool->item_size, need_space, real_space, pool->slot_size, tb_static_fixed_pool_maxn(slot->pool), color);
 
         // ok
         ok = tb_true;
@@ -238,8 +444,9 @@ static tb_fixed_pool_slot_t* tb_fixed_pool_slot_init(tb_fixed_pool_t* pool)
     // failed?
     if (!ok)
     {
-        // exit it
-        if (slot) tb_fixed_pool_slot_exit(pool, slot);
+        // exit it, it has been not inserted to the slot list
+        if (pool->slot_align && slot) tb_fixed_pool_chunk_slot_exit(pool, slot);
+        else if (base) tb_allocator_large_free(pool->large_allocator, base);
         slot = tb_null;
     }
 
@@ -308,6 +515,21 @@ static tb_fixed_pool_slot_t* tb_fixed_pool_slot_find(tb_fixed_pool_t* pool, tb_p
     // check
     tb_assert_and_check_return_val(pool && data, tb_null);
 
+    // the aligned slot? we can get it directly by masking the data address
+    if (pool->slot_align)
+    {
+        // the slot
+        tb_fixed_pool_slot_t* slot = tb_fixed_pool_slot_aligned(pool, data);
+        tb_assert_and_check_return_val(slot && (tb_byte_t*)data > (tb_byte_t*)slot, tb_null);
+
+        // check
+        tb_assertf(slot->owner == pool, "the data: %p not belong to pool: %p", data, pool);
+        tb_assert(tb_fixed_pool_slot_exists(slot, data));
+
+        // ok
+        return slot;
+    }
+
     // make the iterator
     tb_array_iterator_t array_iterator;
     tb_iterator_ref_t   iterator = tb_array_iterator_init_ptr(&array_iterator, (tb_pointer_t*)pool->slot_list, pool->slot_count);
@@ -327,12 +549,103 @@ static tb_fixed_pool_slot_t* tb_fixed_pool_slot_find(tb_fixed_pool_t* pool, tb_p
     // ok?
     return slot;
 }
+#endif
+static tb_bool_t tb_fixed_pool_free_item(tb_fixed_pool_t* pool, tb_pointer_t data, tb_bool_t exit_item __tb_debug_decl__)
+{
+    // check
+    tb_assert_and_check_return_val(pool, tb_false);
+
+    // done
+    tb_bool_t ok = tb_false;
+    do
+    {
+        // check
+        tb_assertf_pass_and_check_break(pool->item_count, "double free data: %p", data);
+
+        // find the slot
+        tb_fixed_pool_slot_t* slot = tb_fixed_pool_slot_find(pool, data);
+        tb_assertf_pass_and_check_break(slot, "the data: %p not belong to pool: %p", data, pool);
+        tb_assert_pass_and_check_break(slot->pool);
+
+        // the slot is full?
+        tb_bool_t full = tb_static_fixed_pool_full(slot->pool);
+
+        // done exit
+        if (exit_item && pool->func_exit) pool->func_exit(data, pool->func_priv);
+
+        // free it
+        if (!tb_static_fixed_pool_free(slot->pool, data __tb_debug_args__)) break;
+
+        // not the current slot?
+        if (slot != pool->current_slot)
+        {
+            // is full? move the slot to the partial slots
+            if (full)
+            {
+                tb_list_entry_remove(&pool->full_slots, &slot->entry);
+                tb_list_entry_insert_tail(&pool->partial_slots, &slot->entry);
+            }
+            // is null? exit the slot
+            else if (tb_static_fixed_pool_null(slot->pool))
+            {
+                tb_list_entry_remove(&pool->partial_slots, &slot->entry);
+                tb_fixed_pool_slot_exit(pool, slot);
+            }
+        }
+
+        // update the item count
+        pool->item_count--;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed? dump it
+#ifdef __tb_debug__
+    if (!ok)
+    {
+        // trace
+        tb_trace_e("free(%p) failed! at %s(): %lu, %s", data, func_, line_, file_);
+
+        // dump data
+        tb_pool_data_dump((tb_byte_t const*)data, tb_true, "[fixed_pool]: [error]: ");
+
+        // abort
+        tb_abort();
+    }
 #endif
 
+    // ok?
+    return ok;
+}
+static tb_void_t tb_fixed_pool_remote_drain(tb_fixed_pool_t* pool __tb_debug_decl__)
+{
+    // check
+    tb_assert(pool);
+
+    // no remote freed items? return it directly
+    tb_check_return(tb_atomic_get_explicit(&pool->remote_list, TB_ATOMIC_RELAXED));
+
+    // take all remote freed items
+    tb_pointer_t data = (tb_pointer_t)tb_atomic_fetch_and_set_explicit(&pool->remote_list, 0, TB_ATOMIC_ACQUIRE);
+    while (data)
+    {
+        // the next item
+        tb_pointer_t next = *((tb_pointer_t*)data);
+
+        // free it, it has been exited when it was freed remotely
+        tb_fixed_pool_free_item(pool, data, tb_false __tb_debug_args__);
+
+        // next
+        data = next;
+    }
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
-tb_fixed_pool_ref_t tb_fixed_pool_init_(tb_allocator_ref_t large_allocator, tb_size_t slot_size, tb_size_t item_size, tb_bool_t for_small, tb_fixed_pool_item_init_func_t item_init, tb_fixed_pool_item_exit_func_t item_exit, tb_cpointer_t priv)
+tb_fixed_pool_ref_t tb_fixed_pool_init_(tb_allocator_ref_t large_allocator, tb_size_t slot_size, tb_size_t item_size, tb_bool_t for_small, tb_bool_t aligned, tb_fixed_pool_item_init_func_t item_init, tb_fixed_pool_item_exit_func_t item_exit, tb_cpointer_t priv)
 {
     // check
     tb_assert_and_check_return_val(item_size, tb_null);
@@ -358,14 +671,36 @@ tb_fixed_pool_ref_t tb_fixed_pool_init_(tb_allocator_ref_t large_allocator, tb_s
         pool->func_exit         = item_exit;
         pool->func_priv         = priv;
         pool->for_small         = for_small;
+        pool->slot_color        = item_size >> 4;
         tb_assert_and_check_break(pool->slot_size);
 
+        // init the slot alignment for the aligned slot mode
+        if (aligned)
+        {
+#ifdef __tb_debug__
+            // init patch for checking underflow
+            tb_size_t patch = 1;
+#else
+            tb_size_t patch = 0;
+#endif
+
+            // the need space of the slot
+            tb_size_t need_space = sizeof(tb_fixed_pool_slot_t) + pool->slot_size * (sizeof(tb_pool_data_head_t) + item_size + patch);
+
+            // align it to the power of 2
+            pool->slot_align = tb_align_pow2(need_space);
+            tb_assert_and_check_break(tb_ispow2(pool->slot_align));
+        }
+
         // init partial slots
         tb_list_entry_init(&pool->partial_slots, tb_fixed_pool_slot_t, entry, tb_null);
 
         // init full slots
         tb_list_entry_init(&pool->full_slots, tb_fixed_pool_slot_t, entry, tb_null);
 
+        // init the chunks of the aligned slots
+        tb_list_entry_init(&pool->chunks, tb_fixed_pool_chunk_t, entry, tb_null);
+
         // ok
         ok = tb_true;
 
@@ -384,7 +719,11 @@ tb_fixed_pool_ref_t tb_fixed_pool_init_(tb_allocator_ref_t large_allocator, tb_s
 }
 tb_fixed_pool_ref_t tb_fixed_pool_init(tb_allocator_ref_t large_allocator, tb_size_t slot_size, tb_size_t item_size, tb_fixed_pool_item_init_func_t item_init, tb_fixed_pool_item_exit_func_t item_exit, tb_cpointer_t priv)
 {
-    return tb_fixed_pool_init_(large_allocator, slot_size, item_size, tb_false, item_init, item_exit, priv);
+    return tb_fixed_pool_init_(large_allocator, slot_size, item_size, tb_false, tb_false, item_init, item_exit, priv);
+}
+tb_fixed_pool_ref_t tb_fixed_pool_init_aligned(tb_allocator_ref_t large_allocator, tb_size_t slot_size, tb_size_t item_size, tb_fixed_pool_item_init_func_t item_init, tb_fixed_pool_item_exit_func_t item_exit, tb_cpointer_t priv)
+{
+    return tb_fixed_pool_init_(large_allocator, slot_size, item_size, tb_false, tb_true, item_init, item_exit, priv);
 }
 tb_void_t tb_fixed_pool_exit(tb_fixed_pool_ref_t self)
 {
@@ -414,6 +753,9 @@ tb_size_t tb_fixed_pool_size(tb_fixed_pool_ref_t self)
     tb_fixed_pool_t* pool = (tb_fixed_pool_t*)self;
     tb_assert_and_check_return_val(pool, 0);
 
+    // reclaim the remote freed items first
+    tb_fixed_pool_remote_drain(pool __tb_debug_vals__);
+
     // the item count
     return pool->item_count;
 }
@@ -426,12 +768,41 @@ tb_size_t tb_fixed_pool_item_size(tb_fixed_pool_ref_t self)
     // the item size
     return pool->item_size;
 }
+tb_size_t tb_fixed_pool_maxn(tb_fixed_pool_ref_t self)
+{
+    // check
+    tb_fixed_pool_t* pool = (tb_fixed_pool_t*)self;
+    tb_assert_and_check_return_val(pool, 0);
+
+    // the current slot
+    tb_size_t maxn = 0;
+    if (pool->current_slot && pool->current_slot->pool)
+        maxn += tb_static_fixed_pool_maxn(pool->current_slot->pool);
+
+    // the partial slots
+    tb_for_all_if(tb_fixed_pool_slot_t*, partial_slot, tb_list_entry_itor(&pool->partial_slots), partial_slot && partial_slot->pool)
+    {
+        maxn += tb_static_fixed_pool_maxn(partial_slot->pool);
+    }
+
+    // the full slots
+    tb_for_all_if(tb_fixed_pool_slot_t*, full_slot, tb_list_entry_itor(&pool->full_slots), full_slot && full_slot->pool)
+    {
+        maxn += tb_static_fixed_pool_maxn(full_slot->pool);
+    }
+
+    // the item maxn
+    return maxn;
+}
 tb_void_t tb_fixed_pool_clear(tb_fixed_pool_ref_t self)
 {
     // check
     tb_fixed_pool_t* pool = (tb_fixed_pool_t*)self;
     tb_assert_and_check_return(pool);
 
+    // reclaim the remote freed items first
+    tb_fixed_pool_remote_drain(pool __tb_debug_vals__);
+
     // exit items
     if (pool->func_exit) tb_fixed_pool_walk(self, tb_fixed_pool_item_exit, (tb_pointer_t)pool);
 
@@ -511,6 +882,10 @@ tb_pointer_t tb_fixed_pool_malloc_(tb_fixed_pool_ref_t self __tb_debug_decl__)
     tb_pointer_t    data = tb_null;
     do
     {
+        // the current slot is full? reclaim the remote freed items first, it may be not full now
+        if (pool->current_slot && tb_static_fixed_pool_full(pool->current_slot->pool))
+            tb_fixed_pool_remote_drain(pool __tb_debug_args__);
+
         // no current slot or the current slot is full? update the current slot
         if (!pool->current_slot || tb_static_fixed_pool_full(pool->current_slot->pool))
         {
@@ -594,69 +969,34 @@ tb_bool_t tb_fixed_pool_free_(tb_fixed_pool_ref_t self, tb_pointer_t data __tb_d
     tb_fixed_pool_t* pool = (tb_fixed_pool_t*)self;
     tb_assert_and_check_return_val(pool, tb_false);
 
-    // done
-    tb_bool_t ok = tb_false;
-    do
-    {
-        // check
-        tb_assertf_pass_and_check_break(pool->item_count, "double free data: %p", data);
-
-        // find the slot
-        tb_fixed_pool_slot_t* slot = tb_fixed_pool_slot_find(pool, data);
-        tb_assertf_pass_and_check_break(slot, "the data: %p not belong to pool: %p", data, self);
-        tb_assert_pass_and_check_break(slot->pool);
-
-        // the slot is full?
-        tb_bool_t full = tb_static_fixed_pool_full(slot->pool);
-
-        // done exit
-        if (pool->func_exit) pool->func_exit(data, pool->func_priv);
-
-        // free it
-        if (!tb_static_fixed_pool_free(slot->pool, data __tb_debug_args__)) break;
-
-        // not the current slot?
-        if (slot != pool->current_slot)
-        {
-            // is full? move the slot to the partial slots
-            if (full)
-            {
-                tb_list_entry_remove(&pool->full_slots, &slot->entry);
-                tb_list_entry_insert_tail(&pool->partial_slots, &slot->entry);
-            }
-            // is null? exit the slot
-            else if (tb_static_fixed_pool_null(slot->pool))
-            {
-                tb_list_entry_remove(&pool->partial_slots, &slot->entry);
-                tb_fixed_pool_slot_exit(pool, slot);
-            }
-        }
+    // reclaim the remote freed items first
+    tb_fixed_pool_remote_drain(pool __tb_debug_args__);
 
-        // update the item count
-        pool->item_count--;
+    // free it
+    return tb_fixed_pool_free_item(pool, data, tb_true __tb_debug_args__);
+}
+tb_bool_t tb_fixed_pool_free_remote(tb_fixed_pool_ref_t self, tb_pointer_t data)
+{
+    // check
+    tb_fixed_pool_t* pool = (tb_fixed_pool_t*)self;
+    tb_assert_and_check_return_val(pool && data, tb_false);
 
-        // ok
-        ok = tb_true;
+    // we need store the next pointer to the item data
+    tb_assert_and_check_return_val(pool->item_size >= sizeof(tb_pointer_t), tb_false);
 
-    } while (0);
+    // done exit on the current thread, because the item data will be overwritten
+    if (pool->func_exit) pool->func_exit(data, pool->func_priv);
 
-    // failed? dump it
-#ifdef __tb_debug__
-    if (!ok)
+    // push it to the remote free list
+    tb_long_t head = tb_atomic_get_explicit(&pool->remote_list, TB_ATOMIC_RELAXED);
+    do
     {
-        // trace
-        tb_trace_e("free(%p) failed! at %s(): %lu, %s", data, func_, line_, file_);
+        *((tb_pointer_t*)data) = (tb_pointer_t)head;
 
-        // dump data
-        tb_pool_data_dump((tb_byte_t const*)data, tb_true, "[fixed_pool]: [error]: ");
+    } while (!tb_atomic_compare_and_swap_weak_explicit(&pool->remote_list, &head, (tb_long_t)data, TB_ATOMIC_RELEASE, TB_ATOMIC_RELAXED));
 
-        // abort
-        tb_abort();
-    }
-#endif
-
-    // ok?
-    return ok;
+    // ok
+    return tb_true;
 }
 tb_void_t tb_fixed_pool_walk(tb_fixed_pool_ref_t self, tb_fixed_pool_item_walk_func_t func, tb_cpointer_t priv)
 {
@@ -664,6 +1004,9 @@ tb_void_t tb_fixed_pool_walk(tb_fixed_pool_ref_t self, tb_fixed_pool_item_walk_f
     tb_fixed_pool_t* pool = (tb_fixed_pool_t*)self;
     tb_assert_and_check_return(pool && func);
 
+    // reclaim the remote freed items first
+    tb_fixed_pool_remote_drain(pool __tb_debug_vals__);
+
     // walk the current slot first
     if (pool->current_slot && pool->current_slot->pool)
         tb_static_fixed_pool_walk(pool->current_slot->pool, func, priv);
@@ -695,6 +1038,9 @@ tb_void_t tb_fixed_pool_dump(tb_fixed_pool_ref_t self)
     tb_fixed_pool_t* pool = (tb_fixed_pool_t*)self;
     tb_assert_and_check_return(pool);
 
+    // reclaim the remote freed items first
+    tb_fixed_pool_remote_drain(pool __tb_debug_vals__);
+
     // dump the current slot first
     if (pool->current_slot && pool->current_slot->pool)
         tb_static_fixed_pool_dump(pool->current_slot->pool);
@@ -148,6 +148,26 @@ typedef tb_bool_t       (*tb_fixed_pool_item_walk_func_t)(tb_pointer_t data, tb_
  */
 tb_fixed_pool_ref_t         tb_fixed_pool_init(tb_allocator_ref_t large_allocator, tb_size_t slot_size, tb_size_t item_size, tb_fixed_pool_item_init_func_t item_init, tb_fixed_pool_item_exit_func_t item_exit, tb_cpointer_t priv);
 
+/*! init fixed pool with the aligned slots
+ *
+ * each slot is allocated at the power-of-two aligned address from the large allocator,
+ * so the owner slot of the freed item can be found in O(1) by masking the item address
+ * instead of the binary search in the slot list.
+ *
+ * the aligned slots are carved out of the larger chunks from the large allocator,
+ * so only one more slot space is reserved per-chunk for aligning them.
+ *
+ * @param large_allocator   the large allocator, uses the global allocator if be null
+ * @param slot_size         the item count per-slot, using the default size if be zero
+ * @param item_size         the item size
+ * @param item_init         the item init func
+ * @param item_exit         the item exit func
+ * @param priv              the private data
+ *
+ * @return                  the pool
+ */
+tb_fixed_pool_ref_t         tb_fixed_pool_init_aligned(tb_allocator_ref_t large_allocator, tb_size_t slot_size, tb_size_t item_size, tb_fixed_pool_item_init_func_t item_init, tb_fixed_pool_item_exit_func_t item_exit, tb_cpointer_t priv);
+
 /*! exit pool
  *
  * @param pool              the pool
@@ -170,6 +190,16 @@ tb_size_t                   tb_fixed_pool_size(tb_fixed_pool_ref_t pool);
  */
 tb_size_t                   tb_fixed_pool_item_size(tb_fixed_pool_ref_t pool);
 
+/*! the item maxn of all allocated slots
+ *
+ * the unused space of the slots is (maxn - size) * item_size, it can be used to compute the fragmentation
+ *
+ * @param pool              the pool
+ *
+ * @return                  the item maxn
+ */
+tb_size_t                   tb_fixed_pool_maxn(tb_fixed_pool_ref_t pool);
+
 /*! clear pool
  *
  * @param pool              the pool
@@ -201,6 +231,24 @@ tb_pointer_t                tb_fixed_pool_malloc0_(tb_fixed_pool_ref_t pool __tb
  */
 tb_bool_t                   tb_fixed_pool_free_(tb_fixed_pool_ref_t pool, tb_pointer_t data __tb_debug_decl__);
 
+/*! free data from the remote thread
+ *
+ * the pool is not thread-safe and need be protected by the owner lock,
+ * but this interface can be called without the owner lock on any thread.
+ *
+ * the data will be pushed to the lock-free remote free list with only one CAS,
+ * and it will be reclaimed lazily by the owner in the next pool operations.
+ *
+ * @note the item size need be larger than or equal to sizeof(tb_pointer_t),
+ * and the item exit func will be called on the current thread.
+ *
+ * @param pool              the pool
+ * @param data              the data
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_fixed_pool_free_remote(tb_fixed_pool_ref_t pool, tb_pointer_t data);
+
 /*! walk item
  *
  * @code
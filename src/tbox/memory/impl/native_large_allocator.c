@@ -75,6 +75,9 @@ typedef struct __tb_native_large_allocator_t
     // the data list
     tb_list_entry_head_t            data_list;
 
+    // the virtual memory flags for the large data
+    tb_size_t                       vmflags;
+
 #ifdef __tb_debug__
     // the peak size
     tb_size_t                       peak_size;
@@ -219,7 +222,7 @@ static tb_pointer_t tb_native_large_allocator_malloc(tb_allocator_ref_t self, tb
 #endif
 
         // make data
-        data = (tb_byte_t*)(size >= TB_VIRTUAL_MEMORY_DATA_MINN? tb_virtual_memory_malloc(need) : tb_native_memory_malloc(need));
+        data = (tb_byte_t*)(size >= TB_VIRTUAL_MEMORY_DATA_MINN? tb_virtual_memory_malloc_with_flags(need, allocator->vmflags) : tb_native_memory_malloc(need));
         tb_assert_and_check_break(data);
         tb_assert_and_check_break(!(((tb_size_t)data) & 0x1));
 
@@ -356,7 +359,7 @@ static tb_pointer_t tb_native_large_allocator_ralloc(tb_allocator_ref_t self, tb
                 data = (tb_byte_t*)tb_virtual_memory_ralloc(data_head, need);
             else
             {
-                data = (tb_byte_t*)tb_virtual_memory_malloc(need);
+                data = (tb_byte_t*)tb_virtual_memory_malloc_with_flags(need, allocator->vmflags);
                 if (data)
                 {
                     tb_memcpy_(data, data_head, base_head->size);
@@ -616,7 +619,7 @@ static tb_bool_t tb_native_large_allocator_have(tb_allocator_ref_t self, tb_cpoi
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
-tb_allocator_ref_t tb_native_large_allocator_init()
+tb_allocator_ref_t tb_native_large_allocator_init(tb_size_t vmflags)
 {
     // done
     tb_bool_t                           ok = tb_false;
@@ -649,6 +652,9 @@ tb_allocator_ref_t tb_native_large_allocator_init()
         // init data_list
         tb_list_entry_init(&allocator->data_list, tb_native_large_data_head_t, entry, tb_null);
 
+        // init the virtual memory flags
+        allocator->vmflags = vmflags;
+
         // register lock profiler
 #ifdef TB_LOCK_PROFILER_ENABLE
         tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&allocator->base.lock, TB_TRACE_MODULE_NAME);
@@ -36,10 +36,12 @@ __tb_extern_c_enter__
  */
 
 /* init the native large allocator and the allocated data will be aligned by the page size
+ *
+ * @param vmflags       the virtual memory flags for the large data (>= TB_VIRTUAL_MEMORY_DATA_MINN)
  *
  * @return              the allocator
  */
-tb_allocator_ref_t      tb_native_large_allocator_init(tb_noarg_t);
+tb_allocator_ref_t      tb_native_large_allocator_init(tb_size_t vmflags);
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -34,7 +34,12 @@
 tb_allocator_ref_t tb_large_allocator_init(tb_byte_t* data, tb_size_t size)
 {
     // init pool
-    return (data && size)? tb_static_large_allocator_init(data, size, tb_page_size()) : tb_native_large_allocator_init();
+    return (data && size)? tb_static_large_allocator_init(data, size, tb_page_size()) : tb_native_large_allocator_init(TB_VIRTUAL_MEMORY_FLAG_NONE);
+}
+tb_allocator_ref_t tb_large_allocator_init_with_flags(tb_size_t flags)
+{
+    // init pool
+    return tb_native_large_allocator_init(flags);
 }
 
 
@@ -61,6 +61,22 @@ __tb_extern_c_enter__
  */
 tb_allocator_ref_t      tb_large_allocator_init(tb_byte_t* data, tb_size_t size);
 
+/*! init the large allocator from the native memory with the given virtual memory flags
+ *
+ * the large data (>= TB_VIRTUAL_MEMORY_DATA_MINN) will be allocated from the virtual memory with these flags,
+ * .e.g huge pages and numa node, it will fallback to the normal pages if they are not available.
+ *
+ * @code
+    tb_allocator_ref_t large_allocator = tb_large_allocator_init_with_flags(TB_VIRTUAL_MEMORY_FLAG_THP | TB_VIRTUAL_MEMORY_FLAG_NUMA_NODE(0));
+    tb_allocator_ref_t allocator = tb_default_allocator_init(large_allocator);
+ * @endcode
+ *
+ * @param flags         the virtual memory flags, .e.g TB_VIRTUAL_MEMORY_FLAG_HUGETLB
+ *
+ * @return              the allocator
+ */
+tb_allocator_ref_t      tb_large_allocator_init_with_flags(tb_size_t flags);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -31,10 +31,12 @@
 #include "fixed_pool.h"
 #include "string_pool.h"
 #include "queue_buffer.h"
+#include "chain_buffer.h"
 #include "static_buffer.h"
 #include "large_allocator.h"
 #include "small_allocator.h"
 #include "native_allocator.h"
+#include "region_allocator.h"
 #include "static_allocator.h"
 #include "virtual_allocator.h"
 #include "default_allocator.h"
@@ -0,0 +1,549 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        region_allocator.c
+ * @ingroup     memory
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "region_allocator"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "region_allocator.h"
+#include "large_allocator.h"
+#include "impl/prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default chunk size
+#ifdef __tb_small__
+#   define TB_REGION_ALLOCATOR_CHUNK_SIZE       (16 * 1024)
+#else
+#   define TB_REGION_ALLOCATOR_CHUNK_SIZE       (64 * 1024)
+#endif
+
+// the data space of the given size, head + data
+#define tb_region_allocator_data_space(size)    (sizeof(tb_pool_data_head_t) + tb_align((size), TB_POOL_DATA_ALIGN))
+
+// is large data? it will be allocated from the large allocator directly
+#define tb_region_allocator_data_large(allocator, size)   (tb_region_allocator_data_space(size) > ((allocator)->chunk_size >> 2))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the region chunk type
+typedef __tb_pool_data_aligned__ struct __tb_region_allocator_chunk_t
+{
+    // the next chunk
+    struct __tb_region_allocator_chunk_t*   next;
+
+    // the data size
+    tb_size_t                               size;
+
+}__tb_pool_data_aligned__ tb_region_allocator_chunk_t;
+
+// the region large data head type
+typedef __tb_pool_data_aligned__ struct __tb_region_allocator_large_t
+{
+    // the list entry
+    tb_list_entry_t                         entry;
+
+    // the data space, head + data
+    tb_size_t                               space;
+
+}__tb_pool_data_aligned__ tb_region_allocator_large_t;
+
+// the region allocator type
+typedef struct __tb_region_allocator_t
+{
+    // the base
+    tb_allocator_t                          base;
+
+    // the large allocator
+    tb_allocator_ref_t                      large_allocator;
+
+    // the chunk size
+    tb_size_t                               chunk_size;
+
+    // the used chunks, the head chunk is the current chunk
+    tb_region_allocator_chunk_t*            chunks;
+
+    // the last used chunk for moving all used chunks to the free chunks in O(1)
+    tb_region_allocator_chunk_t*            chunks_last;
+
+    // the free chunks
+    tb_region_allocator_chunk_t*            chunks_free;
+
+    // the large data list
+    tb_list_entry_head_t                    large_list;
+
+    // the cursor of the current chunk
+    tb_byte_t*                              cursor;
+
+    // the tail of the current chunk
+    tb_byte_t*                              tail;
+
+    // the last data head, we can rollback or grow it in place
+    tb_pool_data_head_t*                    last;
+
+#ifdef __tb_debug__
+    // the peak size
+    tb_size_t                               peak_size;
+
+    // the total size
+    tb_size_t                               total_size;
+
+    // the chunk count
+    tb_size_t                               chunk_count;
+
+    // the malloc count
+    tb_size_t                               malloc_count;
+
+    // the ralloc count
+    tb_size_t                               ralloc_count;
+
+    // the free count
+    tb_size_t                               free_count;
+
+    // the clear count
+    tb_size_t                               clear_count;
+#endif
+
+}tb_region_allocator_t, *tb_region_allocator_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_region_allocator_chunk_grow(tb_region_allocator_ref_t allocator)
+{
+    // check
+    tb_assert(allocator && allocator->large_allocator);
+
+    // attempt to get a chunk from the free chunks
+    tb_region_allocator_chunk_t* chunk = allocator->chunks_free;
+    if (chunk) allocator->chunks_free = chunk->next;
+    else
+    {
+        // make a new chunk
+        tb_size_t real = 0;
+        chunk = (tb_region_allocator_chunk_t*)tb_allocator_large_malloc(allocator->large_allocator, sizeof(tb_region_allocator_chunk_t) + allocator->chunk_size, &real);
+        tb_assert_and_check_return_val(chunk && real > sizeof(tb_region_allocator_chunk_t), tb_false);
+
+        // init chunk
+        chunk->size = (real - sizeof(tb_region_allocator_chunk_t)) & ~(TB_POOL_DATA_ALIGN - 1);
+
+#ifdef __tb_debug__
+        // update the chunk count
+        allocator->chunk_count++;
+#endif
+    }
+
+    // trace
+    tb_trace_d("chunk: grow: %p, size: %lu", chunk, chunk->size);
+
+    // insert it to the head of the used chunks and it will be the current chunk
+    chunk->next = allocator->chunks;
+    if (!allocator->chunks) allocator->chunks_last = chunk;
+    allocator->chunks = chunk;
+
+    // update the cursor
+    allocator->cursor   = (tb_byte_t*)&chunk[1];
+    allocator->tail     = allocator->cursor + chunk->size;
+    allocator->last     = tb_null;
+
+    // ok
+    return tb_true;
+}
+static tb_pointer_t tb_region_allocator_malloc(tb_allocator_ref_t self, tb_size_t size __tb_debug_decl__)
+{
+    // check
+    tb_region_allocator_ref_t allocator = (tb_region_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && allocator->large_allocator, tb_null);
+
+    // the data space
+    tb_size_t space = tb_region_allocator_data_space(size);
+
+    // done
+    tb_pool_data_head_t* data_head = tb_null;
+    if (tb_region_allocator_data_large(allocator, size))
+    {
+        // make the large data
+        tb_region_allocator_large_t* large = (tb_region_allocator_large_t*)tb_allocator_large_malloc_(allocator->large_allocator, sizeof(tb_region_allocator_large_t) + space, tb_null __tb_debug_args__);
+        tb_assert_and_check_return_val(large, tb_null);
+
+        // save it to the large data list
+        large->space = space;
+        tb_list_entry_insert_tail(&allocator->large_list, &large->entry);
+
+        // the data head
+        data_head = (tb_pool_data_head_t*)&large[1];
+    }
+    else
+    {
+        // no enough space in the current chunk? grow it
+        if (allocator->cursor + space > allocator->tail && !tb_region_allocator_chunk_grow(allocator))
+            return tb_null;
+
+        // bump the cursor
+        data_head = (tb_pool_data_head_t*)allocator->cursor;
+        allocator->cursor += space;
+        allocator->last = data_head;
+    }
+
+    // save the data size
+    data_head->size = size;
+
+#ifdef __tb_debug__
+    // init the debug info
+    data_head->debug.magic     = TB_POOL_DATA_MAGIC;
+    data_head->debug.file      = file_;
+    data_head->debug.func      = func_;
+    data_head->debug.line      = (tb_uint16_t)line_;
+
+    // save backtrace
+    tb_pool_data_save_backtrace(&data_head->debug, 3);
+
+    // make the dirty data
+    tb_memset_((tb_pointer_t)&data_head[1], TB_POOL_DATA_PATCH, size);
+
+    // update the total size
+    allocator->total_size += size;
+
+    // update the peak size
+    if (allocator->total_size > allocator->peak_size) allocator->peak_size = allocator->total_size;
+
+    // update the malloc count
+    allocator->malloc_count++;
+#endif
+
+    // ok
+    return (tb_pointer_t)&data_head[1];
+}
+static tb_bool_t tb_region_allocator_free(tb_allocator_ref_t self, tb_pointer_t data __tb_debug_decl__)
+{
+    // check
+    tb_region_allocator_ref_t allocator = (tb_region_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && allocator->large_allocator && data, tb_false);
+
+    // the data head
+    tb_pool_data_head_t* data_head = &(((tb_pool_data_head_t*)data)[-1]);
+
+#ifdef __tb_debug__
+    // check magic
+    tb_assertf_and_check_return_val(data_head->debug.magic == TB_POOL_DATA_MAGIC, tb_false, "free invalid data: %p", data);
+
+    // update the total size
+    allocator->total_size -= data_head->size;
+
+    // update the free count
+    allocator->free_count++;
+
+    // mark it as freed for checking double free
+    data_head->debug.magic = (tb_uint16_t)~TB_POOL_DATA_MAGIC;
+#endif
+
+    // the large data? free it directly
+    if (tb_region_allocator_data_large(allocator, data_head->size))
+    {
+        // remove it from the large data list
+        tb_region_allocator_large_t* large = &(((tb_region_allocator_large_t*)data_head)[-1]);
+        tb_list_entry_remove(&allocator->large_list, &large->entry);
+
+        // free it
+        return tb_allocator_large_free_(allocator->large_allocator, large __tb_debug_args__);
+    }
+
+    // is the last data? rollback the cursor
+    if (data_head == allocator->last)
+    {
+        allocator->cursor   = (tb_byte_t*)data_head;
+        allocator->last     = tb_null;
+    }
+
+    // ok, the others will be freed when clearing allocator
+    return tb_true;
+}
+static tb_pointer_t tb_region_allocator_ralloc(tb_allocator_ref_t self, tb_pointer_t data, tb_size_t size __tb_debug_decl__)
+{
+    // check
+    tb_region_allocator_ref_t allocator = (tb_region_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && allocator->large_allocator, tb_null);
+
+    // no data? malloc it directly
+    if (!data) return tb_region_allocator_malloc(self, size __tb_debug_args__);
+
+    // the data head
+    tb_pool_data_head_t* data_head = &(((tb_pool_data_head_t*)data)[-1]);
+
+#ifdef __tb_debug__
+    // check magic
+    tb_assertf_and_check_return_val(data_head->debug.magic == TB_POOL_DATA_MAGIC, tb_null, "ralloc invalid data: %p", data);
+#endif
+
+    // the old size
+    tb_size_t osize = data_head->size;
+
+#ifdef __tb_debug__
+    // update the ralloc count
+    allocator->ralloc_count++;
+#endif
+
+    // the large data and the new data is large too? ralloc it from the large allocator directly
+    if (tb_region_allocator_data_large(allocator, osize) && tb_region_allocator_data_large(allocator, size))
+    {
+        // remove it from the large data list first, because the entry may be moved
+        tb_region_allocator_large_t* large = &(((tb_region_allocator_large_t*)data_head)[-1]);
+        tb_list_entry_remove(&allocator->large_list, &large->entry);
+
+        // ralloc it
+        tb_region_allocator_large_t* large_new = (tb_region_allocator_large_t*)tb_allocator_large_ralloc_(allocator->large_allocator, large, sizeof(tb_region_allocator_large_t) + tb_region_allocator_data_space(size), tb_null __tb_debug_args__);
+
+        // save it to the large data list
+        if (large_new) large = large_new;
+        tb_list_entry_insert_tail(&allocator->large_list, &large->entry);
+        tb_assert_and_check_return_val(large_new, tb_null);
+
+        // update the data head
+        large->space = tb_region_allocator_data_space(size);
+        data_head = (tb_pool_data_head_t*)&large[1];
+    }
+    // the small data can be resized in place?
+    else if (!tb_region_allocator_data_large(allocator, osize) && !tb_region_allocator_data_large(allocator, size)
+        && (    tb_region_allocator_data_space(size) <= tb_region_allocator_data_space(osize)
+            ||  (data_head == allocator->last && (tb_byte_t*)data_head + tb_region_allocator_data_space(size) <= allocator->tail)))
+    {
+        // grow or shrink the last data
+        if (data_head == allocator->last) allocator->cursor = (tb_byte_t*)data_head + tb_region_allocator_data_space(size);
+    }
+    else
+    {
+        // make the new data
+        tb_pointer_t data_new = tb_region_allocator_malloc(self, size __tb_debug_args__);
+        tb_assert_and_check_return_val(data_new, tb_null);
+
+        // copy the old data
+        tb_memcpy_(data_new, data, tb_min(osize, size));
+
+        // free the old data
+        tb_region_allocator_free(self, data __tb_debug_args__);
+
+        // ok
+        return data_new;
+    }
+
+#ifdef __tb_debug__
+    // update the total size
+    allocator->total_size = allocator->total_size - osize + size;
+
+    // update the peak size
+    if (allocator->total_size > allocator->peak_size) allocator->peak_size = allocator->total_size;
+
+    // update the debug info
+    data_head->debug.file      = file_;
+    data_head->debug.func      = func_;
+    data_head->debug.line      = (tb_uint16_t)line_;
+#endif
+
+    // update the data size
+    data_head->size = size;
+
+    // ok
+    return (tb_pointer_t)&data_head[1];
+}
+static tb_void_t tb_region_allocator_clear(tb_allocator_ref_t self)
+{
+    // check
+    tb_region_allocator_ref_t allocator = (tb_region_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator && allocator->large_allocator);
+
+    // move all used chunks to the free chunks
+    if (allocator->chunks)
+    {
+        tb_assert(allocator->chunks_last);
+        allocator->chunks_last->next    = allocator->chunks_free;
+        allocator->chunks_free          = allocator->chunks;
+        allocator->chunks               = tb_null;
+        allocator->chunks_last          = tb_null;
+    }
+
+    // free all large data
+    while (!tb_list_entry_is_null(&allocator->large_list))
+    {
+        // the head entry
+        tb_list_entry_ref_t entry = tb_list_entry_head(&allocator->large_list);
+        tb_assert_and_check_break(entry);
+
+        // remove it
+        tb_list_entry_remove(&allocator->large_list, entry);
+
+        // free it
+        tb_allocator_large_free(allocator->large_allocator, tb_list_entry(&allocator->large_list, entry));
+    }
+
+    // reset the cursor
+    allocator->cursor   = tb_null;
+    allocator->tail     = tb_null;
+    allocator->last     = tb_null;
+
+#ifdef __tb_debug__
+    // reset the total size
+    allocator->total_size = 0;
+
+    // update the clear count
+    allocator->clear_count++;
+#endif
+}
+static tb_void_t tb_region_allocator_exit(tb_allocator_ref_t self)
+{
+    // check
+    tb_region_allocator_ref_t allocator = (tb_region_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator && allocator->large_allocator);
+
+    // clear it first
+    tb_region_allocator_clear(self);
+
+    // exit the free chunks
+    while (allocator->chunks_free)
+    {
+        tb_region_allocator_chunk_t* chunk = allocator->chunks_free;
+        allocator->chunks_free = chunk->next;
+        tb_allocator_large_free(allocator->large_allocator, chunk);
+    }
+
+    // exit lock
+    tb_spinlock_exit(&allocator->base.lock);
+
+    // exit allocator
+    tb_allocator_large_free(allocator->large_allocator, allocator);
+}
+#ifdef __tb_debug__
+static tb_void_t tb_region_allocator_dump(tb_allocator_ref_t self)
+{
+    // check
+    tb_region_allocator_ref_t allocator = (tb_region_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator);
+
+    // trace
+    tb_trace_i("");
+
+    // trace debug info
+    tb_trace_i("chunk_size: %lu",           allocator->chunk_size);
+    tb_trace_i("chunk_count: %lu",          allocator->chunk_count);
+    tb_trace_i("total_size: %lu",           allocator->total_size);
+    tb_trace_i("peak_size: %lu",            allocator->peak_size);
+    tb_trace_i("free_count: %lu",           allocator->free_count);
+    tb_trace_i("malloc_count: %lu",         allocator->malloc_count);
+    tb_trace_i("ralloc_count: %lu",         allocator->ralloc_count);
+    tb_trace_i("clear_count: %lu",          allocator->clear_count);
+}
+static tb_bool_t tb_region_allocator_have(tb_allocator_ref_t self, tb_cpointer_t data)
+{
+    // check
+    tb_region_allocator_ref_t allocator = (tb_region_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator, tb_false);
+
+    // belong to the used chunks?
+    tb_region_allocator_chunk_t* chunk = allocator->chunks;
+    for (; chunk; chunk = chunk->next)
+    {
+        if ((tb_byte_t const*)data > (tb_byte_t const*)&chunk[1] && (tb_byte_t const*)data < (tb_byte_t const*)&chunk[1] + chunk->size)
+            return tb_true;
+    }
+
+    // belong to the large data?
+    tb_for_all_if(tb_region_allocator_large_t*, large, tb_list_entry_itor(&allocator->large_list), large)
+    {
+        if ((tb_byte_t const*)data > (tb_byte_t const*)&large[1] && (tb_byte_t const*)data < (tb_byte_t const*)&large[1] + large->space)
+            return tb_true;
+    }
+
+    // no
+    return tb_false;
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_allocator_ref_t tb_region_allocator_init(tb_allocator_ref_t large_allocator, tb_size_t chunk_size)
+{
+    // done
+    tb_bool_t                   ok = tb_false;
+    tb_region_allocator_ref_t   allocator = tb_null;
+    do
+    {
+        // no allocator? uses the global allocator
+        if (!large_allocator) large_allocator = tb_allocator();
+        tb_assert_and_check_break(large_allocator);
+
+        // make allocator
+        allocator = (tb_region_allocator_ref_t)tb_allocator_large_malloc0(large_allocator, sizeof(tb_region_allocator_t), tb_null);
+        tb_assert_and_check_break(allocator);
+
+        // init base
+        allocator->base.type            = TB_ALLOCATOR_TYPE_REGION;
+        allocator->base.flag            = TB_ALLOCATOR_FLAG_NONE;
+        allocator->base.malloc          = tb_region_allocator_malloc;
+        allocator->base.ralloc          = tb_region_allocator_ralloc;
+        allocator->base.free            = tb_region_allocator_free;
+        allocator->base.clear           = tb_region_allocator_clear;
+        allocator->base.exit            = tb_region_allocator_exit;
+#ifdef __tb_debug__
+        allocator->base.dump            = tb_region_allocator_dump;
+        allocator->base.have            = tb_region_allocator_have;
+#endif
+
+        // init lock
+        if (!tb_spinlock_init(&allocator->base.lock)) break;
+
+        // init allocator
+        allocator->large_allocator      = large_allocator;
+        allocator->chunk_size           = tb_align(chunk_size? chunk_size : TB_REGION_ALLOCATOR_CHUNK_SIZE, TB_POOL_DATA_ALIGN);
+        tb_assert_and_check_break(allocator->chunk_size > (sizeof(tb_pool_data_head_t) << 2));
+
+        // init the large data list
+        tb_list_entry_init(&allocator->large_list, tb_region_allocator_large_t, entry, tb_null);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it, we need free it directly if the large allocator has been not saved
+        if (allocator)
+        {
+            if (allocator->large_allocator) tb_region_allocator_exit((tb_allocator_ref_t)allocator);
+            else tb_allocator_large_free(large_allocator, allocator);
+        }
+        allocator = tb_null;
+    }
+
+    // ok?
+    return (tb_allocator_ref_t)allocator;
+}
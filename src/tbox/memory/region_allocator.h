@@ -0,0 +1,97 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        region_allocator.h
+ * @ingroup     memory
+ *
+ */
+#ifndef TB_MEMORY_REGION_ALLOCATOR_H
+#define TB_MEMORY_REGION_ALLOCATOR_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "allocator.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the region allocator
+ *
+ * the data is allocated by bumping the pointer of the current chunk and the chunks are grown from the large allocator,
+ * free() only rollbacks the last data, all data will be freed together by tb_allocator_clear() in O(1),
+ * and the chunks will be reused after clearing.
+ *
+ * the large data (> chunk_size / 4) will be allocated from the large allocator directly and be freed immediately.
+ *
+ * <pre>
+ *
+ *  --------------------------------------------------
+ * |    chunk    |||||||||||||||||||||||||||||||||||||| <- full
+ *  --------------------------------------------------
+ *        |
+ *  --------------------------------------------------
+ * |    chunk    |||||||||||||||||||||                | <- current
+ *  --------------------------------------------------
+ *                                     |
+ *                                  cursor
+ *
+ *  ----------------      ----------------
+ * |  large data    | <=> |  large data    | <=> ...
+ *  ----------------      ----------------
+ *
+ * </pre>
+ *
+ * @code
+    tb_allocator_ref_t allocator = tb_region_allocator_init(tb_null, 0);
+    if (allocator)
+    {
+        // handle requests
+        while (...)
+        {
+            // parse the request objects from this allocator
+            tb_pointer_t data = tb_allocator_malloc(allocator, 100);
+            ...
+
+            // free all data of this request
+            tb_allocator_clear(allocator);
+        }
+
+        // exit allocator
+        tb_allocator_exit(allocator);
+    }
+ * @endcode
+ *
+ * @param large_allocator   the large allocator, uses the global allocator if be null
+ * @param chunk_size        the chunk size, uses the default size if be zero
+ *
+ * @return                  the allocator
+ */
+tb_allocator_ref_t          tb_region_allocator_init(tb_allocator_ref_t large_allocator, tb_size_t chunk_size);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -33,6 +33,7 @@
 #include "large_allocator.h"
 #include "fixed_pool.h"
 #include "impl/prefix.h"
+#include "../utils/bits.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
@@ -48,14 +49,21 @@ typedef struct __tb_small_allocator_t
     tb_allocator_ref_t      large_allocator;
 
     // the fixed pool
-    tb_fixed_pool_ref_t     fixed_pool[12];
+    tb_fixed_pool_ref_t     fixed_pool[TB_SMALL_ALLOCATOR_CLASSN];
+
+    // use the aligned slots for the fixed pools?
+    tb_bool_t               aligned;
+
+    // the owner thread, the data freed in batch by the other threads will be given back to the remote free lists
+    tb_size_t               owner;
 
 }tb_small_allocator_t, *tb_small_allocator_ref_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * declaration
  */
-__tb_extern_c__ tb_fixed_pool_ref_t tb_fixed_pool_init_(tb_allocator_ref_t large_allocator, tb_size_t slot_size, tb_size_t item_size, tb_bool_t for_small_allocator, tb_fixed_pool_item_init_func_t item_init, tb_fixed_pool_item_exit_func_t item_exit, tb_cpointer_t priv);
+__tb_extern_c__ tb_fixed_pool_ref_t tb_fixed_pool_init_(tb_allocator_ref_t large_allocator, tb_size_t slot_size, tb_size_t item_size, tb_bool_t for_small_allocator, tb_bool_t aligned, tb_fixed_pool_item_init_func_t item_init, tb_fixed_pool_item_exit_func_t item_exit, tb_cpointer_t priv);
+__tb_extern_c__ tb_size_t tb_small_allocator_find_index(tb_size_t size, tb_size_t* pspace);
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
@@ -70,86 +78,18 @@ static tb_fixed_pool_ref_t tb_small_allocator_find_fixed(tb_small_allocator_ref_
     do
     {
         // the fixed pool index
-        tb_size_t index = 0;
         tb_size_t space = 0;
-        if (size > 64 && size < 193)
-        {
-            if (size < 97)
-            {
-                index = 3;
-                space = 96;
-            }
-            else if (size > 128)
-            {
-                index = 5;
-                space = 192;
-            }
-            else
-            {
-                index = 4;
-                space = 128;
-            }
-        }
-        else if (size > 192 && size < 513)
-        {
-            if (size < 257)
-            {
-                index = 6;
-                space = 256;
-            }
-            else if (size > 384)
-            {
-                index = 8;
-                space = 512;
-            }
-            else
-            {
-                index = 7;
-                space = 384;
-            }
-        }
-        else if (size < 65)
-        {
-            if (size < 17)
-            {
-                index = 0;
-                space = 16;
-            }
-            else if (size > 32)
-            {
-                index = 2;
-                space = 64;
-            }
-            else
-            {
-                index = 1;
-                space = 32;
-            }
-        }
-        else
-        {
-            if (size < 1025)
-            {
-                index = 9;
-                space = 1024;
-            }
-            else if (size > 2048)
-            {
-                index = 11;
-                space = 3072;
-            }
-            else
-            {
-                index = 10;
-                space = 2048;
-            }
-        }
+        tb_size_t index = tb_small_allocator_find_index(size, &space);
 
         // trace
         tb_trace_d("find: size: %lu => index: %lu, space: %lu", size, index, space);
 
-        // make fixed pool if not exists
-        if (!allocator->fixed_pool[index]) allocator->fixed_pool[index] = tb_fixed_pool_init_(allocator->large_allocator, 0, space, tb_true, tb_null, tb_null, tb_null);
+        /* make fixed pool if not exists
+         *
+         * the aligned slots are only used if be enabled, they find the owner slot in O(1) when freeing data,
+         * but much more space will be reserved for each size class
+         */
+        if (!allocator->fixed_pool[index]) allocator->fixed_pool[index] = tb_fixed_pool_init_(allocator->large_allocator, 0, space, tb_true, allocator->aligned, tb_null, tb_null, tb_null);
         tb_assert_and_check_break(allocator->fixed_pool[index]);
 
         // ok
@@ -378,6 +318,31 @@ static tb_bool_t tb_small_allocator_free(tb_allocator_ref_t self, tb_pointer_t d
     // ok?
     return ok;
 }
+static tb_void_t tb_small_allocator_profile(tb_allocator_ref_t self)
+{
+    // check
+    tb_small_allocator_ref_t allocator = (tb_small_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator);
+
+    // dump the fragmentation of the fixed pools
+    tb_size_t i = 0;
+    tb_size_t n = tb_arrayn(allocator->fixed_pool);
+    for (i = 0; i < n; i++)
+    {
+        // exists?
+        tb_fixed_pool_ref_t fixed_pool = allocator->fixed_pool[i];
+        tb_check_continue(fixed_pool);
+
+        // the item size, count and maxn
+        tb_size_t item_size = tb_fixed_pool_item_size(fixed_pool);
+        tb_size_t size      = tb_fixed_pool_size(fixed_pool);
+        tb_size_t maxn      = tb_fixed_pool_maxn(fixed_pool);
+
+        // trace
+        tb_trace_i("profile: {\"type\": \"fixed_pool\", \"item_size\": %lu, \"size\": %lu, \"maxn\": %lu, \"wasted\": %lu}"
+                , item_size, size, maxn, (maxn - size) * item_size);
+    }
+}
 #ifdef __tb_debug__
 static tb_void_t tb_small_allocator_dump(tb_allocator_ref_t self)
 {
@@ -414,10 +379,7 @@ static tb_void_t tb_small_allocator_dump(tb_allocator_ref_t self)
 }
 #endif
 
-/* //////////////////////////////////////////////////////////////////////////////////////
- * implementation
- */
-tb_allocator_ref_t tb_small_allocator_init(tb_allocator_ref_t large_allocator)
+static tb_allocator_ref_t tb_small_allocator_init_(tb_allocator_ref_t large_allocator, tb_bool_t aligned)
 {
     // done
     tb_bool_t                   ok = tb_false;
@@ -434,6 +396,8 @@ tb_allocator_ref_t tb_small_allocator_init(tb_allocator_ref_t large_allocator)
 
         // init large allocator
         allocator->large_allocator      = large_allocator;
+        allocator->aligned              = aligned;
+        allocator->owner                = tb_thread_self();
 
         // init base
         allocator->base.type            = TB_ALLOCATOR_TYPE_SMALL;
@@ -443,6 +407,7 @@ tb_allocator_ref_t tb_small_allocator_init(tb_allocator_ref_t large_allocator)
         allocator->base.free            = tb_small_allocator_free;
         allocator->base.clear           = tb_small_allocator_clear;
         allocator->base.exit            = tb_small_allocator_exit;
+        allocator->base.profile         = tb_small_allocator_profile;
 #ifdef __tb_debug__
         allocator->base.dump            = tb_small_allocator_dump;
         allocator->base.have            = tb_small_allocator_have;
@@ -467,3 +432,133 @@ tb_allocator_ref_t tb_small_allocator_init(tb_allocator_ref_t large_allocator)
     return (tb_allocator_ref_t)allocator;
 }
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_size_t tb_small_allocator_find_index(tb_size_t size, tb_size_t* pspace)
+{
+    // check
+    tb_assert(size && size <= TB_SMALL_ALLOCATOR_DATA_MAXN);
+
+    /* the fixed pool index
+     *
+     * the tiny classes: (0, 16 << shift] with the 16-bytes step
+     * the other classes: (2^lg, 2^(lg + 1)] with the (2^lg >> shift)-bytes step
+     */
+    tb_size_t index = 0;
+    tb_size_t space = 0;
+    tb_size_t last  = size - 1;
+    if (size <= (16 << TB_SMALL_ALLOCATOR_CLASS_SHIFT))
+    {
+        index = last >> 4;
+        space = (index + 1) << 4;
+    }
+    else
+    {
+        tb_size_t lg    = 31 - tb_bits_cl0_u32_be((tb_uint32_t)last);
+        tb_size_t step  = lg - TB_SMALL_ALLOCATOR_CLASS_SHIFT;
+        index = ((lg - 4 - TB_SMALL_ALLOCATOR_CLASS_SHIFT) << TB_SMALL_ALLOCATOR_CLASS_SHIFT) + (last >> step);
+        space = ((last >> step) + 1) << step;
+    }
+    tb_assert(index < TB_SMALL_ALLOCATOR_CLASSN && space >= size);
+
+    // save the space
+    if (pspace) *pspace = space;
+
+    // ok
+    return index;
+}
+tb_allocator_ref_t tb_small_allocator_init(tb_allocator_ref_t large_allocator)
+{
+    return tb_small_allocator_init_(large_allocator, tb_false);
+}
+tb_allocator_ref_t tb_small_allocator_init_aligned(tb_allocator_ref_t large_allocator)
+{
+    return tb_small_allocator_init_(large_allocator, tb_true);
+}
+tb_size_t tb_small_allocator_nmalloc_(tb_allocator_ref_t self, tb_size_t size, tb_pointer_t* list, tb_size_t count __tb_debug_decl__)
+{
+    // check
+    tb_small_allocator_ref_t allocator = (tb_small_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && allocator->large_allocator && size && list && count, 0);
+    tb_assert_and_check_return_val(size <= TB_SMALL_ALLOCATOR_DATA_MAXN, 0);
+
+    // enter
+    tb_spinlock_enter(&allocator->base.lock);
+
+    // done
+    tb_size_t done = 0;
+    do
+    {
+        // the fixed pool
+        tb_fixed_pool_ref_t fixed_pool = tb_small_allocator_find_fixed(allocator, size);
+        tb_assert_and_check_break(fixed_pool);
+
+        // make data list
+        for (done = 0; done < count; done++)
+        {
+            // make data
+            tb_pointer_t data = tb_fixed_pool_malloc_(fixed_pool __tb_debug_args__);
+            tb_check_break(data);
+
+            // save data
+            list[done] = data;
+        }
+
+    } while (0);
+
+    // leave
+    tb_spinlock_leave(&allocator->base.lock);
+
+    // ok?
+    return done;
+}
+tb_void_t tb_small_allocator_nfree_(tb_allocator_ref_t self, tb_pointer_t* list, tb_size_t count __tb_debug_decl__)
+{
+    // check
+    tb_small_allocator_ref_t allocator = (tb_small_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator && allocator->large_allocator && list);
+
+    /* we are not the owner thread? free them to the remote free lists of the fixed pools without lock
+     *
+     * they will be reclaimed lazily by the malloc path with lock, so the other threads need not contend with the owner
+     */
+    tb_size_t i = 0;
+    if (tb_thread_self() != allocator->owner)
+    {
+        for (i = 0; i < count; i++)
+        {
+            // the data
+            tb_pointer_t data = list[i];
+            tb_check_continue(data);
+
+            // the data head
+            tb_pool_data_head_t* data_head = &(((tb_pool_data_head_t*)data)[-1]);
+            tb_assertf(data_head->debug.magic == TB_POOL_DATA_MAGIC, "free invalid data: %p", data);
+
+            // the fixed pool, it must be existed because this data was allocated from it
+            tb_size_t           space = 0;
+            tb_fixed_pool_ref_t fixed_pool = allocator->fixed_pool[tb_small_allocator_find_index(data_head->size, &space)];
+            tb_assert_and_check_continue(fixed_pool);
+
+            // check underflow
+            tb_assertf(space == data_head->size || ((tb_byte_t*)data)[data_head->size] == TB_POOL_DATA_PATCH, "data underflow");
+
+            // free it
+            tb_fixed_pool_free_remote(fixed_pool, data);
+        }
+        return ;
+    }
+
+    // enter
+    tb_spinlock_enter(&allocator->base.lock);
+
+    // free data list
+    for (i = 0; i < count; i++)
+    {
+        if (list[i]) tb_small_allocator_free(self, list[i] __tb_debug_args__);
+    }
+
+    // leave
+    tb_spinlock_leave(&allocator->base.lock);
+}
@@ -39,11 +39,32 @@ __tb_extern_c_enter__
 /// the data size maximum
 #define TB_SMALL_ALLOCATOR_DATA_MAXN        (3072)
 
+/*! the size class shift, there are (1 << shift) size classes per doubling, it can be configured when compiling tbox
+ *
+ * - shift: 1 => 16, 32, 48, 64, 96, 128, 192, 256, ..., 2048, 3072
+ * - shift: 2 => 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, ..., 2048, 2560, 3072
+ */
+#ifndef TB_SMALL_ALLOCATOR_CLASS_SHIFT
+#   define TB_SMALL_ALLOCATOR_CLASS_SHIFT   (2)
+#endif
+
+/// the size class count
+#if TB_SMALL_ALLOCATOR_CLASS_SHIFT == 2
+#   define TB_SMALL_ALLOCATOR_CLASSN        (26)
+#elif TB_SMALL_ALLOCATOR_CLASS_SHIFT == 1
+#   define TB_SMALL_ALLOCATOR_CLASSN        (15)
+#else
+#   error the size class shift of the small allocator must be 1 or 2
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
 
 /*! init the small allocator only for size <=3KB
+ *
+ * the size classes are jemalloc-style, there are four classes per doubling by default (TB_SMALL_ALLOCATOR_CLASS_SHIFT: 2),
+ * so the internal fragmentation is less than 20% for the data size > 64B.
  *
  * <pre>
  *
@@ -52,25 +73,27 @@ __tb_extern_c_enter__
  * |--------------------------------------|
  * |    fixed pool: 32B    |  17-32B      |
  * |--------------------------------------|
- * |    fixed pool: 64B    |  33-64B      |
+ * |    fixed pool: 48B    |  33-48B      |
+ * |--------------------------------------|
+ * |    fixed pool: 64B    |  49-64B      |
  * |--------------------------------------|
- * |    fixed pool: 96B*   |  65-96B*     |
+ * |    fixed pool: 80B    |  65-80B      |
  * |--------------------------------------|
- * |    fixed pool: 128B   |  97-128B     |
+ * |    fixed pool: 96B    |  81-96B      |
  * |--------------------------------------|
- * |    fixed pool: 192B*  |  129-192B*   |
+ * |    fixed pool: 112B   |  97-112B     |
  * |--------------------------------------|
- * |    fixed pool: 256B   |  193-256B    |
+ * |    fixed pool: 128B   |  113-128B    |
  * |--------------------------------------|
- * |    fixed pool: 384B*  |  257-384B*   |
+ * |    fixed pool: 160B   |  129-160B    |
  * |--------------------------------------|
- * |    fixed pool: 512B   |  385-512B    |
+ * |          ...          |     ...      |
  * |--------------------------------------|
- * |    fixed pool: 1024B  |  513-1024B   |
+ * |    fixed pool: 2048B  |  1793-2048B  |
  * |--------------------------------------|
- * |    fixed pool: 2048B  |  1025-2048B  |
+ * |    fixed pool: 2560B  |  2049-2560B  |
  * |--------------------------------------|
- * |    fixed pool: 3072B* |  2049-3072B* |
+ * |    fixed pool: 3072B  |  2561-3072B  |
  *  --------------------------------------
  *
  * </pre>
@@ -81,6 +104,17 @@ __tb_extern_c_enter__
  */
 tb_allocator_ref_t          tb_small_allocator_init(tb_allocator_ref_t large_allocator);
 
+/*! init the small allocator with the aligned slots
+ *
+ * the fixed pools use the aligned slots, so the owner slot of the freed data can be found in O(1),
+ * but each size class will reserve much more space, so it's disabled by default.
+ *
+ * @param large_allocator   the large allocator, uses the global allocator if be null
+ *
+ * @return                  the pool
+ */
+tb_allocator_ref_t          tb_small_allocator_init_aligned(tb_allocator_ref_t large_allocator);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
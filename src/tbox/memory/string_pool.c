@@ -37,23 +37,97 @@
 #include "../container/container.h"
 #include "../algorithm/algorithm.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default shard count of the concurrent string pool for each cpu
+#ifdef __tb_small__
+#   define TB_STRING_POOL_SHARD_CPU             (2)
+#else
+#   define TB_STRING_POOL_SHARD_CPU             (4)
+#endif
+
+// the maximum shard count
+#define TB_STRING_POOL_SHARD_MAXN               (256)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
 
-// the string pool type
-typedef struct __tb_string_pool_t
+// the string pool shard type
+typedef struct __tb_string_pool_shard_t
 {
+    // the lock
+    tb_spinlock_t               lock;
+
     // the cache
     tb_hash_map_ref_t           cache;
 
+    // the padding, avoid false sharing of the adjacent locks
+    tb_byte_t                   padding[TB_L1_CACHE_BYTES - sizeof(tb_spinlock_t) - sizeof(tb_hash_map_ref_t)];
+
+}tb_string_pool_shard_t;
+
+// the string pool type
+typedef struct __tb_string_pool_t
+{
+    // the shards
+    tb_string_pool_shard_t*     shards;
+
+    // the shard count, must be pow2
+    tb_size_t                   shardn;
+
+    // is case?
+    tb_bool_t                   bcase;
+
+    // is concurrent?
+    tb_bool_t                   concurrent;
+
 }tb_string_pool_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
- * implementation
+ * private implementation
  */
-tb_string_pool_ref_t tb_string_pool_init(tb_bool_t bcase)
+static tb_string_pool_shard_t* tb_string_pool_shard_enter(tb_string_pool_t* pool, tb_char_t const* data)
 {
+    // check
+    tb_assert(pool && pool->shards && data);
+
+    // only one shard?
+    tb_string_pool_shard_t* shard = pool->shards;
+    if (pool->shardn > 1)
+    {
+        /* compute the shard hash using fnv-1a
+         *
+         * we cannot use the bucket hash of the hash map here,
+         * otherwise all strings of one shard will be crowded into the same few buckets.
+         *
+         * and the case-insensitive strings need be folded to the same shard
+         */
+        tb_uint32_t         hash = 2166136261U;
+        tb_byte_t const*    p = (tb_byte_t const*)data;
+        if (pool->bcase) for (; *p; p++) hash = (hash ^ *p) * 16777619U;
+        else for (; *p; p++) hash = (hash ^ (tb_byte_t)tb_tolower(*p)) * 16777619U;
+
+        // the shard
+        shard = pool->shards + ((hash ^ (hash >> 16)) & (pool->shardn - 1));
+    }
+
+    // enter lock
+    if (pool->concurrent) tb_spinlock_enter(&shard->lock);
+    return shard;
+}
+static __tb_inline__ tb_void_t tb_string_pool_shard_leave(tb_string_pool_t* pool, tb_string_pool_shard_t* shard)
+{
+    // leave lock
+    if (pool->concurrent) tb_spinlock_leave(&shard->lock);
+}
+static tb_string_pool_ref_t tb_string_pool_init_impl(tb_bool_t bcase, tb_size_t shardn, tb_bool_t concurrent)
+{
+    // check
+    tb_assert_and_check_return_val(shardn && tb_ispow2(shardn), tb_null);
+
     // done
     tb_bool_t           ok = tb_false;
     tb_string_pool_t*   pool = tb_null;
@@ -63,9 +137,29 @@ tb_string_pool_ref_t tb_string_pool_init(tb_bool_t bcase)
         pool = tb_malloc0_type(tb_string_pool_t);
         tb_assert_and_check_break(pool);
 
-        // init hash
-        pool->cache = tb_hash_map_init(0, tb_element_str(bcase), tb_element_size());
-        tb_assert_and_check_break(pool->cache);
+        // init pool
+        pool->bcase         = bcase;
+        pool->concurrent    = concurrent;
+
+        // make shards, they are aligned to the cache line for avoiding false sharing of the adjacent shards
+        pool->shards = (tb_string_pool_shard_t*)tb_align_malloc0(shardn * sizeof(tb_string_pool_shard_t), TB_L1_CACHE_BYTES);
+        tb_assert_and_check_break(pool->shards);
+
+        // init shards
+        tb_size_t i = 0;
+        for (i = 0; i < shardn; i++)
+        {
+            // init lock
+            if (!tb_spinlock_init(&pool->shards[i].lock)) break;
+
+            // init hash
+            pool->shards[i].cache = tb_hash_map_init(shardn > 1? TB_HASH_MAP_BUCKET_SIZE_MICRO : 0, tb_element_str(bcase), tb_element_size());
+            tb_assert_and_check_break(pool->shards[i].cache);
+
+            // update the shard count for exiting it if failed
+            pool->shardn = i + 1;
+        }
+        tb_check_break(pool->shardn == shardn);
 
         // ok
         ok = tb_true;
@@ -83,15 +177,45 @@ tb_string_pool_ref_t tb_string_pool_init(tb_bool_t bcase)
     // ok?
     return (tb_string_pool_ref_t)pool;
 }
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_string_pool_ref_t tb_string_pool_init(tb_bool_t bcase)
+{
+    return tb_string_pool_init_impl(bcase, 1, tb_false);
+}
+tb_string_pool_ref_t tb_string_pool_init_concurrent(tb_bool_t bcase, tb_size_t shardn)
+{
+    // the default shard count
+    if (!shardn) shardn = tb_cpu_count() * TB_STRING_POOL_SHARD_CPU;
+    if (shardn > TB_STRING_POOL_SHARD_MAXN) shardn = TB_STRING_POOL_SHARD_MAXN;
+
+    // init it
+    return tb_string_pool_init_impl(bcase, tb_align_pow2(shardn), tb_true);
+}
 tb_void_t tb_string_pool_exit(tb_string_pool_ref_t self)
 {
     // check
     tb_string_pool_t* pool = (tb_string_pool_t*)self;
     tb_assert_and_check_return(pool);
 
-    // exit cache
-    if (pool->cache) tb_hash_map_exit(pool->cache);
-    pool->cache = tb_null;
+    // exit shards
+    if (pool->shards)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < pool->shardn; i++)
+        {
+            // exit cache
+            if (pool->shards[i].cache) tb_hash_map_exit(pool->shards[i].cache);
+            pool->shards[i].cache = tb_null;
+
+            // exit lock
+            tb_spinlock_exit(&pool->shards[i].lock);
+        }
+        tb_align_free(pool->shards);
+        pool->shards = tb_null;
+    }
 
     // exit it
     tb_free(pool);
@@ -100,32 +224,43 @@ tb_void_t tb_string_pool_clear(tb_string_pool_ref_t self)
 {
     // check
     tb_string_pool_t* pool = (tb_string_pool_t*)self;
-    tb_assert_and_check_return(pool);
+    tb_assert_and_check_return(pool && pool->shards);
 
-    // clear cache
-    if (pool->cache) tb_hash_map_clear(pool->cache);
+    // clear all shards
+    tb_size_t i = 0;
+    for (i = 0; i < pool->shardn; i++)
+    {
+        tb_string_pool_shard_t* shard = pool->shards + i;
+        if (pool->concurrent) tb_spinlock_enter(&shard->lock);
+        if (shard->cache) tb_hash_map_clear(shard->cache);
+        if (pool->concurrent) tb_spinlock_leave(&shard->lock);
+    }
 }
 tb_char_t const* tb_string_pool_insert(tb_string_pool_ref_t self, tb_char_t const* data)
 {
     // check
     tb_string_pool_t* pool = (tb_string_pool_t*)self;
-    tb_assert_and_check_return_val(pool && data, tb_null);
+    tb_assert_and_check_return_val(pool && pool->shards && data, tb_null);
+
+    // enter shard
+    tb_string_pool_shard_t* shard = tb_string_pool_shard_enter(pool, data);
 
     // done
-    tb_char_t const* cstr = tb_null;
-    if (pool->cache)
+    tb_char_t const*    cstr = tb_null;
+    tb_hash_map_ref_t   cache = shard->cache;
+    if (cache)
     {
         // exists?
         tb_size_t               itor;
         tb_hash_map_item_ref_t  item = tb_null;
-        if (    ((itor = tb_hash_map_find(pool->cache, data)) != tb_iterator_tail(pool->cache))
-            &&  (item = (tb_hash_map_item_ref_t)tb_iterator_item(pool->cache, itor)))
+        if (    ((itor = tb_hash_map_find(cache, data)) != tb_iterator_tail(cache))
+            &&  (item = (tb_hash_map_item_ref_t)tb_iterator_item(cache, itor)))
         {
             // refn
             tb_size_t refn = (tb_size_t)item->data;
 
             // refn++
-            if (refn) tb_iterator_copy(pool->cache, itor, (tb_pointer_t)(refn + 1));
+            if (refn) tb_iterator_copy(cache, itor, (tb_pointer_t)(refn + 1));
             // no refn? remove it
             else
             {
@@ -133,7 +268,7 @@ tb_char_t const* tb_string_pool_insert(tb_string_pool_ref_t self, tb_char_t cons
                 tb_assert(0);
 
                 // del it
-                tb_iterator_remove(pool->cache, itor);
+                tb_iterator_remove(cache, itor);
                 item = tb_null;
             }
         }
@@ -142,14 +277,17 @@ tb_char_t const* tb_string_pool_insert(tb_string_pool_ref_t self, tb_char_t cons
         if (!item)
         {
             // insert it
-            if ((itor = tb_hash_map_insert(pool->cache, data, (tb_pointer_t)1)) != tb_iterator_tail(pool->cache))
-                item = (tb_hash_map_item_ref_t)tb_iterator_item(pool->cache, itor);
+            if ((itor = tb_hash_map_insert(cache, data, (tb_pointer_t)1)) != tb_iterator_tail(cache))
+                item = (tb_hash_map_item_ref_t)tb_iterator_item(cache, itor);
         }
 
-        // save the cstr
+        // save the cstr, it is stable until the last reference is removed
         if (item) cstr = (tb_char_t const*)item->name;
     }
 
+    // leave shard
+    tb_string_pool_shard_leave(pool, shard);
+
     // ok?
     return cstr;
 }
@@ -157,52 +295,78 @@ tb_void_t tb_string_pool_remove(tb_string_pool_ref_t self, tb_char_t const* data
 {
     // check
     tb_string_pool_t* pool = (tb_string_pool_t*)self;
-    tb_assert_and_check_return(pool && data);
+    tb_assert_and_check_return(pool && pool->shards && data);
+
+    // enter shard
+    tb_string_pool_shard_t* shard = tb_string_pool_shard_enter(pool, data);
 
     // done
-    tb_hash_map_item_ref_t item = tb_null;
-    if (pool->cache)
+    tb_hash_map_ref_t       cache = shard->cache;
+    tb_hash_map_item_ref_t  item = tb_null;
+    if (cache)
     {
         // exists?
         tb_size_t itor;
-        if (    ((itor = tb_hash_map_find(pool->cache, data)) != tb_iterator_tail(pool->cache))
-            &&  (item = (tb_hash_map_item_ref_t)tb_iterator_item(pool->cache, itor)))
+        if (    ((itor = tb_hash_map_find(cache, data)) != tb_iterator_tail(cache))
+            &&  (item = (tb_hash_map_item_ref_t)tb_iterator_item(cache, itor)))
         {
             // refn
             tb_size_t refn = (tb_size_t)item->data;
 
             // refn--
-            if (refn > 1) tb_iterator_copy(pool->cache, itor, (tb_pointer_t)(refn - 1));
+            if (refn > 1) tb_iterator_copy(cache, itor, (tb_pointer_t)(refn - 1));
             // del it
-            else tb_iterator_remove(pool->cache, itor);
+            else tb_iterator_remove(cache, itor);
         }
     }
+
+    // leave shard
+    tb_string_pool_shard_leave(pool, shard);
 }
 tb_bool_t tb_string_pool_has(tb_string_pool_ref_t self, tb_char_t const* data)
 {
     // check
     tb_string_pool_t* pool = (tb_string_pool_t*)self;
-    tb_assert_and_check_return_val(pool && data, tb_false);
+    tb_assert_and_check_return_val(pool && pool->shards && data, tb_false);
 
-    if (pool->cache)
-    {
-        tb_size_t itor = tb_hash_map_find(pool->cache, data);
-        return itor != tb_iterator_tail(pool->cache);
-    }
-    return tb_false;
+    // enter shard
+    tb_string_pool_shard_t* shard = tb_string_pool_shard_enter(pool, data);
+
+    // find it
+    tb_bool_t ok = tb_false;
+    if (shard->cache) ok = tb_hash_map_find(shard->cache, data) != tb_iterator_tail(shard->cache);
+
+    // leave shard
+    tb_string_pool_shard_leave(pool, shard);
+    return ok;
 }
 #ifdef __tb_debug__
 tb_void_t tb_string_pool_dump(tb_string_pool_ref_t self)
 {
     // check
     tb_string_pool_t* pool = (tb_string_pool_t*)self;
-    tb_assert_and_check_return(pool && pool->cache);
+    tb_assert_and_check_return(pool && pool->shards);
 
-    // dump cache
-    tb_for_all_if (tb_hash_map_item_ref_t, item, pool->cache, item)
+    // dump all shards
+    tb_size_t i = 0;
+    for (i = 0; i < pool->shardn; i++)
     {
-        // trace
-        tb_trace_i("item: refn: %lu, cstr: %s", (tb_size_t)item->data, item->name);
+        // enter shard
+        tb_string_pool_shard_t* shard = pool->shards + i;
+        if (pool->concurrent) tb_spinlock_enter(&shard->lock);
+
+        // dump cache
+        if (shard->cache)
+        {
+            tb_for_all_if (tb_hash_map_item_ref_t, item, shard->cache, item)
+            {
+                // trace
+                tb_trace_i("item: shard: %lu, refn: %lu, cstr: %s", i, (tb_size_t)item->data, item->name);
+            }
+        }
+
+        // leave shard
+        if (pool->concurrent) tb_spinlock_leave(&shard->lock);
     }
 }
 #endif
@@ -53,6 +53,21 @@ typedef __tb_typeref__(string_pool);
  */
 tb_string_pool_ref_t        tb_string_pool_init(tb_bool_t bcase);
 
+/*! init the concurrent string pool for interning strings from multiple threads
+ *
+ * the strings are distributed into the shards by hash and each shard has its own lock,
+ * so the insertion, lookup and removal from the different threads only contend on the same shard.
+ *
+ * the returned string is stable until its last reference is removed,
+ * so it can be shared between threads and be compared by the address.
+ *
+ * @param bcase             is case?
+ * @param shardn            the shard count, will be aligned to pow2, uses cpu count * 4 (* 2 for small) if be zero
+ *
+ * @return                  the string pool
+ */
+tb_string_pool_ref_t        tb_string_pool_init_concurrent(tb_bool_t bcase, tb_size_t shardn);
+
 /*! exit the string pool
  *
  * @param pool              the string pool
@@ -0,0 +1,191 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        ws_deque.c
+ * @ingroup     platform
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "ws_deque.h"
+#include "../../libc/libc.h"
+#include "../../utils/utils.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+#ifdef __tb_small__
+#   define TB_WS_DEQUE_GROW     (64)
+#else
+#   define TB_WS_DEQUE_GROW     (256)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_ws_deque_buffer_t* tb_ws_deque_buffer_init(tb_size_t maxn)
+{
+    // check
+    tb_assert(maxn && tb_ispow2(maxn));
+
+    // make buffer
+    tb_ws_deque_buffer_t* buffer = (tb_ws_deque_buffer_t*)tb_malloc0(sizeof(tb_ws_deque_buffer_t) + (maxn - 1) * sizeof(tb_atomic_t));
+    tb_assert_and_check_return_val(buffer, tb_null);
+
+    // init buffer
+    buffer->mask = maxn - 1;
+    return buffer;
+}
+static tb_ws_deque_buffer_t* tb_ws_deque_buffer_grow(tb_ws_deque_buffer_t* buffer, tb_long_t top, tb_long_t bottom)
+{
+    // check
+    tb_assert(buffer);
+
+    // make a new buffer with the double size
+    tb_ws_deque_buffer_t* buffer_new = tb_ws_deque_buffer_init((buffer->mask + 1) << 1);
+    tb_assert_and_check_return_val(buffer_new, tb_null);
+
+    // copy the alive items
+    tb_long_t i;
+    for (i = top; i < bottom; i++)
+    {
+        tb_long_t data = tb_atomic_get_explicit(&buffer->data[i & buffer->mask], TB_ATOMIC_RELAXED);
+        tb_atomic_set_explicit(&buffer_new->data[i & buffer_new->mask], data, TB_ATOMIC_RELAXED);
+    }
+
+    // retire the old buffer, the thieves may be still reading it
+    buffer_new->prev = buffer;
+    return buffer_new;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_bool_t tb_ws_deque_init(tb_ws_deque_ref_t deque, tb_size_t grow)
+{
+    // check
+    tb_assert_and_check_return_val(deque, tb_false);
+
+    // init indices
+    tb_atomic_init(&deque->top, 0);
+    tb_atomic_init(&deque->bottom, 0);
+
+    // init buffer
+    if (!grow) grow = TB_WS_DEQUE_GROW;
+    tb_ws_deque_buffer_t* buffer = tb_ws_deque_buffer_init(tb_align_pow2(grow));
+    tb_assert_and_check_return_val(buffer, tb_false);
+    tb_atomic_init(&deque->buffer, (tb_long_t)buffer);
+    return tb_true;
+}
+tb_void_t tb_ws_deque_exit(tb_ws_deque_ref_t deque)
+{
+    // check
+    tb_assert_and_check_return(deque);
+
+    // free the current and all retired buffers
+    tb_ws_deque_buffer_t* buffer = (tb_ws_deque_buffer_t*)tb_atomic_get(&deque->buffer);
+    while (buffer)
+    {
+        tb_ws_deque_buffer_t* prev = buffer->prev;
+        tb_free(buffer);
+        buffer = prev;
+    }
+    tb_atomic_set(&deque->buffer, 0);
+}
+tb_bool_t tb_ws_deque_push(tb_ws_deque_ref_t deque, tb_cpointer_t data)
+{
+    // check
+    tb_assert(deque && data);
+
+    // get the bottom and top
+    tb_long_t bottom = tb_atomic_get_explicit(&deque->bottom, TB_ATOMIC_RELAXED);
+    tb_long_t top = tb_atomic_get_explicit(&deque->top, TB_ATOMIC_ACQUIRE);
+
+    // the buffer is full? grow it
+    tb_ws_deque_buffer_t* buffer = (tb_ws_deque_buffer_t*)tb_atomic_get_explicit(&deque->buffer, TB_ATOMIC_RELAXED);
+    if (__tb_unlikely__(bottom - top > (tb_long_t)buffer->mask))
+    {
+        buffer = tb_ws_deque_buffer_grow(buffer, top, bottom);
+        tb_check_return_val(buffer, tb_false);
+        tb_atomic_set_explicit(&deque->buffer, (tb_long_t)buffer, TB_ATOMIC_RELEASE);
+    }
+
+    // save item and publish it to the thieves
+    tb_atomic_set_explicit(&buffer->data[bottom & buffer->mask], (tb_long_t)data, TB_ATOMIC_RELAXED);
+    tb_atomic_set_explicit(&deque->bottom, bottom + 1, TB_ATOMIC_RELEASE);
+    return tb_true;
+}
+tb_pointer_t tb_ws_deque_pop(tb_ws_deque_ref_t deque)
+{
+    // check
+    tb_assert(deque);
+
+    /* reserve the bottom item first
+     *
+     * we use the atomic exchange as a full memory barrier between storing bottom and loading top
+     */
+    tb_long_t bottom = tb_atomic_get_explicit(&deque->bottom, TB_ATOMIC_RELAXED) - 1;
+    tb_ws_deque_buffer_t* buffer = (tb_ws_deque_buffer_t*)tb_atomic_get_explicit(&deque->buffer, TB_ATOMIC_RELAXED);
+    tb_atomic_fetch_and_set(&deque->bottom, bottom);
+    tb_long_t top = tb_atomic_get(&deque->top);
+
+    // empty? restore the bottom
+    if (top > bottom)
+    {
+        tb_atomic_set_explicit(&deque->bottom, bottom + 1, TB_ATOMIC_RELAXED);
+        return tb_null;
+    }
+
+    // get the item
+    tb_pointer_t data = (tb_pointer_t)tb_atomic_get_explicit(&buffer->data[bottom & buffer->mask], TB_ATOMIC_RELAXED);
+
+    // the last item? we need race with the thieves
+    if (top == bottom)
+    {
+        if (!tb_atomic_compare_and_swap(&deque->top, &top, top + 1)) data = tb_null;
+        tb_atomic_set_explicit(&deque->bottom, bottom + 1, TB_ATOMIC_RELAXED);
+    }
+    return data;
+}
+tb_pointer_t tb_ws_deque_steal(tb_ws_deque_ref_t deque)
+{
+    // check
+    tb_assert(deque);
+
+    // get the top and bottom
+    tb_long_t top = tb_atomic_get(&deque->top);
+    tb_long_t bottom = tb_atomic_get(&deque->bottom);
+    tb_check_return_val(top < bottom, tb_null);
+
+    // get the item
+    tb_ws_deque_buffer_t* buffer = (tb_ws_deque_buffer_t*)tb_atomic_get_explicit(&deque->buffer, TB_ATOMIC_ACQUIRE);
+    tb_pointer_t data = (tb_pointer_t)tb_atomic_get_explicit(&buffer->data[top & buffer->mask], TB_ATOMIC_RELAXED);
+
+    // take it, it may be taken by the owner or other thieves
+    return tb_atomic_compare_and_swap(&deque->top, &top, top + 1)? data : tb_null;
+}
+tb_size_t tb_ws_deque_size(tb_ws_deque_ref_t deque)
+{
+    // check
+    tb_assert(deque);
+
+    // get the approximate size
+    tb_long_t top = tb_atomic_get_explicit(&deque->top, TB_ATOMIC_RELAXED);
+    tb_long_t bottom = tb_atomic_get_explicit(&deque->bottom, TB_ATOMIC_RELAXED);
+    return bottom > top? (tb_size_t)(bottom - top) : 0;
+}
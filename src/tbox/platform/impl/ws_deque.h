@@ -0,0 +1,141 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        ws_deque.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_IMPL_WS_DEQUE_H
+#define TB_PLATFORM_IMPL_WS_DEQUE_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../atomic.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the work-stealing deque buffer type
+typedef struct __tb_ws_deque_buffer_t
+{
+    // the previous retired buffer, it will be freed when the deque is exited
+    struct __tb_ws_deque_buffer_t*  prev;
+
+    // the buffer mask, (maxn - 1)
+    tb_size_t                       mask;
+
+    // the items
+    tb_atomic_t                     data[1];
+
+}tb_ws_deque_buffer_t;
+
+/* the work-stealing deque type (Chase-Lev)
+ *
+ * only the owner thread can push and pop items at the bottom,
+ * and the other threads can steal items from the top concurrently.
+ *
+ * <pre>
+ *
+ *   steal(fifo) <- top [item, item, item, ..., item] bottom <-> push/pop(lifo)
+ *
+ * </pre>
+ *
+ * the buffer is grown by the owner when it is full, and the retired buffers
+ * are kept until the deque is exited because the thieves may still read them.
+ */
+typedef struct __tb_ws_deque_t
+{
+    // the top index, be modified by the thieves and owner
+    tb_atomic_t                     top;
+
+    // the padding for avoiding false-sharing
+    tb_byte_t                       padding[TB_L1_CACHE_BYTES - sizeof(tb_atomic_t)];
+
+    // the bottom index, only be modified by the owner
+    tb_atomic_t                     bottom;
+
+    // the current buffer
+    tb_atomic_t                     buffer;
+
+}tb_ws_deque_t, *tb_ws_deque_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init the work-stealing deque
+ *
+ * @param deque         the deque
+ * @param grow          the initial item count, will be aligned by pow2
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_ws_deque_init(tb_ws_deque_ref_t deque, tb_size_t grow);
+
+/* exit the work-stealing deque
+ *
+ * @param deque         the deque
+ */
+tb_void_t               tb_ws_deque_exit(tb_ws_deque_ref_t deque);
+
+/* push an item to the bottom, only for the owner thread
+ *
+ * @param deque         the deque
+ * @param data          the item data, cannot be null
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_ws_deque_push(tb_ws_deque_ref_t deque, tb_cpointer_t data);
+
+/* pop an item from the bottom, only for the owner thread
+ *
+ * @param deque         the deque
+ *
+ * @return              the item data, null if be empty
+ */
+tb_pointer_t            tb_ws_deque_pop(tb_ws_deque_ref_t deque);
+
+/* steal an item from the top, it can be called on any threads
+ *
+ * @param deque         the deque
+ *
+ * @return              the item data, null if be empty or lost the race
+ */
+tb_pointer_t            tb_ws_deque_steal(tb_ws_deque_ref_t deque);
+
+/* get the approximate item count
+ *
+ * @param deque         the deque
+ *
+ * @return              the item count
+ */
+tb_size_t               tb_ws_deque_size(tb_ws_deque_ref_t deque);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,774 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        poller_io_uring.c
+ *
+ */
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../atomic.h"
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <poll.h>
+#include <errno.h>
+#include <unistd.h>
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the submission queue entries
+#ifdef __tb_small__
+#   define TB_POLLER_IO_URING_ENTRIES       (64)
+#else
+#   define TB_POLLER_IO_URING_ENTRIES       (4096)
+#endif
+
+// the completion queue entries, the multishot polls may post more completions than the submissions
+#define TB_POLLER_IO_URING_CQ_ENTRIES       (TB_POLLER_IO_URING_ENTRIES << 2)
+
+// the object data grow
+#ifdef __tb_small__
+#   define TB_POLLER_IO_URING_FDATA_GROW    (64)
+#else
+#   define TB_POLLER_IO_URING_FDATA_GROW    (256)
+#endif
+
+// the required kernel features, ext_arg (5.11) for the wait timeout
+#define TB_POLLER_IO_URING_FEATURES         (IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG)
+
+/* the setup flags (6.1)
+ *
+ * we defer the task work to io_uring_enter(GETEVENTS) and the poll masks will be checked again at that time,
+ * otherwise the multishot poll will post the stale completions when we are reading or writing the object,
+ * it's the same as epoll_wait() and the coroutine scheduler caches these edge-trigger events.
+ *
+ * the ring is disabled at first and it will be enabled by the first tb_poller_wait(),
+ * because the poller may be inited on the other thread, e.g. the coroutine workers.
+ */
+#define TB_POLLER_IO_URING_SETUP            (IORING_SETUP_CQSIZE | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN | IORING_SETUP_R_DISABLED)
+
+// the user data of the ignored completions, e.g. poll remove
+#define TB_POLLER_IO_URING_UDATA_IGNORE     ((tb_uint64_t)-1)
+
+// make the user data of the poll request with fd and generation
+#define tb_poller_io_uring_udata(fd, gen)   (((tb_uint64_t)(gen) << 32) | (tb_uint32_t)(fd))
+
+// the edge-trigger flag of the poll mask, it's the same as EPOLLET
+#define TB_POLLER_IO_URING_POLLET           (1u << 31)
+
+#ifndef POLLRDHUP
+#   define POLLRDHUP                        (0x2000)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the io_uring object data type
+typedef struct __tb_poller_io_uring_fdata_t
+{
+    // the generation of the poll request, the stale completions will be ignored
+    tb_uint32_t             gen;
+
+    // the poller events, it's not inserted if be zero
+    tb_uint16_t             events;
+
+    // is the poll request in flight?
+    tb_uint8_t              armed;
+
+    // has been queued to the ready list of the current waiting?
+    tb_uint8_t              queued;
+
+    // the index of the ready list if it has been queued
+    tb_uint32_t             index;
+
+}tb_poller_io_uring_fdata_t;
+
+/* the io_uring poller type
+ *
+ * the poll requests are only queued to the submission queue when inserting, modifying and removing objects,
+ * and all of them will be submitted in batch and waited with only one io_uring_enter() in tb_poller_wait().
+ *
+ * the edge-trigger (clear) mode uses the multishot poll, and the level-trigger mode will re-arm
+ * the oneshot poll after reporting events.
+ *
+ * the poll masks of the completions are checked by the kernel when waiting them (DEFER_TASKRUN), so we report them directly,
+ * and we only check the ready objects again with one poll() if some completions were posted before waiting, they may be stale.
+ */
+typedef struct __tb_poller_io_uring_t
+{
+    // the poller base
+    tb_poller_t                 base;
+
+    // the pair sockets for spak, kill ..
+    tb_socket_ref_t             pair[2];
+
+    // the ring fd
+    tb_int_t                    fd;
+
+    // the ring has been enabled?
+    tb_bool_t                   enabled;
+
+    // the submission queue ring
+    tb_pointer_t                sq_ring;
+    tb_size_t                   sq_ring_size;
+    tb_atomic32_t*              sq_khead;
+    tb_atomic32_t*              sq_ktail;
+    tb_uint32_t*                sq_array;
+    tb_uint32_t                 sq_mask;
+    tb_uint32_t                 sq_entries;
+
+    // the submission queue entries
+    struct io_uring_sqe*        sqes;
+    tb_size_t                   sqes_size;
+
+    // the completion queue ring, it may be shared with the submission queue ring
+    tb_pointer_t                cq_ring;
+    tb_size_t                   cq_ring_size;
+    tb_atomic32_t*              cq_khead;
+    tb_atomic32_t*              cq_ktail;
+    tb_uint32_t                 cq_mask;
+    struct io_uring_cqe*        cqes;
+
+    // the object data (fd => fdata)
+    tb_poller_io_uring_fdata_t* fdata;
+
+    // the object data maximum count
+    tb_size_t                   fdata_maxn;
+
+    // the ready objects of the current waiting
+    struct pollfd*              ready;
+
+    // the ready objects generation
+    tb_uint32_t*                ready_gen;
+
+    // the ready objects maximum count
+    tb_size_t                   ready_maxn;
+
+    // the socket data
+    tb_pollerdata_t             pollerdata;
+
+}tb_poller_io_uring_t, *tb_poller_io_uring_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_int_t tb_poller_io_uring_setup(tb_uint32_t entries, struct io_uring_params* params)
+{
+    return (tb_int_t)syscall(__NR_io_uring_setup, entries, params);
+}
+static __tb_inline__ tb_int_t tb_poller_io_uring_enter(tb_int_t fd, tb_uint32_t submit, tb_uint32_t wait, tb_uint32_t flags, tb_pointer_t arg, tb_size_t argsz)
+{
+    return (tb_int_t)syscall(__NR_io_uring_enter, fd, submit, wait, flags, arg, argsz);
+}
+static tb_bool_t tb_poller_io_uring_enable(tb_poller_io_uring_ref_t poller)
+{
+    // enabled?
+    tb_check_return_val(!poller->enabled, tb_true);
+
+    // enable the ring and the current thread will be the only submitter
+    if (syscall(__NR_io_uring_register, poller->fd, IORING_REGISTER_ENABLE_RINGS, tb_null, 0) < 0)
+    {
+        // trace
+        tb_trace_e("enable ring failed, errno: %d", errno);
+        return tb_false;
+    }
+    poller->enabled = tb_true;
+    return tb_true;
+}
+static tb_poller_io_uring_fdata_t* tb_poller_io_uring_fdata(tb_poller_io_uring_ref_t poller, tb_long_t fd, tb_bool_t need)
+{
+    // check
+    tb_assert(poller && fd >= 0);
+
+    // exists?
+    if (fd < poller->fdata_maxn) return &poller->fdata[fd];
+    tb_check_return_val(need, tb_null);
+
+    // grow data
+    tb_size_t maxn = fd + 1 + TB_POLLER_IO_URING_FDATA_GROW;
+    if (!poller->fdata) poller->fdata = tb_nalloc_type(maxn, tb_poller_io_uring_fdata_t);
+    else poller->fdata = (tb_poller_io_uring_fdata_t*)tb_ralloc(poller->fdata, maxn * sizeof(tb_poller_io_uring_fdata_t));
+    tb_assert_and_check_return_val(poller->fdata, tb_null);
+
+    // init the growed space
+    tb_memset(poller->fdata + poller->fdata_maxn, 0, (maxn - poller->fdata_maxn) * sizeof(tb_poller_io_uring_fdata_t));
+    poller->fdata_maxn = maxn;
+    return &poller->fdata[fd];
+}
+static tb_uint32_t tb_poller_io_uring_submit_count(tb_poller_io_uring_ref_t poller)
+{
+    // the queued and not submitted entries count
+    return (tb_uint32_t)tb_atomic32_get_explicit(poller->sq_ktail, TB_ATOMIC_RELAXED) - (tb_uint32_t)tb_atomic32_get_explicit(poller->sq_khead, TB_ATOMIC_ACQUIRE);
+}
+static struct io_uring_sqe* tb_poller_io_uring_sqe(tb_poller_io_uring_ref_t poller)
+{
+    // the submission queue is full? submit them first
+    if (tb_poller_io_uring_submit_count(poller) >= poller->sq_entries)
+    {
+        if (!tb_poller_io_uring_enable(poller)) return tb_null;
+        if (tb_poller_io_uring_enter(poller->fd, tb_poller_io_uring_submit_count(poller), 0, 0, tb_null, 0) < 0 && errno != EBUSY && errno != EAGAIN)
+        {
+            // trace
+            tb_trace_e("submit entries failed, errno: %d", errno);
+            return tb_null;
+        }
+        tb_check_return_val(tb_poller_io_uring_submit_count(poller) < poller->sq_entries, tb_null);
+    }
+
+    // get a free entry, it's in the mapped ring memory and we cannot check it by tb_memset()
+    tb_uint32_t             tail = (tb_uint32_t)tb_atomic32_get_explicit(poller->sq_ktail, TB_ATOMIC_RELAXED);
+    tb_uint32_t             index = tail & poller->sq_mask;
+    struct io_uring_sqe*    sqe = &poller->sqes[index];
+    tb_memset_(sqe, 0, sizeof(struct io_uring_sqe));
+
+    // queue it, it will be submitted in tb_poller_wait()
+    poller->sq_array[index] = index;
+    tb_atomic32_set_explicit(poller->sq_ktail, (tb_int32_t)(tail + 1), TB_ATOMIC_RELEASE);
+    return sqe;
+}
+static tb_bool_t tb_poller_io_uring_arm(tb_poller_io_uring_ref_t poller, tb_long_t fd, tb_poller_io_uring_fdata_t* fdata)
+{
+    // check
+    tb_assert(poller && fdata && fdata->events && !fdata->armed);
+
+    // init poll mask
+    tb_size_t   events = fdata->events;
+    tb_uint32_t mask = 0;
+    if (events & TB_POLLER_EVENT_RECV) mask |= POLLIN;
+    if (events & TB_POLLER_EVENT_SEND) mask |= POLLOUT;
+
+    // use the multishot poll for the edge trigger
+    tb_bool_t multishot = (events & TB_POLLER_EVENT_CLEAR) && !(events & TB_POLLER_EVENT_ONESHOT);
+    if (multishot) mask |= POLLRDHUP | TB_POLLER_IO_URING_POLLET;
+
+#ifdef TB_WORDS_BIGENDIAN
+    // the poll32_events is little-endian
+    mask = (mask << 16) | (mask >> 16);
+#endif
+
+    // queue a poll request
+    struct io_uring_sqe* sqe = tb_poller_io_uring_sqe(poller);
+    tb_assert_and_check_return_val(sqe, tb_false);
+    sqe->opcode         = IORING_OP_POLL_ADD;
+    sqe->fd             = (tb_int_t)fd;
+    sqe->poll32_events  = mask;
+    sqe->len            = multishot? IORING_POLL_ADD_MULTI : 0;
+    sqe->user_data      = tb_poller_io_uring_udata(fd, fdata->gen);
+
+    // armed
+    fdata->armed = 1;
+    return tb_true;
+}
+static tb_bool_t tb_poller_io_uring_disarm(tb_poller_io_uring_ref_t poller, tb_long_t fd, tb_poller_io_uring_fdata_t* fdata)
+{
+    // check
+    tb_assert(poller && fdata);
+
+    // the completions of the previous poll request will be ignored
+    tb_uint64_t udata = tb_poller_io_uring_udata(fd, fdata->gen);
+    fdata->gen++;
+
+    // not armed? ok
+    tb_check_return_val(fdata->armed, tb_true);
+
+    // queue a poll remove request
+    struct io_uring_sqe* sqe = tb_poller_io_uring_sqe(poller);
+    tb_assert_and_check_return_val(sqe, tb_false);
+    sqe->opcode     = IORING_OP_POLL_REMOVE;
+    sqe->fd         = -1;
+    sqe->addr       = udata;
+    sqe->user_data  = TB_POLLER_IO_URING_UDATA_IGNORE;
+
+    // disarmed
+    fdata->armed = 0;
+    return tb_true;
+}
+static tb_void_t tb_poller_io_uring_exit(tb_poller_t* self)
+{
+    // check
+    tb_poller_io_uring_ref_t poller = (tb_poller_io_uring_ref_t)self;
+    tb_assert_and_check_return(poller);
+
+    // exit pair sockets
+    if (poller->pair[0]) tb_socket_exit(poller->pair[0]);
+    if (poller->pair[1]) tb_socket_exit(poller->pair[1]);
+    poller->pair[0] = tb_null;
+    poller->pair[1] = tb_null;
+
+    // exit rings
+    if (poller->sqes) munmap(poller->sqes, poller->sqes_size);
+    if (poller->cq_ring && poller->cq_ring != poller->sq_ring) munmap(poller->cq_ring, poller->cq_ring_size);
+    if (poller->sq_ring) munmap(poller->sq_ring, poller->sq_ring_size);
+    poller->sqes    = tb_null;
+    poller->cq_ring = tb_null;
+    poller->sq_ring = tb_null;
+
+    // close ring fd
+    if (poller->fd > 0) close(poller->fd);
+    poller->fd = 0;
+
+    // exit the ready objects
+    if (poller->ready) tb_free(poller->ready);
+    if (poller->ready_gen) tb_free(poller->ready_gen);
+    poller->ready       = tb_null;
+    poller->ready_gen   = tb_null;
+    poller->ready_maxn  = 0;
+
+    // exit object data
+    if (poller->fdata) tb_free(poller->fdata);
+    poller->fdata       = tb_null;
+    poller->fdata_maxn  = 0;
+
+    // exit socket data
+    tb_pollerdata_exit(&poller->pollerdata);
+
+    // free it
+    tb_free(poller);
+}
+static tb_void_t tb_poller_io_uring_kill(tb_poller_t* self)
+{
+    // check
+    tb_poller_io_uring_ref_t poller = (tb_poller_io_uring_ref_t)self;
+    tb_assert_and_check_return(poller);
+
+    // kill it
+    if (poller->pair[0]) tb_socket_send(poller->pair[0], (tb_byte_t const*)"k", 1);
+}
+static tb_void_t tb_poller_io_uring_spak(tb_poller_t* self)
+{
+    // check
+    tb_poller_io_uring_ref_t poller = (tb_poller_io_uring_ref_t)self;
+    tb_assert_and_check_return(poller);
+
+    // post it
+    if (poller->pair[0]) tb_socket_send(poller->pair[0], (tb_byte_t const*)"p", 1);
+}
+static tb_bool_t tb_poller_io_uring_insert(tb_poller_t* self, tb_poller_object_ref_t object, tb_size_t events, tb_cpointer_t priv)
+{
+    // check
+    tb_poller_io_uring_ref_t poller = (tb_poller_io_uring_ref_t)self;
+    tb_assert_and_check_return_val(poller && poller->fd > 0 && object, tb_false);
+
+    // get object data
+    tb_long_t                   fd = tb_ptr2fd(object->ref.ptr);
+    tb_poller_io_uring_fdata_t* fdata = tb_poller_io_uring_fdata(poller, fd, tb_true);
+    tb_assert_and_check_return_val(fdata, tb_false);
+
+    // exists?
+    if (fdata->events)
+    {
+        // trace
+        tb_trace_e("insert object(%p) events: %lu failed, it has been inserted", object->ref.ptr, events);
+        return tb_false;
+    }
+
+    // bind the object type to the private data
+    priv = tb_poller_priv_set_object_type(object, priv);
+
+    // bind user private data to object
+    if (!(events & TB_POLLER_EVENT_NOEXTRA) || object->type == TB_POLLER_OBJECT_PIPE)
+        tb_pollerdata_set(&poller->pollerdata, object, priv);
+
+    // queue the poll request
+    fdata->events = (tb_uint16_t)events;
+    if (!tb_poller_io_uring_arm(poller, fd, fdata))
+    {
+        // trace
+        tb_trace_e("insert object(%p) events: %lu failed", object->ref.ptr, events);
+        fdata->events = 0;
+        return tb_false;
+    }
+    return tb_true;
+}
+static tb_bool_t tb_poller_io_uring_remove(tb_poller_t* self, tb_poller_object_ref_t object)
+{
+    // check
+    tb_poller_io_uring_ref_t poller = (tb_poller_io_uring_ref_t)self;
+    tb_assert_and_check_return_val(poller && poller->fd > 0 && object, tb_false);
+
+    // get object data
+    tb_long_t                   fd = tb_ptr2fd(object->ref.ptr);
+    tb_poller_io_uring_fdata_t* fdata = tb_poller_io_uring_fdata(poller, fd, tb_false);
+    if (!fdata || !fdata->events)
+    {
+        // trace
+        tb_trace_e("remove object(%p) failed, it has been not inserted", object->ref.ptr);
+        return tb_false;
+    }
+
+    /* cancel the poll request
+     *
+     * the object may be closed before submitting it, but the poll request still holds this file
+     * and it will be released after the cancellation is submitted in the next tb_poller_wait().
+     */
+    if (!tb_poller_io_uring_disarm(poller, fd, fdata))
+    {
+        // trace
+        tb_trace_e("remove object(%p) failed", object->ref.ptr);
+        return tb_false;
+    }
+    fdata->events = 0;
+
+    // remove user private data from this object
+    tb_pollerdata_reset(&poller->pollerdata, object);
+    return tb_true;
+}
+static tb_bool_t tb_poller_io_uring_modify(tb_poller_t* self, tb_poller_object_ref_t object, tb_size_t events, tb_cpointer_t priv)
+{
+    // check
+    tb_poller_io_uring_ref_t poller = (tb_poller_io_uring_ref_t)self;
+    tb_assert_and_check_return_val(poller && poller->fd > 0 && object, tb_false);
+
+    // get object data
+    tb_long_t                   fd = tb_ptr2fd(object->ref.ptr);
+    tb_poller_io_uring_fdata_t* fdata = tb_poller_io_uring_fdata(poller, fd, tb_false);
+    if (!fdata || !fdata->events)
+    {
+        // trace
+        tb_trace_e("modify object(%p) events: %lu failed, it has been not inserted", object->ref.ptr, events);
+        return tb_false;
+    }
+
+    // bind the object type to the private data
+    priv = tb_poller_priv_set_object_type(object, priv);
+
+    // bind user private data to object
+    if (!(events & TB_POLLER_EVENT_NOEXTRA) || object->type == TB_POLLER_OBJECT_PIPE)
+        tb_pollerdata_set(&poller->pollerdata, object, priv);
+
+    // cancel the previous poll request and queue a new poll request
+    fdata->events = (tb_uint16_t)events;
+    if (!tb_poller_io_uring_disarm(poller, fd, fdata) || !tb_poller_io_uring_arm(poller, fd, fdata))
+    {
+        // trace
+        tb_trace_e("modify object(%p) events: %lu failed", object->ref.ptr, events);
+        return tb_false;
+    }
+    return tb_true;
+}
+static tb_long_t tb_poller_io_uring_wait(tb_poller_t* self, tb_poller_event_func_t func, tb_long_t timeout)
+{
+    // check
+    tb_poller_io_uring_ref_t poller = (tb_poller_io_uring_ref_t)self;
+    tb_assert_and_check_return_val(poller && poller->fd > 0 && func, -1);
+
+    // enable the ring on the current thread
+    if (!tb_poller_io_uring_enable(poller)) return -1;
+
+    // no completions now? submit all queued requests and wait completions
+    tb_uint32_t head = (tb_uint32_t)tb_atomic32_get_explicit(poller->cq_khead, TB_ATOMIC_RELAXED);
+    tb_uint32_t tail = (tb_uint32_t)tb_atomic32_get_explicit(poller->cq_ktail, TB_ATOMIC_ACQUIRE);
+    tb_uint32_t submit = tb_poller_io_uring_submit_count(poller);
+
+    /* the completions have been posted before waiting? e.g. the inline completions of the last submitting
+     *
+     * their masks may be stale now, so we need check the ready objects again
+     */
+    tb_bool_t recheck = head != tail;
+    if (head == tail)
+    {
+        // init timeout
+        struct __kernel_timespec        ts;
+        struct io_uring_getevents_arg   arg;
+        tb_memset(&arg, 0, sizeof(arg));
+        if (timeout >= 0)
+        {
+            ts.tv_sec   = timeout / 1000;
+            ts.tv_nsec  = (timeout % 1000) * 1000000;
+            arg.ts      = (tb_uint64_t)(tb_size_t)&ts;
+        }
+
+        // submit and wait it
+        if (tb_poller_io_uring_enter(poller->fd, submit, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg)) < 0)
+        {
+            // timeout or interrupted?
+            if (errno == ETIME || errno == EINTR) return 0;
+
+            // failed?
+            if (errno != EBUSY && errno != EAGAIN)
+            {
+                tb_trace_e("wait failed, errno: %d", errno);
+                return -1;
+            }
+        }
+        tail = (tb_uint32_t)tb_atomic32_get_explicit(poller->cq_ktail, TB_ATOMIC_ACQUIRE);
+    }
+    // only submit all queued requests, the deferred completions will be reaped in the next waiting
+    else if (submit)
+        tb_poller_io_uring_enter(poller->fd, submit, 0, 0, tb_null, 0);
+
+    // reap completions to the ready objects
+    tb_size_t ready_count = 0;
+    for (; head != tail; head++)
+    {
+        // get the completion
+        struct io_uring_cqe*    cqe = &poller->cqes[head & poller->cq_mask];
+        tb_uint64_t             udata = cqe->user_data;
+        tb_uint32_t             flags = cqe->flags;
+        tb_check_continue(udata != TB_POLLER_IO_URING_UDATA_IGNORE);
+
+        // get the object data, ignore the stale completions of the removed or modified objects
+        tb_long_t                   fd = (tb_long_t)(tb_uint32_t)udata;
+        tb_poller_io_uring_fdata_t* fdata = tb_poller_io_uring_fdata(poller, fd, tb_false);
+        tb_check_continue(fdata && fdata->events && fdata->gen == (tb_uint32_t)(udata >> 32));
+
+        // the poll request has been finished? it need be re-armed
+        if (!(flags & IORING_CQE_F_MORE)) fdata->armed = 0;
+
+        // the object has been closed before removing it? we cannot re-arm it
+        if (cqe->res == -EBADF) continue ;
+
+        // re-arm it for the level trigger and the terminated multishot poll
+        tb_size_t events_reg = fdata->events;
+        if (!fdata->armed && !(events_reg & TB_POLLER_EVENT_ONESHOT))
+            tb_poller_io_uring_arm(poller, fd, fdata);
+
+        // the failed completion? we need check it again
+        if (cqe->res < 0) recheck = tb_true;
+
+        // queue it to the ready objects
+        if (!fdata->queued && ready_count < poller->ready_maxn)
+        {
+            struct pollfd* pfd = &poller->ready[ready_count];
+            pfd->fd         = (tb_int_t)fd;
+            pfd->events     = 0;
+            pfd->revents    = 0;
+            if (events_reg & TB_POLLER_EVENT_RECV) pfd->events |= POLLIN;
+            if (events_reg & TB_POLLER_EVENT_SEND) pfd->events |= POLLOUT;
+            if (events_reg & TB_POLLER_EVENT_CLEAR) pfd->events |= POLLRDHUP;
+            poller->ready_gen[ready_count] = fdata->gen;
+            fdata->index  = (tb_uint32_t)ready_count++;
+            fdata->queued = 1;
+        }
+
+        // merge the poll masks of the multiple completions
+        if (fdata->queued && cqe->res > 0)
+            poller->ready[fdata->index].revents |= (tb_short_t)(cqe->res & 0xffff);
+    }
+
+    // mark these completions as consumed
+    tb_atomic32_set_explicit(poller->cq_khead, (tb_int32_t)head, TB_ATOMIC_RELEASE);
+    tb_check_return_val(ready_count, 0);
+
+    // check the ready objects again if some completions may be stale
+    if (recheck && poll(poller->ready, (nfds_t)ready_count, 0) < 0 && errno != EINTR)
+    {
+        // trace
+        tb_trace_e("poll ready objects failed, errno: %d", errno);
+        return -1;
+    }
+
+    // handle the ready objects
+    tb_size_t           i = 0;
+    tb_long_t           wait = 0;
+    tb_socket_ref_t     pair = poller->pair[1];
+    tb_poller_object_t  object;
+    for (i = 0; i < ready_count; i++)
+    {
+        // get the object data, it may be removed or modified by the previous event function
+        struct pollfd*              pfd = &poller->ready[i];
+        tb_long_t                   fd = pfd->fd;
+        tb_poller_io_uring_fdata_t* fdata = tb_poller_io_uring_fdata(poller, fd, tb_false);
+        tb_assert_and_check_continue(fdata);
+        fdata->queued = 0;
+        tb_check_continue(fdata->events && fdata->gen == poller->ready_gen[i]);
+
+        // the events for io_uring
+        tb_size_t events_reg = fdata->events;
+        tb_size_t events = TB_POLLER_EVENT_NONE;
+        tb_size_t revents = pfd->revents;
+        if (revents & POLLIN) events |= TB_POLLER_EVENT_RECV;
+        if (revents & POLLOUT) events |= TB_POLLER_EVENT_SEND;
+        if ((revents & (POLLHUP | POLLERR)) && !(events & (TB_POLLER_EVENT_RECV | TB_POLLER_EVENT_SEND)))
+            events |= TB_POLLER_EVENT_RECV | TB_POLLER_EVENT_SEND;
+
+        // connection closed for the edge trigger?
+        if ((revents & POLLRDHUP) && (events_reg & TB_POLLER_EVENT_CLEAR)) events |= TB_POLLER_EVENT_EOF;
+
+        // it's not ready now? the oneshot poll need be re-armed because it has been not reported
+        if (!events)
+        {
+            if (!fdata->armed) tb_poller_io_uring_arm(poller, fd, fdata);
+            continue ;
+        }
+
+        // spank socket events?
+        object.ref.ptr = tb_fd2ptr(fd);
+        if (object.ref.sock == pair)
+        {
+            // read spak
+            tb_char_t spak = '\0';
+            if (1 != tb_socket_recv(pair, (tb_byte_t*)&spak, 1) || spak == 'k')
+            {
+                // failed or killed
+                wait = -1;
+                break;
+            }
+
+            // continue it
+            continue ;
+        }
+
+        // call event function
+        tb_cpointer_t priv = tb_pollerdata_get(&poller->pollerdata, &object);
+        object.type = tb_poller_priv_get_object_type(priv);
+        func((tb_poller_ref_t)self, &object, events, tb_poller_priv_get_original(priv));
+
+        // update the events count
+        wait++;
+    }
+
+    // clear the left queued objects if be killed
+    for (i++; i < ready_count; i++)
+    {
+        tb_poller_io_uring_fdata_t* fdata = tb_poller_io_uring_fdata(poller, poller->ready[i].fd, tb_false);
+        if (fdata) fdata->queued = 0;
+    }
+
+    // ok
+    return wait;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_poller_t* tb_poller_io_uring_init()
+{
+    // done
+    tb_bool_t                   ok = tb_false;
+    tb_poller_io_uring_ref_t    poller = tb_null;
+    do
+    {
+        // make poller
+        poller = tb_malloc0_type(tb_poller_io_uring_t);
+        tb_assert_and_check_break(poller);
+
+        // init base
+        poller->base.type   = TB_POLLER_TYPE_IO_URING;
+        poller->base.exit   = tb_poller_io_uring_exit;
+        poller->base.kill   = tb_poller_io_uring_kill;
+        poller->base.spak   = tb_poller_io_uring_spak;
+        poller->base.wait   = tb_poller_io_uring_wait;
+        poller->base.insert = tb_poller_io_uring_insert;
+        poller->base.remove = tb_poller_io_uring_remove;
+        poller->base.modify = tb_poller_io_uring_modify;
+        poller->base.supported_events = TB_POLLER_EVENT_EALL | TB_POLLER_EVENT_CLEAR | TB_POLLER_EVENT_ONESHOT;
+
+        // init poller data
+        tb_pollerdata_init(&poller->pollerdata);
+
+        // init io_uring, it may be not supported or be disabled by the current kernel
+        struct io_uring_params params;
+        tb_memset(&params, 0, sizeof(params));
+        params.flags        = TB_POLLER_IO_URING_SETUP;
+        params.cq_entries   = TB_POLLER_IO_URING_CQ_ENTRIES;
+        poller->fd = tb_poller_io_uring_setup(TB_POLLER_IO_URING_ENTRIES, &params);
+        tb_check_break(poller->fd > 0);
+
+        // check the required features
+        if ((params.features & TB_POLLER_IO_URING_FEATURES) != TB_POLLER_IO_URING_FEATURES)
+        {
+            // trace
+            tb_trace_d("io_uring: the kernel features(%x) are not enough", params.features);
+            break;
+        }
+
+        // map the submission and completion queue rings
+        poller->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(tb_uint32_t);
+        poller->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            poller->sq_ring_size = poller->cq_ring_size = tb_max(poller->sq_ring_size, poller->cq_ring_size);
+        poller->sq_ring = mmap(tb_null, poller->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, poller->fd, IORING_OFF_SQ_RING);
+        if (poller->sq_ring == MAP_FAILED)
+        {
+            poller->sq_ring = tb_null;
+            break;
+        }
+        if (params.features & IORING_FEAT_SINGLE_MMAP) poller->cq_ring = poller->sq_ring;
+        else
+        {
+            poller->cq_ring = mmap(tb_null, poller->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, poller->fd, IORING_OFF_CQ_RING);
+            if (poller->cq_ring == MAP_FAILED)
+            {
+                poller->cq_ring = tb_null;
+                break;
+            }
+        }
+
+        // map the submission queue entries
+        poller->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+        poller->sqes = (struct io_uring_sqe*)mmap(tb_null, poller->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, poller->fd, IORING_OFF_SQES);
+        if (poller->sqes == MAP_FAILED)
+        {
+            poller->sqes = tb_null;
+            break;
+        }
+
+        // init the submission queue
+        tb_byte_t* sq_ring  = (tb_byte_t*)poller->sq_ring;
+        poller->sq_khead    = (tb_atomic32_t*)(sq_ring + params.sq_off.head);
+        poller->sq_ktail    = (tb_atomic32_t*)(sq_ring + params.sq_off.tail);
+        poller->sq_array    = (tb_uint32_t*)(sq_ring + params.sq_off.array);
+        poller->sq_mask     = *(tb_uint32_t*)(sq_ring + params.sq_off.ring_mask);
+        poller->sq_entries  = params.sq_entries;
+
+        // init the completion queue
+        tb_byte_t* cq_ring  = (tb_byte_t*)poller->cq_ring;
+        poller->cq_khead    = (tb_atomic32_t*)(cq_ring + params.cq_off.head);
+        poller->cq_ktail    = (tb_atomic32_t*)(cq_ring + params.cq_off.tail);
+        poller->cq_mask     = *(tb_uint32_t*)(cq_ring + params.cq_off.ring_mask);
+        poller->cqes        = (struct io_uring_cqe*)(cq_ring + params.cq_off.cqes);
+
+        // init the ready objects, the completions count of one waiting is not greater than the completion queue size
+        poller->ready_maxn  = params.cq_entries;
+        poller->ready       = tb_nalloc_type(poller->ready_maxn, struct pollfd);
+        poller->ready_gen   = tb_nalloc_type(poller->ready_maxn, tb_uint32_t);
+        tb_assert_and_check_break(poller->ready && poller->ready_gen);
+
+        // init pair sockets
+        if (!tb_socket_pair(TB_SOCKET_TYPE_TCP, poller->pair)) break;
+
+        // insert pair socket first
+        tb_poller_object_t object;
+        object.type = TB_POLLER_OBJECT_SOCK;
+        object.ref.sock = poller->pair[1];
+        if (!tb_poller_io_uring_insert((tb_poller_t*)poller, &object, TB_POLLER_EVENT_RECV, tb_null)) break;
+
+        // trace
+        tb_trace_d("io_uring: init ok, sq: %u, cq: %u, features: %x", params.sq_entries, params.cq_entries, params.features);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (poller) tb_poller_io_uring_exit((tb_poller_t*)poller);
+        poller = tb_null;
+    }
+
+    // ok?
+    return (tb_poller_t*)poller;
+}
@@ -37,6 +37,7 @@
 #include "timer.h"
 #include "print.h"
 #include "ltimer.h"
+#include "wtimer.h"
 #include "socket.h"
 #include "thread.h"
 #include "atomic.h"
@@ -59,6 +60,7 @@
 #include "cache_time.h"
 #include "environment.h"
 #include "thread_pool.h"
+#include "thread_pool_graph.h"
 #include "thread_local.h"
 #include "native_memory.h"
 #include "virtual_memory.h"
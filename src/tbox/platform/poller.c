@@ -30,6 +30,7 @@
  */
 #include "poller.h"
 #include "time.h"
+#include "environment.h"
 #include "impl/poller.h"
 #include "impl/pollerdata.h"
 
@@ -48,6 +49,10 @@
     && defined(TB_CONFIG_POSIX_HAVE_EPOLL_WAIT)
 #   include "linux/poller_epoll.c"
 #   define TB_POLLER_ENABLE_EPOLL
+#   ifdef TB_CONFIG_LINUX_HAVE_IO_URING
+#       include "linux/poller_io_uring.c"
+#       define TB_POLLER_ENABLE_IO_URING
+#   endif
 #elif defined(TB_CONFIG_OS_MACOSX) || defined(TB_CONFIG_OS_BSD)
 #   include "bsd/poller_kqueue.c"
 #   define TB_POLLER_ENABLE_KQUEUE
@@ -79,6 +84,15 @@
 #   endif
 #endif
 
+#ifdef TB_POLLER_ENABLE_IO_URING
+static tb_bool_t tb_poller_io_uring_enabled()
+{
+    // io_uring is disabled by default, we can enable it by the environment variable, e.g. TB_POLLER_IO_URING=1
+    tb_char_t value[16];
+    return tb_environment_first("TB_POLLER_IO_URING", value, sizeof(value)) && value[0] == '1';
+}
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -90,6 +104,11 @@ tb_poller_ref_t tb_poller_init(tb_cpointer_t priv)
     {
         // init poller
 #if defined(TB_POLLER_ENABLE_EPOLL)
+#   ifdef TB_POLLER_ENABLE_IO_URING
+        // attempt to use io_uring if be enabled, it will fall back to epoll if the kernel does not support it
+        if (tb_poller_io_uring_enabled()) poller = tb_poller_io_uring_init();
+        if (!poller)
+#   endif
         poller = tb_poller_epoll_init();
 #elif defined(TB_POLLER_ENABLE_KQUEUE)
         poller = tb_poller_kqueue_init();
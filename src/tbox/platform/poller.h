@@ -48,6 +48,7 @@ typedef enum __tb_poller_type_e
 ,   TB_POLLER_TYPE_EPOLL        = 3
 ,   TB_POLLER_TYPE_KQUEUE       = 4
 ,   TB_POLLER_TYPE_SELECT       = 5
+,   TB_POLLER_TYPE_IO_URING     = 6
 
 }tb_poller_type_e;
 
@@ -125,6 +126,8 @@ typedef tb_void_t   (*tb_poller_event_func_t)(tb_poller_ref_t poller, tb_poller_
  */
 
 /*! init poller
+ *
+ * it uses epoll on linux by default, and we can use io_uring (linux >= 6.1) by setting the environment variable TB_POLLER_IO_URING=1
  *
  * @param priv      the user private data
  *
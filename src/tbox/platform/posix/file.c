@@ -41,6 +41,132 @@
 #   include <sys/sendfile.h>
 #endif
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+
+// the file io code for coroutine
+typedef enum __tb_file_io_code_e
+{
+    TB_FILE_IO_CODE_READ    = 0
+,   TB_FILE_IO_CODE_WRIT    = 1
+,   TB_FILE_IO_CODE_SYNC    = 2
+,   TB_FILE_IO_CODE_WRITF   = 3
+
+}tb_file_io_code_e;
+
+/* the file io type for coroutine, it will be done on the thread pool
+ *
+ * it will be copied to the heap with the iovec list, because it may be still accessed
+ * by the thread pool after the scheduler of the waiting coroutine is exited
+ */
+typedef struct __tb_file_io_t
+{
+    // the io code
+    tb_size_t               code;
+
+    // the file
+    tb_file_ref_t           file;
+
+    // the input file for writf
+    tb_file_ref_t           ifile;
+
+    // the iovec list and count for read/writ
+    tb_iovec_t const*       list;
+    tb_size_t               count;
+
+    // the offset, it will use the current file offset if be -1
+    tb_hong_t               offset;
+
+    // the size for writf
+    tb_hize_t               size;
+
+}tb_file_io_t;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+static tb_long_t tb_file_io_done(tb_cpointer_t priv)
+{
+    // check
+    tb_file_io_t* io = (tb_file_io_t*)priv;
+    tb_assert_and_check_return_val(io && io->file, -1);
+
+    // do io, we are not in coroutine now
+    switch (io->code)
+    {
+    case TB_FILE_IO_CODE_READ:
+        return io->offset >= 0? tb_file_preadv(io->file, io->list, io->count, io->offset) : tb_file_readv(io->file, io->list, io->count);
+    case TB_FILE_IO_CODE_WRIT:
+        return io->offset >= 0? tb_file_pwritv(io->file, io->list, io->count, io->offset) : tb_file_writv(io->file, io->list, io->count);
+    case TB_FILE_IO_CODE_SYNC:
+        return tb_file_sync(io->file)? 1 : -1;
+    case TB_FILE_IO_CODE_WRITF:
+        return (tb_long_t)tb_file_writf(io->file, io->ifile, io->offset, io->size);
+    default:
+        break;
+    }
+    return -1;
+}
+static tb_void_t tb_file_io_exit(tb_cpointer_t priv)
+{
+    // exit io
+    if (priv) tb_free((tb_pointer_t)priv);
+}
+static tb_long_t tb_file_io_wait(tb_file_io_t const* io)
+{
+    // check
+    tb_assert(io && io->file);
+
+#if defined(TB_CONFIG_POSIX_HAVE_PREADV2) && defined(TB_CONFIG_POSIX_HAVE_PWRITEV2) && defined(RWF_NOWAIT)
+    /* attempt to read or write the page cache directly without blocking first
+     *
+     * it will return EAGAIN if the data is not cached or the writing need be blocked,
+     * and the old kernel or some file systems will return EOPNOTSUPP.
+     */
+    if (io->code == TB_FILE_IO_CODE_READ || io->code == TB_FILE_IO_CODE_WRIT)
+    {
+        tb_long_t real = io->code == TB_FILE_IO_CODE_READ?
+                preadv2(tb_file2fd(io->file), (struct iovec const*)io->list, (tb_int_t)io->count, (off_t)io->offset, RWF_NOWAIT) :
+                pwritev2(tb_file2fd(io->file), (struct iovec const*)io->list, (tb_int_t)io->count, (off_t)io->offset, RWF_NOWAIT);
+        if (real >= 0 || (errno != EAGAIN && errno != EOPNOTSUPP)) return real;
+    }
+#endif
+
+    // copy io and the iovec list to the heap
+    tb_size_t       listsize = io->count * sizeof(tb_iovec_t);
+    tb_file_io_t*   copy = (tb_file_io_t*)tb_malloc(sizeof(tb_file_io_t) + listsize);
+    tb_assert_and_check_return_val(copy, -1);
+    *copy = *io;
+    if (listsize)
+    {
+        copy->list = (tb_iovec_t const*)&copy[1];
+        tb_memcpy(&copy[1], io->list, listsize);
+    }
+
+    // do it on the thread pool and wait it, the other coroutines will not be blocked
+    return tb_coroutine_waitcall(tb_file_io_done, tb_file_io_exit, copy);
+}
+static tb_long_t tb_file_io_wait_rw(tb_size_t code, tb_file_ref_t file, tb_iovec_t const* list, tb_size_t count, tb_hong_t offset)
+{
+    // init io
+    tb_file_io_t io = {0};
+    io.code     = code;
+    io.file     = file;
+    io.list     = list;
+    io.count    = count;
+    io.offset   = offset;
+
+    // wait it
+    return tb_file_io_wait(&io);
+}
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -127,6 +253,18 @@ tb_long_t tb_file_read(tb_file_ref_t file, tb_byte_t* data, tb_size_t size)
     // check
     tb_assert_and_check_return_val(file && data, -1);
 
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+    // attempt to read it in coroutine
+    if (tb_coroutine_self())
+    {
+        tb_iovec_t list = {0};
+        list.data = data;
+        list.size = size;
+        return tb_file_io_wait_rw(TB_FILE_IO_CODE_READ, file, &list, 1, -1);
+    }
+#endif
+
     // read it
     return read(tb_file2fd(file), data, size);
 }
@@ -135,6 +273,18 @@ tb_long_t tb_file_writ(tb_file_ref_t file, tb_byte_t const* data, tb_size_t size
     // check
     tb_assert_and_check_return_val(file && data, -1);
 
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+    // attempt to writ it in coroutine
+    if (tb_coroutine_self())
+    {
+        tb_iovec_t list = {0};
+        list.data = (tb_byte_t*)data;
+        list.size = size;
+        return tb_file_io_wait_rw(TB_FILE_IO_CODE_WRIT, file, &list, 1, -1);
+    }
+#endif
+
     // writ it
     return write(tb_file2fd(file), data, size);
 }
@@ -143,6 +293,18 @@ tb_bool_t tb_file_sync(tb_file_ref_t file)
     // check
     tb_assert_and_check_return_val(file, tb_false);
 
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+    // attempt to sync it in coroutine
+    if (tb_coroutine_self())
+    {
+        tb_file_io_t io = {0};
+        io.code = TB_FILE_IO_CODE_SYNC;
+        io.file = file;
+        return tb_file_io_wait(&io) > 0;
+    }
+#endif
+
     // sync
 #ifdef TB_CONFIG_POSIX_HAVE_FDATASYNC
     return !fdatasync(tb_file2fd(file))? tb_true : tb_false;
@@ -250,6 +412,18 @@ tb_long_t tb_file_pread(tb_file_ref_t file, tb_byte_t* data, tb_size_t size, tb_
     // check
     tb_assert_and_check_return_val(file, -1);
 
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+    // attempt to read it in coroutine
+    if (tb_coroutine_self())
+    {
+        tb_iovec_t list = {0};
+        list.data = data;
+        list.size = size;
+        return tb_file_io_wait_rw(TB_FILE_IO_CODE_READ, file, &list, 1, (tb_hong_t)offset);
+    }
+#endif
+
     // read it
 #ifdef TB_CONFIG_POSIX_HAVE_PREAD64
     return pread64(tb_file2fd(file), data, (size_t)size, offset);
@@ -262,6 +436,18 @@ tb_long_t tb_file_pwrit(tb_file_ref_t file, tb_byte_t const* data, tb_size_t siz
     // check
     tb_assert_and_check_return_val(file, -1);
 
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+    // attempt to writ it in coroutine
+    if (tb_coroutine_self())
+    {
+        tb_iovec_t list = {0};
+        list.data = (tb_byte_t*)data;
+        list.size = size;
+        return tb_file_io_wait_rw(TB_FILE_IO_CODE_WRIT, file, &list, 1, (tb_hong_t)offset);
+    }
+#endif
+
     // writ it
 #ifdef TB_CONFIG_POSIX_HAVE_PWRITE64
     return pwrite64(tb_file2fd(file), data, (size_t)size, offset);
@@ -279,6 +465,12 @@ tb_long_t tb_file_readv(tb_file_ref_t file, tb_iovec_t const* list, tb_size_t si
     tb_assert(tb_memberof_eq(tb_iovec_t, data, struct iovec, iov_base));
     tb_assert(tb_memberof_eq(tb_iovec_t, size, struct iovec, iov_len));
 
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+    // attempt to read it in coroutine
+    if (tb_coroutine_self()) return tb_file_io_wait_rw(TB_FILE_IO_CODE_READ, file, list, size, -1);
+#endif
+
     // read it
     return readv(tb_file2fd(file), (struct iovec const*)list, size);
 }
@@ -292,6 +484,12 @@ tb_long_t tb_file_writv(tb_file_ref_t file, tb_iovec_t const* list, tb_size_t si
     tb_assert(tb_memberof_eq(tb_iovec_t, data, struct iovec, iov_base));
     tb_assert(tb_memberof_eq(tb_iovec_t, size, struct iovec, iov_len));
 
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+    // attempt to writ it in coroutine
+    if (tb_coroutine_self()) return tb_file_io_wait_rw(TB_FILE_IO_CODE_WRIT, file, list, size, -1);
+#endif
+
     // writ it
     return writev(tb_file2fd(file), (struct iovec const*)list, size);
 }
@@ -300,6 +498,25 @@ tb_hong_t tb_file_writf(tb_file_ref_t file, tb_file_ref_t ifile, tb_hize_t offse
     // check
     tb_assert_and_check_return_val(file && ifile && size, -1);
 
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+    /* attempt to writ it in coroutine
+     *
+     * the result of the blocking call is tb_long_t, so we write it partially if it's too large,
+     * and sendfile() will only write 0x7ffff000 bytes at most on linux
+     */
+    if (tb_coroutine_self())
+    {
+        tb_file_io_t io = {0};
+        io.code     = TB_FILE_IO_CODE_WRITF;
+        io.file     = file;
+        io.ifile    = ifile;
+        io.offset   = (tb_hong_t)offset;
+        io.size     = tb_min(size, (tb_hize_t)TB_MAXS32);
+        return (tb_hong_t)tb_file_io_wait(&io);
+    }
+#endif
+
 #ifdef TB_CONFIG_POSIX_HAVE_SENDFILE
 
     // writ it
@@ -345,6 +562,12 @@ tb_long_t tb_file_preadv(tb_file_ref_t file, tb_iovec_t const* list, tb_size_t s
     tb_assert(tb_memberof_eq(tb_iovec_t, data, struct iovec, iov_base));
     tb_assert(tb_memberof_eq(tb_iovec_t, size, struct iovec, iov_len));
 
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+    // attempt to read it in coroutine
+    if (tb_coroutine_self()) return tb_file_io_wait_rw(TB_FILE_IO_CODE_READ, file, list, size, (tb_hong_t)offset);
+#endif
+
     // read it
 #ifdef TB_CONFIG_POSIX_HAVE_PREADV
     return preadv(tb_file2fd(file), (struct iovec const*)list, size, offset);
@@ -379,6 +602,12 @@ tb_long_t tb_file_pwritv(tb_file_ref_t file, tb_iovec_t const* list, tb_size_t s
     tb_assert(tb_memberof_eq(tb_iovec_t, data, struct iovec, iov_base));
     tb_assert(tb_memberof_eq(tb_iovec_t, size, struct iovec, iov_len));
 
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE)
+    // attempt to writ it in coroutine
+    if (tb_coroutine_self()) return tb_file_io_wait_rw(TB_FILE_IO_CODE_WRIT, file, list, size, (tb_hong_t)offset);
+#endif
+
     // writ it
 #ifdef TB_CONFIG_POSIX_HAVE_PWRITEV
     return pwritev(tb_file2fd(file), (struct iovec const*)list, size, offset);
@@ -55,9 +55,71 @@
 #   define SO_NOSIGPIPE MSG_NOSIGNAL
 #endif
 
+// send file on the thread pool in coroutine?
+#if defined(TB_CONFIG_MODULE_HAVE_COROUTINE) \
+        && !defined(TB_CONFIG_MICRO_ENABLE) \
+        && (defined(TB_CONFIG_POSIX_HAVE_SENDFILE) || defined(TB_CONFIG_OS_MACOSX) || defined(TB_CONFIG_OS_IOS))
+#   define TB_SOCKET_SENDF_WAITCALL
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+#ifdef TB_SOCKET_SENDF_WAITCALL
+
+// the sendfile type for coroutine, it will be allocated on the heap and be done on the thread pool
+typedef struct __tb_socket_sendf_t
+{
+    // the socket
+    tb_socket_ref_t         sock;
+
+    // the file
+    tb_file_ref_t           file;
+
+    // the offset
+    tb_hize_t               offset;
+
+    // the size
+    tb_hize_t               size;
+
+}tb_socket_sendf_t;
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
+#ifdef TB_SOCKET_SENDF_WAITCALL
+static tb_long_t tb_socket_sendf_done(tb_cpointer_t priv)
+{
+    // check
+    tb_socket_sendf_t* sendf = (tb_socket_sendf_t*)priv;
+    tb_assert_and_check_return_val(sendf, -1);
+
+    // send it on the thread pool, we are not in coroutine now
+    return (tb_long_t)tb_socket_sendf(sendf->sock, sendf->file, sendf->offset, sendf->size);
+}
+static tb_void_t tb_socket_sendf_exit(tb_cpointer_t priv)
+{
+    // exit it
+    if (priv) tb_free((tb_pointer_t)priv);
+}
+static tb_bool_t tb_socket_sendf_nowait(tb_file_ref_t file, tb_hize_t offset)
+{
+#if defined(TB_CONFIG_POSIX_HAVE_PREADV2) && defined(RWF_NOWAIT)
+    /* is the file data at the given offset in the page cache?
+     *
+     * we only probe the first byte, and the following pages are usually cached by the readahead,
+     * and it will return EAGAIN if it is not cached or EOPNOTSUPP for the old kernel
+     */
+    tb_byte_t       data = 0;
+    struct iovec    list = {&data, 1};
+    return preadv2(tb_sock2fd(file), &list, 1, (off_t)offset, RWF_NOWAIT) >= 0;
+#else
+    // we do not know whether it will be blocked by reading the disk
+    return tb_false;
+#endif
+}
+#endif
 static tb_int_t tb_socket_type(tb_size_t type)
 {
     // get socket type
@@ -624,6 +686,27 @@ tb_hong_t tb_socket_sendf(tb_socket_ref_t sock, tb_file_ref_t file, tb_hize_t of
     // check
     tb_assert_and_check_return_val(sock && file && size, -1);
 
+#ifdef TB_SOCKET_SENDF_WAITCALL
+    /* attempt to send it on the thread pool in coroutine
+     *
+     * the socket is non-blocking, but sendfile() may be blocked by reading the disk,
+     * so we send it directly only if the file data has been cached
+     *
+     * the result of the blocking call is tb_long_t, so we send it partially if it's too large
+     */
+    if (tb_coroutine_self() && !tb_socket_sendf_nowait(file, offset))
+    {
+        tb_socket_sendf_t* sendf = tb_malloc0_type(tb_socket_sendf_t);
+        tb_assert_and_check_return_val(sendf, -1);
+
+        sendf->sock     = sock;
+        sendf->file     = file;
+        sendf->offset   = offset;
+        sendf->size     = tb_min(size, (tb_hize_t)TB_MAXS32);
+        return (tb_hong_t)tb_coroutine_waitcall(tb_socket_sendf_done, tb_socket_sendf_exit, sendf);
+    }
+#endif
+
 #if defined(TB_CONFIG_POSIX_HAVE_SENDFILE)
 
     // send it
@@ -24,8 +24,13 @@
  */
 #include "prefix.h"
 #include "../virtual_memory.h"
+#include "../page.h"
 #include "../../memory/impl/prefix.h"
 #include <sys/mman.h>
+#if defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)
+#   include <unistd.h>
+#   include <sys/syscall.h>
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -34,26 +39,111 @@
 #   define MAP_ANONYMOUS MAP_ANON
 #endif
 
+// the preferred numa memory policy for mbind
+#define TB_VIRTUAL_MEMORY_MPOL_PREFERRED        (1)
+
+// the page count of each mincore() call
+#define TB_VIRTUAL_MEMORY_MINCORE_PAGEN         (256)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the virtual memory block head type
+typedef struct __tb_virtual_memory_head_t
+{
+    // the real mapped size
+    tb_size_t               real;
+
+    // the flags
+    tb_size_t               flags;
+
+    /* the data head
+     *
+     * @note we use tb_pool_data_head_t to support tb_pool_data_size() when checking memory in debug mode
+     */
+    tb_pool_data_head_t     base;
+
+}tb_virtual_memory_head_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_virtual_memory_numa_bind(tb_pointer_t data, tb_size_t size, tb_size_t node)
+{
+#if (defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)) && defined(SYS_mbind)
+    /* prefer the given node and allow to fallback to the other nodes if this node has no enough memory
+     *
+     * @note the kernel only uses (maxnode - 1) bits
+     */
+    unsigned long nodemask = 1UL << node;
+    if (syscall(SYS_mbind, data, size, TB_VIRTUAL_MEMORY_MPOL_PREFERRED, &nodemask, sizeof(nodemask) * 8 + 1, 0) != 0)
+    {
+        // trace, the pages will be placed by the first-touch policy
+        tb_trace_d("mbind(%p, %lu, %lu) failed", data, size, node);
+    }
+#endif
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
 tb_pointer_t tb_virtual_memory_malloc(tb_size_t size)
+{
+    return tb_virtual_memory_malloc_with_flags(size, TB_VIRTUAL_MEMORY_FLAG_NONE);
+}
+tb_pointer_t tb_virtual_memory_malloc_with_flags(tb_size_t size, tb_size_t flags)
 {
     // check
     tb_check_return_val(size, tb_null);
     tb_assert_and_check_return_val(size >= TB_VIRTUAL_MEMORY_DATA_MINN, tb_null);
 
-    /* allocate an anonymous mmap buffer
-     *
-     * @note we use tb_pool_data_head_t to support tb_pool_data_size() when checking memory in debug mode
-     */
-    tb_pool_data_head_t* block = mmap(tb_null, sizeof(tb_pool_data_head_t) + size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-    if (block)
+    // the need size
+    tb_size_t need = sizeof(tb_virtual_memory_head_t) + size;
+
+    // attempt to allocate it from the reserved huge pages first
+    tb_size_t                   real = 0;
+    tb_virtual_memory_head_t*   block = (tb_virtual_memory_head_t*)MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (flags & TB_VIRTUAL_MEMORY_FLAG_HUGETLB)
+    {
+        // the huge page flags, we need the fixed huge page size for munmap()
+        tb_int_t hugetlb = MAP_HUGETLB;
+#   ifdef MAP_HUGE_2MB
+        hugetlb |= MAP_HUGE_2MB;
+#   endif
+
+        // the size must be aligned by the huge page size
+        real = tb_align(need, TB_VIRTUAL_MEMORY_HUGEPAGE_SIZE);
+        block = (tb_virtual_memory_head_t*)mmap(tb_null, real, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | hugetlb, -1, 0);
+
+        // trace
+        if (block == MAP_FAILED) tb_trace_d("mmap(%lu) with huge pages failed, fallback to the normal pages", real);
+    }
+#endif
+
+    // allocate an anonymous mmap buffer
+    if (block == MAP_FAILED)
     {
-        block->size = size;
-        return (tb_pointer_t)&block[1];
+        real = need;
+        block = (tb_virtual_memory_head_t*)mmap(tb_null, real, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        tb_check_return_val(block != MAP_FAILED, tb_null);
+
+#ifdef MADV_HUGEPAGE
+        // advise the transparent huge pages, it will be ignored if THP is disabled
+        if (flags & TB_VIRTUAL_MEMORY_FLAG_THP) madvise((tb_pointer_t)block, real, MADV_HUGEPAGE);
+#endif
     }
-    return tb_null;
+
+    // bind the numa node before touching these pages
+    if (flags & TB_VIRTUAL_MEMORY_FLAG_NUMA)
+        tb_virtual_memory_numa_bind((tb_pointer_t)block, real, tb_virtual_memory_flag_numa_node(flags));
+
+    // init block
+    block->real         = real;
+    block->flags        = flags;
+    block->base.size    = size;
+    return (tb_pointer_t)&block[1];
 }
 tb_pointer_t tb_virtual_memory_ralloc(tb_pointer_t data, tb_size_t size)
 {
@@ -66,25 +156,98 @@ tb_pointer_t tb_virtual_memory_ralloc(tb_pointer_t data, tb_size_t size)
     else
     {
         // shrink size? return it directly
-        tb_pool_data_head_t* block = &((tb_pool_data_head_t*)data)[-1];
-        if (size <= block->size)
+        tb_virtual_memory_head_t* block = &((tb_virtual_memory_head_t*)data)[-1];
+        if (size <= block->base.size)
             return data;
 
-        // allocate a new anonymous map buffer
-        tb_pointer_t data_new = tb_virtual_memory_malloc(size);
-        if (data_new) tb_memcpy(data_new, data, block->size);
+        // allocate a new anonymous map buffer with the same flags
+        tb_pointer_t data_new = tb_virtual_memory_malloc_with_flags(size, block->flags);
+        if (data_new) tb_memcpy(data_new, data, block->base.size);
         tb_virtual_memory_free(data);
         return data_new;
     }
 }
 tb_bool_t tb_virtual_memory_free(tb_pointer_t data)
 {
-    tb_pool_data_head_t* block = (tb_pool_data_head_t*)data;
+    tb_virtual_memory_head_t* block = (tb_virtual_memory_head_t*)data;
     if (block)
     {
         block--;
-        return munmap((tb_pointer_t)block, sizeof(tb_pool_data_head_t) + block->size) == 0;
+        return munmap((tb_pointer_t)block, block->real) == 0;
     }
     return tb_true;
 }
+tb_pointer_t tb_virtual_memory_guard_malloc(tb_size_t size, tb_size_t guard)
+{
+    // check
+    tb_size_t pagesize = tb_page_size();
+    tb_assert_and_check_return_val(size && pagesize && !(size & (pagesize - 1)) && !(guard & (pagesize - 1)), tb_null);
+
+    // the map flags
+    tb_int_t flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+
+    // reserve the guard and data pages, the data pages will be committed when they are touched
+    tb_byte_t* base = (tb_byte_t*)mmap(tb_null, guard + size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    tb_check_return_val(base != (tb_byte_t*)MAP_FAILED, tb_null);
+
+    // protect the guard pages
+    if (guard && mprotect(base, guard, PROT_NONE) != 0)
+    {
+        munmap(base, guard + size);
+        return tb_null;
+    }
+    return base + guard;
+}
+tb_bool_t tb_virtual_memory_guard_free(tb_pointer_t data, tb_size_t size, tb_size_t guard)
+{
+    return data? munmap((tb_byte_t*)data - guard, guard + size) == 0 : tb_true;
+}
+tb_bool_t tb_virtual_memory_decommit(tb_pointer_t data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(data, tb_false);
+    tb_check_return_val(size, tb_true);
+
+#if defined(MADV_DONTNEED)
+    return madvise(data, size, MADV_DONTNEED) == 0;
+#elif defined(POSIX_MADV_DONTNEED)
+    return posix_madvise(data, size, POSIX_MADV_DONTNEED) == 0;
+#else
+    return tb_false;
+#endif
+}
+tb_long_t tb_virtual_memory_committed(tb_pointer_t data, tb_size_t size)
+{
+    // check
+    tb_size_t pagesize = tb_page_size();
+    tb_assert_and_check_return_val(data && pagesize && !((tb_size_t)data & (pagesize - 1)), -1);
+    tb_check_return_val(size, 0);
+
+#if defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID) || \
+    defined(TB_CONFIG_OS_MACOSX) || defined(TB_CONFIG_OS_IOS) || defined(TB_CONFIG_OS_BSD)
+    // query the resident pages part by part
+    tb_byte_t   vec[TB_VIRTUAL_MEMORY_MINCORE_PAGEN];
+    tb_byte_t*  p = (tb_byte_t*)data;
+    tb_byte_t*  e = p + size;
+    while (p < e)
+    {
+        // get the resident states of the current part
+        tb_size_t n = tb_min((tb_size_t)(e - p + pagesize - 1) / pagesize, (tb_size_t)TB_VIRTUAL_MEMORY_MINCORE_PAGEN);
+        if (mincore((tb_pointer_t)p, n * pagesize, (tb_pointer_t)vec) != 0) return -1;
 
+        // some pages are committed?
+        tb_size_t i = 0;
+        for (i = 0; i < n; i++)
+        {
+            if (vec[i] & 0x1) return 1;
+        }
+        p += n * pagesize;
+    }
+    return 0;
+#else
+    return -1;
+#endif
+}
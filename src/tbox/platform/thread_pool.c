@@ -30,6 +30,7 @@
  * includes
  */
 #include "platform.h"
+#include "impl/ws_deque.h"
 #include "../utils/utils.h"
 #include "../memory/memory.h"
 #include "../container/container.h"
@@ -74,6 +75,13 @@
 #   define TB_THREAD_POOL_JOBS_PULL_TIME_MAXN   (20000)
 #endif
 
+// the free jobs cache maxn of each worker for the work-stealing mode
+#ifdef __tb_small__
+#   define TB_THREAD_POOL_JOBS_CACHE_MAXN       (64)
+#else
+#   define TB_THREAD_POOL_JOBS_CACHE_MAXN       (256)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -100,6 +108,9 @@ typedef struct __tb_thread_pool_job_t
     // the entry
     tb_list_entry_t                     entry;
 
+    // the next free job in the cache of worker for the work-stealing mode
+    struct __tb_thread_pool_job_t*      next;
+
 }tb_thread_pool_job_t;
 
 // the thread pool job stats type
@@ -148,6 +159,15 @@ typedef struct __tb_thread_pool_worker_t
     // is stoped?
     tb_atomic_flag_t                    bstoped;
 
+    // the local run queue for the work-stealing mode, it can be stolen by the other workers
+    tb_ws_deque_t                       runq;
+
+    // the free jobs cache for the work-stealing mode, only be accessed by this worker
+    tb_thread_pool_job_t*               jobs_free;
+
+    // the free jobs count in cache
+    tb_size_t                           jobs_free_count;
+
     // the private data
     tb_thread_pool_worker_priv_t        priv[TB_THREAD_POOL_WORKER_PRIV_MAXN];
 
@@ -162,6 +182,9 @@ typedef struct __tb_thread_pool_impl_t
     // the worker maxn
     tb_size_t                           worker_maxn;
 
+    // the scheduling mode
+    tb_size_t                           mode;
+
     // the lock
     tb_spinlock_t                       lock;
 
@@ -186,11 +209,34 @@ typedef struct __tb_thread_pool_impl_t
     // the worker size
     tb_size_t                           worker_size;
 
+    // the jobs count in the urgent and waiting jobs for the work-stealing mode
+    tb_atomic_t                         jobs_injected;
+
+    // the alive jobs count for the work-stealing mode
+    tb_atomic_t                         jobs_count;
+
+    // the idle workers count for the work-stealing mode
+    tb_atomic32_t                       idlen;
+
+    // the searching workers count for the work-stealing mode, they have been waked up but not got jobs
+    tb_atomic32_t                       searching;
+
     // the worker list
     tb_thread_pool_worker_t             worker_list[TB_THREAD_POOL_WORKER_MAXN];
 
 }tb_thread_pool_impl_t;
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the current worker for the work-stealing mode
+#ifdef __tb_thread_local__
+static __tb_thread_local__ tb_thread_pool_worker_t* g_worker_self = tb_null;
+#else
+static tb_thread_local_t                            g_worker_self = TB_THREAD_LOCAL_INIT;
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * instance implementation
  */
@@ -743,6 +789,371 @@ static tb_thread_pool_job_t* tb_thread_pool_jobs_post_task(tb_thread_pool_impl_t
     return job;
 }
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * stealing implementation
+ */
+static tb_thread_pool_worker_t* tb_thread_pool_stealing_self(tb_thread_pool_impl_t* impl)
+{
+    // get the worker of the current thread
+#ifdef __tb_thread_local__
+    tb_thread_pool_worker_t* worker = g_worker_self;
+#else
+    tb_thread_pool_worker_t* worker = (tb_thread_pool_worker_t*)tb_thread_local_get(&g_worker_self);
+#endif
+
+    // is the worker of this pool?
+    return (worker && worker->pool == (tb_thread_pool_ref_t)impl)? worker : tb_null;
+}
+static tb_void_t tb_thread_pool_stealing_wake(tb_thread_pool_impl_t* impl)
+{
+    // check
+    tb_assert(impl);
+
+    /* some workers are searching jobs? they will get it, so we need not wake up the idle workers
+     *
+     * the atomic add is also a full memory barrier between pushing job and loading the searching and idle count,
+     * so we will not lose the wakeup if the worker is entering the idle state at the same time
+     */
+    tb_check_return(!tb_atomic32_fetch_and_add(&impl->searching, 0));
+
+    // wake up only one idle worker, it will wake up the next worker if there are still jobs after getting one
+    if (tb_atomic32_get(&impl->idlen) > 0) tb_thread_pool_worker_post(impl, 1);
+}
+static tb_thread_pool_job_t* tb_thread_pool_stealing_job_make(tb_thread_pool_impl_t* impl, tb_thread_pool_worker_t* worker)
+{
+    // check
+    tb_assert(impl);
+
+    // get a free job from the local cache of worker first
+    tb_thread_pool_job_t* job = tb_null;
+    if (worker && worker->jobs_free)
+    {
+        job = worker->jobs_free;
+        worker->jobs_free = job->next;
+        worker->jobs_free_count--;
+        job->next = tb_null;
+    }
+    // make job from the jobs pool
+    else
+    {
+        tb_spinlock_enter(&impl->lock);
+        job = (tb_thread_pool_job_t*)tb_fixed_pool_malloc0(impl->jobs_pool);
+        tb_spinlock_leave(&impl->lock);
+    }
+    return job;
+}
+static tb_void_t tb_thread_pool_stealing_job_free(tb_thread_pool_impl_t* impl, tb_thread_pool_worker_t* worker, tb_thread_pool_job_t* job)
+{
+    // check
+    tb_assert(impl && job);
+
+    // cache it to the current worker
+    if (worker && worker->jobs_free_count < TB_THREAD_POOL_JOBS_CACHE_MAXN)
+    {
+        job->next = worker->jobs_free;
+        worker->jobs_free = job;
+        worker->jobs_free_count++;
+    }
+    // free it to the jobs pool
+    else
+    {
+        tb_spinlock_enter(&impl->lock);
+        tb_fixed_pool_free(impl->jobs_pool, job);
+        tb_spinlock_leave(&impl->lock);
+    }
+
+    // update the alive jobs count after freeing it, tb_thread_pool_exit() may be waiting it
+    tb_atomic_fetch_and_sub(&impl->jobs_count, 1);
+}
+static tb_void_t tb_thread_pool_stealing_job_exit(tb_thread_pool_impl_t* impl, tb_thread_pool_worker_t* worker, tb_thread_pool_job_t* job)
+{
+    // check
+    tb_assert(impl && job);
+
+    // free it if the task handle has been exited
+    if (tb_atomic32_fetch_and_sub(&job->refn, 1) == 1)
+        tb_thread_pool_stealing_job_free(impl, worker, job);
+}
+static tb_thread_pool_job_t* tb_thread_pool_stealing_post_task(tb_thread_pool_impl_t* impl, tb_thread_pool_task_t const* task, tb_int32_t refn)
+{
+    // check
+    tb_assert_and_check_return_val(impl && task && task->done, tb_null);
+
+    // stoped?
+    tb_check_return_val(!impl->bstoped, tb_null);
+
+    // make job
+    tb_thread_pool_worker_t*    worker = tb_thread_pool_stealing_self(impl);
+    tb_thread_pool_job_t*       job = tb_thread_pool_stealing_job_make(impl, worker);
+    tb_assert_and_check_return_val(job, tb_null);
+
+    // init job
+    tb_atomic32_init(&job->refn, refn);
+    tb_atomic32_init(&job->state, TB_STATE_WAITING);
+    job->task = *task;
+    tb_atomic_fetch_and_add(&impl->jobs_count, 1);
+
+    // trace
+    tb_trace_d("task[%p:%s]: post to %s", task->done, task->name, worker && !task->urgent? "local" : "global");
+
+    // push it to the local run queue if we are in the worker thread, the urgent job need be handled first by all workers
+    if (!worker || task->urgent || !tb_ws_deque_push(&worker->runq, job))
+    {
+        // post it to the urgent or waiting jobs
+        tb_bool_t ok = tb_false;
+        tb_spinlock_enter(&impl->lock);
+        if (tb_list_entry_size(&impl->jobs_waiting) + tb_list_entry_size(&impl->jobs_urgent) + 1 < TB_THREAD_POOL_JOBS_WAITING_MAXN)
+        {
+            tb_list_entry_insert_tail(task->urgent? &impl->jobs_urgent : &impl->jobs_waiting, &job->entry);
+            tb_atomic_fetch_and_add(&impl->jobs_injected, 1);
+            ok = tb_true;
+        }
+        tb_spinlock_leave(&impl->lock);
+
+        // failed? free it
+        if (!ok)
+        {
+            tb_thread_pool_stealing_job_free(impl, worker, job);
+            return tb_null;
+        }
+    }
+
+    // wake up the idle workers
+    tb_thread_pool_stealing_wake(impl);
+    return job;
+}
+static tb_thread_pool_job_t* tb_thread_pool_stealing_pull(tb_thread_pool_impl_t* impl)
+{
+    // check
+    tb_assert(impl);
+
+    // no urgent and waiting jobs?
+    tb_check_return_val(tb_atomic_get_explicit(&impl->jobs_injected, TB_ATOMIC_RELAXED), tb_null);
+
+    // pull a job from the urgent jobs first, and then the waiting jobs
+    tb_thread_pool_job_t* job = tb_null;
+    tb_spinlock_enter(&impl->lock);
+    tb_list_entry_head_ref_t jobs = tb_list_entry_size(&impl->jobs_urgent)? &impl->jobs_urgent : &impl->jobs_waiting;
+    if (tb_list_entry_size(jobs))
+    {
+        job = (tb_thread_pool_job_t*)tb_list_entry(jobs, tb_list_entry_head(jobs));
+        tb_list_entry_remove_head(jobs);
+        tb_atomic_fetch_and_sub(&impl->jobs_injected, 1);
+    }
+    tb_spinlock_leave(&impl->lock);
+    return job;
+}
+static tb_thread_pool_job_t* tb_thread_pool_stealing_steal(tb_thread_pool_impl_t* impl, tb_thread_pool_worker_t* worker)
+{
+    // check
+    tb_assert(impl && worker);
+
+    // steal it from the top of the other run queues
+    tb_thread_pool_job_t*   job = tb_null;
+    tb_size_t               i = 1;
+    tb_size_t               n = impl->worker_size;
+    for (i = 1; i < n && !job; i++)
+        job = (tb_thread_pool_job_t*)tb_ws_deque_steal(&impl->worker_list[(worker->id + i) % n].runq);
+
+    // trace
+    if (job) tb_trace_d("worker[%lu]: steal: task[%p:%s]", worker->id, job->task.done, job->task.name);
+    return job;
+}
+static tb_bool_t tb_thread_pool_stealing_has_jobs(tb_thread_pool_impl_t* impl)
+{
+    // check
+    tb_assert(impl);
+
+    // exists urgent or waiting jobs?
+    tb_check_return_val(!tb_atomic_get(&impl->jobs_injected), tb_true);
+
+    // exists jobs in the run queues?
+    tb_size_t i = 0;
+    tb_size_t n = impl->worker_size;
+    for (i = 0; i < n; i++)
+    {
+        if (tb_ws_deque_size(&impl->worker_list[i].runq))
+            return tb_true;
+    }
+    return tb_false;
+}
+static tb_void_t tb_thread_pool_stealing_done(tb_thread_pool_impl_t* impl, tb_thread_pool_worker_t* worker, tb_thread_pool_job_t* job)
+{
+    // check
+    tb_assert(impl && worker && job && job->task.done);
+
+    // the job is waiting? work it
+    tb_int32_t state = TB_STATE_WAITING;
+    if (tb_atomic32_compare_and_swap(&job->state, &state, TB_STATE_WORKING))
+    {
+        // trace
+        tb_trace_d("worker[%lu]: done: task[%p:%s]: ..", worker->id, job->task.done, job->task.name);
+
+        // done the job
+        job->task.done((tb_thread_pool_worker_ref_t)worker, job->task.priv);
+
+        // update the job state
+        tb_atomic32_set(&job->state, TB_STATE_FINISHED);
+    }
+    // the job is killing? kill it
+    else if (state == TB_STATE_KILLING)
+    {
+        // update the job state
+        tb_atomic32_set(&job->state, TB_STATE_KILLED);
+    }
+
+    // exit the job, we need not clean it from the pending jobs lazily
+    if (job->task.exit) job->task.exit((tb_thread_pool_worker_ref_t)worker, job->task.priv);
+    tb_thread_pool_stealing_job_exit(impl, worker, job);
+}
+static tb_int_t tb_thread_pool_stealing_loop(tb_cpointer_t priv)
+{
+    // the worker
+    tb_thread_pool_worker_t* worker = (tb_thread_pool_worker_t*)priv;
+    tb_assert_and_check_return_val(worker, -1);
+
+    // the pool
+    tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)worker->pool;
+    tb_assert_and_check_return_val(impl && impl->semaphore, -1);
+
+    // trace
+    tb_trace_d("worker[%lu]: init", worker->id);
+
+    // save the current worker
+#ifdef __tb_thread_local__
+    g_worker_self = worker;
+#else
+    if (tb_thread_local_init(&g_worker_self, tb_null)) tb_thread_local_set(&g_worker_self, worker);
+#endif
+
+    // loop
+    tb_bool_t searching = tb_false;
+    while (1)
+    {
+        // pop a job from the local run queue first (lifo), it's more cache-friendly
+        tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)tb_ws_deque_pop(&worker->runq);
+
+        // pull a job from the urgent and waiting jobs
+        if (!job) job = tb_thread_pool_stealing_pull(impl);
+
+        // steal a job from the other workers before sleeping
+        if (!job) job = tb_thread_pool_stealing_steal(impl, worker);
+
+        // done it
+        if (job)
+        {
+            // stop searching, we need wake up the next worker if we are the last searching worker and there are still jobs
+            if (searching)
+            {
+                searching = tb_false;
+                if (tb_atomic32_fetch_and_sub(&impl->searching, 1) == 1 && tb_thread_pool_stealing_has_jobs(impl))
+                    tb_thread_pool_stealing_wake(impl);
+            }
+
+            // done it
+            tb_thread_pool_stealing_done(impl, worker, job);
+            continue;
+        }
+
+        // stop searching before entering the idle state, the posters will wake up the idle workers now
+        if (searching)
+        {
+            searching = tb_false;
+            tb_atomic32_fetch_and_sub(&impl->searching, 1);
+        }
+
+        // killed?
+        tb_check_break(!tb_atomic_flag_test_explicit(&worker->bstoped, TB_ATOMIC_RELAXED));
+
+        // enter the idle state, the atomic add is also a full memory barrier
+        tb_atomic32_fetch_and_add(&impl->idlen, 1);
+
+        // check again, we may lose the wakeup from the posters
+        if (tb_thread_pool_stealing_has_jobs(impl) || tb_atomic_flag_test(&worker->bstoped))
+        {
+            tb_atomic32_fetch_and_sub(&impl->idlen, 1);
+            continue;
+        }
+
+        // trace
+        tb_trace_d("worker[%lu]: wait: ..", worker->id);
+
+        // wait some time
+        tb_long_t wait = tb_semaphore_wait(impl->semaphore, -1);
+
+        // we are searching jobs after waking up
+        searching = tb_true;
+        tb_atomic32_fetch_and_add(&impl->searching, 1);
+        tb_atomic32_fetch_and_sub(&impl->idlen, 1);
+        tb_assert_and_check_break(wait > 0);
+    }
+
+    // stop searching
+    if (searching) tb_atomic32_fetch_and_sub(&impl->searching, 1);
+
+    // trace
+    tb_trace_d("worker[%lu]: exit", worker->id);
+
+    // stop it
+    tb_atomic_flag_test_and_set_explicit(&worker->bstoped, TB_ATOMIC_RELAXED);
+
+    // exit all private data
+    tb_size_t i = 0;
+    tb_size_t n = tb_arrayn(worker->priv);
+    for (i = 0; i < n; i++)
+    {
+        // the private data
+        tb_thread_pool_worker_priv_t* priv = &worker->priv[n - i - 1];
+
+        // exit it
+        if (priv->exit) priv->exit((tb_thread_pool_worker_ref_t)worker, priv->priv);
+
+        // clear it
+        priv->exit = tb_null;
+        priv->priv = tb_null;
+    }
+
+    // clear the current worker
+#ifdef __tb_thread_local__
+    g_worker_self = tb_null;
+#else
+    tb_thread_local_set(&g_worker_self, tb_null);
+#endif
+    return 0;
+}
+static tb_bool_t tb_thread_pool_stealing_init(tb_thread_pool_impl_t* impl)
+{
+    // check
+    tb_assert_and_check_return_val(impl, tb_false);
+
+    // init the run queues of all workers first, the thieves will access them
+    tb_size_t i = 0;
+    tb_size_t n = impl->worker_maxn;
+    for (i = 0; i < n; i++)
+    {
+        // the worker
+        tb_thread_pool_worker_t* worker = &impl->worker_list[i];
+
+        // init worker
+        tb_memset(worker, 0, sizeof(tb_thread_pool_worker_t));
+        tb_atomic_flag_clear_explicit(&worker->bstoped, TB_ATOMIC_RELAXED);
+        worker->id      = i;
+        worker->pool    = (tb_thread_pool_ref_t)impl;
+        if (!tb_ws_deque_init(&worker->runq, 0)) break;
+    }
+    impl->worker_size = i;
+    tb_assert_and_check_return_val(i == n, tb_false);
+
+    // start all workers
+    for (i = 0; i < n; i++)
+    {
+        tb_thread_pool_worker_t* worker = &impl->worker_list[i];
+        worker->loop = tb_thread_init(__tb_lstring__("thread_pool"), tb_thread_pool_stealing_loop, worker, impl->stack);
+        tb_assert_and_check_return_val(worker->loop, tb_false);
+    }
+    return tb_true;
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -751,6 +1162,10 @@ tb_thread_pool_ref_t tb_thread_pool()
     return (tb_thread_pool_ref_t)tb_singleton_instance(TB_SINGLETON_TYPE_THREAD_POOL, tb_thread_pool_instance_init, tb_thread_pool_instance_exit, tb_thread_pool_instance_kill, tb_null);
 }
 tb_thread_pool_ref_t tb_thread_pool_init(tb_size_t worker_maxn, tb_size_t stack)
+{
+    return tb_thread_pool_init_with_mode(worker_maxn, stack, TB_THREAD_POOL_MODE_SHARED);
+}
+tb_thread_pool_ref_t tb_thread_pool_init_with_mode(tb_size_t worker_maxn, tb_size_t stack, tb_size_t mode)
 {
     // done
     tb_bool_t               ok = tb_false;
@@ -764,13 +1179,19 @@ tb_thread_pool_ref_t tb_thread_pool_init(tb_size_t worker_maxn, tb_size_t stack)
         // init lock
         if (!tb_spinlock_init(&impl->lock)) break;
 
-        // computate the default worker maxn if be zero
-        if (!worker_maxn) worker_maxn = tb_cpu_count() << 2;
+        // computate the default worker maxn if be zero, the work-stealing workers need not be blocked
+        if (!worker_maxn) worker_maxn = mode == TB_THREAD_POOL_MODE_STEALING? tb_cpu_count() : tb_cpu_count() << 2;
         tb_assert_and_check_break(worker_maxn);
 
+        // all workers will be started at once for the work-stealing mode
+        if (mode == TB_THREAD_POOL_MODE_STEALING) worker_maxn = tb_min(worker_maxn, TB_THREAD_POOL_WORKER_MAXN);
+
         // init thread stack
         impl->stack         = stack;
 
+        // init mode
+        impl->mode          = mode;
+
         // init workers
         impl->worker_size   = 0;
         impl->worker_maxn   = worker_maxn;
@@ -797,6 +1218,9 @@ tb_thread_pool_ref_t tb_thread_pool_init(tb_size_t worker_maxn, tb_size_t stack)
         tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&impl->lock, TB_TRACE_MODULE_NAME);
 #endif
 
+        // start all workers for the work-stealing mode
+        if (mode == TB_THREAD_POOL_MODE_STEALING && !tb_thread_pool_stealing_init(impl)) break;
+
         // ok
         ok = tb_true;
 
@@ -858,6 +1282,10 @@ tb_bool_t tb_thread_pool_exit(tb_thread_pool_ref_t pool)
             tb_thread_exit(worker->loop);
             worker->loop = tb_null;
         }
+
+        // exit the run queue, all jobs have been finished or killed
+        if (impl->mode == TB_THREAD_POOL_MODE_STEALING)
+            tb_ws_deque_exit(&worker->runq);
     }
     impl->worker_size = 0;
 
@@ -976,6 +1404,10 @@ tb_size_t tb_thread_pool_task_size(tb_thread_pool_ref_t pool)
     tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)pool;
     tb_assert_and_check_return_val(impl, 0);
 
+    // the alive jobs count for the work-stealing mode
+    if (impl->mode == TB_THREAD_POOL_MODE_STEALING)
+        return (tb_size_t)tb_atomic_get(&impl->jobs_count);
+
     // enter
     tb_spinlock_enter(&impl->lock);
 
@@ -994,6 +1426,18 @@ tb_bool_t tb_thread_pool_task_post(tb_thread_pool_ref_t pool, tb_char_t const* n
     tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)pool;
     tb_assert_and_check_return_val(impl && done, tb_false);
 
+    // post it to the local run queue or the global jobs for the work-stealing mode
+    if (impl->mode == TB_THREAD_POOL_MODE_STEALING)
+    {
+        tb_thread_pool_task_t task = {0};
+        task.name       = name;
+        task.done       = done;
+        task.exit       = exit;
+        task.priv       = priv;
+        task.urgent     = urgent;
+        return tb_thread_pool_stealing_post_task(impl, &task, 1) != tb_null;
+    }
+
     // init the post size
     tb_size_t post_size = 0;
 
@@ -1039,6 +1483,17 @@ tb_size_t tb_thread_pool_task_post_list(tb_thread_pool_ref_t pool, tb_thread_poo
     tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)pool;
     tb_assert_and_check_return_val(impl && list, 0);
 
+    // post them for the work-stealing mode
+    if (impl->mode == TB_THREAD_POOL_MODE_STEALING)
+    {
+        tb_size_t ok = 0;
+        for (ok = 0; ok < size; ok++)
+        {
+            if (!tb_thread_pool_stealing_post_task(impl, &list[ok], 1)) break;
+        }
+        return ok;
+    }
+
     // init the post size
     tb_size_t post_size = 0;
 
@@ -1072,6 +1527,18 @@ tb_thread_pool_task_ref_t tb_thread_pool_task_init(tb_thread_pool_ref_t pool, tb
     tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)pool;
     tb_assert_and_check_return_val(impl && done, tb_null);
 
+    // post it with the task handle reference for the work-stealing mode
+    if (impl->mode == TB_THREAD_POOL_MODE_STEALING)
+    {
+        tb_thread_pool_task_t task = {0};
+        task.name       = name;
+        task.done       = done;
+        task.exit       = exit;
+        task.priv       = priv;
+        task.urgent     = urgent;
+        return (tb_thread_pool_task_ref_t)tb_thread_pool_stealing_post_task(impl, &task, 2);
+    }
+
     // init the post size
     tb_size_t post_size = 0;
 
@@ -1179,6 +1646,15 @@ tb_long_t tb_thread_pool_task_wait_all(tb_thread_pool_ref_t pool, tb_long_t time
     tb_hong_t time = tb_cache_time_spak();
     while ((timeout < 0 || tb_cache_time_spak() < time + timeout))
     {
+        // the alive jobs count for the work-stealing mode, the jobs are usually short, so we poll it more frequently
+        if (impl->mode == TB_THREAD_POOL_MODE_STEALING)
+        {
+            size = (tb_size_t)tb_atomic_get(&impl->jobs_count);
+            tb_check_break(size);
+            tb_msleep(10);
+            continue;
+        }
+
         // enter
         tb_spinlock_enter(&impl->lock);
 
@@ -1222,6 +1698,13 @@ tb_void_t tb_thread_pool_task_exit(tb_thread_pool_ref_t pool, tb_thread_pool_tas
     // kill it first
     tb_thread_pool_task_kill(pool, task);
 
+    // release the task handle reference for the work-stealing mode
+    if (impl->mode == TB_THREAD_POOL_MODE_STEALING)
+    {
+        tb_thread_pool_stealing_job_exit(impl, tb_null, job);
+        return ;
+    }
+
     // enter
     tb_spinlock_enter(&impl->lock);
 
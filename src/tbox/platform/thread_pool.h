@@ -47,6 +47,14 @@ __tb_extern_c_enter__
  * types
  */
 
+/// the thread pool mode enum
+typedef enum __tb_thread_pool_mode_e
+{
+    TB_THREAD_POOL_MODE_SHARED      = 0 //!< all jobs are kept in the shared job lists and pulled by the workers in batches
+,   TB_THREAD_POOL_MODE_STEALING    = 1 //!< each worker has a lock-free local deque and the idle workers steal jobs from the others
+
+}tb_thread_pool_mode_e;
+
 /// the thread pool ref type
 typedef __tb_typeref__(thread_pool);
 
@@ -104,6 +112,21 @@ tb_thread_pool_ref_t        tb_thread_pool(tb_noarg_t);
  */
 tb_thread_pool_ref_t        tb_thread_pool_init(tb_size_t worker_maxn, tb_size_t stack);
 
+/*! init thread pool with the given scheduling mode
+ *
+ * the work-stealing mode is better for a lot of short tasks, all workers will be started at once,
+ * the tasks posted from the worker threads will be pushed to their local deques without locks,
+ * and the idle workers will steal tasks from the other workers before sleeping.
+ *
+ * @param worker_maxn       the thread worker max count, using the default count
+ *                          (the cpu count for the work-stealing mode)
+ * @param stack             the thread stack, using the default stack size if be zero
+ * @param mode              the scheduling mode, e.g. TB_THREAD_POOL_MODE_STEALING
+ *
+ * @return                  the thread pool
+ */
+tb_thread_pool_ref_t        tb_thread_pool_init_with_mode(tb_size_t worker_maxn, tb_size_t stack, tb_size_t mode);
+
 /*! exit thread pool
  *
  * @param pool              the thread pool
@@ -0,0 +1,506 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        thread_pool_graph.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "thread_pool_graph"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "thread_pool_graph.h"
+#include "event.h"
+#include "atomic32.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the tasks grow
+#ifdef __tb_small__
+#   define TB_THREAD_POOL_GRAPH_TASKS_GROW          (16)
+#else
+#   define TB_THREAD_POOL_GRAPH_TASKS_GROW          (64)
+#endif
+
+// the successors grow
+#define TB_THREAD_POOL_GRAPH_SUCCS_GROW             (4)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the thread pool graph task type
+typedef struct __tb_thread_pool_graph_task_t
+{
+    // the graph
+    struct __tb_thread_pool_graph_t*        graph;
+
+    // the task name
+    tb_char_t const*                        name;
+
+    // the task done func
+    tb_thread_pool_task_done_func_t         done;
+
+    // the task exit func
+    tb_thread_pool_task_exit_func_t         exit;
+
+    // the task private data
+    tb_cpointer_t                           priv;
+
+    // the task flags
+    tb_size_t                               flags;
+
+    // the task index in the graph
+    tb_size_t                               index;
+
+    // the successors which depend on this task
+    struct __tb_thread_pool_graph_task_t**  succs;
+
+    // the successors count
+    tb_size_t                               succn;
+
+    // the successors maxn
+    tb_size_t                               succm;
+
+    // the dependencies count
+    tb_size_t                               depn;
+
+    // the pending dependencies count of the current run
+    tb_atomic32_t                           pending;
+
+    // has been cancelled in the current run?
+    tb_atomic32_t                           cancelled;
+
+    // has been done by the thread pool in the current run?
+    tb_bool_t                               finished;
+
+    // the next ready task which will be run inline or cancelled
+    struct __tb_thread_pool_graph_task_t*   next;
+
+}tb_thread_pool_graph_task_t;
+
+// the thread pool graph type
+typedef struct __tb_thread_pool_graph_t
+{
+    // the thread pool
+    tb_thread_pool_ref_t                    pool;
+
+    // the tasks
+    tb_thread_pool_graph_task_t**           tasks;
+
+    // the tasks count
+    tb_size_t                               taskn;
+
+    // the tasks maxn
+    tb_size_t                               taskm;
+
+    // the pending tasks count of the current run
+    tb_atomic32_t                           pending;
+
+    // the cancelled tasks count of the current run
+    tb_atomic32_t                           killed;
+
+    // the finished event
+    tb_event_ref_t                          event;
+
+    // has been started?
+    tb_bool_t                               started;
+
+}tb_thread_pool_graph_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_thread_pool_graph_post(tb_thread_pool_graph_t* graph, tb_thread_pool_graph_task_t* task);
+static tb_void_t tb_thread_pool_graph_task_leave(tb_thread_pool_worker_ref_t worker, tb_thread_pool_graph_task_t* task)
+{
+    // check
+    tb_thread_pool_graph_t* graph = task->graph;
+    tb_assert(graph);
+
+    // cancelled?
+    if (tb_atomic32_get(&task->cancelled)) tb_atomic32_fetch_and_add(&graph->killed, 1);
+
+    // exit the task
+    if (task->exit) task->exit(worker, task->priv);
+
+    // the last task? notify the waiter, the graph may be exited after it
+    if (tb_atomic32_fetch_and_sub(&graph->pending, 1) == 1) tb_event_post(graph->event);
+}
+static tb_void_t tb_thread_pool_graph_task_release(tb_thread_pool_worker_ref_t worker, tb_thread_pool_graph_task_t* task)
+{
+    // check
+    tb_thread_pool_graph_t* graph = task->graph;
+    tb_assert(graph);
+
+    /* release the successors of this task
+     *
+     * the inline continuations and the cancelled successors are run on this worker directly,
+     * we use an intrusive ready list instead of recursion, so the long chain will not overflow the stack.
+     */
+    tb_thread_pool_graph_task_t* ready = tb_null;
+    tb_thread_pool_graph_task_t* current = task;
+    while (current)
+    {
+        // release all successors
+        tb_size_t i = 0;
+        tb_bool_t cancelled = (tb_bool_t)tb_atomic32_get(&current->cancelled);
+        for (i = 0; i < current->succn; i++)
+        {
+            // cancel it if the dependency has been cancelled
+            tb_thread_pool_graph_task_t* succ = current->succs[i];
+            if (cancelled) tb_atomic32_set(&succ->cancelled, 1);
+
+            // is it ready now?
+            if (tb_atomic32_fetch_and_sub(&succ->pending, 1) != 1) continue;
+
+            // post it to the thread pool, it will be pushed to the local deque of this worker in the work-stealing mode
+            if (!tb_atomic32_get(&succ->cancelled) && !(succ->flags & TB_THREAD_POOL_GRAPH_TASK_FLAG_INLINE))
+            {
+                if (tb_thread_pool_graph_post(graph, succ)) continue;
+                tb_atomic32_set(&succ->cancelled, 1);
+            }
+
+            // run or cancel it on this worker
+            succ->next = ready;
+            ready = succ;
+        }
+
+        // leave the finished inline continuation, the posted task will be left in the task exit func
+        if (current != task) tb_thread_pool_graph_task_leave(worker, current);
+
+        // run the next ready task
+        current = ready;
+        if (current)
+        {
+            // trace
+            tb_trace_d("task[%p:%s]: %s inline", current, current->name, tb_atomic32_get(&current->cancelled)? "cancel" : "done");
+
+            // done it
+            ready = current->next;
+            if (!tb_atomic32_get(&current->cancelled)) current->done(worker, current->priv);
+        }
+    }
+}
+static tb_void_t tb_thread_pool_graph_task_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_thread_pool_graph_task_t* task = (tb_thread_pool_graph_task_t*)priv;
+    tb_assert(task && task->done);
+
+    // done it
+    task->done(worker, task->priv);
+    task->finished = tb_true;
+
+    // release the successors as soon as possible, the task exit func may be called later in the shared mode
+    tb_thread_pool_graph_task_release(worker, task);
+}
+static tb_void_t tb_thread_pool_graph_task_exit(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_thread_pool_graph_task_t* task = (tb_thread_pool_graph_task_t*)priv;
+    tb_assert(task);
+
+    // this task has been killed? cancel all its successors
+    if (!task->finished)
+    {
+        // trace
+        tb_trace_d("task[%p:%s]: killed", task, task->name);
+
+        // cancel it
+        tb_atomic32_set(&task->cancelled, 1);
+        tb_thread_pool_graph_task_release(worker, task);
+    }
+
+    // leave it
+    tb_thread_pool_graph_task_leave(worker, task);
+}
+static tb_bool_t tb_thread_pool_graph_post(tb_thread_pool_graph_t* graph, tb_thread_pool_graph_task_t* task)
+{
+    // trace
+    tb_trace_d("task[%p:%s]: post", task, task->name);
+
+    // post it
+    return tb_thread_pool_task_post(graph->pool, task->name, tb_thread_pool_graph_task_done, tb_thread_pool_graph_task_exit, task, (task->flags & TB_THREAD_POOL_GRAPH_TASK_FLAG_URGENT)? tb_true : tb_false);
+}
+static tb_bool_t tb_thread_pool_graph_is_acyclic(tb_thread_pool_graph_t* graph)
+{
+    // make the pending dependencies and the ready queue
+    tb_size_t  taskn = graph->taskn;
+    tb_size_t* data = tb_nalloc_type(taskn << 1, tb_size_t);
+    tb_assert_and_check_return_val(data, tb_false);
+
+    // init the pending dependencies and push all root tasks
+    tb_size_t  i = 0;
+    tb_size_t  tail = 0;
+    tb_size_t* depn = data;
+    tb_size_t* queue = data + taskn;
+    for (i = 0; i < taskn; i++)
+    {
+        depn[i] = graph->tasks[i]->depn;
+        if (!depn[i]) queue[tail++] = i;
+    }
+
+    // visit all tasks in topological order
+    tb_size_t head = 0;
+    while (head < tail)
+    {
+        tb_size_t j = 0;
+        tb_thread_pool_graph_task_t* task = graph->tasks[queue[head++]];
+        for (j = 0; j < task->succn; j++)
+        {
+            tb_size_t index = task->succs[j]->index;
+            if (!--depn[index]) queue[tail++] = index;
+        }
+    }
+    tb_free(data);
+
+    // all tasks have been visited? no cycles
+    return tail == taskn;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_thread_pool_graph_ref_t tb_thread_pool_graph_init(tb_thread_pool_ref_t pool)
+{
+    // done
+    tb_bool_t               ok = tb_false;
+    tb_thread_pool_graph_t* graph = tb_null;
+    do
+    {
+        // check
+        tb_assert_and_check_break(pool);
+
+        // make graph
+        graph = tb_malloc0_type(tb_thread_pool_graph_t);
+        tb_assert_and_check_break(graph);
+
+        // init graph
+        graph->pool = pool;
+        tb_atomic32_init(&graph->pending, 0);
+        tb_atomic32_init(&graph->killed, 0);
+
+        // init event
+        graph->event = tb_event_init();
+        tb_assert_and_check_break(graph->event);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (graph) tb_thread_pool_graph_exit((tb_thread_pool_graph_ref_t)graph);
+        graph = tb_null;
+    }
+
+    // ok?
+    return (tb_thread_pool_graph_ref_t)graph;
+}
+tb_void_t tb_thread_pool_graph_exit(tb_thread_pool_graph_ref_t self)
+{
+    // check
+    tb_thread_pool_graph_t* graph = (tb_thread_pool_graph_t*)self;
+    tb_assert_and_check_return(graph);
+
+    // wait the running tasks
+    if (graph->started) tb_thread_pool_graph_wait(self, -1);
+
+    // exit tasks
+    tb_size_t i = 0;
+    for (i = 0; i < graph->taskn; i++)
+    {
+        tb_thread_pool_graph_task_t* task = graph->tasks[i];
+        if (task->succs) tb_free(task->succs);
+        tb_free(task);
+    }
+    if (graph->tasks) tb_free(graph->tasks);
+    graph->tasks = tb_null;
+
+    // exit event
+    if (graph->event) tb_event_exit(graph->event);
+    graph->event = tb_null;
+
+    // exit it
+    tb_free(graph);
+}
+tb_size_t tb_thread_pool_graph_size(tb_thread_pool_graph_ref_t self)
+{
+    // check
+    tb_thread_pool_graph_t* graph = (tb_thread_pool_graph_t*)self;
+    tb_assert_and_check_return_val(graph, 0);
+
+    // the task count
+    return graph->taskn;
+}
+tb_thread_pool_graph_task_ref_t tb_thread_pool_graph_task_add(tb_thread_pool_graph_ref_t self, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv, tb_size_t flags)
+{
+    // check
+    tb_thread_pool_graph_t* graph = (tb_thread_pool_graph_t*)self;
+    tb_assert_and_check_return_val(graph && done, tb_null);
+
+    // cannot modify the running graph
+    tb_assert_and_check_return_val(!graph->started, tb_null);
+
+    // grow tasks
+    if (graph->taskn >= graph->taskm)
+    {
+        tb_size_t taskm = graph->taskm + TB_THREAD_POOL_GRAPH_TASKS_GROW;
+        graph->tasks = tb_ralloc_type(graph->tasks, taskm, tb_thread_pool_graph_task_t*);
+        tb_assert_and_check_return_val(graph->tasks, tb_null);
+        graph->taskm = taskm;
+    }
+
+    // make task
+    tb_thread_pool_graph_task_t* task = tb_malloc0_type(tb_thread_pool_graph_task_t);
+    tb_assert_and_check_return_val(task, tb_null);
+
+    // init task
+    task->graph = graph;
+    task->name  = name;
+    task->done  = done;
+    task->exit  = exit;
+    task->priv  = priv;
+    task->flags = flags;
+    task->index = graph->taskn;
+    tb_atomic32_init(&task->pending, 0);
+    tb_atomic32_init(&task->cancelled, 0);
+
+    // add it
+    graph->tasks[graph->taskn++] = task;
+    return (tb_thread_pool_graph_task_ref_t)task;
+}
+tb_thread_pool_graph_task_ref_t tb_thread_pool_graph_task_then(tb_thread_pool_graph_ref_t self, tb_thread_pool_graph_task_ref_t task, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv)
+{
+    // check
+    tb_thread_pool_graph_task_t* prev = (tb_thread_pool_graph_task_t*)task;
+    tb_assert_and_check_return_val(self && prev && prev->graph == (tb_thread_pool_graph_t*)self, tb_null);
+
+    // add the continuation task
+    tb_thread_pool_graph_task_ref_t next = tb_thread_pool_graph_task_add(self, name, done, exit, priv, TB_THREAD_POOL_GRAPH_TASK_FLAG_INLINE);
+    tb_check_return_val(next, tb_null);
+
+    // it will be run after the previous task
+    if (!tb_thread_pool_graph_task_depend(self, next, task)) return tb_null;
+    return next;
+}
+tb_bool_t tb_thread_pool_graph_task_depend(tb_thread_pool_graph_ref_t self, tb_thread_pool_graph_task_ref_t task, tb_thread_pool_graph_task_ref_t depend)
+{
+    // check
+    tb_thread_pool_graph_t*      graph = (tb_thread_pool_graph_t*)self;
+    tb_thread_pool_graph_task_t* succ = (tb_thread_pool_graph_task_t*)task;
+    tb_thread_pool_graph_task_t* pred = (tb_thread_pool_graph_task_t*)depend;
+    tb_assert_and_check_return_val(graph && succ && pred && succ != pred, tb_false);
+    tb_assert_and_check_return_val(succ->graph == graph && pred->graph == graph, tb_false);
+
+    // cannot modify the running graph
+    tb_assert_and_check_return_val(!graph->started, tb_false);
+
+    // grow successors
+    if (pred->succn >= pred->succm)
+    {
+        tb_size_t succm = pred->succm + TB_THREAD_POOL_GRAPH_SUCCS_GROW;
+        pred->succs = tb_ralloc_type(pred->succs, succm, tb_thread_pool_graph_task_t*);
+        tb_assert_and_check_return_val(pred->succs, tb_false);
+        pred->succm = succm;
+    }
+
+    // add the dependency
+    pred->succs[pred->succn++] = succ;
+    succ->depn++;
+    return tb_true;
+}
+tb_bool_t tb_thread_pool_graph_start(tb_thread_pool_graph_ref_t self)
+{
+    // check
+    tb_thread_pool_graph_t* graph = (tb_thread_pool_graph_t*)self;
+    tb_assert_and_check_return_val(graph && !graph->started, tb_false);
+
+    // empty graph?
+    tb_check_return_val(graph->taskn, tb_false);
+
+    // check cycles, the cyclic tasks will be never finished
+    if (!tb_thread_pool_graph_is_acyclic(graph))
+    {
+        // trace
+        tb_trace_e("cannot start the cyclic graph!");
+        return tb_false;
+    }
+
+    // reset the state of the current run
+    tb_size_t i = 0;
+    tb_size_t n = graph->taskn;
+    for (i = 0; i < n; i++)
+    {
+        tb_thread_pool_graph_task_t* task = graph->tasks[i];
+        tb_atomic32_set(&task->pending, (tb_int32_t)task->depn);
+        tb_atomic32_set(&task->cancelled, 0);
+        task->finished = tb_false;
+        task->next = tb_null;
+    }
+    tb_atomic32_set(&graph->killed, 0);
+    tb_atomic32_set(&graph->pending, (tb_int32_t)n);
+    graph->started = tb_true;
+
+    /* post all root tasks
+     *
+     * the graph will be not finished before all root tasks have been posted,
+     * so we can access the tasks safely here.
+     */
+    for (i = 0; i < n; i++)
+    {
+        tb_thread_pool_graph_task_t* task = graph->tasks[i];
+        if (task->depn) continue;
+
+        // post it, cancel it and its successors if failed
+        if (!tb_thread_pool_graph_post(graph, task))
+        {
+            tb_atomic32_set(&task->cancelled, 1);
+            tb_thread_pool_graph_task_release(tb_null, task);
+            tb_thread_pool_graph_task_leave(tb_null, task);
+        }
+    }
+
+    // ok
+    return tb_true;
+}
+tb_long_t tb_thread_pool_graph_wait(tb_thread_pool_graph_ref_t self, tb_long_t timeout)
+{
+    // check
+    tb_thread_pool_graph_t* graph = (tb_thread_pool_graph_t*)self;
+    tb_assert_and_check_return_val(graph && graph->event && graph->started, -1);
+
+    // wait it
+    tb_long_t wait = tb_event_wait(graph->event, timeout);
+    tb_check_return_val(wait > 0, wait);
+
+    // finished, we can modify or restart it now
+    graph->started = tb_false;
+    return tb_atomic32_get(&graph->killed)? -1 : 1;
+}
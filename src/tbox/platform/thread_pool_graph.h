@@ -0,0 +1,159 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        thread_pool_graph.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_THREAD_POOL_GRAPH_H
+#define TB_PLATFORM_THREAD_POOL_GRAPH_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "thread_pool.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the thread pool graph task flag enum
+typedef enum __tb_thread_pool_graph_task_flag_e
+{
+    TB_THREAD_POOL_GRAPH_TASK_FLAG_NONE     = 0
+,   TB_THREAD_POOL_GRAPH_TASK_FLAG_URGENT   = 1 //!< post it as the urgent task
+,   TB_THREAD_POOL_GRAPH_TASK_FLAG_INLINE   = 2 //!< run it as a continuation on the worker which has finished its last dependency
+
+}tb_thread_pool_graph_task_flag_e;
+
+/// the thread pool graph ref type
+typedef __tb_typeref__(thread_pool_graph);
+
+/// the thread pool graph task ref type
+typedef __tb_typeref__(thread_pool_graph_task);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the task graph on the given thread pool
+ *
+ * the task will be runnable after all its dependencies have been finished,
+ * the ready tasks are posted by the worker which has finished their last dependency,
+ * so they will be pushed to the local deque of this worker in the work-stealing mode.
+ *
+ * @code
+    tb_thread_pool_graph_ref_t      graph       = tb_thread_pool_graph_init(tb_thread_pool());
+    tb_thread_pool_graph_task_ref_t parse       = tb_thread_pool_graph_task_add(graph, "parse", parse_done, tb_null, data, 0);
+    tb_thread_pool_graph_task_ref_t transform   = tb_thread_pool_graph_task_then(graph, parse, "transform", transform_done, tb_null, data);
+    tb_thread_pool_graph_task_ref_t compress    = tb_thread_pool_graph_task_add(graph, "compress", compress_done, tb_null, data, 0);
+    tb_thread_pool_graph_task_depend(graph, compress, transform);
+    if (tb_thread_pool_graph_start(graph)) tb_thread_pool_graph_wait(graph, -1);
+    tb_thread_pool_graph_exit(graph);
+ * @endcode
+ *
+ * @param pool              the thread pool
+ *
+ * @return                  the graph
+ */
+tb_thread_pool_graph_ref_t  tb_thread_pool_graph_init(tb_thread_pool_ref_t pool);
+
+/*! exit the task graph, it will wait the running tasks if the graph has been started
+ *
+ * @param graph             the graph
+ */
+tb_void_t                   tb_thread_pool_graph_exit(tb_thread_pool_graph_ref_t graph);
+
+/*! the task count of the graph
+ *
+ * @param graph             the graph
+ *
+ * @return                  the task count
+ */
+tb_size_t                   tb_thread_pool_graph_size(tb_thread_pool_graph_ref_t graph);
+
+/*! add one task to the graph
+ *
+ * @note the task exit func will be called after each run of the graph
+ *
+ * @param graph             the graph
+ * @param name              the task name, optional
+ * @param done              the task done func
+ * @param exit              the task exit func, optional
+ * @param priv              the task private data
+ * @param flags             the task flags, e.g. TB_THREAD_POOL_GRAPH_TASK_FLAG_INLINE
+ *
+ * @return                  the graph task
+ */
+tb_thread_pool_graph_task_ref_t tb_thread_pool_graph_task_add(tb_thread_pool_graph_ref_t graph, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv, tb_size_t flags);
+
+/*! add one continuation task which will be run inline after the given task
+ *
+ * @param graph             the graph
+ * @param task              the previous task
+ * @param name              the task name, optional
+ * @param done              the task done func
+ * @param exit              the task exit func, optional
+ * @param priv              the task private data
+ *
+ * @return                  the graph task
+ */
+tb_thread_pool_graph_task_ref_t tb_thread_pool_graph_task_then(tb_thread_pool_graph_ref_t graph, tb_thread_pool_graph_task_ref_t task, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv);
+
+/*! the task depends on the given task
+ *
+ * @param graph             the graph
+ * @param task              the task
+ * @param depend            the dependent task which will be finished before this task
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_thread_pool_graph_task_depend(tb_thread_pool_graph_ref_t graph, tb_thread_pool_graph_task_ref_t task, tb_thread_pool_graph_task_ref_t depend);
+
+/*! start the graph and post all tasks without dependencies
+ *
+ * the graph can be started again after waiting it, but it cannot be modified when it's running.
+ *
+ * @param graph             the graph
+ *
+ * @return                  tb_true or tb_false (empty or cyclic graph)
+ */
+tb_bool_t                   tb_thread_pool_graph_start(tb_thread_pool_graph_ref_t graph);
+
+/*! wait all tasks of the graph
+ *
+ * the dependent tasks will be not run if their dependencies have been killed
+ *
+ * @param graph             the graph
+ * @param timeout           the timeout
+ *
+ * @return                  ok: 1, timeout: 0, killed or error: -1
+ */
+tb_long_t                   tb_thread_pool_graph_wait(tb_thread_pool_graph_ref_t graph, tb_long_t timeout);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -19,6 +19,12 @@
  * @ingroup     platform
  */
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "virtual_memory"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * includes
  */
@@ -37,6 +43,10 @@ tb_pointer_t tb_virtual_memory_malloc(tb_size_t size)
 {
     return tb_native_memory_malloc(size);
 }
+tb_pointer_t tb_virtual_memory_malloc_with_flags(tb_size_t size, tb_size_t flags)
+{
+    return tb_native_memory_malloc(size);
+}
 tb_pointer_t tb_virtual_memory_ralloc(tb_pointer_t data, tb_size_t size)
 {
     return tb_native_memory_ralloc(data, size);
@@ -45,5 +55,23 @@ tb_bool_t tb_virtual_memory_free(tb_pointer_t data)
 {
     return tb_native_memory_free(data);
 }
+tb_pointer_t tb_virtual_memory_guard_malloc(tb_size_t size, tb_size_t guard)
+{
+    // no memory protection, only reserve the guard space
+    tb_byte_t* data = (tb_byte_t*)tb_native_memory_malloc(size + guard);
+    return data? data + guard : tb_null;
+}
+tb_bool_t tb_virtual_memory_guard_free(tb_pointer_t data, tb_size_t size, tb_size_t guard)
+{
+    return data? tb_native_memory_free((tb_byte_t*)data - guard) : tb_true;
+}
+tb_bool_t tb_virtual_memory_decommit(tb_pointer_t data, tb_size_t size)
+{
+    return tb_false;
+}
+tb_long_t tb_virtual_memory_committed(tb_pointer_t data, tb_size_t size)
+{
+    return -1;
+}
 #endif
 
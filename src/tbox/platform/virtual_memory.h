@@ -34,11 +34,34 @@
 /// the virtual memory data size minimum
 #define TB_VIRTUAL_MEMORY_DATA_MINN                 (128 * 1024)
 
+/// the huge page size for TB_VIRTUAL_MEMORY_FLAG_HUGETLB
+#define TB_VIRTUAL_MEMORY_HUGEPAGE_SIZE             (2 * 1024 * 1024)
+
+/// the numa node flag, the node must be less than 64
+#define TB_VIRTUAL_MEMORY_FLAG_NUMA_NODE(node)      (TB_VIRTUAL_MEMORY_FLAG_NUMA | (((tb_size_t)(node) & 0x3f) << 8))
+
+/// the numa node of the given flags
+#define tb_virtual_memory_flag_numa_node(flags)     (((tb_size_t)(flags) >> 8) & 0x3f)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
 __tb_extern_c_enter__
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the virtual memory flag enum
+typedef enum __tb_virtual_memory_flag_e
+{
+    TB_VIRTUAL_MEMORY_FLAG_NONE         = 0
+,   TB_VIRTUAL_MEMORY_FLAG_HUGETLB      = 1     //!< allocate it from the reserved huge pages (MAP_HUGETLB), fallback to the normal pages if no huge pages
+,   TB_VIRTUAL_MEMORY_FLAG_THP          = 2     //!< advise the transparent huge pages (MADV_HUGEPAGE)
+,   TB_VIRTUAL_MEMORY_FLAG_NUMA         = 4     //!< prefer the numa node, please use TB_VIRTUAL_MEMORY_FLAG_NUMA_NODE(node)
+
+}tb_virtual_memory_flag_e;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -51,7 +74,26 @@ __tb_extern_c_enter__
  */
 tb_pointer_t            tb_virtual_memory_malloc(tb_size_t size);
 
-/*! realloc the virtual memory
+/*! malloc the virtual memory with the given flags
+ *
+ * these flags are only hints, it will fallback to the normal pages if they are not supported,
+ * and the numa node policy will fallback to the first-touch if mbind() is not available.
+ *
+ * on windows, TB_VIRTUAL_MEMORY_FLAG_HUGETLB uses MEM_LARGE_PAGES (the SeLockMemoryPrivilege is required),
+ * TB_VIRTUAL_MEMORY_FLAG_NUMA uses VirtualAllocExNuma() and TB_VIRTUAL_MEMORY_FLAG_THP is ignored.
+ *
+ * @code
+    tb_pointer_t data = tb_virtual_memory_malloc_with_flags(size, TB_VIRTUAL_MEMORY_FLAG_HUGETLB | TB_VIRTUAL_MEMORY_FLAG_THP | TB_VIRTUAL_MEMORY_FLAG_NUMA_NODE(1));
+ * @endcode
+ *
+ * @param size          the size
+ * @param flags         the flags, .e.g TB_VIRTUAL_MEMORY_FLAG_HUGETLB | TB_VIRTUAL_MEMORY_FLAG_THP
+ *
+ * @return              the data address
+ */
+tb_pointer_t            tb_virtual_memory_malloc_with_flags(tb_size_t size, tb_size_t flags);
+
+/*! realloc the virtual memory, the new memory will keep the flags of the old memory
  *
  * @param data          the data address
  * @param size          the size
@@ -68,6 +110,57 @@ tb_pointer_t            tb_virtual_memory_ralloc(tb_pointer_t data, tb_size_t si
  */
 tb_bool_t               tb_virtual_memory_free(tb_pointer_t data);
 
+/*! allocate the page-aligned virtual memory with the guard pages before it
+ *
+ * the data pages are committed lazily when they are touched first,
+ * and the guard pages are inaccessible, so the underflow (e.g. stack overflow) will fault immediately.
+ *
+ * <pre>
+ *
+ *  ---------------------------------------------
+ * |  guard pages  |            data             |
+ *  ---------------------------------------------
+ *                 |
+ *               return
+ * </pre>
+ *
+ * @param size          the data size, must be aligned by page size
+ * @param guard         the guard size, must be aligned by page size
+ *
+ * @return              the data address
+ */
+tb_pointer_t            tb_virtual_memory_guard_malloc(tb_size_t size, tb_size_t guard);
+
+/*! free the virtual memory with the guard pages
+ *
+ * @param data          the data address
+ * @param size          the data size
+ * @param guard         the guard size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_virtual_memory_guard_free(tb_pointer_t data, tb_size_t size, tb_size_t guard);
+
+/*! give the physical pages back to the system, e.g. madvise(MADV_DONTNEED)
+ *
+ * the address range is still valid and the pages will be committed again (maybe zero-filled) when they are touched
+ *
+ * @param data          the data address, must be aligned by page size
+ * @param size          the data size, must be aligned by page size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_virtual_memory_decommit(tb_pointer_t data, tb_size_t size);
+
+/*! check whether some physical pages are committed in the given range, e.g. mincore()
+ *
+ * @param data          the data address, must be aligned by page size
+ * @param size          the data size, must be aligned by page size
+ *
+ * @return              1: some pages are committed, 0: no committed pages, -1: unknown or not supported
+ */
+tb_long_t               tb_virtual_memory_committed(tb_pointer_t data, tb_size_t size);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -180,6 +180,18 @@ typedef BOOL (WINAPI* tb_kernel32_UpdateProcThreadAttribute_t)(
 typedef void (WINAPI* tb_kernel32_DeleteProcThreadAttributeList_t)(
     LPPROC_THREAD_ATTRIBUTE_LIST lpAttributeList);
 
+// the GetLargePageMinimum func type
+typedef SIZE_T (WINAPI* tb_kernel32_GetLargePageMinimum_t)(tb_void_t);
+
+// the VirtualAllocExNuma func type
+typedef LPVOID (WINAPI* tb_kernel32_VirtualAllocExNuma_t)(
+    HANDLE hProcess,
+    LPVOID lpAddress,
+    SIZE_T dwSize,
+    DWORD flAllocationType,
+    DWORD flProtect,
+    DWORD nndPreferred);
+
 // the GetLogicalProcessorInformationEx func type
 #if defined(TB_COMPILER_IS_MSVC) && TB_COMPILER_VERSION_BT(16, 0)
 typedef BOOL (WINAPI* tb_kernel32_GetLogicalProcessorInformationEx_t)(
@@ -266,6 +278,12 @@ typedef struct __tb_kernel32_t
     // DeleteProcThreadAttributeList
     tb_kernel32_DeleteProcThreadAttributeList_t         DeleteProcThreadAttributeList;
 
+    // GetLargePageMinimum
+    tb_kernel32_GetLargePageMinimum_t                   GetLargePageMinimum;
+
+    // VirtualAllocExNuma
+    tb_kernel32_VirtualAllocExNuma_t                    VirtualAllocExNuma;
+
     // GetLogicalProcessorInformationEx
 #if defined(TB_COMPILER_IS_MSVC) && TB_COMPILER_VERSION_BT(16, 0)
     tb_kernel32_GetLogicalProcessorInformationEx_t      GetLogicalProcessorInformationEx;
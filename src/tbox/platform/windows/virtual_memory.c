@@ -25,11 +25,34 @@
 #include "prefix.h"
 #include "../virtual_memory.h"
 #include "../../memory/impl/prefix.h"
+#include "interface/interface.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the virtual memory head type
+typedef struct __tb_virtual_memory_head_t
+{
+    // the allocation flags, we need keep them when reallocating it
+    tb_size_t               flags;
+
+    /* the base head
+     *
+     * @note we use tb_pool_data_head_t to support tb_pool_data_size() when checking memory in debug mode
+     */
+    tb_pool_data_head_t     base;
+
+}tb_virtual_memory_head_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
 tb_pointer_t tb_virtual_memory_malloc(tb_size_t size)
+{
+    return tb_virtual_memory_malloc_with_flags(size, TB_VIRTUAL_MEMORY_FLAG_NONE);
+}
+tb_pointer_t tb_virtual_memory_malloc_with_flags(tb_size_t size, tb_size_t flags)
 {
     // check
     tb_check_return_val(size, tb_null);
@@ -37,15 +60,38 @@ tb_pointer_t tb_virtual_memory_malloc(tb_size_t size)
 
     /* allocate a virtual buffer
      *
-     * @note we use tb_pool_data_head_t to support tb_pool_data_size() when checking memory in debug mode
+     * @note the transparent huge pages are not supported on windows, we ignore TB_VIRTUAL_MEMORY_FLAG_THP
      */
-    tb_pool_data_head_t* block = (tb_pool_data_head_t*)VirtualAlloc(tb_null, sizeof(tb_pool_data_head_t) + size, MEM_COMMIT, PAGE_READWRITE);
-    if (block)
+    tb_size_t                   real = sizeof(tb_virtual_memory_head_t) + size;
+    tb_virtual_memory_head_t*   block = tb_null;
+
+    /* try allocating it from the large pages first
+     *
+     * it requires the SeLockMemoryPrivilege of the current process token,
+     * we will fallback to the normal pages if it has been not enabled
+     */
+    if ((flags & TB_VIRTUAL_MEMORY_FLAG_HUGETLB) && tb_kernel32()->GetLargePageMinimum)
     {
-        block->size = size;
-        return (tb_pointer_t)&block[1];
+        tb_size_t large = (tb_size_t)tb_kernel32()->GetLargePageMinimum();
+        if (large)
+        {
+            block = (tb_virtual_memory_head_t*)VirtualAlloc(tb_null, tb_align(real, large), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (!block) tb_trace_d("VirtualAlloc(%lu) with large pages failed(%lu), fallback to the normal pages", real, (tb_size_t)GetLastError());
+        }
     }
-    return tb_null;
+
+    // allocate it on the preferred numa node
+    if (!block && (flags & TB_VIRTUAL_MEMORY_FLAG_NUMA) && tb_kernel32()->VirtualAllocExNuma)
+        block = (tb_virtual_memory_head_t*)tb_kernel32()->VirtualAllocExNuma(GetCurrentProcess(), tb_null, real, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, (DWORD)tb_virtual_memory_flag_numa_node(flags));
+
+    // allocate it from the normal pages
+    if (!block) block = (tb_virtual_memory_head_t*)VirtualAlloc(tb_null, real, MEM_COMMIT, PAGE_READWRITE);
+    tb_check_return_val(block, tb_null);
+
+    // save the flags and size
+    block->flags        = flags;
+    block->base.size    = size;
+    return (tb_pointer_t)&block[1];
 }
 tb_pointer_t tb_virtual_memory_ralloc(tb_pointer_t data, tb_size_t size)
 {
@@ -58,20 +104,20 @@ tb_pointer_t tb_virtual_memory_ralloc(tb_pointer_t data, tb_size_t size)
     else
     {
         // shrink size? return it directly
-        tb_pool_data_head_t* block = &((tb_pool_data_head_t*)data)[-1];
-        if (size <= block->size)
+        tb_virtual_memory_head_t* block = &((tb_virtual_memory_head_t*)data)[-1];
+        if (size <= block->base.size)
             return data;
 
-        // allocate a new anonymous map buffer
-        tb_pointer_t data_new = tb_virtual_memory_malloc(size);
-        if (data_new) tb_memcpy(data_new, data, block->size);
+        // allocate a new virtual buffer with the same flags
+        tb_pointer_t data_new = tb_virtual_memory_malloc_with_flags(size, block->flags);
+        if (data_new) tb_memcpy(data_new, data, block->base.size);
         tb_virtual_memory_free(data);
         return data_new;
     }
 }
 tb_bool_t tb_virtual_memory_free(tb_pointer_t data)
 {
-    tb_pool_data_head_t* block = (tb_pool_data_head_t*)data;
+    tb_virtual_memory_head_t* block = (tb_virtual_memory_head_t*)data;
     if (block)
     {
         block--;
@@ -80,3 +126,38 @@ tb_bool_t tb_virtual_memory_free(tb_pointer_t data)
     return tb_true;
 }
 
+tb_pointer_t tb_virtual_memory_guard_malloc(tb_size_t size, tb_size_t guard)
+{
+    // check
+    tb_assert_and_check_return_val(size, tb_null);
+
+    // reserve the guard and data pages
+    tb_byte_t* base = (tb_byte_t*)VirtualAlloc(tb_null, guard + size, MEM_RESERVE, PAGE_NOACCESS);
+    tb_check_return_val(base, tb_null);
+
+    // commit the data pages, the physical pages will be allocated when they are touched
+    if (!VirtualAlloc(base + guard, size, MEM_COMMIT, PAGE_READWRITE))
+    {
+        VirtualFree(base, 0, MEM_RELEASE);
+        return tb_null;
+    }
+    return base + guard;
+}
+tb_bool_t tb_virtual_memory_guard_free(tb_pointer_t data, tb_size_t size, tb_size_t guard)
+{
+    return data? VirtualFree((tb_byte_t*)data - guard, 0, MEM_RELEASE) : tb_true;
+}
+tb_bool_t tb_virtual_memory_decommit(tb_pointer_t data, tb_size_t size)
+{
+    // check
+    tb_assert_and_check_return_val(data, tb_false);
+    tb_check_return_val(size, tb_true);
+
+    // discard these pages, they will not be written to the paging file
+    return VirtualAlloc(data, size, MEM_RESET, PAGE_READWRITE) != tb_null;
+}
+tb_long_t tb_virtual_memory_committed(tb_pointer_t data, tb_size_t size)
+{
+    // the committed pages are always backed by the page file, we cannot know whether they were touched
+    return -1;
+}
@@ -0,0 +1,765 @@
+/*!The Treasure Box Library
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009-present, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        wtimer.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "wtimer"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "platform.h"
+#include "../memory/memory.h"
+#include "../container/container.h"
+#include "../algorithm/algorithm.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the root wheel bits
+#ifdef __tb_small__
+#   define TB_WTIMER_ROOT_BITS              (6)
+#else
+#   define TB_WTIMER_ROOT_BITS              (8)
+#endif
+
+// the node wheel bits
+#define TB_WTIMER_NODE_BITS                 (6)
+
+// the node wheels count
+#define TB_WTIMER_NODE_MAXN                 (4)
+
+// the root and node wheel size
+#define TB_WTIMER_ROOT_SIZE                 (1 << TB_WTIMER_ROOT_BITS)
+#define TB_WTIMER_NODE_SIZE                 (1 << TB_WTIMER_NODE_BITS)
+
+// the root and node wheel mask
+#define TB_WTIMER_ROOT_MASK                 (TB_WTIMER_ROOT_SIZE - 1)
+#define TB_WTIMER_NODE_MASK                 (TB_WTIMER_NODE_SIZE - 1)
+
+// the time shift of the given node wheel
+#define TB_WTIMER_NODE_SHIFT(level)         (TB_WTIMER_ROOT_BITS + (level) * TB_WTIMER_NODE_BITS)
+
+// the timer limit, 2^32 ms (~49 days) or 2^30 ms (~12 days) for small mode
+#define TB_WTIMER_LIMIT                     ((tb_hong_t)1 << TB_WTIMER_NODE_SHIFT(TB_WTIMER_NODE_MAXN))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the timer task type
+typedef struct __tb_wtimer_task_t
+{
+    // the list entry
+    tb_list_entry_t             entry;
+
+    // the wheel list, it is null if the task is not in the wheel (expired)
+    tb_list_entry_head_ref_t    wlist;
+
+    // the func
+    tb_wtimer_task_func_t       func;
+
+    // the priv
+    tb_cpointer_t               priv;
+
+    // the when
+    tb_hong_t                   when;
+
+    // the period
+    tb_uint32_t                 period  : 28;
+
+    // is repeat?
+    tb_uint32_t                 repeat  : 1;
+
+    // is killed?
+    tb_uint32_t                 killed  : 1;
+
+    // the refn, <= 2
+    tb_uint32_t                 refn    : 2;
+
+}tb_wtimer_task_t;
+
+/*! the timer type
+ *
+ * <pre>
+ *
+ * tick: 1ms
+ *
+ *        root: 256 x 1ms
+ *          |
+ * wheel: |---|---|---|- ... -|---|                     <= the due tasks
+ *          ^ wtime & 0xff
+ *
+ *        node[0]: 64 x 256ms
+ *          |
+ *        |-------|-------|- ... -|                     <= cascaded to root if (wtime & 0xff) == 0
+ *
+ *        node[1]: 64 x 16s
+ *        node[2]: 64 x 17m
+ *        node[3]: 64 x 18h                             <= the range: [wtime, wtime + 2^32ms)
+ *
+ * </pre>
+ *
+ * the task is placed at the wheel level by the distance from wtime,
+ * so the inserting and removing are O(1), and the far tasks will be cascaded to the lower level only once per level.
+ */
+typedef struct __tb_wtimer_t
+{
+    // the grow
+    tb_uint16_t                 grow;
+
+    // cache time?
+    tb_bool_t                   ctime;
+
+    // is stoped?
+    tb_atomic_flag_t            stop;
+
+    // is worked?
+    tb_atomic32_t               work;
+
+    // the wheel time, all tasks before it have been expired
+    tb_hong_t                   wtime;
+
+    // the lock
+    tb_spinlock_t               lock;
+
+    // the pool
+    tb_fixed_pool_ref_t         pool;
+
+    // the tasks count in the wheel
+    tb_size_t                   size;
+
+    // the expired tasks
+    tb_list_entry_head_t        expired;
+
+    // the root wheel
+    tb_list_entry_head_t        root[TB_WTIMER_ROOT_SIZE];
+
+    // the node wheels
+    tb_list_entry_head_t        node[TB_WTIMER_NODE_MAXN][TB_WTIMER_NODE_SIZE];
+
+}tb_wtimer_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static __tb_inline__ tb_hong_t tb_wtimer_now(tb_wtimer_t* timer)
+{
+    // using the real time?
+    if (!timer->ctime)
+    {
+        // get the time
+        tb_timeval_t tv = {0};
+        if (tb_gettimeofday(&tv, tb_null)) return ((tb_hong_t)tv.tv_sec * 1000 + tv.tv_usec / 1000);
+    }
+
+    // using cached time
+    return tb_cache_time_mclock();
+}
+static tb_void_t tb_wtimer_add_task(tb_wtimer_t* timer, tb_wtimer_task_t* timer_task)
+{
+    // check
+    tb_assert(timer && timer_task && !timer_task->wlist);
+
+    // the expired task will be done at the next tick
+    tb_hong_t when = tb_max(timer_task->when, timer->wtime);
+    tb_hong_t diff = when - timer->wtime;
+
+    // the far task? place it at the last node wheel, it will be cascaded again
+    if (diff >= TB_WTIMER_LIMIT)
+    {
+        when = timer->wtime + TB_WTIMER_LIMIT - 1;
+        diff = TB_WTIMER_LIMIT - 1;
+    }
+
+    // trace
+    tb_trace_d("add: when: %lld, wtime: %lld, diff: %lld, refn: %u", timer_task->when, timer->wtime, diff, timer_task->refn);
+
+    // get the wheel list
+    tb_list_entry_head_ref_t wlist = tb_null;
+    if (diff < TB_WTIMER_ROOT_SIZE) wlist = &timer->root[when & TB_WTIMER_ROOT_MASK];
+    else
+    {
+        tb_size_t level = 0;
+        while (level < TB_WTIMER_NODE_MAXN - 1 && diff >= ((tb_hong_t)1 << TB_WTIMER_NODE_SHIFT(level + 1))) level++;
+        wlist = &timer->node[level][(when >> TB_WTIMER_NODE_SHIFT(level)) & TB_WTIMER_NODE_MASK];
+    }
+
+    // add task to the wheel list
+    tb_list_entry_insert_tail(wlist, &timer_task->entry);
+    timer_task->wlist = wlist;
+    timer->size++;
+}
+static tb_void_t tb_wtimer_del_task(tb_wtimer_t* timer, tb_wtimer_task_t* timer_task)
+{
+    // check
+    tb_assert(timer && timer_task && timer_task->wlist && timer->size);
+
+    // trace
+    tb_trace_d("del: when: %lld, refn: %u", timer_task->when, timer_task->refn);
+
+    // remove task from the wheel list
+    tb_list_entry_remove(timer_task->wlist, &timer_task->entry);
+    timer_task->wlist = tb_null;
+    timer->size--;
+}
+static tb_void_t tb_wtimer_cascade(tb_wtimer_t* timer, tb_list_entry_head_ref_t wlist)
+{
+    // detach all tasks of this wheel list
+    tb_list_entry_head_t tasks;
+    tb_list_entry_init(&tasks, tb_wtimer_task_t, entry, tb_null);
+    tb_list_entry_splice_tail(&tasks, wlist);
+    timer->size -= tb_list_entry_size(&tasks);
+
+    // re-add them to the lower wheels
+    while (tb_list_entry_size(&tasks))
+    {
+        tb_wtimer_task_t* timer_task = (tb_wtimer_task_t*)tb_list_entry(&tasks, tb_list_entry_head(&tasks));
+        tb_list_entry_remove_head(&tasks);
+        timer_task->wlist = tb_null;
+        tb_wtimer_add_task(timer, timer_task);
+    }
+    tb_list_entry_exit(&tasks);
+}
+static tb_void_t tb_wtimer_tick(tb_wtimer_t* timer)
+{
+    // cascade the node wheels if the root wheel is turned a round
+    tb_size_t index = (tb_size_t)(timer->wtime & TB_WTIMER_ROOT_MASK);
+    if (!index)
+    {
+        tb_size_t level = 0;
+        for (level = 0; level < TB_WTIMER_NODE_MAXN; level++)
+        {
+            // cascade the current wheel list of this level
+            tb_size_t nindex = (tb_size_t)((timer->wtime >> TB_WTIMER_NODE_SHIFT(level)) & TB_WTIMER_NODE_MASK);
+            if (tb_list_entry_size(&timer->node[level][nindex])) tb_wtimer_cascade(timer, &timer->node[level][nindex]);
+
+            // the upper wheel is turned only if this wheel is turned a round
+            tb_check_break(!nindex);
+        }
+    }
+
+    // move the due tasks to the expired tasks
+    tb_list_entry_head_ref_t wlist = &timer->root[index];
+    if (tb_list_entry_size(wlist))
+    {
+        // clear the wheel list of all tasks
+        tb_for_all_if (tb_wtimer_task_t*, timer_task, tb_list_entry_itor(wlist), timer_task)
+            timer_task->wlist = tb_null;
+
+        // detach them
+        timer->size -= tb_list_entry_size(wlist);
+        tb_list_entry_splice_tail(&timer->expired, wlist);
+    }
+
+    // next tick
+    timer->wtime++;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+tb_wtimer_ref_t tb_wtimer_init(tb_size_t grow, tb_bool_t ctime)
+{
+    // done
+    tb_bool_t       ok = tb_false;
+    tb_wtimer_t*    timer = tb_null;
+    do
+    {
+        // make timer
+        timer = tb_malloc0_type(tb_wtimer_t);
+        tb_assert_and_check_break(timer);
+
+        // init timer
+        timer->grow     = (tb_uint16_t)tb_max(grow, 16);
+        timer->ctime    = ctime;
+        timer->wtime    = tb_wtimer_now(timer);
+        tb_atomic_flag_clear_explicit(&timer->stop, TB_ATOMIC_RELAXED);
+        tb_atomic32_init(&timer->work, 0);
+
+        // init lock
+        if (!tb_spinlock_init(&timer->lock)) break;
+
+        // init pool
+        timer->pool = tb_fixed_pool_init(tb_null, timer->grow, sizeof(tb_wtimer_task_t), tb_null, tb_null, tb_null);
+        tb_assert_and_check_break(timer->pool);
+
+        // init the expired tasks
+        tb_list_entry_init(&timer->expired, tb_wtimer_task_t, entry, tb_null);
+
+        // init wheels
+        tb_size_t i = 0;
+        tb_size_t j = 0;
+        for (i = 0; i < TB_WTIMER_ROOT_SIZE; i++)
+            tb_list_entry_init(&timer->root[i], tb_wtimer_task_t, entry, tb_null);
+        for (i = 0; i < TB_WTIMER_NODE_MAXN; i++)
+        {
+            for (j = 0; j < TB_WTIMER_NODE_SIZE; j++)
+                tb_list_entry_init(&timer->node[i][j], tb_wtimer_task_t, entry, tb_null);
+        }
+
+        // register lock profiler
+#ifdef TB_LOCK_PROFILER_ENABLE
+        tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&timer->lock, TB_TRACE_MODULE_NAME);
+#endif
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (timer) tb_wtimer_exit((tb_wtimer_ref_t)timer);
+        timer = tb_null;
+    }
+
+    // ok?
+    return (tb_wtimer_ref_t)timer;
+}
+tb_void_t tb_wtimer_exit(tb_wtimer_ref_t self)
+{
+    // check
+    tb_wtimer_t* timer = (tb_wtimer_t*)self;
+    tb_assert_and_check_return(timer);
+
+    // kill it first
+    tb_wtimer_kill(self);
+
+    // wait loop exit
+    tb_size_t tryn = 10;
+    while (tb_atomic32_get_explicit(&timer->work, TB_ATOMIC_RELAXED) && tryn--) tb_msleep(500);
+
+    // warning
+    if (!tryn && tb_atomic32_get_explicit(&timer->work, TB_ATOMIC_RELAXED))
+    {
+        tb_trace_w("[wtimer]: the loop has been not exited now!");
+    }
+
+    // enter
+    tb_spinlock_enter(&timer->lock);
+
+    // exit pool, all tasks in the wheels are freed together
+    if (timer->pool) tb_fixed_pool_exit(timer->pool);
+    timer->pool = tb_null;
+    timer->size = 0;
+
+    // leave
+    tb_spinlock_leave(&timer->lock);
+
+    // exit lock
+    tb_spinlock_exit(&timer->lock);
+
+    // exit it
+    tb_free(timer);
+}
+tb_void_t tb_wtimer_kill(tb_wtimer_ref_t self)
+{
+    // check
+    tb_wtimer_t* timer = (tb_wtimer_t*)self;
+    tb_assert_and_check_return(timer);
+
+    // stop it
+    tb_atomic_flag_test_and_set_explicit(&timer->stop, TB_ATOMIC_RELAXED);
+}
+tb_void_t tb_wtimer_clear(tb_wtimer_ref_t self)
+{
+    tb_wtimer_t* timer = (tb_wtimer_t*)self;
+    if (timer)
+    {
+        // enter
+        tb_spinlock_enter(&timer->lock);
+
+        // reset the wheel time
+        timer->wtime = tb_wtimer_now(timer);
+
+        // clear wheels
+        tb_size_t i = 0;
+        tb_size_t j = 0;
+        for (i = 0; i < TB_WTIMER_ROOT_SIZE; i++)
+            tb_list_entry_clear(&timer->root[i]);
+        for (i = 0; i < TB_WTIMER_NODE_MAXN; i++)
+        {
+            for (j = 0; j < TB_WTIMER_NODE_SIZE; j++)
+                tb_list_entry_clear(&timer->node[i][j]);
+        }
+        tb_list_entry_clear(&timer->expired);
+        timer->size = 0;
+
+        // clear pool
+        if (timer->pool) tb_fixed_pool_clear(timer->pool);
+
+        // leave
+        tb_spinlock_leave(&timer->lock);
+    }
+}
+tb_hize_t tb_wtimer_limit(tb_wtimer_ref_t self)
+{
+    // check
+    tb_wtimer_t* timer = (tb_wtimer_t*)self;
+    tb_assert_and_check_return_val(timer, 0);
+
+    // the timer limit
+    return (tb_hize_t)TB_WTIMER_LIMIT;
+}
+tb_size_t tb_wtimer_delay(tb_wtimer_ref_t self)
+{
+    // check
+    tb_wtimer_t* timer = (tb_wtimer_t*)self;
+    tb_assert_and_check_return_val(timer, -1);
+
+    // stoped?
+    tb_assert_and_check_return_val(!tb_atomic_flag_test_explicit(&timer->stop, TB_ATOMIC_RELAXED), -1);
+
+    // enter
+    tb_spinlock_enter(&timer->lock);
+
+    // done
+    tb_size_t delay = -1;
+    if (timer->size)
+    {
+        // find the nearest due task in the root wheel
+        tb_size_t i = 0;
+        tb_hong_t wtime = timer->wtime;
+        tb_hong_t next = wtime + TB_WTIMER_LIMIT;
+        for (i = 0; i < TB_WTIMER_ROOT_SIZE; i++)
+        {
+            if (tb_list_entry_size(&timer->root[(wtime + i) & TB_WTIMER_ROOT_MASK]))
+            {
+                next = wtime + i;
+                break;
+            }
+        }
+
+        /* find the nearest cascading time of the node wheels
+         *
+         * the tasks in the node wheel will be not expired before it is cascaded,
+         * so we need only wake up at the cascading time and find the due tasks again.
+         */
+        tb_size_t level = 0;
+        for (level = 0; level < TB_WTIMER_NODE_MAXN; level++)
+        {
+            // the next cascading block of this level
+            tb_size_t shift = TB_WTIMER_NODE_SHIFT(level);
+            tb_hong_t block = (wtime + ((tb_hong_t)1 << shift) - 1) >> shift;
+
+            // no nearer time at this and upper levels
+            tb_check_break((block << shift) < next);
+
+            // find the first non-empty wheel list from the next cascading block
+            for (i = 0; i < TB_WTIMER_NODE_SIZE && ((block + i) << shift) < next; i++)
+            {
+                if (tb_list_entry_size(&timer->node[level][(block + i) & TB_WTIMER_NODE_MASK]))
+                {
+                    next = (block + i) << shift;
+                    break;
+                }
+            }
+        }
+
+        // the delay
+        tb_hong_t now = tb_wtimer_now(timer);
+        delay = next > now? (tb_size_t)(next - now) : 0;
+    }
+
+    // leave
+    tb_spinlock_leave(&timer->lock);
+
+    // ok?
+    return delay;
+}
+tb_bool_t tb_wtimer_spak(tb_wtimer_ref_t self)
+{
+    // check
+    tb_wtimer_t* timer = (tb_wtimer_t*)self;
+    tb_assert_and_check_return_val(timer && timer->pool, tb_false);
+
+    // stoped?
+    tb_check_return_val(!tb_atomic_flag_test_explicit(&timer->stop, TB_ATOMIC_RELAXED), tb_false);
+
+    // the now time
+    tb_hong_t now = tb_wtimer_now(timer);
+
+    // enter
+    tb_spinlock_enter(&timer->lock);
+
+    // turn the wheels to now
+    if (timer->size)
+    {
+        while (timer->wtime <= now && timer->size) tb_wtimer_tick(timer);
+    }
+
+    // no tasks? move to now directly
+    if (!timer->size && timer->wtime <= now) timer->wtime = now + 1;
+
+    // leave
+    tb_spinlock_leave(&timer->lock);
+
+    // exists expired tasks?
+    if (tb_list_entry_size(&timer->expired))
+    {
+        // done all expired tasks, they are only accessed by the spaking thread now
+        tb_for_all_if (tb_wtimer_task_t*, timer_task, tb_list_entry_itor(&timer->expired), timer_task)
+        {
+            // trace
+            tb_trace_d("done: expired: when: %lld, period: %u, refn: %u, killed: %u", timer_task->when, timer_task->period, timer_task->refn, timer_task->killed);
+
+            // done func
+            tb_wtimer_task_func_t func = timer_task->func;
+            if (func) func(timer_task->killed? tb_true : tb_false, timer_task->priv);
+        }
+
+        // enter
+        tb_spinlock_enter(&timer->lock);
+
+        // exit all expired tasks
+        while (tb_list_entry_size(&timer->expired))
+        {
+            // detach the task
+            tb_wtimer_task_t* timer_task = (tb_wtimer_task_t*)tb_list_entry(&timer->expired, tb_list_entry_head(&timer->expired));
+            tb_list_entry_remove_head(&timer->expired);
+
+            // repeat? continue the task
+            if (timer_task->repeat)
+            {
+                timer_task->when = now + timer_task->period;
+                tb_wtimer_add_task(timer, timer_task);
+            }
+            // refn--
+            else if (timer_task->refn > 1) timer_task->refn--;
+            // remove it from pool directly
+            else tb_fixed_pool_free(timer->pool, timer_task);
+        }
+
+        // leave
+        tb_spinlock_leave(&timer->lock);
+    }
+
+    // ok
+    return tb_true;
+}
+tb_void_t tb_wtimer_loop(tb_wtimer_ref_t self)
+{
+    // check
+    tb_wtimer_t* timer = (tb_wtimer_t*)self;
+    tb_assert_and_check_return(timer);
+
+    // work++
+    tb_atomic32_fetch_and_add_explicit(&timer->work, 1, TB_ATOMIC_RELAXED);
+
+    // loop
+    while (!tb_atomic_flag_test_explicit(&timer->stop, TB_ATOMIC_RELAXED))
+    {
+        // the delay, we need check the stop flag periodically
+        tb_size_t delay = tb_wtimer_delay(self);
+        if (delay > 1000) delay = 1000;
+
+        // wait some time
+        if (delay) tb_msleep(delay);
+
+        // spak ctime
+        if (timer->ctime) tb_cache_time_spak();
+
+        // spak it
+        if (!tb_wtimer_spak(self)) break;
+    }
+
+    // work--
+    tb_atomic32_fetch_and_sub_explicit(&timer->work, 1, TB_ATOMIC_RELAXED);
+}
+tb_wtimer_task_ref_t tb_wtimer_task_init(tb_wtimer_ref_t self, tb_size_t delay, tb_bool_t repeat, tb_wtimer_task_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_wtimer_t* timer = (tb_wtimer_t*)self;
+    tb_assert_and_check_return_val(timer && func, tb_null);
+
+    // add task
+    return tb_wtimer_task_init_at(self, tb_wtimer_now(timer) + delay, delay, repeat, func, priv);
+}
+tb_wtimer_task_ref_t tb_wtimer_task_init_at(tb_wtimer_ref_t self, tb_hize_t when, tb_size_t period, tb_bool_t repeat, tb_wtimer_task_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_wtimer_t* timer = (tb_wtimer_t*)self;
+    tb_assert_and_check_return_val(timer && timer->pool && func, tb_null);
+
+    // stoped?
+    tb_assert_and_check_return_val(!tb_atomic_flag_test_explicit(&timer->stop, TB_ATOMIC_RELAXED), tb_null);
+
+    // enter
+    tb_spinlock_enter(&timer->lock);
+
+    // make task
+    tb_wtimer_task_t* timer_task = (tb_wtimer_task_t*)tb_fixed_pool_malloc0(timer->pool);
+    if (timer_task)
+    {
+        // init task
+        timer_task->refn      = 2;
+        timer_task->func      = func;
+        timer_task->priv      = priv;
+        timer_task->when      = when;
+        timer_task->period    = period;
+        timer_task->repeat    = repeat? 1 : 0;
+        timer_task->killed    = 0;
+
+        // add task
+        tb_wtimer_add_task(timer, timer_task);
+    }
+
+    // leave
+    tb_spinlock_leave(&timer->lock);
+
+    // ok?
+    return (tb_wtimer_task_ref_t)timer_task;
+}
+tb_wtimer_task_ref_t tb_wtimer_task_init_after(tb_wtimer_ref_t self, tb_hize_t after, tb_size_t period, tb_bool_t repeat, tb_wtimer_task_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_wtimer_t* timer = (tb_wtimer_t*)self;
+    tb_assert_and_check_return_val(timer && func, tb_null);
+
+    // add task
+    return tb_wtimer_task_init_at(self, tb_wtimer_now(timer) + after, period, repeat, func, priv);
+}
+tb_void_t tb_wtimer_task_post(tb_wtimer_ref_t self, tb_size_t delay, tb_bool_t repeat, tb_wtimer_task_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_wtimer_t* timer = (tb_wtimer_t*)self;
+    tb_assert_and_check_return(timer && func);
+
+    // run task
+    tb_wtimer_task_post_at(self, tb_wtimer_now(timer) + delay, delay, repeat, func, priv);
+}
+tb_void_t tb_wtimer_task_post_at(tb_wtimer_ref_t self, tb_hize_t when, tb_size_t period, tb_bool_t repeat, tb_wtimer_task_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_wtimer_t* timer = (tb_wtimer_t*)self;
+    tb_assert_and_check_return(timer && timer->pool && func);
+
+    // stoped?
+    tb_assert_and_check_return(!tb_atomic_flag_test_explicit(&timer->stop, TB_ATOMIC_RELAXED));
+
+    // enter
+    tb_spinlock_enter(&timer->lock);
+
+    // make task
+    tb_wtimer_task_t* timer_task = (tb_wtimer_task_t*)tb_fixed_pool_malloc0(timer->pool);
+    if (timer_task)
+    {
+        // init task
+        timer_task->refn      = 1;
+        timer_task->func      = func;
+        timer_task->priv      = priv;
+        timer_task->when      = when;
+        timer_task->period    = period;
+        timer_task->repeat    = repeat? 1 : 0;
+        timer_task->killed    = 0;
+
+        // add task
+        tb_wtimer_add_task(timer, timer_task);
+    }
+
+    // leave
+    tb_spinlock_leave(&timer->lock);
+}
+tb_void_t tb_wtimer_task_post_after(tb_wtimer_ref_t self, tb_hize_t after, tb_size_t period, tb_bool_t repeat, tb_wtimer_task_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_wtimer_t* timer = (tb_wtimer_t*)self;
+    tb_assert_and_check_return(timer && func);
+
+    // run task
+    tb_wtimer_task_post_at(self, tb_wtimer_now(timer) + after, period, repeat, func, priv);
+}
+tb_void_t tb_wtimer_task_exit(tb_wtimer_ref_t self, tb_wtimer_task_ref_t task)
+{
+    // check
+    tb_wtimer_t*        timer = (tb_wtimer_t*)self;
+    tb_wtimer_task_t*   timer_task = (tb_wtimer_task_t*)task;
+    tb_assert_and_check_return(timer && timer->pool && timer_task);
+
+    // trace
+    tb_trace_d("exit: when: %lld, period: %u, refn: %u", timer_task->when, timer_task->period, timer_task->refn);
+
+    // enter
+    tb_spinlock_enter(&timer->lock);
+
+    // the pending task? remove it from the wheel and free it directly
+    if (timer_task->wlist)
+    {
+        tb_wtimer_del_task(timer, timer_task);
+        tb_fixed_pool_free(timer->pool, timer_task);
+    }
+    // the expired task is being done now? cancel it and it will be freed after done
+    else if (timer_task->refn > 1)
+    {
+        // refn--
+        timer_task->refn--;
+
+        // cancel task
+        timer_task->func      = tb_null;
+        timer_task->priv      = tb_null;
+        timer_task->repeat    = 0;
+    }
+    // remove it from pool directly if the task have been expired
+    else tb_fixed_pool_free(timer->pool, timer_task);
+
+    // leave
+    tb_spinlock_leave(&timer->lock);
+}
+tb_void_t tb_wtimer_task_kill(tb_wtimer_ref_t self, tb_wtimer_task_ref_t task)
+{
+    // check
+    tb_wtimer_t*        timer = (tb_wtimer_t*)self;
+    tb_wtimer_task_t*   timer_task = (tb_wtimer_task_t*)task;
+    tb_assert_and_check_return(timer && timer->pool && timer_task);
+
+    // trace
+    tb_trace_d("kill: when: %lld, period: %u, refn: %u", timer_task->when, timer_task->period, timer_task->refn);
+
+    // enter
+    tb_spinlock_enter(&timer->lock);
+
+    // the pending task? move it to the next tick
+    if (timer_task->wlist && timer_task->refn == 2)
+    {
+        // del the task first
+        tb_wtimer_del_task(timer, timer_task);
+
+        // killed and no repeat
+        timer_task->killed = 1;
+        timer_task->repeat = 0;
+
+        // modify when => now
+        timer_task->when = tb_wtimer_now(timer);
+
+        // re-add task
+        tb_wtimer_add_task(timer, timer_task);
+    }
+
+    // leave
+    tb_spinlock_leave(&timer->lock);
+}
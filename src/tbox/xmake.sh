@@ -107,12 +107,15 @@ target "tbox"
     add_files "platform/thread.c"
     add_files "platform/thread_local.c"
     add_files "platform/thread_pool.c"
+    add_files "platform/thread_pool_graph.c"
     add_files "platform/time.c"
     add_files "platform/timer.c"
     add_files "platform/virtual_memory.c"
+    add_files "platform/wtimer.c"
     add_files "platform/impl/platform.c"
     add_files "platform/impl/pollerdata.c"
     add_files "platform/impl/dns.c"
+    add_files "platform/impl/ws_deque.c"
 
     # add the source files for the windows
     if is_plat "mingw"; then
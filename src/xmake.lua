@@ -274,7 +274,7 @@ function check_interfaces()
         check_module_cfuncs("posix", "unistd.h",                         "getpagesize", "sysconf")
         check_module_cfuncs("posix", "sched.h",                          "sched_yield", "sched_setaffinity") -- need _GNU_SOURCE
         check_module_cfuncs("posix", "regex.h",                          "regcomp", "regexec")
-        check_module_cfuncs("posix", "sys/uio.h",                        "readv", "writev", "preadv", "pwritev")
+        check_module_cfuncs("posix", "sys/uio.h",                        "readv", "writev", "preadv", "pwritev", "preadv2", "pwritev2")
         check_module_cfuncs("posix", "unistd.h",                         "pread64", "pwrite64")
         check_module_cfuncs("posix", "unistd.h",                         "fdatasync")
         check_module_cfuncs("posix", "copyfile.h",                       "copyfile")
@@ -354,6 +354,14 @@ function check_interfaces()
     -- add the interfaces for linux
     if is_plat("linux", "android") then
         check_module_cfuncs("linux", {"sys/inotify.h"}, "inotify_init")
+
+        -- add the interfaces for io_uring (linux >= 6.1)
+        configvar_check_csnippets("TB_CONFIG_LINUX_HAVE_IO_URING", [[
+            #include <linux/io_uring.h>
+            #include <sys/syscall.h>
+            #include <unistd.h>
+            void test() {struct io_uring_params p = {0}; p.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN; p.features = IORING_FEAT_EXT_ARG; syscall(__NR_io_uring_setup, IORING_POLL_ADD_MULTI, &p); syscall(__NR_io_uring_register, 0, IORING_REGISTER_ENABLE_RINGS, 0, 0);}]],
+            {name = "linux_io_uring", defines = "_GNU_SOURCE=1", languages = stdc})
     end
 
     -- add the interfaces for valgrind
@@ -249,7 +249,7 @@ check_interfaces() {
     check_module_cfuncs "posix" "unistd.h"                         "getpagesize" "sysconf"
     check_module_cfuncs "posix" "sched.h"                          "sched_yield" "sched_setaffinity" # need _GNU_SOURCE
     check_module_cfuncs "posix" "regex.h"                          "regcomp" "regexec"
-    check_module_cfuncs "posix" "sys/uio.h"                        "readv" "writev" "preadv" "pwritev"
+    check_module_cfuncs "posix" "sys/uio.h"                        "readv" "writev" "preadv" "pwritev" "preadv2" "pwritev2"
     check_module_cfuncs "posix" "unistd.h"                         "pread64" "pwrite64"
     check_module_cfuncs "posix" "unistd.h"                         "fdatasync"
     check_module_cfuncs "posix" "copyfile.h"                       "copyfile"
@@ -276,6 +276,13 @@ check_interfaces() {
     # add the interfaces for linux
     check_module_cfuncs "linux" "sys/inotify.h" "inotify_init"
 
+    # add the interfaces for io_uring (linux >= 6.1)
+    check_module_csnippets "linux_io_uring" "TB_CONFIG_LINUX_HAVE_IO_URING" \
+        "#include <linux/io_uring.h>\n
+         #include <sys/syscall.h>\n
+         #include <unistd.h>\n
+         void test() {struct io_uring_params p = {0}; p.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN; p.features = IORING_FEAT_EXT_ARG; syscall(__NR_io_uring_setup, IORING_POLL_ADD_MULTI, &p); syscall(__NR_io_uring_register, 0, IORING_REGISTER_ENABLE_RINGS, 0, 0);}"
+
     # add the interfaces for sigsetjmp
     check_module_csnippets "libc_sigsetjmp" "TB_CONFIG_LIBC_HAVE_SIGSETJMP" \
         "#include <signal.h>\n